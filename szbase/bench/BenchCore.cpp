@@ -0,0 +1,215 @@
+// comment: 基础数据结构微基准
+
+#include "../test/Benchmark.h"
+#include "../ds/Delegate.h"
+#include "../ds/EventBus.h"
+#include "../ds/Math.h"
+#include "../ds/MPSCQueue.h"
+#include "../string/String.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace sz_test;
+
+    // 委托调用
+    SZ_BENCHMARK(Delegate_Invoke)
+    {
+        int base = 1;
+        sz_ds::Delegate<int, int> delegate;
+        delegate.Bind([&base](int x) { return x + base; });
+
+        int sum = 0;
+        while (state.KeepRunning())
+        {
+            sum = delegate(sum);
+            DoNotOptimize(sum);
+        }
+    }
+
+    // std::function调用，和委托对比
+    SZ_BENCHMARK(StdFunction_Invoke)
+    {
+        int base = 1;
+        std::function<int(int)> function = [&base](int x) { return x + base; };
+
+        int sum = 0;
+        while (state.KeepRunning())
+        {
+            sum = function(sum);
+            DoNotOptimize(sum);
+        }
+    }
+
+    // 委托拷贝，可平凡拷贝的可调用对象直接拷贝内存
+    SZ_BENCHMARK(Delegate_CopyTrivial)
+    {
+        int base = 1;
+        sz_ds::Delegate<int, int> delegate;
+        delegate.Bind([&base](int x) { return x + base; });
+
+        while (state.KeepRunning())
+        {
+            sz_ds::Delegate<int, int> copy(delegate);
+            DoNotOptimize(copy);
+        }
+    }
+
+    // 委托拷贝，捕获shared_ptr需要经过管理跳板
+    SZ_BENCHMARK(Delegate_CopyManaged)
+    {
+        auto shared = std::make_shared<int>(1);
+        sz_ds::Delegate<int, int> delegate;
+        delegate.Bind([shared](int x) { return x + *shared; });
+
+        while (state.KeepRunning())
+        {
+            sz_ds::Delegate<int, int> copy(delegate);
+            DoNotOptimize(copy);
+        }
+    }
+
+    // std::function拷贝，和委托对比
+    SZ_BENCHMARK(StdFunction_CopyManaged)
+    {
+        auto shared = std::make_shared<int>(1);
+        std::function<int(int)> function = [shared](int x) { return x + *shared; };
+
+        while (state.KeepRunning())
+        {
+            std::function<int(int)> copy(function);
+            DoNotOptimize(copy);
+        }
+    }
+
+    // 多播委托调用，16个绑定
+    SZ_BENCHMARK(MulticastDelegate_Invoke16)
+    {
+        int sum = 0;
+        sz_ds::MulticastDelegate<int> multicast;
+        for (int i = 0; i < 16; ++i)
+        {
+            multicast.Add([&sum](int x) { sum += x; });
+        }
+
+        state.SetItemsPerIteration(16);
+        while (state.KeepRunning())
+        {
+            multicast(1);
+            DoNotOptimize(sum);
+        }
+    }
+
+    struct BenchEventData
+    {
+        int m_value = 0;
+    };
+    using BenchEvent = sz_ds::Event<BenchEventData>;
+
+    // 事件发布，8个订阅者
+    SZ_BENCHMARK(EventBus_Publish8)
+    {
+        sz_ds::EventBus bus;
+        int sum = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            bus.Subscribe<BenchEvent>([&sum](const sz_ds::IEvent& event) {
+                sum += static_cast<const BenchEvent&>(event).GetData().m_value;
+            });
+        }
+
+        state.SetItemsPerIteration(8);
+        while (state.KeepRunning())
+        {
+            bus.Publish<BenchEvent>(BenchEventData{ 1 });
+            DoNotOptimize(sum);
+        }
+    }
+
+    // 事件订阅和取消订阅，每次迭代16对
+    SZ_BENCHMARK(EventBus_SubscribeUnsubscribe16)
+    {
+        sz_ds::EventBus bus;
+        int sum = 0;
+        std::vector<uint64_t> ids;
+        ids.reserve(16);
+
+        state.SetItemsPerIteration(16);
+        while (state.KeepRunning())
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                ids.push_back(bus.Subscribe<BenchEvent>([&sum](const sz_ds::IEvent&) { ++sum; }));
+            }
+            for (auto id : ids)
+            {
+                bus.Unsubscribe<BenchEvent>(id);
+            }
+            ids.clear();
+        }
+        DoNotOptimize(sum);
+    }
+
+    // 多生产者单消费者队列，单线程投递并取出一个闭包，节点来自预分配池
+    SZ_BENCHMARK(MPSCQueue_PushPop)
+    {
+        using Task = sz_ds::Delegate<void>;
+        sz_ds::MPSCQueue<Task> queue(256);
+        int sum = 0;
+        Task task;
+        while (state.KeepRunning())
+        {
+            Task pushed;
+            pushed.Bind([&sum]() { ++sum; });
+            queue.Push(std::move(pushed));
+            queue.TryPop(task);
+            task();
+        }
+        DoNotOptimize(sum);
+    }
+
+    // UTF8解码，中英文混合
+    SZ_BENCHMARK(UTF8Decode_Mixed)
+    {
+        std::string text;
+        for (int i = 0; i < 16; ++i)
+        {
+            text += "Hello, world! 你好，世界！";
+        }
+
+        state.SetItemsPerIteration(text.size());
+        while (state.KeepRunning())
+        {
+            auto [ok, codepoints] = sz_string::UTF8Decode(text);
+            DoNotOptimize(ok);
+            DoNotOptimize(codepoints.data());
+        }
+    }
+
+    // 包围盒求交
+    SZ_BENCHMARK(AABB2D_Intersection)
+    {
+        std::vector<sz_ds::AABB2D> boxes;
+        for (int i = 0; i < 256; ++i)
+        {
+            const float x = float((i * 37) % 500);
+            const float y = float((i * 91) % 400);
+            boxes.emplace_back(x, y, x + 120.0f, y + 80.0f);
+        }
+        const sz_ds::AABB2D clip(100.0f, 100.0f, 400.0f, 300.0f);
+
+        state.SetItemsPerIteration(boxes.size());
+        while (state.KeepRunning())
+        {
+            for (const auto& box : boxes)
+            {
+                auto intersection = box.Intersection(clip);
+                DoNotOptimize(intersection);
+            }
+        }
+    }
+}
@@ -0,0 +1,389 @@
+// comment: 布局、文字排版和命中测试微基准，不创建窗口和图形上下文
+
+#include "../test/Benchmark.h"
+#include "../gui/UIManager.h"
+#include "../gui/TextLayout.h"
+#include "../gui/WidgetFactory.h"
+#include "../gui/layout/AnchorLayout.h"
+#include "../gui/layout/ConstraintLayout.h"
+#include "../gui/layout/GridLayout.h"
+#include "../gui/layout/StackLayout.h"
+#include "../gui/widget/UIButton.h"
+#include "../gui/widget/UIFrame.h"
+#include "../string/String.h"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 锚点布局，父容器尺寸交替变化，每次所有控件重新计算
+    SZ_BENCHMARK(AnchorLayout_PerformLayout1k)
+    {
+        const size_t count = 1000;
+        layout::AnchorLayout anchorLayout;
+        std::vector<std::shared_ptr<widget::UIButton>> buttons;
+        buttons.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto button = MakeWidget<widget::UIButton>("BenchAnchor" + std::to_string(i),
+                layout::AnchorPoint(1 + i % 9), layout::Margins::Mixed(float(i % 50), true, float(i % 40), false,
+                    4.0f, false, 4.0f, false), 60, 20);
+            button->setChildIdForUIManager(i + 1);
+            anchorLayout.AddWidget(button);
+            buttons.push_back(button);
+        }
+
+        state.SetItemsPerIteration(count);
+        float width = 1920.0f;
+        while (state.KeepRunning())
+        {
+            width = width == 1920.0f ? 1280.0f : 1920.0f;
+            anchorLayout.SetParentRect({ 0.0f, 0.0f, width, 1080.0f });
+            anchorLayout.PerformLayout();
+            DoNotOptimize(buttons.back()->GetRect());
+        }
+    }
+
+    // 行布局基准的规模，100行每行20个按钮
+    constexpr size_t ROW_COUNT = 100;
+    constexpr size_t ROW_CELLS = 20;
+
+    // 构建ROW_COUNT行按钮，每行一个边框控件
+    // anchored为true时用锚点布局和边距定位，否则用堆叠布局
+    std::vector<std::shared_ptr<widget::UIFrame>> buildRows(ILayout& outer, bool anchored)
+    {
+        uint64_t nextId = 1;
+        std::vector<std::shared_ptr<widget::UIFrame>> frames;
+        for (size_t r = 0; r < ROW_COUNT; ++r)
+        {
+            auto frame = MakeWidget<widget::UIFrame>("BenchRow" + std::to_string(r), layout::AnchorPoint::TopLeft,
+                layout::Margins(0.0f, anchored ? r * 20.0f : 0.0f, 0.0f, 0.0f), 0, 20);
+            frame->setChildIdForUIManager(nextId++);
+            outer.AddWidget(frame);
+            if (anchored)
+            {
+                frame->SetLayout(new layout::AnchorLayout());
+            }
+            else
+            {
+                frame->SetLayout(new layout::StackLayout(layout::StackDirection::Horizontal));
+            }
+            for (size_t c = 0; c < ROW_CELLS; ++c)
+            {
+                auto button = MakeWidget<widget::UIButton>("BenchCell" + std::to_string(r) + "_" + std::to_string(c),
+                    layout::AnchorPoint::TopLeft, layout::Margins(anchored ? c * 40.0f : 0.0f, 0.0f, 0.0f, 0.0f), 40, 18);
+                button->setChildIdForUIManager(nextId++);
+                frame->AddWidget(button);
+            }
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    // 每次迭代执行一次外层布局和所有行内布局，makeRect(i)给出第i次迭代的父容器矩形
+    template<typename MakeRect>
+    void runRows(BenchmarkState& state, bool anchored, MakeRect makeRect)
+    {
+        std::unique_ptr<ILayout> outer;
+        if (anchored)
+        {
+            outer = std::make_unique<layout::AnchorLayout>();
+        }
+        else
+        {
+            outer = std::make_unique<layout::StackLayout>(layout::StackDirection::Vertical);
+        }
+        auto frames = buildRows(*outer, anchored);
+
+        state.SetItemsPerIteration(ROW_COUNT * ROW_CELLS);
+        uint64_t i = 0;
+        while (state.KeepRunning())
+        {
+            outer->SetParentRect(makeRect(i++));
+            outer->PerformLayout();
+            for (auto& frame : frames)
+            {
+                frame->UpdateLayout();
+            }
+            DoNotOptimize(frames.back()->GetRect());
+        }
+    }
+
+    sz_ds::Rect resizeRect(uint64_t i) { return { 0.0f, 0.0f, 800.0f + (i % 2) * 20.0f, 2000.0f }; }
+    sz_ds::Rect moveRect(uint64_t i) { return { (i % 2) * 10.0f, 0.0f, 800.0f, 2000.0f }; }
+
+    // 堆叠布局，父容器宽度交替变化，和嵌套锚点布局对比
+    SZ_BENCHMARK(StackLayout_Resize)
+    {
+        runRows(state, false, resizeRect);
+    }
+
+    SZ_BENCHMARK(NestedAnchorLayout_Resize)
+    {
+        runRows(state, true, resizeRect);
+    }
+
+    // 堆叠布局，父容器只移动位置，测量全部命中缓存
+    SZ_BENCHMARK(StackLayout_Move)
+    {
+        runRows(state, false, moveRect);
+    }
+
+    SZ_BENCHMARK(NestedAnchorLayout_Move)
+    {
+        runRows(state, true, moveRect);
+    }
+
+    // 网格布局，1000行4列只显示5行，列宽交替变化，耗时和单元格总数无关
+    SZ_BENCHMARK(GridLayout_ColumnChange4k)
+    {
+        const uint32_t rows = 1000;
+        const uint32_t cols = 4;
+        layout::GridLayout grid(std::vector<layout::GridTrack>(cols, layout::GridTrack::Fraction(1.0f)), {});
+        grid.SetImplicitRow(layout::GridTrack::Fixed(20.0f));
+        std::vector<std::shared_ptr<widget::UIButton>> cells;
+        for (uint32_t i = 0; i < rows * cols; ++i)
+        {
+            auto cell = MakeWidget<widget::UIButton>("BenchGridCell" + std::to_string(i), layout::AnchorPoint::TopLeft,
+                layout::Margins(0.0f), 0, 0);
+            cell->setChildIdForUIManager(i + 1);
+            grid.AddWidget(cell);
+            cells.push_back(cell);
+        }
+        grid.SetParentRect({ 0.0f, 0.0f, 400.0f, 600.0f });
+        grid.SetVisibleRect({ 0.0f, 0.0f, 400.0f, 100.0f });
+        grid.PerformLayout();
+
+        uint64_t i = 0;
+        while (state.KeepRunning())
+        {
+            grid.SetColumn(0, layout::GridTrack::Fixed(50.0f + (i++ % 2) * 10.0f));
+            grid.PerformLayout();
+            DoNotOptimize(cells.front()->GetRect());
+        }
+    }
+
+    // 横向排列count个等宽控件，约束总数约为count的8倍
+    std::unique_ptr<layout::ConstraintLayout> buildChain(size_t count, std::vector<std::shared_ptr<widget::UIButton>>& widgets)
+    {
+        using sz_ds::solver::Expression;
+        auto chain = std::make_unique<layout::ConstraintLayout>();
+        const auto& parent = chain->GetParent();
+        const layout::ConstraintAnchors* first = nullptr;
+        const layout::ConstraintAnchors* prev = nullptr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto button = MakeWidget<widget::UIButton>("BenchChain" + std::to_string(i), layout::AnchorPoint::TopLeft,
+                layout::Margins(0.0f), 0, 20);
+            button->setChildIdForUIManager(i + 1);
+            chain->AddWidget(button);
+            widgets.push_back(button);
+
+            const auto* anchors = chain->GetAnchors(button);
+            chain->AddConstraint(Expression(anchors->m_left) == (prev ? prev->Right() : Expression(parent.m_left)) + 2.0);
+            chain->AddConstraint(Expression(anchors->m_top) == Expression(parent.m_top) + 4.0);
+            if (first)
+            {
+                chain->AddConstraint(Expression(anchors->m_width) == first->m_width);
+            }
+            first = first ? first : anchors;
+            prev = anchors;
+        }
+        chain->AddConstraint(prev->Right() == parent.Right() - 2.0);
+        return chain;
+    }
+
+    // 持续缩放时父容器宽度
+    sz_ds::Rect chainRect(uint64_t i) { return { 0.0f, 0.0f, 1600.0f + (i % 50) * 8.0f, 900.0f }; }
+
+    // 约束布局，1k约束持续缩放，每帧只修改编辑变量增量求解，输出每帧单纯形换基次数
+    SZ_BENCHMARK(ConstraintLayout_Resize1k)
+    {
+        std::vector<std::shared_ptr<widget::UIButton>> widgets;
+        auto chain = buildChain(125, widgets);
+        chain->SetParentRect(chainRect(0));
+        chain->PerformLayout();
+
+        const uint64_t pivots = chain->GetPivotCount();
+        uint64_t i = 1;
+        while (state.KeepRunning())
+        {
+            chain->SetParentRect(chainRect(i++));
+            chain->PerformLayout();
+            DoNotOptimize(widgets.back()->GetRect());
+        }
+        state.SetCounter("constraints", double(chain->GetConstraintCount()));
+        state.SetCounter("pivots/frame", double(chain->GetPivotCount() - pivots) / double(state.GetIterations()));
+    }
+
+    // 约束布局，每帧重建1k约束再求解，和增量求解对比
+    SZ_BENCHMARK(ConstraintLayout_Rebuild1k)
+    {
+        std::vector<std::shared_ptr<widget::UIButton>> widgets;
+        uint64_t i = 1;
+        while (state.KeepRunning())
+        {
+            widgets.clear();
+            auto chain = buildChain(125, widgets);
+            chain->SetParentRect(chainRect(i++));
+            chain->PerformLayout();
+            DoNotOptimize(widgets.back()->GetRect());
+        }
+    }
+
+    // 构建panels个面板，每个面板一半是按钮，一半是嵌套边框里的按钮，共rows行cols列
+    std::vector<std::shared_ptr<IUIBase>> buildPanels(const std::shared_ptr<UIManager>& manager,
+        size_t panels, size_t rows, size_t cols)
+    {
+        std::vector<std::shared_ptr<IUIBase>> widgets;
+        const float panelPct = 100.0f / panels;
+        for (size_t p = 0; p < panels; ++p)
+        {
+            auto panel = MakeWidget<widget::UIFrame>("BenchPanel" + std::to_string(p), layout::AnchorPoint::Fill,
+                layout::Margins::Percentage(p * panelPct, 0.0f, 100.0f - (p + 1) * panelPct, 0.0f), 0, 0);
+            manager->RegTopUI(panel);
+            manager->LayoutAddWidget(panel);
+            panel->SetLayout(new layout::AnchorLayout());
+            widgets.push_back(panel);
+
+            auto inner = MakeWidget<widget::UIFrame>("BenchInner" + std::to_string(p), layout::AnchorPoint::Fill,
+                layout::Margins::Percentage(0.0f, 50.0f, 0.0f, 0.0f), 0, 0);
+            inner->SetParent(panel);
+            panel->AddWidget(inner);
+            inner->SetLayout(new layout::AnchorLayout());
+            widgets.push_back(inner);
+
+            for (size_t r = 0; r < rows; ++r)
+            {
+                for (size_t c = 0; c < cols; ++c)
+                {
+                    auto owner = r % 2 == 0 ? panel : inner;
+                    auto button = MakeWidget<widget::UIButton>("BenchPanelCell" + std::to_string(p) + "_" + std::to_string(r) + "_" + std::to_string(c),
+                        r % 3 == 0 ? layout::AnchorPoint::TopLeft : layout::AnchorPoint::Center,
+                        layout::Margins::Mixed(c * 2.0f, true, r * 0.5f, true, 0.0f, false, 0.0f, false),
+                        10, c % 4 == 0 ? 0 : 8);
+                    button->SetParent(owner);
+                    owner->AddWidget(button);
+                    widgets.push_back(button);
+                }
+            }
+        }
+        return widgets;
+    }
+
+    // 4K窗口持续缩放，8个面板共16000个按钮，workerCount为0时串行
+    void runPanels(BenchmarkState& state, size_t workerCount)
+    {
+        auto manager = std::make_shared<UIManager>(nullptr);
+        manager->SetLayout(new layout::AnchorLayout());
+        if (workerCount > 0)
+        {
+            manager->SetParallelLayout(workerCount, 256);
+        }
+        auto widgets = buildPanels(manager, 8, 40, 50);
+        manager->Init(3840, 2160);
+        manager->RunBeforWork();
+
+        state.SetItemsPerIteration(widgets.size());
+        uint64_t i = 0;
+        while (state.KeepRunning())
+        {
+            const int shrink = int(i++ % 2);
+            manager->Init(3840 - shrink * 40, 2160 - shrink * 20);
+            manager->RunBeforWork();
+            DoNotOptimize(widgets.back()->GetRect());
+        }
+        state.SetCounter("workers", double(workerCount));
+    }
+
+    SZ_BENCHMARK(UIManager_SerialLayout4K)
+    {
+        runPanels(state, 0);
+    }
+
+    // 并行布局，工作线程数取默认值，至少一个
+    SZ_BENCHMARK(UIManager_ParallelLayout4K)
+    {
+        runPanels(state, std::max<size_t>(1, sz_ds::TaskPool::DefaultWorkerCount()));
+    }
+
+    // 文字排版，等宽的合成字形，限定区域内折行
+    SZ_BENCHMARK(TextLayout_Layout)
+    {
+        TextLayout textLayout;
+        textLayout.SetFontMetrics(800.0f, -200.0f, 90.0f, 0.02f);
+        textLayout.SetAtlas(1024, 1024, 1);
+        for (int32_t codepoint = 32; codepoint < 127; ++codepoint)
+        {
+            const float x = float((codepoint - 32) % 32) * 24.0f;
+            const float y = float((codepoint - 32) / 32) * 24.0f;
+            textLayout.AddGlyph(codepoint, TextGlyph{ 0, x, y, x + 12.0f, y + 20.0f, 1.0f, -16.0f, 13.0f });
+        }
+        for (int32_t codepoint = 0x4E00; codepoint < 0x4E00 + 512; ++codepoint)
+        {
+            const float x = float((codepoint - 0x4E00) % 32) * 24.0f;
+            const float y = float((codepoint - 0x4E00) / 32) * 24.0f;
+            textLayout.AddGlyph(codepoint, TextGlyph{ 1, x, y, x + 20.0f, y + 20.0f, 0.0f, -17.0f, 20.0f });
+        }
+
+        auto [ok, codepoints] = sz_string::UTF8Decode("Quick layout 丁七万丈三上下不与丐丑专且 of mixed text 丕世丘丙业丛东丝");
+        std::vector<float> positions;
+        std::vector<float> uvs;
+        std::vector<uint32_t> indices;
+        std::vector<float> layers;
+
+        state.SetItemsPerIteration(codepoints.size());
+        while (state.KeepRunning())
+        {
+            bool laid = textLayout.Layout(TextAlignment::HCenter | TextAlignment::VCenter, 200.0f, 60.0f,
+                codepoints, positions, uvs, indices, layers);
+            DoNotOptimize(laid);
+            DoNotOptimize(positions.data());
+        }
+    }
+
+    // 命中测试，鼠标移动事件在2000个按钮中查找最近的可交互控件
+    SZ_BENCHMARK(UIManager_HitTest2k)
+    {
+        const size_t cols = 50;
+        const size_t rows = 40;
+        auto manager = std::make_shared<UIManager>(nullptr);
+        manager->SetLayout(new layout::AnchorLayout());
+        std::vector<std::shared_ptr<widget::UIButton>> buttons;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t c = 0; c < cols; ++c)
+            {
+                auto button = MakeWidget<widget::UIButton>("BenchHit" + std::to_string(r) + "_" + std::to_string(c),
+                    layout::AnchorPoint::TopLeft, layout::Margins(c * 38.0f, r * 26.0f, 0.0f, 0.0f), 36, 24);
+                manager->RegTopUI(button);
+                manager->LayoutAddWidget(button);
+                buttons.push_back(button);
+            }
+        }
+        manager->Init(1920, 1080);
+        manager->RunBeforWork();
+
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_MOTION;
+        uint32_t step = 0;
+        while (state.KeepRunning())
+        {
+            // 在网格上移动，命中和未命中交替
+            step = step * 1664525u + 1013904223u;
+            event.motion.x = float(step % 1920);
+            event.motion.y = float((step >> 11) % 1080);
+            bool handled = manager->HandleEvent(std::any(&event));
+            DoNotOptimize(handled);
+        }
+    }
+}
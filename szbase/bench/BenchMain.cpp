@@ -0,0 +1,8 @@
+// comment: 微基准入口，参数见sz_test::ParseBenchmarkOptions
+
+#include "../test/Benchmark.h"
+
+int main(int argc, char* argv[])
+{
+    return sz_test::RunBenchmarks(argc, argv);
+}
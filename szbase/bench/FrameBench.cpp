@@ -0,0 +1,427 @@
+// comment: 帧耗时基准，合成场景按脚本输入逐帧渲染，统计布局、收集、提交、GPU耗时、绘制调用、上传字节数、输入延迟和遮挡剔除组件数
+// 默认使用空渲染器，只测CPU侧；定义SZ_FRAMEBENCH_GL时使用隐藏窗口和GLContext，
+// Linux下可以用SDL_VIDEODRIVER=offscreen配合Mesa llvmpipe无窗口运行
+// szframebench --scene=all --counts=1000,10000,50000 --frames=300 --warmup=30 --json=frame.json [--font=xx.ttf] [--overdraw]
+// --overdraw只在GL渲染时有效，统计平均每个像素写入的片元数，回读热度图会拖慢帧耗时
+
+#include "NullRender.h"
+#include "SceneGenerator.h"
+#include "../test/Benchmark.h"
+
+#ifdef SZ_FRAMEBENCH_GL
+#include "../gui/gl/GLContext.h"
+#include <SDL3/SDL.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace sz_test;
+
+    // 60帧每秒的帧预算，单位毫秒
+    constexpr double FRAME_BUDGET_MS = 1000.0 / 60.0;
+    // 窗口大小
+    constexpr int WINDOW_W = 1920;
+    constexpr int WINDOW_H = 1080;
+
+    struct FrameBenchOptions
+    {
+        // 场景
+        std::vector<SceneKind> m_scenes{ SceneKind::Flat, SceneKind::Nested, SceneKind::TextHeavy };
+        // 控件数量
+        std::vector<size_t> m_counts{ 1000, 10000, 50000 };
+        // 统计帧数
+        uint32_t m_frames = 300;
+        // 预热帧数
+        uint32_t m_warmup = 30;
+        // JSON输出文件，"-"输出到标准输出
+        std::string m_jsonPath;
+        // 字体文件，GL渲染时使用
+        std::string m_fontPath;
+        // 过度绘制模式，GL渲染时使用
+        bool m_overdraw = false;
+    };
+
+    // 单项耗时分布
+    struct Distribution
+    {
+        double m_median = 0.0;
+        double m_p95 = 0.0;
+    };
+
+    struct FrameBenchResult
+    {
+        std::string m_scene;
+        size_t m_count = 0;
+        uint32_t m_frames = 0;
+        Distribution m_frame;
+        Distribution m_layout;
+        Distribution m_occlusion;
+        Distribution m_collect;
+        Distribution m_submit;
+        // 没有GPU计时结果时为负数
+        Distribution m_gpu;
+        double m_drawCalls = 0.0;
+        double m_uploadBytes = 0.0;
+        // 平均每个覆盖像素写入的片元数，没有开启过度绘制模式时为负数
+        double m_overdraw = -1.0;
+        // 平均每帧被遮挡剔除的组件数
+        double m_occluded = 0.0;
+        // 输入到呈现的延迟
+        sz_gui::LatencyStats m_latency;
+        bool m_fits60 = false;
+    };
+
+    Distribution distribution(std::vector<double> samples)
+    {
+        Distribution d;
+        if (samples.empty())
+        {
+            d.m_median = d.m_p95 = -1.0;
+            return d;
+        }
+        std::sort(samples.begin(), samples.end());
+        d.m_median = samples[samples.size() / 2];
+        d.m_p95 = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+        return d;
+    }
+
+    std::shared_ptr<sz_gui::IRender> createRender(const FrameBenchOptions& options)
+    {
+#ifdef SZ_FRAMEBENCH_GL
+        static SDL_Window* window = nullptr;
+        if (!window)
+        {
+            if (!SDL_Init(SDL_INIT_VIDEO))
+            {
+                log(LogLevel::FAIL, "sdl init error," + std::string(SDL_GetError()));
+                return nullptr;
+            }
+            sz_gui::gl::GLContext::InitGLAttributes();
+            window = SDL_CreateWindow("szframebench", WINDOW_W, WINDOW_H, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+            if (!window)
+            {
+                log(LogLevel::FAIL, "sdl create window error," + std::string(SDL_GetError()));
+                return nullptr;
+            }
+        }
+        auto render = std::make_shared<sz_gui::gl::GLContext>(window);
+        auto [err, ok] = render->Init(WINDOW_W, WINDOW_H);
+        if (!ok)
+        {
+            log(LogLevel::FAIL, err);
+            return nullptr;
+        }
+        // 启动时着色器构建耗时，命中缓存时只有加载耗时
+        const auto& shaderStats = render->GetShaderBuildStats();
+        char shaderLine[160];
+        std::snprintf(shaderLine, sizeof(shaderLine), "shader compile %.3fms link %.3fms cache load %.3fms hits %u misses %u stale %u",
+            shaderStats.m_compileMs, shaderStats.m_linkMs, shaderStats.m_loadMs,
+            shaderStats.m_cacheHits, shaderStats.m_cacheMisses, shaderStats.m_cacheStale);
+        log(LogLevel::INFO, shaderLine);
+        // 不等待垂直同步
+        SDL_GL_SetSwapInterval(0);
+        render->SetOverdrawMode(options.m_overdraw);
+        if (!options.m_fontPath.empty())
+        {
+            std::tie(err, ok) = render->BuildTrueType(options.m_fontPath);
+            if (!ok)
+            {
+                log(LogLevel::FAIL, err);
+                return nullptr;
+            }
+        }
+        return render;
+#else
+        auto render = std::make_shared<NullRender>();
+        render->BuildTrueType(options.m_fontPath);
+        return render;
+#endif
+    }
+
+    bool runScene(const FrameBenchOptions& options, SceneKind kind, size_t count, FrameBenchResult& result)
+    {
+        auto render = createRender(options);
+        if (!render)
+        {
+            return false;
+        }
+        auto scene = BuildScene(render, kind, count, WINDOW_W, WINDOW_H);
+        EventScript script(WINDOW_W, WINDOW_H);
+#ifdef SZ_FRAMEBENCH_GL
+        scene.m_manager->GetLatencyTracker().SetClock(&SDL_GetTicksNS);
+#endif
+
+        std::vector<double> frameMs, layoutMs, occlusionMs, collectMs, submitMs, gpuMs;
+        frameMs.reserve(options.m_frames);
+        double drawCalls = 0.0;
+        double uploadBytes = 0.0;
+        double fragments = 0.0;
+        double coveredPixels = 0.0;
+        double occluded = 0.0;
+
+        using Clock = std::chrono::steady_clock;
+        const uint64_t total = uint64_t(options.m_warmup) + options.m_frames;
+        for (uint64_t frame = 0; frame < total; ++frame)
+        {
+            auto begin = Clock::now();
+            script.Step(scene, frame);
+            scene.m_manager->Render();
+            auto end = Clock::now();
+            if (frame < options.m_warmup)
+            {
+                if (frame + 1 == options.m_warmup)
+                {
+                    scene.m_manager->GetLatencyTracker().Reset();
+                }
+                continue;
+            }
+
+            const auto& stats = scene.m_manager->GetFrameStats();
+            frameMs.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+            layoutMs.push_back(stats.m_layoutMs);
+            occlusionMs.push_back(stats.m_occlusionMs);
+            collectMs.push_back(stats.m_collectMs);
+            submitMs.push_back(stats.m_submitMs);
+            if (stats.m_gpuMs >= 0.0)
+            {
+                gpuMs.push_back(stats.m_gpuMs);
+            }
+            drawCalls += double(stats.m_drawCalls);
+            uploadBytes += double(stats.m_uploadBytes);
+            fragments += double(stats.m_fragments);
+            coveredPixels += double(stats.m_coveredPixels);
+            occluded += double(stats.m_occludedWidgets);
+        }
+
+        result.m_scene = SceneKindName(kind);
+        result.m_count = count;
+        result.m_frames = options.m_frames;
+        result.m_frame = distribution(std::move(frameMs));
+        result.m_layout = distribution(std::move(layoutMs));
+        result.m_occlusion = distribution(std::move(occlusionMs));
+        result.m_collect = distribution(std::move(collectMs));
+        result.m_submit = distribution(std::move(submitMs));
+        result.m_gpu = distribution(std::move(gpuMs));
+        result.m_drawCalls = drawCalls / options.m_frames;
+        result.m_uploadBytes = uploadBytes / options.m_frames;
+        result.m_occluded = occluded / options.m_frames;
+        if (coveredPixels > 0.0)
+        {
+            result.m_overdraw = fragments / coveredPixels;
+        }
+        result.m_latency = scene.m_manager->GetLatencyTracker().GetStats();
+        // CPU和GPU并行，取两者较大的p95和帧预算比较
+        result.m_fits60 = std::max(result.m_frame.m_p95, result.m_gpu.m_p95) <= FRAME_BUDGET_MS;
+        return true;
+    }
+
+    std::string formatMs(const Distribution& d)
+    {
+        if (d.m_median < 0.0)
+        {
+            return "n/a";
+        }
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.3f/%.3f", d.m_median, d.m_p95);
+        return buffer;
+    }
+
+    void printResult(const FrameBenchResult& r)
+    {
+        char line[512];
+        snprintf(line, sizeof(line), "%-7s %6zu  frame %-17s layout %-17s occlusion %-17s collect %-17s submit %-17s gpu %-17s "
+            "draws %9.1f  upload %10.1fKB  latency %.3f/%.3f/%.3f  %s",
+            r.m_scene.c_str(), r.m_count, formatMs(r.m_frame).c_str(), formatMs(r.m_layout).c_str(),
+            formatMs(r.m_occlusion).c_str(), formatMs(r.m_collect).c_str(), formatMs(r.m_submit).c_str(),
+            formatMs(r.m_gpu).c_str(),
+            r.m_drawCalls, r.m_uploadBytes / 1024.0, r.m_latency.m_medianMs, r.m_latency.m_p95Ms,
+            r.m_latency.m_p99Ms, r.m_fits60 ? "60fps" : "over budget");
+        std::cout << line;
+        if (r.m_overdraw >= 0.0)
+        {
+            snprintf(line, sizeof(line), "  overdraw %.2f", r.m_overdraw);
+            std::cout << line;
+        }
+        if (r.m_occluded > 0.0)
+        {
+            snprintf(line, sizeof(line), "  occluded %.1f", r.m_occluded);
+            std::cout << line;
+        }
+        std::cout << "\n";
+    }
+
+    void writeDistribution(std::ostream& os, const char* name, const Distribution& d)
+    {
+        os << "\"" << name << "\": {\"median\": " << d.m_median << ", \"p95\": " << d.m_p95 << "}, ";
+    }
+
+    void writeJson(std::ostream& os, const std::vector<FrameBenchResult>& results, const FrameBenchOptions& options)
+    {
+        os << "{\n  \"unit\": \"ms\",\n";
+        os << "  \"frames\": " << options.m_frames << ",\n";
+        os << "  \"warmup\": " << options.m_warmup << ",\n";
+        os << "  \"budget\": " << FRAME_BUDGET_MS << ",\n";
+        os << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            os << "    {\"scene\": \"" << JsonEscape(r.m_scene) << "\", \"count\": " << r.m_count << ", ";
+            writeDistribution(os, "frame", r.m_frame);
+            writeDistribution(os, "layout", r.m_layout);
+            writeDistribution(os, "occlusion", r.m_occlusion);
+            writeDistribution(os, "collect", r.m_collect);
+            writeDistribution(os, "submit", r.m_submit);
+            writeDistribution(os, "gpu", r.m_gpu);
+            os << "\"latency\": {\"inputs\": " << r.m_latency.m_count << ", \"median\": " << r.m_latency.m_medianMs
+                << ", \"p95\": " << r.m_latency.m_p95Ms << ", \"p99\": " << r.m_latency.m_p99Ms
+                << ", \"max\": " << r.m_latency.m_maxMs << ", \"queue_median\": " << r.m_latency.m_queueMedianMs
+                << ", \"wait_median\": " << r.m_latency.m_waitMedianMs
+                << ", \"frame_median\": " << r.m_latency.m_frameMedianMs << "}, ";
+            os << "\"draw_calls\": " << r.m_drawCalls << ", \"upload_bytes\": " << r.m_uploadBytes
+                << ", \"overdraw\": " << r.m_overdraw << ", \"occluded\": " << r.m_occluded << ", \"fits_60fps\": " << (r.m_fits60 ? "true" : "false") << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+    // 解析逗号分隔的数量列表
+    std::vector<size_t> parseCounts(const char* text)
+    {
+        std::vector<size_t> counts;
+        while (*text)
+        {
+            char* end = nullptr;
+            const unsigned long long value = strtoull(text, &end, 10);
+            if (end == text)
+            {
+                break;
+            }
+            if (value > 0)
+            {
+                counts.push_back(size_t(value));
+            }
+            text = *end == ',' ? end + 1 : end;
+        }
+        return counts;
+    }
+
+    bool parseOptions(int argc, char* argv[], FrameBenchOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&arg](const char* key) -> const char* {
+                const size_t length = strlen(key);
+                return arg.compare(0, length, key) == 0 ? arg.c_str() + length : nullptr;
+            };
+            if (auto v = value("--scene="))
+            {
+                const std::string scene = v;
+                if (scene == "flat")
+                {
+                    options.m_scenes = { SceneKind::Flat };
+                }
+                else if (scene == "nested")
+                {
+                    options.m_scenes = { SceneKind::Nested };
+                }
+                else if (scene == "text")
+                {
+                    options.m_scenes = { SceneKind::TextHeavy };
+                }
+                else if (scene != "all")
+                {
+                    log(LogLevel::FAIL, "unknown scene: " + scene);
+                    return false;
+                }
+            }
+            else if (auto v = value("--counts="))
+            {
+                options.m_counts = parseCounts(v);
+            }
+            else if (auto v = value("--frames="))
+            {
+                options.m_frames = uint32_t(std::max(1, atoi(v)));
+            }
+            else if (auto v = value("--warmup="))
+            {
+                options.m_warmup = uint32_t(std::max(0, atoi(v)));
+            }
+            else if (auto v = value("--font="))
+            {
+                options.m_fontPath = v;
+            }
+            else if (arg == "--json")
+            {
+                options.m_jsonPath = "-";
+            }
+            else if (auto v = value("--json="))
+            {
+                options.m_jsonPath = v;
+            }
+            else if (arg == "--overdraw")
+            {
+                options.m_overdraw = true;
+            }
+            else
+            {
+                log(LogLevel::FAIL, "unknown argument: " + arg);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    FrameBenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    std::vector<FrameBenchResult> results;
+    for (auto kind : options.m_scenes)
+    {
+        for (auto count : options.m_counts)
+        {
+            FrameBenchResult result;
+            if (!runScene(options, kind, count, result))
+            {
+                return 1;
+            }
+            if (options.m_jsonPath != "-")
+            {
+                printResult(result);
+            }
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (options.m_jsonPath == "-")
+    {
+        writeJson(std::cout, results, options);
+    }
+    else if (!options.m_jsonPath.empty())
+    {
+        std::ofstream file(options.m_jsonPath);
+        if (!file)
+        {
+            log(LogLevel::FAIL, "open json file failed: " + options.m_jsonPath);
+            return 1;
+        }
+        writeJson(file, results, options);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// comment: 空渲染器，不调用图形接口，按GLContext的规则统计绘制调用和上传字节数，文字使用合成的等宽字形排版
+
+#pragma once
+
+#include "../gui/IRender.h"
+#include "../gui/TextLayout.h"
+
+#include <chrono>
+#include <unordered_map>
+
+namespace sz_test
+{
+    class NullRender final : public sz_gui::IRender
+    {
+    public:
+        NullRender() = default;
+
+    public:
+        std::tuple<std::string, bool> Init(int, int) override { return { "success", true }; }
+        // 不读取字体文件，生成ASCII和CJK的合成字形
+        std::tuple<std::string, bool> BuildTrueType(const std::string&) override
+        {
+            m_textLayout.SetFontMetrics(880.0f, -120.0f, 0.0f, 32.0f / 1000.0f);
+            m_textLayout.SetAtlas(4096, 4096, 2);
+            for (int32_t codepoint = 0x20; codepoint < 0x7F; ++codepoint)
+            {
+                const float x = float((codepoint - 0x20) % 128) * 32.0f;
+                m_textLayout.AddGlyph(codepoint, sz_gui::TextGlyph{ 0, x, 0.0f, x + 16.0f, 28.0f, 1.0f, -24.0f, 17.0f });
+            }
+            for (int32_t codepoint = 0x4E00; codepoint <= 0x9FA5; ++codepoint)
+            {
+                const int32_t index = codepoint - 0x4E00;
+                const float x = float(index % 128) * 32.0f;
+                const float y = float(index / 128 % 128) * 32.0f;
+                m_textLayout.AddGlyph(codepoint, sz_gui::TextGlyph{ 1 + index / 16384, x, y, x + 30.0f, y + 30.0f,
+                    1.0f, -26.0f, 32.0f });
+            }
+            return { "success", true };
+        }
+        bool DrawTextToBuffer(const sz_gui::TextAlignment ta, const float limitWidth, const float limitHeight,
+            const std::vector<int32_t>& codepoints, std::vector<float>& positions, std::vector<float>& uvs,
+            std::vector<uint32_t>& indices, std::vector<float>& layers) override
+        {
+            return m_textLayout.Layout(ta, limitWidth, limitHeight, codepoints, positions, uvs, indices, layers);
+        }
+        void AppendDrawData(const std::vector<float>& positions, const std::vector<float>& colorOrUVs,
+            const std::vector<uint32_t>& indices, sz_gui::DrawCommand cmd) override
+        {
+            ++m_frameStats.m_drawCalls;
+            m_frameStats.m_uploadBytes += sz_gui::GetUploadBytes(cmd, positions, colorOrUVs, indices, nullptr);
+        }
+        void AppendTextDrawData(const std::vector<float>& positions, const std::vector<float>& uvs,
+            const std::vector<uint32_t>& indices, const std::vector<float>& layers, sz_gui::DrawCommand cmd) override
+        {
+            ++m_frameStats.m_drawCalls;
+            m_frameStats.m_uploadBytes += sz_gui::GetUploadBytes(cmd, positions, uvs, indices, &layers);
+        }
+        // 不读取图片文件，同一路径返回同一个id
+        uint32_t LoadImageFile(const std::string& path) override
+        {
+            auto it = m_imageIds.emplace(path, uint32_t(m_imageIds.size() + 1)).first;
+            return it->second;
+        }
+        void Render() override
+        {
+            m_frameStats.m_frameIndex = m_frameIndex++;
+            m_lastFrameStats = m_frameStats;
+            m_frameStats = sz_gui::FrameStats{};
+        }
+        void OnWindowResize(int, int) override {}
+        void SetColorTheme(sz_gui::ColorTheme) override {}
+        void ReserveDrawData(size_t) override {}
+        sz_gui::RenderPoolStats GetPoolStats() const override { return {}; }
+        const sz_gui::FrameStats& GetFrameStats() const override { return m_lastFrameStats; }
+        bool HasPendingWork() const override { return false; }
+
+    private:
+        // 文字排版
+        sz_gui::TextLayout m_textLayout;
+        // 当前帧统计
+        sz_gui::FrameStats m_frameStats;
+        // 上一帧统计
+        sz_gui::FrameStats m_lastFrameStats;
+        // 帧序号
+        uint64_t m_frameIndex = 1;
+        // 图片路径->id
+        std::unordered_map<std::string, uint32_t> m_imageIds;
+    };
+}
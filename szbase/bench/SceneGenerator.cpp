@@ -0,0 +1,218 @@
+#include "SceneGenerator.h"
+#include "../gui/WidgetFactory.h"
+#include "../gui/layout/AnchorLayout.h"
+#include "../gui/widget/UIButton.h"
+#include "../gui/widget/UIFrame.h"
+
+#include <SDL3/SDL.h>
+
+#include <any>
+
+namespace sz_test
+{
+    using namespace sz_gui;
+
+    namespace
+    {
+        // 平铺网格
+        constexpr size_t FLAT_COLUMNS = 40;
+        constexpr float FLAT_CELL_W = 48.0f;
+        constexpr float FLAT_CELL_H = 20.0f;
+        // 嵌套链深度
+        constexpr size_t NESTED_DEPTH = 8;
+        constexpr size_t NESTED_COLUMNS = 12;
+        // 长文本网格
+        constexpr size_t TEXT_COLUMNS = 8;
+        constexpr float TEXT_CELL_W = 240.0f;
+        constexpr float TEXT_CELL_H = 32.0f;
+
+        // 中英文混合标签
+        const char* TEXT_LABELS[] = {
+            "Settings 设置 Options",
+            "打开文件 Open file...",
+            "Network status 网络状态 online",
+            "保存并退出 Save & Quit",
+            "The quick brown fox 敏捷的棕色狐狸",
+            "下载进度 Download 42%",
+        };
+
+        std::shared_ptr<widget::UIButton> makeButton(const std::string& name, float x, float y,
+            uint32_t w, uint32_t h)
+        {
+            return MakeWidget<widget::UIButton>(name, layout::AnchorPoint::TopLeft,
+                layout::Margins(x, y, 0.0f, 0.0f), w, h);
+        }
+
+        void buildFlat(Scene& scene, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float x = float(i % FLAT_COLUMNS) * FLAT_CELL_W;
+                const float y = float(i / FLAT_COLUMNS) * FLAT_CELL_H;
+                auto button = makeButton("Flat" + std::to_string(i), x, y,
+                    uint32_t(FLAT_CELL_W) - 2, uint32_t(FLAT_CELL_H) - 2);
+                button->SetText(std::to_string(i));
+                scene.m_manager->RegTopUI(button);
+                scene.m_manager->LayoutAddWidget(button);
+                scene.m_widgets.push_back(button);
+            }
+        }
+
+        void buildNested(Scene& scene, size_t count)
+        {
+            // 每条链NESTED_DEPTH层，每层一个边框控件和一个按钮
+            size_t built = 0;
+            for (size_t chain = 0; built < count; ++chain)
+            {
+                const float x = float(chain % NESTED_COLUMNS) * 160.0f;
+                const float y = float(chain / NESTED_COLUMNS) * 160.0f;
+                std::shared_ptr<widget::UIFrame> parent;
+                for (size_t depth = 0; depth < NESTED_DEPTH && built < count; ++depth)
+                {
+                    const std::string suffix = std::to_string(chain) + "_" + std::to_string(depth);
+                    const uint32_t size = uint32_t(156 - depth * 16);
+                    auto frame = MakeWidget<widget::UIFrame>("NestedFrame" + suffix, layout::AnchorPoint::TopLeft,
+                        parent ? layout::Margins(8.0f, 8.0f, 0.0f, 0.0f) : layout::Margins(x, y, 0.0f, 0.0f),
+                        size, size);
+                    frame->SetLayout(new layout::AnchorLayout());
+                    if (parent)
+                    {
+                        frame->SetParent(parent);
+                        parent->AddWidget(frame);
+                    }
+                    else
+                    {
+                        scene.m_manager->RegTopUI(frame);
+                        scene.m_manager->LayoutAddWidget(frame);
+                    }
+                    scene.m_widgets.push_back(frame);
+                    ++built;
+
+                    if (built < count)
+                    {
+                        auto button = makeButton("NestedButton" + suffix, float(size) - 40.0f, 2.0f, 36, 14);
+                        button->SetParent(frame);
+                        frame->AddWidget(button);
+                        scene.m_widgets.push_back(button);
+                        ++built;
+                    }
+                    parent = frame;
+                }
+            }
+        }
+
+        void buildTextHeavy(Scene& scene, size_t count)
+        {
+            const size_t labelCount = sizeof(TEXT_LABELS) / sizeof(TEXT_LABELS[0]);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float x = float(i % TEXT_COLUMNS) * TEXT_CELL_W;
+                const float y = float(i / TEXT_COLUMNS) * TEXT_CELL_H;
+                auto button = makeButton("Text" + std::to_string(i), x, y,
+                    uint32_t(TEXT_CELL_W) - 4, uint32_t(TEXT_CELL_H) - 4);
+                button->SetText(TEXT_LABELS[i % labelCount]);
+                scene.m_manager->RegTopUI(button);
+                scene.m_manager->LayoutAddWidget(button);
+                scene.m_widgets.push_back(button);
+            }
+        }
+    }
+
+    const char* SceneKindName(SceneKind kind)
+    {
+        switch (kind)
+        {
+        case SceneKind::Flat:
+            return "flat";
+        case SceneKind::Nested:
+            return "nested";
+        case SceneKind::TextHeavy:
+            return "text";
+        }
+        return "unknown";
+    }
+
+    Scene BuildScene(std::shared_ptr<IRender> render, SceneKind kind, size_t count, int width, int height)
+    {
+        Scene scene;
+        scene.m_width = width;
+        scene.m_height = height;
+        scene.m_manager = std::make_shared<UIManager>(render);
+        scene.m_manager->SetLayout(new layout::AnchorLayout());
+        scene.m_widgets.reserve(count);
+
+        switch (kind)
+        {
+        case SceneKind::Flat:
+            buildFlat(scene, count);
+            break;
+        case SceneKind::Nested:
+            buildNested(scene, count);
+            break;
+        case SceneKind::TextHeavy:
+            buildTextHeavy(scene, count);
+            break;
+        }
+
+        scene.m_manager->Init(width, height);
+        scene.m_manager->RunBeforWork();
+        return scene;
+    }
+
+    EventScript::EventScript(int width, int height, uint32_t seed) :
+        m_width(width), m_height(height), m_random(seed)
+    {
+    }
+
+    void EventScript::Step(Scene& scene, uint64_t frame)
+    {
+        SDL_Event event{};
+        auto& manager = *scene.m_manager;
+        // 事件在投递时产生，延迟包括处理、布局、收集和提交
+        const uint64_t timestamp = manager.GetLatencyTracker().Now();
+
+        // 悬停，每帧移动到一个伪随机位置
+        m_random = m_random * 1664525u + 1013904223u;
+        const float x = float(m_random % uint32_t(scene.m_width));
+        const float y = float((m_random >> 12) % uint32_t(scene.m_height));
+        event.type = SDL_EVENT_MOUSE_MOTION;
+        event.common.timestamp = timestamp;
+        event.motion.x = x;
+        event.motion.y = y;
+        manager.HandleEvent(std::any(&event));
+
+        // 点击
+        if (m_clickInterval && frame % m_clickInterval == 0)
+        {
+            event = SDL_Event{};
+            event.type = SDL_EVENT_MOUSE_BUTTON_DOWN;
+            event.common.timestamp = timestamp;
+            event.button.button = SDL_BUTTON_LEFT;
+            event.button.down = true;
+            event.button.x = x;
+            event.button.y = y;
+            manager.HandleEvent(std::any(&event));
+            event.type = SDL_EVENT_MOUSE_BUTTON_UP;
+            event.button.down = false;
+            manager.HandleEvent(std::any(&event));
+        }
+
+        // 改变窗口大小，在初始大小和四分之三之间切换
+        if (m_resizeInterval && frame % m_resizeInterval == m_resizeInterval - 1)
+        {
+            m_shrunk = !m_shrunk;
+            scene.m_width = m_shrunk ? m_width * 3 / 4 : m_width;
+            scene.m_height = m_shrunk ? m_height * 3 / 4 : m_height;
+            event = SDL_Event{};
+            event.type = SDL_EVENT_WINDOW_RESIZED;
+            event.common.timestamp = timestamp;
+            event.window.data1 = scene.m_width;
+            event.window.data2 = scene.m_height;
+            manager.HandleEvent(std::any(&event));
+            if (auto& render = manager.GetRender())
+            {
+                render->OnWindowResize(scene.m_width, scene.m_height);
+            }
+        }
+    }
+}
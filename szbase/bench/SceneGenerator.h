@@ -0,0 +1,71 @@
+// comment: 合成场景生成和确定性的输入脚本，用于帧耗时基准
+
+#pragma once
+
+#include "../gui/IRender.h"
+#include "../gui/UIManager.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sz_test
+{
+    // 场景类型
+    enum class SceneKind
+    {
+        // 平铺网格，所有按钮都是顶层UI
+        Flat,
+        // 边框控件嵌套成链，每层一个按钮
+        Nested,
+        // 长文本按钮，中英文混合
+        TextHeavy,
+    };
+
+    // 场景类型名字
+    const char* SceneKindName(SceneKind kind);
+
+    // 合成场景
+    struct Scene
+    {
+        // UI管理器
+        std::shared_ptr<sz_gui::UIManager> m_manager;
+        // 所有控件，保持所有权
+        std::vector<std::shared_ptr<sz_gui::IUIBase>> m_widgets;
+        // 窗口宽
+        int m_width = 0;
+        // 窗口高
+        int m_height = 0;
+    };
+
+    // 生成count个控件(边框控件和按钮都计数)的场景，控件超出窗口时仍然参与布局和收集
+    Scene BuildScene(std::shared_ptr<sz_gui::IRender> render, SceneKind kind, size_t count, int width, int height);
+
+    // 输入脚本，每帧移动鼠标，每隔m_clickInterval帧点击一次，每隔m_resizeInterval帧改变一次窗口大小
+    class EventScript
+    {
+    public:
+        EventScript(int width, int height, uint32_t seed = 1);
+
+    public:
+        // 向场景投递第frame帧的事件
+        void Step(Scene& scene, uint64_t frame);
+
+    public:
+        // 点击间隔
+        uint64_t m_clickInterval = 30;
+        // 改变窗口大小间隔
+        uint64_t m_resizeInterval = 120;
+
+    private:
+        // 初始窗口宽
+        int m_width;
+        // 初始窗口高
+        int m_height;
+        // 当前是否缩小
+        bool m_shrunk = false;
+        // 随机数状态
+        uint32_t m_random;
+    };
+}
@@ -0,0 +1,892 @@
+// comment: 增量线性约束求解器，Cassowary算法，单纯形表常驻，增删约束和修改编辑变量都从上次的解继续优化
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sz_ds
+{
+    namespace solver
+    {
+        // 约束强度，非必须约束按强度加权最小化误差
+        namespace Strength
+        {
+            // 必须满足
+            constexpr double Required = 1001001000.0;
+            // 强
+            constexpr double Strong = 1000000.0;
+            // 中
+            constexpr double Medium = 1000.0;
+            // 弱
+            constexpr double Weak = 1.0;
+        }
+
+        // 变量，求解器内的编号，0表示无效
+        struct Variable
+        {
+            uint32_t m_id = 0;
+
+            // 是否有效
+            bool IsValid() const { return m_id != 0; }
+        };
+
+        // 线性项
+        struct Term
+        {
+            // 变量
+            Variable m_variable;
+            // 系数
+            double m_coefficient = 1.0;
+        };
+
+        // 线性表达式
+        struct Expression
+        {
+            // 线性项，同一变量可以出现多次
+            std::vector<Term> m_terms;
+            // 常量
+            double m_constant = 0.0;
+
+            Expression() = default;
+            Expression(double constant) : m_constant(constant) {}
+            Expression(Variable variable) : m_terms{ Term{ variable, 1.0 } } {}
+        };
+
+        inline Expression operator+(Expression lhs, const Expression& rhs)
+        {
+            lhs.m_terms.insert(lhs.m_terms.end(), rhs.m_terms.begin(), rhs.m_terms.end());
+            lhs.m_constant += rhs.m_constant;
+            return lhs;
+        }
+        inline Expression operator*(Expression lhs, double coefficient)
+        {
+            for (auto& term : lhs.m_terms)
+            {
+                term.m_coefficient *= coefficient;
+            }
+            lhs.m_constant *= coefficient;
+            return lhs;
+        }
+        inline Expression operator*(double coefficient, Expression rhs)
+        {
+            return std::move(rhs) * coefficient;
+        }
+        inline Expression operator/(Expression lhs, double denominator)
+        {
+            return std::move(lhs) * (1.0 / denominator);
+        }
+        inline Expression operator-(Expression expression)
+        {
+            return std::move(expression) * -1.0;
+        }
+        inline Expression operator-(Expression lhs, const Expression& rhs)
+        {
+            return std::move(lhs) + (-rhs);
+        }
+
+        // 关系
+        enum class Relation
+        {
+            LessEqual,
+            Equal,
+            GreaterEqual,
+        };
+
+        // 约束，表示 m_expression 关系 0
+        struct Constraint
+        {
+            // 左边减右边
+            Expression m_expression;
+            // 关系
+            Relation m_relation = Relation::Equal;
+            // 强度
+            double m_strength = Strength::Required;
+        };
+
+        inline Constraint operator==(const Expression& lhs, const Expression& rhs)
+        {
+            return { lhs - rhs, Relation::Equal, Strength::Required };
+        }
+        inline Constraint operator<=(const Expression& lhs, const Expression& rhs)
+        {
+            return { lhs - rhs, Relation::LessEqual, Strength::Required };
+        }
+        inline Constraint operator>=(const Expression& lhs, const Expression& rhs)
+        {
+            return { lhs - rhs, Relation::GreaterEqual, Strength::Required };
+        }
+        // 修改约束强度，例如 (a == b) | Strength::Weak
+        inline Constraint operator|(Constraint constraint, double strength)
+        {
+            constraint.m_strength = std::clamp(strength, 0.0, Strength::Required);
+            return constraint;
+        }
+
+        // 约束编号，0表示无效
+        using ConstraintId = uint64_t;
+
+        // 求解器，单线程使用
+        class Solver
+        {
+        private:
+            // 符号类型
+            enum class SymbolType : uint8_t
+            {
+                Invalid,
+                // 外部变量
+                External,
+                // 不等式松弛变量
+                Slack,
+                // 非必须约束误差变量
+                Error,
+                // 必须等式占位变量，不参与主元选择
+                Dummy,
+            };
+
+            // 单纯形表符号
+            struct Symbol
+            {
+                uint64_t m_id = 0;
+                SymbolType m_type = SymbolType::Invalid;
+
+                bool IsValid() const { return m_type != SymbolType::Invalid; }
+                bool operator<(const Symbol& other) const { return m_id < other.m_id; }
+            };
+
+            // 单纯形表行，基变量 = m_constant + sum(系数 * 符号)
+            struct Row
+            {
+                // 按符号编号有序，保证选主元结果确定
+                std::map<Symbol, double> m_cells;
+                double m_constant = 0.0;
+
+                // 常量加上value，返回新常量
+                double Add(double value)
+                {
+                    m_constant += value;
+                    return m_constant;
+                }
+                // 累加符号系数，系数接近0时移除
+                void Insert(const Symbol& symbol, double coefficient = 1.0)
+                {
+                    auto it = m_cells.try_emplace(symbol, 0.0).first;
+                    it->second += coefficient;
+                    if (nearZero(it->second))
+                    {
+                        m_cells.erase(it);
+                    }
+                }
+                // 累加另一行乘以系数
+                void Insert(const Row& other, double coefficient = 1.0)
+                {
+                    m_constant += other.m_constant * coefficient;
+                    for (const auto& [symbol, value] : other.m_cells)
+                    {
+                        Insert(symbol, value * coefficient);
+                    }
+                }
+                // 移除符号
+                void Remove(const Symbol& symbol)
+                {
+                    m_cells.erase(symbol);
+                }
+                // 取反
+                void ReverseSign()
+                {
+                    m_constant = -m_constant;
+                    for (auto& cell : m_cells)
+                    {
+                        cell.second = -cell.second;
+                    }
+                }
+                // 把 0 = 本行 变形为 symbol = 本行
+                void SolveFor(const Symbol& symbol)
+                {
+                    auto it = m_cells.find(symbol);
+                    assert(it != m_cells.end());
+                    const double coefficient = -1.0 / it->second;
+                    m_cells.erase(it);
+                    m_constant *= coefficient;
+                    for (auto& cell : m_cells)
+                    {
+                        cell.second *= coefficient;
+                    }
+                }
+                // 把 lhs = 本行 变形为 rhs = 本行
+                void SolveFor(const Symbol& lhs, const Symbol& rhs)
+                {
+                    Insert(lhs, -1.0);
+                    SolveFor(rhs);
+                }
+                // 获取符号系数
+                double CoefficientFor(const Symbol& symbol) const
+                {
+                    auto it = m_cells.find(symbol);
+                    return it == m_cells.end() ? 0.0 : it->second;
+                }
+                // 用 symbol = row 替换本行中的symbol
+                void Substitute(const Symbol& symbol, const Row& row)
+                {
+                    auto it = m_cells.find(symbol);
+                    if (it == m_cells.end())
+                    {
+                        return;
+                    }
+                    const double coefficient = it->second;
+                    m_cells.erase(it);
+                    Insert(row, coefficient);
+                }
+            };
+
+            // 约束对应的标记符号，删除约束时用来定位
+            struct Tag
+            {
+                Symbol m_marker;
+                Symbol m_other;
+            };
+
+            // 约束记录
+            struct ConstraintRecord
+            {
+                Tag m_tag;
+                double m_strength = Strength::Required;
+            };
+
+            // 编辑变量记录
+            struct EditInfo
+            {
+                ConstraintId m_constraint = 0;
+                Tag m_tag;
+                // 当前建议值
+                double m_constant = 0.0;
+            };
+
+        private:
+            // 变量的值
+            std::vector<double> m_values;
+            // 变量的外部符号，懒创建
+            std::vector<Symbol> m_variableSymbols;
+            // 单纯形表，基变量到行
+            std::map<Symbol, Row> m_rows;
+            // 约束
+            std::unordered_map<ConstraintId, ConstraintRecord> m_constraints;
+            // 编辑变量，变量编号到记录
+            std::unordered_map<uint32_t, EditInfo> m_edits;
+            // 对偶优化待处理的不可行行
+            std::vector<Symbol> m_infeasibleRows;
+            // 目标函数
+            Row m_objective;
+            // 人工变量目标函数，只在添加约束时存在
+            std::unique_ptr<Row> m_artificial;
+            // 符号编号
+            uint64_t m_symbolTick = 0;
+            // 约束编号
+            ConstraintId m_constraintTick = 0;
+            // 主元变换次数
+            uint64_t m_pivotCount = 0;
+
+        public:
+            Solver() = default;
+            ~Solver() = default;
+
+            Solver(const Solver&) = delete;
+            Solver& operator=(const Solver&) = delete;
+
+        public:
+            // 新建变量
+            Variable NewVariable()
+            {
+                m_values.push_back(0.0);
+                m_variableSymbols.emplace_back();
+                return Variable{ (uint32_t)m_values.size() };
+            }
+            // 获取变量的值，需要先UpdateVariables
+            double GetValue(Variable variable) const
+            {
+                assert(variable.IsValid() && variable.m_id <= m_values.size());
+                return m_values[variable.m_id - 1];
+            }
+            // 添加约束，必须约束无法满足时返回0，求解器状态不变
+            ConstraintId AddConstraint(const Constraint& constraint)
+            {
+                Tag tag;
+                Row row = createRow(constraint, tag);
+                Symbol subject = chooseSubject(row, tag);
+
+                // 只含占位变量的行，常量为0表示约束冗余，否则冲突
+                if (!subject.IsValid() && allDummies(row))
+                {
+                    if (!nearZero(row.m_constant))
+                    {
+                        return 0;
+                    }
+                    subject = tag.m_marker;
+                }
+
+                const ConstraintId id = ++m_constraintTick;
+                m_constraints.emplace(id, ConstraintRecord{ tag, constraint.m_strength });
+                if (!subject.IsValid())
+                {
+                    if (!addWithArtificialVariable(row))
+                    {
+                        RemoveConstraint(id);
+                        return 0;
+                    }
+                }
+                else
+                {
+                    row.SolveFor(subject);
+                    substitute(subject, row);
+                    m_rows[subject] = std::move(row);
+                }
+
+                optimize(m_objective);
+                return id;
+            }
+            // 删除约束
+            bool RemoveConstraint(ConstraintId id)
+            {
+                auto record = m_constraints.find(id);
+                if (record == m_constraints.end())
+                {
+                    return false;
+                }
+
+                const Tag tag = record->second.m_tag;
+                const double strength = record->second.m_strength;
+                m_constraints.erase(record);
+
+                // 先从目标函数中移除误差项
+                if (tag.m_marker.m_type == SymbolType::Error)
+                {
+                    removeMarkerEffects(tag.m_marker, strength);
+                }
+                if (tag.m_other.m_type == SymbolType::Error)
+                {
+                    removeMarkerEffects(tag.m_other, strength);
+                }
+
+                // 标记符号是基变量时直接删除该行，否则先把它换入基
+                auto rowIt = m_rows.find(tag.m_marker);
+                if (rowIt != m_rows.end())
+                {
+                    m_rows.erase(rowIt);
+                }
+                else
+                {
+                    rowIt = getMarkerLeavingRow(tag.m_marker);
+                    if (rowIt != m_rows.end())
+                    {
+                        const Symbol leaving = rowIt->first;
+                        Row row = std::move(rowIt->second);
+                        m_rows.erase(rowIt);
+                        row.SolveFor(leaving, tag.m_marker);
+                        substitute(tag.m_marker, row);
+                        ++m_pivotCount;
+                    }
+                }
+
+                optimize(m_objective);
+                return true;
+            }
+            // 是否存在约束
+            bool HasConstraint(ConstraintId id) const
+            {
+                return m_constraints.find(id) != m_constraints.end();
+            }
+            // 添加编辑变量，强度不能是必须
+            bool AddEditVariable(Variable variable, double strength)
+            {
+                if (!variable.IsValid() || m_edits.find(variable.m_id) != m_edits.end())
+                {
+                    return false;
+                }
+                if (strength >= Strength::Required)
+                {
+                    return false;
+                }
+
+                Constraint constraint{ Expression(variable), Relation::Equal, std::max(0.0, strength) };
+                const ConstraintId id = AddConstraint(constraint);
+                if (id == 0)
+                {
+                    return false;
+                }
+                m_edits.emplace(variable.m_id, EditInfo{ id, m_constraints[id].m_tag, 0.0 });
+                return true;
+            }
+            // 删除编辑变量
+            bool RemoveEditVariable(Variable variable)
+            {
+                auto it = m_edits.find(variable.m_id);
+                if (it == m_edits.end())
+                {
+                    return false;
+                }
+                RemoveConstraint(it->second.m_constraint);
+                m_edits.erase(it);
+                return true;
+            }
+            // 是否是编辑变量
+            bool HasEditVariable(Variable variable) const
+            {
+                return m_edits.find(variable.m_id) != m_edits.end();
+            }
+            // 修改编辑变量的建议值，只调整受影响行的常量再对偶优化
+            bool SuggestValue(Variable variable, double value)
+            {
+                auto it = m_edits.find(variable.m_id);
+                if (it == m_edits.end())
+                {
+                    return false;
+                }
+
+                auto& info = it->second;
+                const double delta = value - info.m_constant;
+                if (delta == 0.0)
+                {
+                    return true;
+                }
+                info.m_constant = value;
+
+                // 正误差变量是基变量
+                auto rowIt = m_rows.find(info.m_tag.m_marker);
+                if (rowIt != m_rows.end())
+                {
+                    if (rowIt->second.Add(-delta) < 0.0)
+                    {
+                        m_infeasibleRows.push_back(rowIt->first);
+                    }
+                    dualOptimize();
+                    return true;
+                }
+
+                // 负误差变量是基变量
+                rowIt = m_rows.find(info.m_tag.m_other);
+                if (rowIt != m_rows.end())
+                {
+                    if (rowIt->second.Add(delta) < 0.0)
+                    {
+                        m_infeasibleRows.push_back(rowIt->first);
+                    }
+                    dualOptimize();
+                    return true;
+                }
+
+                // 都不是基变量，更新所有含正误差变量的行
+                for (auto& [symbol, row] : m_rows)
+                {
+                    const double coefficient = row.CoefficientFor(info.m_tag.m_marker);
+                    if (coefficient != 0.0 && row.Add(delta * coefficient) < 0.0 &&
+                        symbol.m_type != SymbolType::External)
+                    {
+                        m_infeasibleRows.push_back(symbol);
+                    }
+                }
+                dualOptimize();
+                return true;
+            }
+            // 把解写回变量
+            void UpdateVariables()
+            {
+                for (size_t i = 0; i < m_values.size(); ++i)
+                {
+                    const auto& symbol = m_variableSymbols[i];
+                    if (!symbol.IsValid())
+                    {
+                        m_values[i] = 0.0;
+                        continue;
+                    }
+                    auto it = m_rows.find(symbol);
+                    m_values[i] = it == m_rows.end() ? 0.0 : it->second.m_constant;
+                }
+            }
+            // 获取约束个数
+            size_t GetConstraintCount() const { return m_constraints.size(); }
+            // 获取累计主元变换次数
+            uint64_t GetPivotCount() const { return m_pivotCount; }
+
+        private:
+            static bool nearZero(double value)
+            {
+                constexpr double eps = 1.0e-8;
+                return value < 0.0 ? -value < eps : value < eps;
+            }
+
+            Symbol newSymbol(SymbolType type)
+            {
+                return Symbol{ ++m_symbolTick, type };
+            }
+
+            // 获取变量的外部符号
+            Symbol variableSymbol(Variable variable)
+            {
+                assert(variable.IsValid() && variable.m_id <= m_variableSymbols.size());
+                auto& symbol = m_variableSymbols[variable.m_id - 1];
+                if (!symbol.IsValid())
+                {
+                    symbol = newSymbol(SymbolType::External);
+                }
+                return symbol;
+            }
+
+            // 约束转为单纯形表行，基变量已代入
+            Row createRow(const Constraint& constraint, Tag& tag)
+            {
+                const auto& expression = constraint.m_expression;
+                Row row;
+                row.m_constant = expression.m_constant;
+                for (const auto& term : expression.m_terms)
+                {
+                    if (nearZero(term.m_coefficient))
+                    {
+                        continue;
+                    }
+                    const Symbol symbol = variableSymbol(term.m_variable);
+                    auto it = m_rows.find(symbol);
+                    if (it != m_rows.end())
+                    {
+                        row.Insert(it->second, term.m_coefficient);
+                    }
+                    else
+                    {
+                        row.Insert(symbol, term.m_coefficient);
+                    }
+                }
+
+                const bool required = constraint.m_strength >= Strength::Required;
+                switch (constraint.m_relation)
+                {
+                case Relation::LessEqual:
+                case Relation::GreaterEqual:
+                {
+                    const double coefficient = constraint.m_relation == Relation::LessEqual ? 1.0 : -1.0;
+                    const Symbol slack = newSymbol(SymbolType::Slack);
+                    tag.m_marker = slack;
+                    row.Insert(slack, coefficient);
+                    if (!required)
+                    {
+                        const Symbol error = newSymbol(SymbolType::Error);
+                        tag.m_other = error;
+                        row.Insert(error, -coefficient);
+                        m_objective.Insert(error, constraint.m_strength);
+                    }
+                }
+                break;
+                case Relation::Equal:
+                {
+                    if (!required)
+                    {
+                        const Symbol errorPlus = newSymbol(SymbolType::Error);
+                        const Symbol errorMinus = newSymbol(SymbolType::Error);
+                        tag.m_marker = errorPlus;
+                        tag.m_other = errorMinus;
+                        row.Insert(errorPlus, -1.0);
+                        row.Insert(errorMinus, 1.0);
+                        m_objective.Insert(errorPlus, constraint.m_strength);
+                        m_objective.Insert(errorMinus, constraint.m_strength);
+                    }
+                    else
+                    {
+                        const Symbol dummy = newSymbol(SymbolType::Dummy);
+                        tag.m_marker = dummy;
+                        row.Insert(dummy);
+                    }
+                }
+                break;
+                }
+
+                if (row.m_constant < 0.0)
+                {
+                    row.ReverseSign();
+                }
+                return row;
+            }
+
+            // 选择入基符号，优先外部变量，其次系数为负的松弛或误差变量
+            static Symbol chooseSubject(const Row& row, const Tag& tag)
+            {
+                for (const auto& cell : row.m_cells)
+                {
+                    if (cell.first.m_type == SymbolType::External)
+                    {
+                        return cell.first;
+                    }
+                }
+                auto pivotable = [](const Symbol& symbol) {
+                    return symbol.m_type == SymbolType::Slack || symbol.m_type == SymbolType::Error;
+                };
+                if (pivotable(tag.m_marker) && row.CoefficientFor(tag.m_marker) < 0.0)
+                {
+                    return tag.m_marker;
+                }
+                if (pivotable(tag.m_other) && row.CoefficientFor(tag.m_other) < 0.0)
+                {
+                    return tag.m_other;
+                }
+                return Symbol{};
+            }
+
+            static bool allDummies(const Row& row)
+            {
+                return std::all_of(row.m_cells.begin(), row.m_cells.end(),
+                    [](const auto& cell) { return cell.first.m_type == SymbolType::Dummy; });
+            }
+
+            static Symbol anyPivotableSymbol(const Row& row)
+            {
+                for (const auto& cell : row.m_cells)
+                {
+                    if (cell.first.m_type == SymbolType::Slack || cell.first.m_type == SymbolType::Error)
+                    {
+                        return cell.first;
+                    }
+                }
+                return Symbol{};
+            }
+
+            // 找不到入基符号时用人工变量求可行解
+            bool addWithArtificialVariable(const Row& row)
+            {
+                const Symbol artificial = newSymbol(SymbolType::Slack);
+                m_rows[artificial] = row;
+                m_artificial = std::make_unique<Row>(row);
+
+                optimize(*m_artificial);
+                const bool success = nearZero(m_artificial->m_constant);
+                m_artificial.reset();
+
+                // 人工变量仍是基变量时换出
+                auto it = m_rows.find(artificial);
+                if (it != m_rows.end())
+                {
+                    Row temp = std::move(it->second);
+                    m_rows.erase(it);
+                    if (temp.m_cells.empty())
+                    {
+                        return success;
+                    }
+                    const Symbol entering = anyPivotableSymbol(temp);
+                    if (!entering.IsValid())
+                    {
+                        return false;
+                    }
+                    temp.SolveFor(artificial, entering);
+                    substitute(entering, temp);
+                    m_rows[entering] = std::move(temp);
+                    ++m_pivotCount;
+                }
+
+                for (auto& [symbol, other] : m_rows)
+                {
+                    other.Remove(artificial);
+                }
+                m_objective.Remove(artificial);
+                return success;
+            }
+
+            // 把symbol = row代入所有行和目标函数
+            void substitute(const Symbol& symbol, const Row& row)
+            {
+                for (auto& [basic, other] : m_rows)
+                {
+                    other.Substitute(symbol, row);
+                    if (basic.m_type != SymbolType::External && other.m_constant < 0.0)
+                    {
+                        m_infeasibleRows.push_back(basic);
+                    }
+                }
+                m_objective.Substitute(symbol, row);
+                if (m_artificial)
+                {
+                    m_artificial->Substitute(symbol, row);
+                }
+            }
+
+            // 原始单纯形优化
+            void optimize(const Row& objective)
+            {
+                while (true)
+                {
+                    const Symbol entering = getEnteringSymbol(objective);
+                    if (!entering.IsValid())
+                    {
+                        return;
+                    }
+
+                    auto it = getLeavingRow(entering);
+                    if (it == m_rows.end())
+                    {
+                        // 目标函数无界，约束构造有误
+                        assert(false);
+                        return;
+                    }
+
+                    const Symbol leaving = it->first;
+                    Row row = std::move(it->second);
+                    m_rows.erase(it);
+                    row.SolveFor(leaving, entering);
+                    substitute(entering, row);
+                    m_rows[entering] = std::move(row);
+                    ++m_pivotCount;
+                }
+            }
+
+            // 对偶单纯形优化，修改编辑变量后从上次的最优解恢复可行性
+            void dualOptimize()
+            {
+                while (!m_infeasibleRows.empty())
+                {
+                    const Symbol leaving = m_infeasibleRows.back();
+                    m_infeasibleRows.pop_back();
+
+                    auto it = m_rows.find(leaving);
+                    if (it == m_rows.end() || nearZero(it->second.m_constant) || it->second.m_constant >= 0.0)
+                    {
+                        continue;
+                    }
+
+                    const Symbol entering = getDualEnteringSymbol(it->second);
+                    if (!entering.IsValid())
+                    {
+                        assert(false);
+                        continue;
+                    }
+
+                    Row row = std::move(it->second);
+                    m_rows.erase(it);
+                    row.SolveFor(leaving, entering);
+                    substitute(entering, row);
+                    m_rows[entering] = std::move(row);
+                    ++m_pivotCount;
+                }
+            }
+
+            Symbol getEnteringSymbol(const Row& objective) const
+            {
+                for (const auto& cell : objective.m_cells)
+                {
+                    if (cell.first.m_type != SymbolType::Dummy && cell.second < 0.0)
+                    {
+                        return cell.first;
+                    }
+                }
+                return Symbol{};
+            }
+
+            Symbol getDualEnteringSymbol(const Row& row) const
+            {
+                Symbol entering;
+                double ratio = std::numeric_limits<double>::max();
+                for (const auto& cell : row.m_cells)
+                {
+                    if (cell.second > 0.0 && cell.first.m_type != SymbolType::Dummy)
+                    {
+                        const double r = m_objective.CoefficientFor(cell.first) / cell.second;
+                        if (r < ratio)
+                        {
+                            ratio = r;
+                            entering = cell.first;
+                        }
+                    }
+                }
+                return entering;
+            }
+
+            std::map<Symbol, Row>::iterator getLeavingRow(const Symbol& entering)
+            {
+                double ratio = std::numeric_limits<double>::max();
+                auto found = m_rows.end();
+                for (auto it = m_rows.begin(); it != m_rows.end(); ++it)
+                {
+                    if (it->first.m_type == SymbolType::External)
+                    {
+                        continue;
+                    }
+                    const double coefficient = it->second.CoefficientFor(entering);
+                    if (coefficient < 0.0)
+                    {
+                        const double r = -it->second.m_constant / coefficient;
+                        if (r < ratio)
+                        {
+                            ratio = r;
+                            found = it;
+                        }
+                    }
+                }
+                return found;
+            }
+
+            // 删除约束时选择标记符号换入基的行
+            std::map<Symbol, Row>::iterator getMarkerLeavingRow(const Symbol& marker)
+            {
+                const double max = std::numeric_limits<double>::max();
+                double r1 = max;
+                double r2 = max;
+                auto first = m_rows.end();
+                auto second = m_rows.end();
+                auto third = m_rows.end();
+                for (auto it = m_rows.begin(); it != m_rows.end(); ++it)
+                {
+                    const double coefficient = it->second.CoefficientFor(marker);
+                    if (coefficient == 0.0)
+                    {
+                        continue;
+                    }
+                    if (it->first.m_type == SymbolType::External)
+                    {
+                        third = it;
+                    }
+                    else if (coefficient < 0.0)
+                    {
+                        const double r = -it->second.m_constant / coefficient;
+                        if (r < r1)
+                        {
+                            r1 = r;
+                            first = it;
+                        }
+                    }
+                    else
+                    {
+                        const double r = it->second.m_constant / coefficient;
+                        if (r < r2)
+                        {
+                            r2 = r;
+                            second = it;
+                        }
+                    }
+                }
+                if (first != m_rows.end())
+                {
+                    return first;
+                }
+                if (second != m_rows.end())
+                {
+                    return second;
+                }
+                return third;
+            }
+
+            void removeMarkerEffects(const Symbol& marker, double strength)
+            {
+                auto it = m_rows.find(marker);
+                if (it != m_rows.end())
+                {
+                    m_objective.Insert(it->second, -strength);
+                }
+                else
+                {
+                    m_objective.Insert(marker, -strength);
+                }
+            }
+        };
+    }
+}
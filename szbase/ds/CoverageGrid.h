@@ -0,0 +1,139 @@
+// comment: 遮挡覆盖位图，把区域切成固定大小的格子，每个格子一位，
+// 遮挡物只标记完全在它内部的格子，查询时矩形碰到的格子都被标记才算被遮挡，两边都保守，不会误判
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Math.h"
+
+namespace sz_ds
+{
+    class CoverageGrid
+    {
+    public:
+        CoverageGrid(float tileSize = 8.0f) : m_tileSize(tileSize) {}
+
+        // 重置为width*height的空白区域，格子数不变时不重新分配
+        void Reset(float width, float height)
+        {
+            m_width = std::max(0.0f, width);
+            m_height = std::max(0.0f, height);
+            m_cols = int32_t(std::ceil(m_width / m_tileSize));
+            m_rows = int32_t(std::ceil(m_height / m_tileSize));
+            m_wordsPerRow = (m_cols + 63) / 64;
+            m_bits.assign(size_t(m_wordsPerRow) * size_t(m_rows), 0);
+            m_coveredTiles = 0;
+        }
+
+        // 加入遮挡物，标记完全被它覆盖的格子，超出区域的格子按区域边界裁掉后判断
+        void AddOccluder(const AABB2D& box)
+        {
+            if (box.IsNull())
+            {
+                return;
+            }
+            const auto& min = box.GetMinimum();
+            const auto& max = box.GetMaximum();
+            const int32_t x0 = min.x <= 0.0f ? 0 : int32_t(std::ceil(min.x / m_tileSize));
+            const int32_t y0 = min.y <= 0.0f ? 0 : int32_t(std::ceil(min.y / m_tileSize));
+            const int32_t x1 = max.x >= m_width ? m_cols : int32_t(std::floor(max.x / m_tileSize));
+            const int32_t y1 = max.y >= m_height ? m_rows : int32_t(std::floor(max.y / m_tileSize));
+            if (x0 >= x1 || y0 >= y1)
+            {
+                return;
+            }
+            for (int32_t y = y0; y < y1; ++y)
+            {
+                uint64_t* words = m_bits.data() + size_t(y) * size_t(m_wordsPerRow);
+                for (int32_t w = x0 / 64; w <= (x1 - 1) / 64; ++w)
+                {
+                    const uint64_t mask = wordMask(w, x0, x1);
+                    m_coveredTiles += size_t(popcount(mask & ~words[w]));
+                    words[w] |= mask;
+                }
+            }
+        }
+
+        // 矩形在区域内的部分是否完全被遮挡，矩形为空或者完全在区域外时返回false
+        bool IsCovered(const AABB2D& box) const
+        {
+            if (box.IsNull())
+            {
+                return false;
+            }
+            const auto& min = box.GetMinimum();
+            const auto& max = box.GetMaximum();
+            const float left = std::max(min.x, 0.0f);
+            const float top = std::max(min.y, 0.0f);
+            const float right = std::min(max.x, m_width);
+            const float bottom = std::min(max.y, m_height);
+            if (left >= right || top >= bottom)
+            {
+                return false;
+            }
+            const int32_t x0 = int32_t(std::floor(left / m_tileSize));
+            const int32_t y0 = int32_t(std::floor(top / m_tileSize));
+            const int32_t x1 = std::min(m_cols, int32_t(std::ceil(right / m_tileSize)));
+            const int32_t y1 = std::min(m_rows, int32_t(std::ceil(bottom / m_tileSize)));
+            for (int32_t y = y0; y < y1; ++y)
+            {
+                const uint64_t* words = m_bits.data() + size_t(y) * size_t(m_wordsPerRow);
+                for (int32_t w = x0 / 64; w <= (x1 - 1) / 64; ++w)
+                {
+                    const uint64_t mask = wordMask(w, x0, x1);
+                    if ((words[w] & mask) != mask)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // 被遮挡的格子数
+        size_t GetCoveredTileCount() const { return m_coveredTiles; }
+        // 格子列数和行数
+        int32_t GetCols() const { return m_cols; }
+        int32_t GetRows() const { return m_rows; }
+
+    private:
+        // 第w个字里落在[x0, x1)格子范围内的位
+        static uint64_t wordMask(int32_t w, int32_t x0, int32_t x1)
+        {
+            const int32_t begin = std::max(x0, w * 64) - w * 64;
+            const int32_t end = std::min(x1, w * 64 + 64) - w * 64;
+            const uint64_t high = end == 64 ? ~uint64_t(0) : ((uint64_t(1) << end) - 1);
+            return high & ~((uint64_t(1) << begin) - 1);
+        }
+
+        static int popcount(uint64_t v)
+        {
+            int count = 0;
+            for (; v; v &= v - 1)
+            {
+                ++count;
+            }
+            return count;
+        }
+
+    private:
+        // 格子边长
+        float m_tileSize;
+        // 区域大小
+        float m_width = 0.0f;
+        float m_height = 0.0f;
+        // 格子列数和行数
+        int32_t m_cols = 0;
+        int32_t m_rows = 0;
+        // 每行占用的字数
+        int32_t m_wordsPerRow = 0;
+        // 每个格子一位，按行存放
+        std::vector<uint64_t> m_bits;
+        // 被遮挡的格子数
+        size_t m_coveredTiles = 0;
+    };
+}
@@ -1,371 +1,449 @@
 // comment: 委托，不会主动在堆上分配内存，性能敏感，可以使用
+// 调用只经过一个函数指针跳板，可平凡拷贝的可调用对象按内存直接拷贝，不经过虚函数
 
 #pragma once
 
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <cstddef>
+#include <algorithm>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace sz_ds
 {
     static constexpr size_t MAX_DELEGATE_SIZE = 48;
     static constexpr size_t MAX_ALIGN = alignof(std::max_align_t);
 
-    // 委托接口
-    template<typename R, typename... Args>
-    class IDelegate
+    // 委托内部对象的管理操作
+    enum class DelegateOp
     {
-    public:
-        virtual ~IDelegate() = default;
-        virtual R invoke(Args... args) = 0;
-        virtual void move_construct(void* buf) noexcept = 0;
-        virtual void copy_construct(void* buf) const = 0;
-        virtual bool is_bound() const noexcept = 0;
+        // 拷贝构造到目标缓冲区
+        Copy,
+        // 移动构造到目标缓冲区并析构源对象
+        Move,
+        // 析构
+        Destroy,
     };
 
-    // 空委托
-    template<typename R, typename... Args>
-    class EmptyDelegate final : public  IDelegate<R, Args...>
+    // 成员函数委托保存的对象
+    template<typename T, typename R, typename... Args>
+    struct DelegateMember
     {
-    public:
-        EmptyDelegate() = default;
-
-        void move_construct(void* buf) noexcept override 
-        {
-            new(buf) EmptyDelegate;
-        }
+        using Method = R(T::*)(Args...);
 
-        void copy_construct(void* buf) const override 
-        {
-            new(buf) EmptyDelegate;
-        }
+        T* m_object;
+        Method m_method;
 
-        R invoke(Args...) override 
+        R operator()(Args... args) const
         {
-            if constexpr (std::is_same_v<R, void>) {}
-            else { return R{}; }
+            return (m_object->*m_method)(std::forward<Args>(args)...);
         }
-
-        bool is_bound() const noexcept override { return false; }
     };
 
-    // 成员函数委托实现
-    template<typename T, typename R, typename... Args>
-    class DelegateImp : public IDelegate<R, Args...>
+    // 委托
+    template<typename R, typename... Args>
+    class Delegate
     {
-    public:
-        using Method = R(T::*)(Args...);
-
-        DelegateImp(T* object, Method method)
-            : m_object(object), m_method(method)
-        {
-        }
-
-        void move_construct(void* buf) noexcept override
-        {
-            new(buf) DelegateImp(std::exchange(m_object, nullptr), m_method);
-        }
+    private:
+        // 调用跳板
+        using Invoker = R(*)(void* object, Args... args);
+        // 管理跳板，可平凡拷贝和析构的对象为nullptr
+        using Manager = void(*)(DelegateOp op, void* dst, void* src);
 
-        void copy_construct(void* buf) const override
+        template<typename F>
+        static R invokeThunk(void* object, Args... args)
         {
-            new(buf) DelegateImp(m_object, m_method);
+            return (*static_cast<F*>(object))(std::forward<Args>(args)...);
         }
 
-        R invoke(Args... args) override
+        template<typename F>
+        static void manageThunk(DelegateOp op, void* dst, void* src)
         {
-            return (m_object->*m_method)(std::forward<Args>(args)...);
+            switch (op)
+            {
+            case DelegateOp::Copy:
+                new(dst) F(*static_cast<const F*>(src));
+                break;
+            case DelegateOp::Move:
+                new(dst) F(std::move(*static_cast<F*>(src)));
+                static_cast<F*>(src)->~F();
+                break;
+            case DelegateOp::Destroy:
+                static_cast<F*>(dst)->~F();
+                break;
+            }
         }
 
-        bool is_bound() const noexcept override { return true; }
-
-    private:
-        T* m_object;
-        Method m_method;
-    };
+        // 可以直接按内存拷贝
+        template<typename F>
+        static constexpr bool isTrivial = std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
 
-    // 静态/全局函数委托实现
-    template<typename R, typename... Args>
-    class DelegateImpStatic : public IDelegate<R, Args...>
-    {
     public:
-        using Method = R(*)(Args...);
+        Delegate() noexcept = default;
 
-        explicit DelegateImpStatic(Method method)
-            : m_method(method)
+        ~Delegate() noexcept
         {
+            reset();
         }
 
-        void move_construct(void* buf) noexcept override
+        // 拷贝构造，可调用对象的拷贝可能抛出异常
+        Delegate(const Delegate& rhs)
         {
-            new(buf) DelegateImpStatic(std::exchange(m_method, nullptr));
+            copyFrom(rhs);
         }
 
-        void copy_construct(void* buf) const override
+        // 移动构造
+        Delegate(Delegate&& rhs) noexcept
         {
-            new(buf) DelegateImpStatic(m_method);
+            moveFrom(rhs);
         }
 
-        R invoke(Args... args) override
+        // 拷贝赋值，可调用对象的拷贝抛出异常时本委托为空
+        Delegate& operator=(const Delegate& rhs)
         {
-            return (*m_method)(std::forward<Args>(args)...);
-        }
-
-        bool is_bound() const noexcept override { return true; }
-
-    private:
-        Method m_method;
-    };
+            if (this == &rhs)
+            {
+                return *this;
+            }
 
-    // Lambda/std::function/Functor委托
-    template<typename F, typename R, typename... Args>
-    class DelegateImpFunctor final : public IDelegate<R, Args...>
-    {
-    public:
-        template<typename FunctorType>
-        explicit DelegateImpFunctor(FunctorType&& functor)
-            : m_functor(std::forward<FunctorType>(functor))
-        {
+            reset();
+            copyFrom(rhs);
+            return *this;
         }
 
-        void move_construct(void* buf) noexcept override
+        // 移动赋值
+        Delegate& operator=(Delegate&& rhs) noexcept
         {
-            new(buf) DelegateImpFunctor(std::move(m_functor));
-        }
+            if (this == &rhs)
+            {
+                return *this;
+            }
 
-        void copy_construct(void* buf) const override
-        {
-            new(buf) DelegateImpFunctor(m_functor);
+            reset();
+            moveFrom(rhs);
+            return *this;
         }
 
-        R invoke(Args... args) override
+        // 绑定成员函数
+        template<typename T>
+        void Bind(T* object, R(T::* method)(Args...))
         {
-            return m_functor(std::forward<Args>(args)...);
+            reset();
+            if (object && method)
+            {
+                store(DelegateMember<T, R, Args...>{ object, method });
+            }
         }
 
-        bool is_bound() const noexcept override { return true; }
-
-    private:
-        F m_functor;
-    };
-
-    // 委托
-    template<typename R, typename... Args>
-    class Delegate
-    {
-    private:
-        using IDelegateBase = IDelegate<R, Args...>;
-
-        void empty()
+        // 绑定静态/全局函数
+        void Bind(R(*method)(Args...))
         {
-            new(static_cast<void*>(m_realObject)) EmptyDelegate<R, Args...>;
-            m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
+            reset();
+            if (method)
+            {
+                store(method);
+            }
         }
 
-    public:
-        Delegate() noexcept
+        // 绑定任意可调用对象(Functor, std::function, 捕获/非捕获Lambda)
+        template<typename F>
+        void Bind(F&& functor)
         {
-            empty();
-        }
+            // 获取Functor的真实类型（去除引用和cv限定符）
+            using FunctorType = std::decay_t<F>;
 
-        ~Delegate() noexcept
-        {
-            if (m_delegate)
+            // 销毁当前绑定的对象
+            reset();
+
+            // 检查FunctorType是否可调用且参数匹配，不可调用时保持为空委托
+            if constexpr (std::is_invocable_v<FunctorType, Args...>)
             {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
+                store(std::forward<F>(functor));
             }
         }
 
-        // 拷贝构造
-        Delegate(const Delegate& rhs) noexcept 
+        // 解除绑定
+        void Reset() noexcept
         {
-            if (rhs.m_delegate) 
-            {
-                rhs.m_delegate->copy_construct(m_realObject);
-            }
-            else 
-            {
-                new(static_cast<void*>(m_realObject)) EmptyDelegate<R, Args...>;
-            }
-            m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
+            reset();
         }
 
-        // 移动构造
-        Delegate(Delegate&& rhs) noexcept
+        // 调用，未绑定时返回默认值
+        R operator()(Args... args) const
         {
-            if (rhs.m_delegate)
+            if (m_invoke)
             {
-                rhs.m_delegate->move_construct(m_realObject);
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
-
-                rhs.empty();
+                return m_invoke(const_cast<char*>(m_realObject), std::forward<Args>(args)...);
             }
+            if constexpr (std::is_same_v<R, void>) {}
             else
             {
-                empty();
+                return R{};
             }
         }
 
-        // 拷贝赋值
-        Delegate& operator=(const Delegate& rhs) noexcept
+        // bool判断，是否有绑定函数
+        explicit operator bool() const noexcept
         {
-            if (this == &rhs)
-            {
-                return *this;
-            }
+            return m_invoke != nullptr;
+        }
 
-            if (m_delegate)
-            {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
-            }
+    private:
+        // 在内部缓冲区上构造可调用对象
+        template<typename F>
+        void store(F&& functor)
+        {
+            using FunctorType = std::decay_t<F>;
 
-            if (rhs.m_delegate)
+            // 编译时检查大小和对齐
+            static_assert(sizeof(FunctorType) <= MAX_DELEGATE_SIZE,
+                "Callable is too large for the internal buffer.");
+            static_assert(alignof(FunctorType) <= MAX_ALIGN,
+                "Callable alignment is too large for the internal buffer.");
+            static_assert(std::is_copy_constructible_v<FunctorType>,
+                "Callable must be copy constructible.");
+            // 移动操作声明了noexcept
+            static_assert(std::is_nothrow_move_constructible_v<FunctorType>,
+                "Callable must be nothrow move constructible.");
+
+            new(static_cast<void*>(m_realObject)) FunctorType(std::forward<F>(functor));
+            m_invoke = &invokeThunk<FunctorType>;
+            if constexpr (isTrivial<FunctorType>)
             {
-                rhs.m_delegate->copy_construct(m_realObject);
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
+                m_manage = nullptr;
             }
             else
             {
-                empty();
+                m_manage = &manageThunk<FunctorType>;
             }
-            return *this;
         }
 
-        // 移动赋值
-        Delegate& operator=(Delegate&& rhs) noexcept
+        void copyFrom(const Delegate& rhs)
         {
-            if (this == &rhs) 
+            if (!rhs.m_invoke)
             {
-                return *this;
+                return;
             }
 
-            if (m_delegate) 
+            if (rhs.m_manage)
             {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
+                rhs.m_manage(DelegateOp::Copy, m_realObject, const_cast<char*>(rhs.m_realObject));
             }
-
-            if (rhs.m_delegate) 
-            {
-                rhs.m_delegate->move_construct(m_realObject);
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
-                rhs.empty();
-            }
-            else 
+            else
             {
-                empty();
+                memcpy(m_realObject, rhs.m_realObject, MAX_DELEGATE_SIZE);
             }
-            return *this;
+            m_invoke = rhs.m_invoke;
+            m_manage = rhs.m_manage;
         }
 
-        // 绑定成员函数
-        template<typename T>
-        void Bind(T* object, R(T::* method)(Args...))
+        // 移动后源委托为空
+        void moveFrom(Delegate& rhs) noexcept
         {
-            static_assert(sizeof(DelegateImp<T, R, Args...>) <= MAX_DELEGATE_SIZE,
-                "DelegateImp is too large for the internal buffer.");
-            static_assert(alignof(DelegateImp<T, R, Args...>) <= MAX_ALIGN,
-                "DelegateImp alignment is too large for the internal buffer.");
-            if (m_delegate)
+            if (!rhs.m_invoke)
             {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
+                return;
             }
 
-            if (object && method)
+            if (rhs.m_manage)
             {
-                new(m_realObject) DelegateImp<T, R, Args...>(object, method);
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
+                rhs.m_manage(DelegateOp::Move, m_realObject, rhs.m_realObject);
             }
             else
             {
-                empty();
+                memcpy(m_realObject, rhs.m_realObject, MAX_DELEGATE_SIZE);
             }
+            m_invoke = std::exchange(rhs.m_invoke, nullptr);
+            m_manage = std::exchange(rhs.m_manage, nullptr);
         }
 
-        // 绑定静态/全局函数
-        void Bind(R(*method)(Args...))
+        void reset() noexcept
         {
-            static_assert(sizeof(DelegateImpStatic<R, Args...>) <= MAX_DELEGATE_SIZE,
-                "DelegateImpStatic is too large for the internal buffer.");
-            static_assert(alignof(DelegateImpStatic<R, Args...>) <= MAX_ALIGN,
-                "DelegateImpStatic alignment is too large for the internal buffer.");
-            
-            if (m_delegate)
+            if (m_manage)
             {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
-            }
-
-            if (method)
-            {
-                new(m_realObject) DelegateImpStatic<R, Args...>(method);
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
-            }
-            else
-            {
-                empty();
+                m_manage(DelegateOp::Destroy, m_realObject, nullptr);
             }
+            m_invoke = nullptr;
+            m_manage = nullptr;
         }
 
-        // 绑定任意可调用对象(Functor, std::function, 捕获/非捕获Lambda)
-        template<typename F>
-        void Bind(F&& functor)
+    private:
+        alignas(MAX_ALIGN) char m_realObject[MAX_DELEGATE_SIZE];
+        Invoker m_invoke = nullptr;
+        Manager m_manage = nullptr;
+    };
+
+    // 多播委托，一次调用通知所有绑定的函数，返回值忽略
+    // 调用过程中可以添加和删除，新添加的本次不会调用，删除的本次不再调用
+    template<typename... Args>
+    class MulticastDelegate
+    {
+    public:
+        using Handler = Delegate<void, Args...>;
+        // 绑定标识，0为无效
+        using HandlerId = uint64_t;
+
+    private:
+        // 绑定槽
+        struct Slot
         {
-            // 获取Functor的真实类型（去除引用和cv限定符）
-            using FunctorType = std::decay_t<F>;
-            using ImpType = DelegateImpFunctor<FunctorType, R, Args...>;
+            HandlerId m_id = 0;
+            Handler m_handler;
+        };
 
-            // 编译时检查大小和对齐
-            static_assert(sizeof(ImpType) <= MAX_DELEGATE_SIZE,
-                "DelegateImpFunctor is too large for the internal buffer.");
-            static_assert(alignof(ImpType) <= MAX_ALIGN,
-                "DelegateImpFunctor alignment is too large for the internal buffer.");
+    private:
+        // 绑定槽，调用过程中不会重新分配
+        std::vector<Slot> m_slots;
+        // 调用过程中添加的绑定，调用结束后合并
+        std::vector<Slot> m_pendingSlots;
+        // 下一个标识
+        HandlerId m_nextId = 1;
+        // 调用嵌套深度
+        uint32_t m_invokeDepth = 0;
+        // 调用过程中有删除，调用结束后压缩
+        bool m_needCompact = false;
 
-            // 销毁当前绑定的对象
-            if (m_delegate)
+    public:
+        MulticastDelegate() = default;
+
+    public:
+        // 添加绑定
+        HandlerId Add(Handler handler)
+        {
+            if (!handler)
             {
-                m_delegate->~IDelegate();
-                m_delegate = nullptr;
+                return 0;
             }
 
-            // 检查FunctorType是否可调用且参数匹配
-            if constexpr (std::is_invocable_v<FunctorType, Args...>)
+            const HandlerId id = m_nextId++;
+            auto& slots = m_invokeDepth > 0 ? m_pendingSlots : m_slots;
+            slots.push_back(Slot{ id, std::move(handler) });
+            return id;
+        }
+        // 添加成员函数
+        template<typename T>
+        HandlerId Add(T* object, void(T::* method)(Args...))
+        {
+            Handler handler;
+            handler.Bind(object, method);
+            return Add(std::move(handler));
+        }
+        // 添加任意可调用对象
+        template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Handler>>>
+        HandlerId Add(F&& functor)
+        {
+            Handler handler;
+            handler.Bind(std::forward<F>(functor));
+            return Add(std::move(handler));
+        }
+        // 删除绑定
+        bool Remove(HandlerId id)
+        {
+            if (id == 0)
             {
-                // 在内部缓冲区上构造新的DelegateImpFunctor实例
-                new(m_realObject) ImpType(std::forward<F>(functor));
-                m_delegate = static_cast<IDelegateBase*>(static_cast<void*>(m_realObject));
+                return false;
             }
-            else
+
+            for (auto it = m_pendingSlots.begin(); it != m_pendingSlots.end(); ++it)
             {
-                // 如果不可调用，设置为空委托
-                empty();
+                if (it->m_id == id)
+                {
+                    m_pendingSlots.erase(it);
+                    return true;
+                }
             }
-        }
 
-        // 调用
-        R operator()(Args... args) const
+            for (auto it = m_slots.begin(); it != m_slots.end(); ++it)
+            {
+                if (it->m_id != id)
+                {
+                    continue;
+                }
+                // 调用过程中只做标记，正在执行的函数对象不能析构
+                if (m_invokeDepth > 0)
+                {
+                    it->m_id = 0;
+                    m_needCompact = true;
+                }
+                else
+                {
+                    m_slots.erase(it);
+                }
+                return true;
+            }
+            return false;
+        }
+        // 清空绑定
+        void Clear()
         {
-            if (m_delegate)
+            m_pendingSlots.clear();
+            if (m_invokeDepth > 0)
             {
-                return m_delegate->invoke(std::forward<Args>(args)...);
+                for (auto& slot : m_slots)
+                {
+                    slot.m_id = 0;
+                }
+                m_needCompact = !m_slots.empty();
+                return;
             }
-            if constexpr (std::is_same_v<R, void>) {}
-            else
+            m_slots.clear();
+        }
+        // 绑定个数
+        size_t GetCount() const
+        {
+            size_t count = m_pendingSlots.size();
+            for (const auto& slot : m_slots)
             {
-                return R{};
+                count += slot.m_id != 0 ? 1 : 0;
             }
+            return count;
         }
-
-        // bool判断，是否有绑定函数
+        // 是否有绑定
         explicit operator bool() const noexcept
         {
-            return m_delegate && m_delegate->is_bound();
+            return GetCount() > 0;
+        }
+        // 按添加顺序调用所有绑定
+        void operator()(Args... args)
+        {
+            ++m_invokeDepth;
+            const size_t count = m_slots.size();
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Slot& slot = m_slots[i];
+                if (slot.m_id != 0)
+                {
+                    slot.m_handler(args...);
+                }
+            }
+            if (--m_invokeDepth == 0)
+            {
+                flushPending();
+            }
         }
 
     private:
-        alignas(MAX_ALIGN) char m_realObject[MAX_DELEGATE_SIZE];
-        IDelegateBase* m_delegate;
+        // 合并调用过程中的增删
+        void flushPending()
+        {
+            if (m_needCompact)
+            {
+                m_needCompact = false;
+                m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(),
+                    [](const Slot& slot) { return slot.m_id == 0; }), m_slots.end());
+            }
+            if (!m_pendingSlots.empty())
+            {
+                for (auto& slot : m_pendingSlots)
+                {
+                    m_slots.push_back(std::move(slot));
+                }
+                m_pendingSlots.clear();
+            }
+        }
     };
-}
\ No newline at end of file
+}
@@ -3,10 +3,14 @@
 #pragma once
 
 #include <iostream>
-#include <unordered_map>
 #include <typeindex>
 #include <utility>
 #include <cassert>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
 
 #include "Delegate.h"
 
@@ -48,13 +52,62 @@ namespace sz_ds
         Type m_data;
     };
 
+    // 事件类型编号分配器
+    class EventTypeCounter
+    {
+    public:
+        // 分配下一个编号，从0开始连续
+        static uint32_t Next()
+        {
+            static std::atomic<uint32_t> next{ 0 };
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // 事件类型编号，每个类型第一次使用时分配，之后不变
+    template<typename T>
+    uint32_t EventTypeId()
+    {
+        static const uint32_t id = EventTypeCounter::Next();
+        return id;
+    }
+
     // 事件总线
+    // 每个事件类型一个通道，按类型编号直接索引，处理器存在连续数组中，空槽位用空闲链表复用
     class EventBus
     {
     private:
         using EventHandler = sz_ds::Delegate<void, const IEvent&>;
-        using HandlerMap = std::unordered_map<uint64_t, EventHandler>;
-        using EventMap = std::unordered_map<std::type_index, HandlerMap>;
+
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // 处理器槽位
+        struct HandlerSlot
+        {
+            // 处理器
+            EventHandler m_handler;
+            // 代数，和槽位索引组成订阅ID
+            uint32_t m_generation = 1;
+            // 空闲链表下一个槽位
+            uint32_t m_nextFree = INVALID_INDEX;
+            // 是否订阅中
+            bool m_active = false;
+        };
+
+        // 事件通道
+        struct Channel
+        {
+            // 处理器槽位，分发中不会扩容
+            std::vector<HandlerSlot> m_slots;
+            // 空闲链表头
+            uint32_t m_freeHead = INVALID_INDEX;
+            // 分发嵌套深度
+            uint32_t m_dispatchDepth = 0;
+            // 分发中取消订阅的槽位，分发结束后回收
+            std::vector<uint32_t> m_pendingFree;
+            // 分发中新增的订阅，分发结束后追加到槽位末尾
+            std::vector<HandlerSlot> m_pendingSlots;
+        };
 
     public:
         // 不用全局也可以独立使用
@@ -72,83 +125,86 @@ namespace sz_ds
         template<typename EventType>
         uint64_t Subscribe(EventHandler handler) 
         {
-            // 生成唯一的订阅ID
-            uint64_t subscriptionId = next_subscription_id++;
-            if (subscriptionId == 0) [[unlikely]]
-			{
-                assert(0);
-			}
-
-            // 将处理器插入到对应事件类型的handlerMap中
-            auto& handlerMap = m_eventMap[std::type_index(typeid(typename EventType::Type))];
-
-            // 插入处理器
-            handlerMap.insert({ subscriptionId, std::move(handler) });
-
-            return subscriptionId;
+            auto& channel = getChannel(EventTypeId<typename EventType::Type>());
+            return addHandler(channel, std::move(handler));
         }
 
         template<typename EventType, typename HandlerFunc>
         uint64_t Subscribe(HandlerFunc handler)
         {
-            // 生成唯一的订阅ID
-            uint64_t subscriptionId = next_subscription_id++;
-            if (subscriptionId == 0) [[unlikely]]
-            {
-                assert(0);
-            }
-
             EventHandler eventDelegate;
             eventDelegate.Bind(std::move(handler));
 
-            auto& handlerMap = m_eventMap[std::type_index(typeid(typename EventType::Type))];
-            handlerMap.insert({ subscriptionId, std::move(eventDelegate) });
-
-            return subscriptionId;
+            auto& channel = getChannel(EventTypeId<typename EventType::Type>());
+            return addHandler(channel, std::move(eventDelegate));
         }
 
-        // 取消订阅
+        // 取消订阅，分发中调用时处理器本次分发不再被调用
         template<typename EventType>
         void Unsubscribe(uint64_t subscriptionId) 
         {
-            auto it = m_eventMap.find(std::type_index(typeid(typename EventType::Type)));
-            if (it != m_eventMap.end()) 
+            auto channel = findChannel(EventTypeId<typename EventType::Type>());
+            if (!channel)
             {
-                auto& handlerMap = it->second;
-
-                handlerMap.erase(subscriptionId);
-
-                // 如果没有订阅者了，移除该事件类型
-                // if (handlerMap.empty()) 
-                // {
-                //     m_eventMap.erase(it);
-                // }
+                return;
             }
+            removeHandler(*channel, subscriptionId);
         }
 
-        // 发布事件
+        // 发布事件，按槽位顺序调用，分发中新增的订阅本次不调用
         template<typename EventType, typename... Args>
         void Publish(Args&&... args) 
         {
+            auto channel = findChannel(EventTypeId<typename EventType::Type>());
+            if (!channel)
+            {
+                return;
+            }
+
             using EventDataType = typename EventType::Type;
             EventType event(EventDataType(std::forward<Args>(args)...));
 
-            auto it = m_eventMap.find(std::type_index(typeid(EventDataType)));
-            if (it == m_eventMap.end()) 
+            ++channel->m_dispatchDepth;
+            const size_t count = channel->m_slots.size();
+            for (size_t i = 0; i < count; ++i)
             {
-                return;
+                const auto& slot = channel->m_slots[i];
+                if (slot.m_active)
+                {
+                    slot.m_handler(event);
+                }
             }
-
-            for (const auto& pair : it->second) 
+            if (--channel->m_dispatchDepth == 0)
             {
-                pair.second(event);
+                flushPending(*channel);
             }
         }
 
         // 清空所有事件订阅
         void Clear() 
         {
-            m_eventMap.clear();
+            for (auto& channel : m_channels)
+            {
+                if (!channel)
+                {
+                    continue;
+                }
+                // 分发中只能标记，分发结束后回收
+                if (channel->m_dispatchDepth > 0)
+                {
+                    for (uint32_t i = 0; i < channel->m_slots.size(); ++i)
+                    {
+                        if (channel->m_slots[i].m_active)
+                        {
+                            channel->m_slots[i].m_active = false;
+                            channel->m_pendingFree.push_back(i);
+                        }
+                    }
+                    channel->m_pendingSlots.clear();
+                    continue;
+                }
+                channel.reset();
+            }
         }
 
     private:
@@ -158,10 +214,130 @@ namespace sz_ds
         EventBus(EventBus&&) = delete;
         EventBus& operator=(EventBus&&) = delete;
 
-        // 事件map，用于存储事件类型和对应的处理器
-        EventMap m_eventMap;
-        // 订阅ID生成器
-        uint64_t next_subscription_id = 1;
+        static uint64_t makeId(uint32_t index, uint32_t generation)
+        {
+            return (uint64_t(generation) << 32) | index;
+        }
+
+        Channel* findChannel(uint32_t typeId) const
+        {
+            return typeId < m_channels.size() ? m_channels[typeId].get() : nullptr;
+        }
+
+        Channel& getChannel(uint32_t typeId)
+        {
+            if (typeId >= m_channels.size())
+            {
+                m_channels.resize(typeId + 1);
+            }
+            auto& channel = m_channels[typeId];
+            if (!channel)
+            {
+                channel = std::make_unique<Channel>();
+            }
+            return *channel;
+        }
+
+        uint64_t addHandler(Channel& channel, EventHandler handler)
+        {
+            // 分发中不修改槽位数组，避免正在调用的处理器被移动
+            if (channel.m_dispatchDepth > 0)
+            {
+                const auto index = uint32_t(channel.m_slots.size() + channel.m_pendingSlots.size());
+                auto& slot = channel.m_pendingSlots.emplace_back();
+                slot.m_handler = std::move(handler);
+                slot.m_active = true;
+                return makeId(index, slot.m_generation);
+            }
+
+            uint32_t index = channel.m_freeHead;
+            if (index != INVALID_INDEX)
+            {
+                channel.m_freeHead = channel.m_slots[index].m_nextFree;
+            }
+            else
+            {
+                assert(channel.m_slots.size() < INVALID_INDEX);
+                index = (uint32_t)channel.m_slots.size();
+                channel.m_slots.emplace_back();
+            }
+
+            auto& slot = channel.m_slots[index];
+            slot.m_handler = std::move(handler);
+            slot.m_nextFree = INVALID_INDEX;
+            slot.m_active = true;
+            return makeId(index, slot.m_generation);
+        }
+
+        void removeHandler(Channel& channel, uint64_t subscriptionId)
+        {
+            const auto index = uint32_t(subscriptionId & 0xffffffffu);
+            const auto generation = uint32_t(subscriptionId >> 32);
+
+            if (index >= channel.m_slots.size())
+            {
+                // 分发中新增还未追加的订阅
+                const size_t pending = index - channel.m_slots.size();
+                if (pending < channel.m_pendingSlots.size() &&
+                    channel.m_pendingSlots[pending].m_generation == generation)
+                {
+                    channel.m_pendingSlots[pending].m_active = false;
+                }
+                return;
+            }
+
+            auto& slot = channel.m_slots[index];
+            if (!slot.m_active || slot.m_generation != generation)
+            {
+                return;
+            }
+
+            slot.m_active = false;
+            if (channel.m_dispatchDepth > 0)
+            {
+                // 处理器可能正在执行，分发结束后再销毁
+                channel.m_pendingFree.push_back(index);
+                return;
+            }
+            releaseSlot(channel, index);
+        }
+
+        void releaseSlot(Channel& channel, uint32_t index)
+        {
+            auto& slot = channel.m_slots[index];
+            slot.m_handler = EventHandler();
+            // 代数回绕时跳过0，保证订阅ID不为0
+            if (++slot.m_generation == 0) [[unlikely]]
+            {
+                slot.m_generation = 1;
+            }
+            slot.m_nextFree = channel.m_freeHead;
+            channel.m_freeHead = index;
+        }
+
+        void flushPending(Channel& channel)
+        {
+            for (auto index : channel.m_pendingFree)
+            {
+                releaseSlot(channel, index);
+            }
+            channel.m_pendingFree.clear();
+
+            for (auto& pendingSlot : channel.m_pendingSlots)
+            {
+                const auto index = (uint32_t)channel.m_slots.size();
+                const bool active = pendingSlot.m_active;
+                channel.m_slots.push_back(std::move(pendingSlot));
+                if (!active)
+                {
+                    releaseSlot(channel, index);
+                }
+            }
+            channel.m_pendingSlots.clear();
+        }
+
+        // 事件通道，按事件类型编号索引，通道地址在分发中保持不变
+        std::vector<std::unique_ptr<Channel>> m_channels;
     };
 
     // 辅助函数
@@ -0,0 +1,132 @@
+// comment: 代际索引句柄，句柄表只保存裸指针不持有所有权，对象移除后旧句柄自动失效
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <limits>
+
+namespace sz_ds
+{
+    // 句柄，T只用来区分句柄类型
+    template<typename T>
+    struct Handle
+    {
+        // 槽位索引
+        uint32_t m_index = 0;
+        // 代数，0表示空句柄
+        uint32_t m_generation = 0;
+
+        // 是否空句柄
+        bool IsNull() const { return m_generation == 0; }
+
+        bool operator==(const Handle& other) const
+        {
+            return m_index == other.m_index && m_generation == other.m_generation;
+        }
+        bool operator!=(const Handle& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    // 句柄表，槽位复用时代数加一
+    // 不加锁，插入和移除只能在UI线程，没有插入和移除进行时多个线程可以同时查询（比如并行布局的工作线程）
+    template<typename T>
+    class HandleTable
+    {
+    public:
+        HandleTable() = default;
+        ~HandleTable() = default;
+
+        HandleTable(const HandleTable&) = delete;
+        HandleTable& operator=(const HandleTable&) = delete;
+
+        // 插入对象，返回句柄
+        Handle<T> Insert(T* object)
+        {
+            assert(object);
+
+            uint32_t index = 0;
+            if (m_freeHead != INVALID_INDEX)
+            {
+                index = m_freeHead;
+                m_freeHead = m_slots[index].m_nextFree;
+            }
+            else
+            {
+                assert(m_slots.size() < INVALID_INDEX);
+                index = (uint32_t)m_slots.size();
+                m_slots.emplace_back();
+            }
+
+            auto& slot = m_slots[index];
+            slot.m_object = object;
+            slot.m_nextFree = INVALID_INDEX;
+            ++m_size;
+            return Handle<T>{ index, slot.m_generation };
+        }
+        // 移除句柄对应的对象，句柄失效返回false
+        bool Remove(Handle<T> handle)
+        {
+            if (!IsValid(handle))
+            {
+                return false;
+            }
+
+            auto& slot = m_slots[handle.m_index];
+            slot.m_object = nullptr;
+            // 代数回绕时跳过0，保证空句柄永远无效
+            if (++slot.m_generation == 0) [[unlikely]]
+            {
+                slot.m_generation = 1;
+            }
+            slot.m_nextFree = m_freeHead;
+            m_freeHead = handle.m_index;
+            --m_size;
+            return true;
+        }
+        // 获取句柄对应的对象，句柄失效返回nullptr
+        T* Get(Handle<T> handle) const
+        {
+            if (handle.m_index >= m_slots.size())
+            {
+                return nullptr;
+            }
+
+            const auto& slot = m_slots[handle.m_index];
+            if (slot.m_generation != handle.m_generation)
+            {
+                return nullptr;
+            }
+            return slot.m_object;
+        }
+        // 句柄是否有效
+        bool IsValid(Handle<T> handle) const { return Get(handle) != nullptr; }
+        // 有效对象个数
+        size_t Size() const { return m_size; }
+
+    private:
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // 槽位
+        struct Slot
+        {
+            // 对象
+            T* m_object = nullptr;
+            // 当前代数
+            uint32_t m_generation = 1;
+            // 空闲链表下一个槽位
+            uint32_t m_nextFree = INVALID_INDEX;
+        };
+
+    private:
+        // 所有槽位
+        std::vector<Slot> m_slots;
+        // 空闲链表头
+        uint32_t m_freeHead = INVALID_INDEX;
+        // 有效对象个数
+        size_t m_size = 0;
+    };
+}
@@ -0,0 +1,175 @@
+// comment: 多生产者单消费者无锁队列，Vyukov侵入式链表，链入只有一次原子交换，节点优先从预分配池中取
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace sz_ds
+{
+    // 多生产者单消费者队列，T需要可默认构造和移动赋值
+    // Push可以在任意线程调用，TryPop只能在一个线程调用
+    // Push是无锁的但不是无等待的：领取池节点是CAS重试循环，其他线程同时领取或归还时要重试；
+    // 节点池用完时从堆上分配，池的容量要按峰值积压的任务数设置
+    template<typename T>
+    class MPSCQueue
+    {
+    private:
+        // 链表节点
+        struct Node
+        {
+            std::atomic<Node*> m_next{ nullptr };
+            T m_value{};
+            // 池中的索引加一，0表示堆上分配
+            uint32_t m_poolIndex = 0;
+        };
+
+        // 缓存行大小，生产者和消费者的数据分开
+        static constexpr size_t CACHE_LINE = 64;
+
+    private:
+        // 生产者交换的链表头
+        alignas(CACHE_LINE) std::atomic<Node*> m_head;
+        // 消费者的链表尾
+        alignas(CACHE_LINE) Node* m_tail;
+        // 哨兵节点
+        Node m_stub;
+        // 节点池
+        std::unique_ptr<Node[]> m_pool;
+        // 空闲链表中每个池节点的下一个索引，索引加一，0表示结尾
+        std::unique_ptr<std::atomic<uint32_t>[]> m_freeNext;
+        // 空闲链表头，高32位为版本号防止ABA，低32位为索引加一
+        alignas(CACHE_LINE) std::atomic<uint64_t> m_freeHead{ 0 };
+
+    public:
+        explicit MPSCQueue(uint32_t poolCapacity = 1024)
+            : m_head(&m_stub), m_tail(&m_stub)
+        {
+            m_pool = std::make_unique<Node[]>(poolCapacity);
+            m_freeNext = std::make_unique<std::atomic<uint32_t>[]>(poolCapacity);
+            for (uint32_t i = 0; i < poolCapacity; ++i)
+            {
+                m_pool[i].m_poolIndex = i + 1;
+                m_freeNext[i].store(i + 1 < poolCapacity ? i + 2 : 0, std::memory_order_relaxed);
+            }
+            m_freeHead.store(poolCapacity > 0 ? 1 : 0, std::memory_order_relaxed);
+        }
+        ~MPSCQueue()
+        {
+            T value;
+            while (TryPop(value))
+            {
+            }
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    public:
+        // 入队，任意线程
+        void Push(T value)
+        {
+            Node* node = acquireNode();
+            node->m_value = std::move(value);
+            node->m_next.store(nullptr, std::memory_order_relaxed);
+            pushNode(node);
+        }
+        // 出队，只能在消费者线程调用，队列为空或者生产者正在入队时返回false
+        bool TryPop(T& value)
+        {
+            Node* tail = m_tail;
+            Node* next = tail->m_next.load(std::memory_order_acquire);
+            if (tail == &m_stub)
+            {
+                if (!next)
+                {
+                    return false;
+                }
+                m_tail = next;
+                tail = next;
+                next = next->m_next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                m_tail = next;
+                value = std::move(tail->m_value);
+                releaseNode(tail);
+                return true;
+            }
+
+            // 最后一个节点，生产者还没链接完成时等下一次
+            if (tail != m_head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            // 重新挂上哨兵，才能把最后一个节点取走
+            m_stub.m_next.store(nullptr, std::memory_order_relaxed);
+            pushNode(&m_stub);
+            next = tail->m_next.load(std::memory_order_acquire);
+            if (next)
+            {
+                m_tail = next;
+                value = std::move(tail->m_value);
+                releaseNode(tail);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        void pushNode(Node* node)
+        {
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->m_next.store(node, std::memory_order_release);
+        }
+
+        // 从池中领取节点，池空时堆上分配
+        Node* acquireNode()
+        {
+            uint64_t head = m_freeHead.load(std::memory_order_acquire);
+            while (true)
+            {
+                const auto index = uint32_t(head);
+                if (index == 0)
+                {
+                    return new Node();
+                }
+
+                const uint32_t next = m_freeNext[index - 1].load(std::memory_order_relaxed);
+                const uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+                if (m_freeHead.compare_exchange_weak(head, newHead,
+                    std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    return &m_pool[index - 1];
+                }
+            }
+        }
+
+        // 归还节点，只在消费者线程调用
+        void releaseNode(Node* node)
+        {
+            if (node->m_poolIndex == 0)
+            {
+                delete node;
+                return;
+            }
+
+            // 出队后立即释放负载持有的资源
+            node->m_value = T{};
+            const uint32_t index = node->m_poolIndex;
+            uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+            uint64_t newHead = 0;
+            do
+            {
+                m_freeNext[index - 1].store(uint32_t(head), std::memory_order_relaxed);
+                newHead = (((head >> 32) + 1) << 32) | index;
+            } while (!m_freeHead.compare_exchange_weak(head, newHead,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+}
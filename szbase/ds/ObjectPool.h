@@ -0,0 +1,328 @@
+// comment: 对象池，按块批量申请内存，通过空闲链表复用，单线程使用
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace sz_ds
+{
+    // 对象池统计
+    struct PoolStats
+    {
+        // 累计分配次数
+        uint64_t m_allocCount = 0;
+        // 累计释放次数
+        uint64_t m_freeCount = 0;
+        // 当前存活对象个数
+        size_t m_liveCount = 0;
+        // 存活对象个数峰值
+        size_t m_peakLiveCount = 0;
+        // 已申请的对象容量
+        size_t m_capacity = 0;
+        // 已申请的块数量
+        size_t m_slabCount = 0;
+
+        // 记录一次分配
+        void RecordAlloc()
+        {
+            ++m_allocCount;
+            ++m_liveCount;
+            m_peakLiveCount = std::max(m_peakLiveCount, m_liveCount);
+        }
+        // 记录一次释放
+        void RecordFree()
+        {
+            assert(m_liveCount > 0);
+            ++m_freeCount;
+            --m_liveCount;
+        }
+    };
+
+    // 固定大小内存块池
+    class SlabPool
+    {
+    public:
+        // 每块默认包含的内存块个数
+        static constexpr size_t DEFAULT_SLAB_BLOCKS = 64;
+
+    public:
+        SlabPool(size_t blockSize, size_t blockAlign, size_t slabBlocks = DEFAULT_SLAB_BLOCKS)
+        {
+            // 空闲时内存块用来存放链表指针
+            m_blockAlign = std::max(blockAlign, alignof(FreeNode));
+            m_blockSize = std::max(blockSize, sizeof(FreeNode));
+            m_blockSize = (m_blockSize + m_blockAlign - 1) / m_blockAlign * m_blockAlign;
+            m_slabBlocks = std::max<size_t>(slabBlocks, 1);
+        }
+        ~SlabPool()
+        {
+            assert(m_stats.m_liveCount == 0);
+            for (void* slab : m_slabs)
+            {
+                ::operator delete(slab, std::align_val_t(m_blockAlign));
+            }
+            m_slabs.clear();
+            m_freeList = nullptr;
+        }
+
+        SlabPool(const SlabPool&) = delete;
+        SlabPool& operator=(const SlabPool&) = delete;
+        SlabPool(SlabPool&&) = delete;
+        SlabPool& operator=(SlabPool&&) = delete;
+
+        // 分配一个内存块
+        void* Allocate()
+        {
+            if (!m_freeList) [[unlikely]]
+            {
+                addSlab(m_slabBlocks);
+            }
+
+            FreeNode* node = m_freeList;
+            m_freeList = node->m_next;
+            --m_freeCount;
+            m_stats.RecordAlloc();
+            return node;
+        }
+        // 归还一个内存块
+        void Deallocate(void* p)
+        {
+            if (!p)
+            {
+                return;
+            }
+
+            FreeNode* node = static_cast<FreeNode*>(p);
+            node->m_next = m_freeList;
+            m_freeList = node;
+            ++m_freeCount;
+            m_stats.RecordFree();
+        }
+        // 保证接下来至少count次分配不再申请新块
+        void Reserve(size_t count)
+        {
+            if (count <= m_freeCount)
+            {
+                return;
+            }
+            addSlab(count - m_freeCount);
+        }
+        // 获取统计
+        const PoolStats& GetStats() const { return m_stats; }
+        // 获取内存块大小
+        size_t GetBlockSize() const { return m_blockSize; }
+
+    private:
+        // 空闲链表节点
+        struct FreeNode
+        {
+            FreeNode* m_next;
+        };
+
+        // 申请新块，并串入空闲链表
+        void addSlab(size_t blocks)
+        {
+            auto* slab = static_cast<std::byte*>(
+                ::operator new(m_blockSize * blocks, std::align_val_t(m_blockAlign)));
+            m_slabs.push_back(slab);
+
+            // 倒序串联，分配顺序和内存顺序一致
+            for (size_t i = blocks; i > 0; --i)
+            {
+                auto* node = reinterpret_cast<FreeNode*>(slab + (i - 1) * m_blockSize);
+                node->m_next = m_freeList;
+                m_freeList = node;
+            }
+            m_freeCount += blocks;
+            m_stats.m_capacity += blocks;
+            m_stats.m_slabCount = m_slabs.size();
+        }
+
+    private:
+        // 内存块大小和对齐
+        size_t m_blockSize = 0;
+        size_t m_blockAlign = 0;
+        // 每块包含的内存块个数
+        size_t m_slabBlocks = DEFAULT_SLAB_BLOCKS;
+        // 空闲链表
+        FreeNode* m_freeList = nullptr;
+        // 空闲内存块个数
+        size_t m_freeCount = 0;
+        // 所有块
+        std::vector<void*> m_slabs;
+        // 统计
+        PoolStats m_stats;
+    };
+
+    // 是否在第一次使用共享内存块池的线程上，这个线程视为UI线程
+    inline bool IsSharedSlabPoolThread()
+    {
+        static const std::thread::id owner = std::this_thread::get_id();
+        return owner == std::this_thread::get_id();
+    }
+
+    // 获取共享的固定大小内存块池，按大小和对齐区分，大小和对齐相同的所有类型共用一个池
+    // 不加锁，只能在UI线程使用，任务池和图片解码等工作线程不能创建控件，也不能使用PoolAllocator的容器
+    // 故意不释放，保证静态对象析构阶段归还内存时池依然有效
+    template<size_t BlockSize, size_t BlockAlign>
+    SlabPool& GetSharedSlabPool()
+    {
+        assert(IsSharedSlabPoolThread());
+        static SlabPool* pool = new SlabPool(BlockSize, BlockAlign);
+        return *pool;
+    }
+
+    // 类型化对象池
+    template<typename T>
+    class ObjectPool
+    {
+    public:
+        explicit ObjectPool(size_t slabBlocks = SlabPool::DEFAULT_SLAB_BLOCKS)
+            : m_slab(sizeof(T), alignof(T), slabBlocks)
+        {
+        }
+        ~ObjectPool() = default;
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool& operator=(const ObjectPool&) = delete;
+        ObjectPool(ObjectPool&&) = delete;
+        ObjectPool& operator=(ObjectPool&&) = delete;
+
+        // 构造对象
+        template<typename... Args>
+        T* Create(Args&&... args)
+        {
+            void* p = m_slab.Allocate();
+            return new(p) T(std::forward<Args>(args)...);
+        }
+        // 析构对象
+        void Destroy(T* p)
+        {
+            if (!p)
+            {
+                return;
+            }
+            p->~T();
+            m_slab.Deallocate(p);
+        }
+        // 保证接下来至少count次构造不再申请新块
+        void Reserve(size_t count) { m_slab.Reserve(count); }
+        // 获取统计
+        const PoolStats& GetStats() const { return m_slab.GetStats(); }
+
+    private:
+        // 内存块池
+        SlabPool m_slab;
+    };
+
+    // 对象池删除器
+    template<typename T>
+    struct PoolDeleter
+    {
+        // 所属对象池
+        ObjectPool<T>* m_pool = nullptr;
+
+        void operator()(T* p) const
+        {
+            assert(m_pool);
+            m_pool->Destroy(p);
+        }
+    };
+
+    // 对象池独占指针
+    template<typename T>
+    using PoolPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+    // 从对象池构造独占指针
+    template<typename T, typename... Args>
+    PoolPtr<T> MakePooled(ObjectPool<T>& pool, Args&&... args)
+    {
+        return PoolPtr<T>(pool.Create(std::forward<Args>(args)...), PoolDeleter<T>{ &pool });
+    }
+
+    // STL分配器，单个对象走共享的固定大小内存块池，数组走全局分配器
+    // 可用于std::list/std::unordered_map节点和std::allocate_shared控制块
+    template<typename T>
+    class PoolAllocator
+    {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = PoolAllocator<U>;
+        };
+
+    public:
+        PoolAllocator() noexcept = default;
+        // stats: 分配统计，可为空，容量和块数取自共享池，包括同大小的其他类型
+        // reserve: 首次单对象分配前预留的个数，用后清零，可为空
+        explicit PoolAllocator(PoolStats* stats, size_t* reserve = nullptr) noexcept
+            : m_stats(stats), m_reserve(reserve)
+        {
+        }
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>& other) noexcept
+            : m_stats(other.m_stats), m_reserve(other.m_reserve)
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            if (n != 1) [[unlikely]]
+            {
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+            }
+
+            auto& pool = GetSharedSlabPool<sizeof(T), alignof(T)>();
+            if (m_reserve && *m_reserve > 0)
+            {
+                pool.Reserve(*m_reserve);
+                *m_reserve = 0;
+            }
+            void* p = pool.Allocate();
+            if (m_stats)
+            {
+                m_stats->RecordAlloc();
+                m_stats->m_capacity = pool.GetStats().m_capacity;
+                m_stats->m_slabCount = pool.GetStats().m_slabCount;
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if (n != 1) [[unlikely]]
+            {
+                ::operator delete(p, std::align_val_t(alignof(T)));
+                return;
+            }
+
+            if (m_stats)
+            {
+                m_stats->RecordFree();
+            }
+            GetSharedSlabPool<sizeof(T), alignof(T)>().Deallocate(p);
+        }
+
+        template<typename U>
+        bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+
+    public:
+        // 分配统计
+        PoolStats* m_stats = nullptr;
+        // 预留个数
+        size_t* m_reserve = nullptr;
+    };
+}
@@ -0,0 +1,205 @@
+// comment: 区间分配器，在一段连续空间中按单位分配区间，空闲区间按偏移合并、按大小最佳适配，只记录偏移不持有内存
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <algorithm>
+
+namespace sz_ds
+{
+    // 区间分配器统计
+    struct RangeAllocatorStats
+    {
+        // 总容量
+        size_t m_capacity = 0;
+        // 已分配
+        size_t m_used = 0;
+        // 当前存活区间个数
+        size_t m_liveCount = 0;
+        // 空闲区间个数
+        size_t m_freeBlocks = 0;
+        // 最大空闲区间
+        size_t m_largestFree = 0;
+        // 累计分配次数
+        uint64_t m_allocCount = 0;
+        // 累计释放次数
+        uint64_t m_freeCount = 0;
+        // 累计扩容次数
+        uint64_t m_growCount = 0;
+
+        // 使用率
+        double GetUtilization() const
+        {
+            return m_capacity ? double(m_used) / double(m_capacity) : 0.0;
+        }
+        // 碎片率，0表示空闲空间连续，越接近1越零碎
+        double GetFragmentation() const
+        {
+            const size_t free = m_capacity - m_used;
+            return free ? 1.0 - double(m_largestFree) / double(free) : 0.0;
+        }
+        // 合并多个分配器的统计
+        void Merge(const RangeAllocatorStats& other)
+        {
+            m_capacity += other.m_capacity;
+            m_used += other.m_used;
+            m_liveCount += other.m_liveCount;
+            m_freeBlocks += other.m_freeBlocks;
+            m_largestFree = std::max(m_largestFree, other.m_largestFree);
+            m_allocCount += other.m_allocCount;
+            m_freeCount += other.m_freeCount;
+            m_growCount += other.m_growCount;
+        }
+    };
+
+    class RangeAllocator
+    {
+    public:
+        // 分配失败
+        static constexpr size_t INVALID_OFFSET = SIZE_MAX;
+
+    public:
+        explicit RangeAllocator(size_t capacity = 0)
+        {
+            Grow(capacity);
+        }
+
+        RangeAllocator(const RangeAllocator&) = delete;
+        RangeAllocator& operator=(const RangeAllocator&) = delete;
+
+        // 分配size个单位，返回偏移，空间不足返回INVALID_OFFSET
+        size_t Allocate(size_t size)
+        {
+            if (size == 0)
+            {
+                return INVALID_OFFSET;
+            }
+
+            // 最佳适配，取能放下的最小空闲区间
+            auto it = m_freeBySize.lower_bound({ size, 0 });
+            if (it == m_freeBySize.end())
+            {
+                return INVALID_OFFSET;
+            }
+
+            const size_t blockSize = it->first;
+            const size_t offset = it->second;
+            m_freeBySize.erase(it);
+            m_freeByOffset.erase(offset);
+            if (blockSize > size)
+            {
+                insertFree(offset + size, blockSize - size);
+            }
+
+            m_stats.m_used += size;
+            ++m_stats.m_liveCount;
+            ++m_stats.m_allocCount;
+            return offset;
+        }
+
+        // 释放区间，与相邻空闲区间合并
+        void Free(size_t offset, size_t size)
+        {
+            if (offset == INVALID_OFFSET || size == 0)
+            {
+                return;
+            }
+            assert(offset + size <= m_stats.m_capacity);
+            assert(m_stats.m_used >= size && m_stats.m_liveCount > 0);
+
+            m_stats.m_used -= size;
+            --m_stats.m_liveCount;
+            ++m_stats.m_freeCount;
+
+            // 后一个空闲区间紧挨着时合并
+            auto next = m_freeByOffset.lower_bound(offset);
+            assert(next == m_freeByOffset.end() || next->first >= offset + size);
+            if (next != m_freeByOffset.end() && next->first == offset + size)
+            {
+                size += next->second;
+                eraseFree(next);
+                next = m_freeByOffset.lower_bound(offset);
+            }
+            // 前一个空闲区间紧挨着时合并
+            if (next != m_freeByOffset.begin())
+            {
+                auto prev = std::prev(next);
+                assert(prev->first + prev->second <= offset);
+                if (prev->first + prev->second == offset)
+                {
+                    offset = prev->first;
+                    size += prev->second;
+                    eraseFree(prev);
+                }
+            }
+            insertFree(offset, size);
+        }
+
+        // 扩容到newCapacity，新增部分加入空闲区间
+        void Grow(size_t newCapacity)
+        {
+            if (newCapacity <= m_stats.m_capacity)
+            {
+                return;
+            }
+            const size_t oldCapacity = m_stats.m_capacity;
+            const size_t added = newCapacity - oldCapacity;
+            m_stats.m_capacity = newCapacity;
+            if (oldCapacity != 0)
+            {
+                ++m_stats.m_growCount;
+            }
+
+            // 与末尾的空闲区间合并
+            if (!m_freeByOffset.empty())
+            {
+                auto last = std::prev(m_freeByOffset.end());
+                if (last->first + last->second == oldCapacity)
+                {
+                    const size_t offset = last->first;
+                    const size_t size = last->second + added;
+                    eraseFree(last);
+                    insertFree(offset, size);
+                    return;
+                }
+            }
+            insertFree(oldCapacity, added);
+        }
+
+        // 容量
+        size_t GetCapacity() const { return m_stats.m_capacity; }
+        // 统计
+        RangeAllocatorStats GetStats() const
+        {
+            RangeAllocatorStats stats = m_stats;
+            stats.m_freeBlocks = m_freeByOffset.size();
+            stats.m_largestFree = m_freeBySize.empty() ? 0 : std::prev(m_freeBySize.end())->first;
+            return stats;
+        }
+
+    private:
+        void insertFree(size_t offset, size_t size)
+        {
+            m_freeByOffset.emplace(offset, size);
+            m_freeBySize.emplace(size, offset);
+        }
+        void eraseFree(std::map<size_t, size_t>::iterator it)
+        {
+            m_freeBySize.erase({ it->second, it->first });
+            m_freeByOffset.erase(it);
+        }
+
+    private:
+        // 空闲区间，偏移->大小
+        std::map<size_t, size_t> m_freeByOffset;
+        // 空闲区间，按(大小, 偏移)排序
+        std::set<std::pair<size_t, size_t>> m_freeBySize;
+        // 统计
+        RangeAllocatorStats m_stats;
+    };
+}
@@ -0,0 +1,97 @@
+// comment: 货架式矩形装箱，在固定大小的页面中按行(货架)从左到右放置矩形，适合大小相近的图标，只能整页重置
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace sz_ds
+{
+    class ShelfPacker
+    {
+    public:
+        // padding为矩形之间的间隔，避免线性采样时相邻图片渗色
+        ShelfPacker(int32_t width = 0, int32_t height = 0, int32_t padding = 1) :
+            m_width(width), m_height(height), m_padding(padding)
+        {}
+
+        // 分配w*h的矩形，成功时返回左上角坐标
+        bool Allocate(int32_t w, int32_t h, int32_t& x, int32_t& y)
+        {
+            assert(w > 0 && h > 0);
+            const int32_t pw = w + m_padding;
+            const int32_t ph = h + m_padding;
+            if (pw > m_width || ph > m_height)
+            {
+                return false;
+            }
+
+            // 放得下的货架中取高度浪费最少的
+            Shelf* best = nullptr;
+            for (auto& shelf : m_shelves)
+            {
+                if (shelf.m_height < ph || m_width - shelf.m_cursorX < pw)
+                {
+                    continue;
+                }
+                if (!best || shelf.m_height < best->m_height)
+                {
+                    best = &shelf;
+                }
+            }
+
+            // 浪费超过一半高度时宁可开新货架
+            if ((!best || best->m_height > ph * 2) && m_nextY + ph <= m_height)
+            {
+                m_shelves.push_back(Shelf{ m_nextY, ph, 0 });
+                m_nextY += ph;
+                best = &m_shelves.back();
+            }
+            if (!best)
+            {
+                return false;
+            }
+
+            x = best->m_cursorX;
+            y = best->m_y;
+            best->m_cursorX += pw;
+            m_usedArea += int64_t(w) * h;
+            return true;
+        }
+
+        // 清空页面
+        void Reset()
+        {
+            m_shelves.clear();
+            m_nextY = 0;
+            m_usedArea = 0;
+        }
+
+        // 页面宽高
+        int32_t GetWidth() const { return m_width; }
+        int32_t GetHeight() const { return m_height; }
+        // 已放置的矩形面积，不含间隔
+        int64_t GetUsedArea() const { return m_usedArea; }
+        // 货架个数
+        size_t GetShelfCount() const { return m_shelves.size(); }
+
+    private:
+        // 货架
+        struct Shelf
+        {
+            int32_t m_y;
+            int32_t m_height;
+            int32_t m_cursorX;
+        };
+
+        int32_t m_width;
+        int32_t m_height;
+        int32_t m_padding;
+        // 下一个货架的起始y
+        int32_t m_nextY = 0;
+        // 已放置的面积
+        int64_t m_usedArea = 0;
+        std::vector<Shelf> m_shelves;
+    };
+}
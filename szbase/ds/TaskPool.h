@@ -0,0 +1,220 @@
+// comment: 任务池，固定数量的工作线程，ParallelFor时调用线程也参与执行，返回时所有任务都已完成
+// Post投递的异步任务由工作线程在没有ParallelFor时执行，适合解码这类不需要等待结果的工作
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Delegate.h"
+
+namespace sz_ds
+{
+    // 任务池，同一时间只执行一个ParallelFor，只能由一个线程提交，Post可以从任意线程调用
+    class TaskPool
+    {
+    public:
+        // 异步任务，捕获不超过委托内部缓冲区时投递不会分配内存
+        using Task = Delegate<void>;
+
+    private:
+        // 一次ParallelFor，放在提交线程的栈上
+        struct Job
+        {
+            // 类型擦除后的任务
+            void* m_context = nullptr;
+            void (*m_invoke)(void*, size_t) = nullptr;
+            // 任务个数
+            size_t m_count = 0;
+            // 下一个要领取的任务
+            std::atomic<size_t> m_next{ 0 };
+            // 正在执行该Job的工作线程数，受m_mutex保护
+            size_t m_users = 0;
+
+            // 领取任务直到全部领完
+            void Run()
+            {
+                for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+                    i = m_next.fetch_add(1, std::memory_order_relaxed))
+                {
+                    m_invoke(m_context, i);
+                }
+            }
+        };
+
+    private:
+        // 工作线程
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        // 唤醒工作线程
+        std::condition_variable m_wake;
+        // 通知提交线程工作线程已退出Job
+        std::condition_variable m_done;
+        // 当前Job，提交线程等待完成前置空，之后唤醒的工作线程不会再进入
+        Job* m_job = nullptr;
+        // 等待执行的异步任务
+        std::deque<Task> m_tasks;
+        // Job代数，工作线程用来区分新旧Job
+        uint64_t m_generation = 0;
+        // 停止
+        bool m_stop = false;
+        // 当前线程是否在执行任务，嵌套ParallelFor时串行执行
+        static inline thread_local bool t_inTask = false;
+
+    public:
+        // 工作线程数默认为核数减一，调用线程也算一个
+        explicit TaskPool(size_t workerCount = DefaultWorkerCount())
+        {
+            m_workers.reserve(workerCount);
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                m_workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+        // 等待正在执行的异步任务结束，还没开始的丢弃
+        ~TaskPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+                m_tasks.clear();
+            }
+            m_wake.notify_all();
+            for (auto& worker : m_workers)
+            {
+                worker.join();
+            }
+        }
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+    public:
+        // 默认工作线程数
+        static size_t DefaultWorkerCount()
+        {
+            const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+            return cores - 1;
+        }
+        // 获取工作线程数
+        size_t GetWorkerCount() const { return m_workers.size(); }
+        // 对[0, count)的每个下标执行func，调用线程参与执行，返回时全部完成
+        template<typename Func>
+        void ParallelFor(size_t count, Func&& func)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            // 没有工作线程、只有一个任务或者嵌套调用时串行执行
+            if (m_workers.empty() || count == 1 || t_inTask)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            using FuncType = std::remove_reference_t<Func>;
+            Job job;
+            job.m_context = (void*)&func;
+            job.m_invoke = [](void* context, size_t index) { (*static_cast<FuncType*>(context))(index); };
+            job.m_count = count;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                assert(!m_job);
+                m_job = &job;
+                ++m_generation;
+            }
+            m_wake.notify_all();
+
+            t_inTask = true;
+            job.Run();
+            t_inTask = false;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_job = nullptr;
+            m_done.wait(lock, [&job]() { return job.m_users == 0; });
+        }
+
+        // 投递异步任务，由某个工作线程执行，没有工作线程时在调用线程直接执行
+        void Post(Task task)
+        {
+            if (m_workers.empty())
+            {
+                task();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+            m_wake.notify_one();
+        }
+        template<typename HandlerFunc>
+        void Post(HandlerFunc handler)
+        {
+            Task task;
+            task.Bind(std::move(handler));
+            Post(std::move(task));
+        }
+
+    private:
+        void workerLoop()
+        {
+            t_inTask = true;
+            uint64_t seen = 0;
+            while (true)
+            {
+                Job* job = nullptr;
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wake.wait(lock, [this, seen]() {
+                        return m_stop || (m_job && m_generation != seen) || !m_tasks.empty();
+                    });
+                    if (m_stop)
+                    {
+                        return;
+                    }
+                    // 提交线程在等待ParallelFor，优先执行
+                    if (m_job && m_generation != seen)
+                    {
+                        seen = m_generation;
+                        job = m_job;
+                        ++job->m_users;
+                    }
+                    else
+                    {
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+                }
+
+                if (!job)
+                {
+                    task();
+                    continue;
+                }
+
+                job->Run();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--job->m_users == 0)
+                {
+                    m_done.notify_all();
+                }
+            }
+        }
+    };
+}
@@ -4,11 +4,18 @@
 #include <unordered_map>
 
 #include "../ds/Math.h"
+#include "../ds/Handle.h"
 
 namespace sz_gui 
 {
 	// 前置声明
 	class IUIBase;
+	class IUIManager;
+
+	// UI句柄，由UI管理器分配，UI注销后失效
+	using UIHandle = sz_ds::Handle<IUIBase>;
+	// UI管理器句柄
+	using UIManagerHandle = sz_ds::Handle<IUIManager>;
 
 	// 容忍度
 	static constexpr float EPSILON = 0.00001f;
@@ -80,6 +80,19 @@ namespace sz_gui
                 m.m_isPercentage[3] = bIsPct;
                 return m;
             }
+
+            // 根据父容器宽高计算实际像素边距
+            Margins ToPixels(float parentWidth, float parentHeight) const
+            {
+                Margins actual;
+
+                actual.m_left = m_isPercentage[0] ? (m_left * 0.01f * parentWidth) : m_left;
+                actual.m_top = m_isPercentage[1] ? (m_top * 0.01f * parentHeight) : m_top;
+                actual.m_right = m_isPercentage[2] ? (m_right * 0.01f * parentWidth) : m_right;
+                actual.m_bottom = m_isPercentage[3] ? (m_bottom * 0.01f * parentHeight) : m_bottom;
+
+                return actual;
+            }
         };
     }
 
@@ -105,7 +118,11 @@ namespace sz_gui
 		virtual bool AddWidget(std::shared_ptr<IUIBase> widget) = 0;
         // 删除布局控件
         virtual bool DelWidget(std::shared_ptr<IUIBase> widget) = 0;
-        // 执行布局计算
+        // 控件布局约束发生变化，下次布局时重新计算
+        virtual void InvalidateWidget(IUIBase* widget) = 0;
+        // 是否需要重新布局
+        virtual bool IsDirty() const = 0;
+        // 执行布局计算，只计算父容器区域或约束发生变化的控件
         virtual void PerformLayout() = 0;
 	};
 }
\ No newline at end of file
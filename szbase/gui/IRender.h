@@ -4,10 +4,13 @@
 #include <tuple>
 #include <vector>
 #include <cstdint>
+#include <limits>
 
 #include <glm/glm.hpp>
 
 #include "../utils/BitwiseEnum.h"
+#include "../ds/ObjectPool.h"
+#include "../ds/RangeAllocator.h"
 #include "IUIBase.h"
 
 namespace sz_gui
@@ -77,13 +80,9 @@ namespace sz_gui
 		float m_opacity{ 1.0f };
 	};
 
-	// 剪裁测试
-	struct ScissorTest
-	{
-		bool m_scissorTest{ false };
-		int32_t m_x, m_y;
-		int32_t m_width, m_height;
-	};
+	// 不剪裁时的剪裁矩形
+	inline const glm::vec4 NO_CLIP_RECT{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+		std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
 
 	// 上传行为
 	enum class UploadOperation : uint32_t
@@ -103,7 +102,7 @@ namespace sz_gui
 	// 绘制状态
 	enum class RenderState : uint32_t
 	{
-		// 默认scissorTest
+		// 无
 		None = 1 << 0,
 		// 开启面剔除
 		EnableFaceCulling = 1 << 1,
@@ -111,8 +110,6 @@ namespace sz_gui
 		EnableDepthTest = 1 << 3,
 		// 开启混合
 		EnableBlend = 1 << 4,
-		// 开启剪裁设置
-		EnableScissorSet = 1 << 5,
 	};
 
 	// 文字对齐方式
@@ -194,14 +191,91 @@ namespace sz_gui
 		DepthTest m_depthTest;
 		// 混合参数
 		Blend m_blend;
-		// 裁剪测试参数
-		ScissorTest m_scissorTest;
+		// 剪裁矩形，UI坐标(minX, minY, maxX, maxY)，矩形外的片元在着色器中丢弃
+		glm::vec4 m_clipRect = NO_CLIP_RECT;
 		// 文字参数
 		TextInfo m_textInfo;
+		// 贴图材质的图片id，由LoadImageFile返回
+		uint32_t m_imageId = 0;
 		// 顶点数据索引数量
 		size_t m_indexCount = 0;
 	};
 
+	// 渲染对象内存统计
+	struct RenderPoolStats
+	{
+		// 渲染对象
+		sz_ds::PoolStats m_renderItem;
+		// 几何体
+		sz_ds::PoolStats m_geometry;
+		// 几何体GPU堆，单位字节，所有顶点格式合计
+		sz_ds::RangeAllocatorStats m_vertexHeap;
+		sz_ds::RangeAllocatorStats m_indexHeap;
+	};
+
+	// 单帧统计，时间单位为毫秒
+	struct FrameStats
+	{
+		// 帧序号
+		uint64_t m_frameIndex = 0;
+		// 布局耗时
+		double m_layoutMs = 0.0;
+		// 遮挡剔除耗时，包括准备渲染数据
+		double m_occlusionMs = 0.0;
+		// 收集绘制数据耗时，包括顶点生成和上传
+		double m_collectMs = 0.0;
+		// 提交绘制指令耗时
+		double m_submitMs = 0.0;
+		// GPU耗时，结果延迟几帧，不支持计时查询时为负数
+		double m_gpuMs = -1.0;
+		// 绘制调用次数
+		uint32_t m_drawCalls = 0;
+		// 上传到GPU的字节数
+		uint64_t m_uploadBytes = 0;
+		// 通过深度测试写入的片元数，只在过度绘制模式下统计，否则为0
+		uint64_t m_fragments = 0;
+		// 至少写入一次的像素数，只在过度绘制模式下统计
+		uint64_t m_coveredPixels = 0;
+		// 被遮挡剔除跳过的组件数
+		uint32_t m_occludedWidgets = 0;
+	};
+
+	// 绘制命令需要上传的字节数，按接口上的float数据计算，GL渲染器量化后实际上传更少
+	inline uint64_t GetUploadBytes(const DrawCommand& cmd, const std::vector<float>& positions,
+		const std::vector<float>& colorOrUVs, const std::vector<uint32_t>& indices,
+		const std::vector<float>* const layers)
+	{
+		if (cmd.m_uploadOp == UploadOperation::Retain)
+		{
+			return 0;
+		}
+
+		if (cmd.m_materialType == MaterialType::TextMaterial)
+		{
+			if (!sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadText))
+			{
+				return 0;
+			}
+			return (positions.size() + colorOrUVs.size() + (layers ? layers->size() : 0)) * sizeof(float) +
+				indices.size() * sizeof(uint32_t);
+		}
+
+		uint64_t bytes = 0;
+		if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadPos))
+		{
+			bytes += positions.size() * sizeof(float);
+		}
+		if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadColorOrUv))
+		{
+			bytes += colorOrUVs.size() * sizeof(float);
+		}
+		if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadIndex))
+		{
+			bytes += indices.size() * sizeof(uint32_t);
+		}
+		return bytes;
+	}
+
 	// 渲染接口
 	class IRender
 	{
@@ -232,13 +306,21 @@ namespace sz_gui
 		virtual void AppendTextDrawData(const std::vector<float>& positions, 
 			const std::vector<float>& uvs, const std::vector<uint32_t>& indices, 
 			const std::vector<float>& layers, DrawCommand cmd) = 0;
-		// 额外加入绘制指令
-		virtual void ExtraAppendDrawCommand(DrawCommand cmd) = 0;
+		// 异步加载图片到图集，立即返回图片id，路径为空返回0
+		virtual uint32_t LoadImageFile(const std::string&) = 0;
 		// 绘制
 		virtual void Render() = 0;
 		// 窗口大小改变事件
 		virtual void OnWindowResize(int,int) = 0;
 		// 设置颜色主题
 		virtual void SetColorTheme(ColorTheme) = 0;
+		// 预留绘制数据容量，批量创建控件前调用，count为绘制对象个数
+		virtual void ReserveDrawData(size_t count) = 0;
+		// 获取渲染对象内存统计
+		virtual RenderPoolStats GetPoolStats() const = 0;
+		// 获取上一帧的统计，收集和布局耗时由UI管理器填写
+		virtual const FrameStats& GetFrameStats() const = 0;
+		// 是否还有跨帧完成的工作，例如图片解码和分帧上传，有时事件循环不能阻塞等待
+		virtual bool HasPendingWork() const = 0;
 	};
 }
\ No newline at end of file
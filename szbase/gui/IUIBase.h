@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <map>
+#include <optional>
 
 #include <glm/glm.hpp>
 
@@ -22,6 +23,12 @@ namespace sz_gui
 		Visibale = 1 << 1,
 		// 是否可交互
 		Interactive = 1 << 2,
+		// 布局需要更新
+		LayoutDirty = 1 << 3,
+		// 被布局剔除，不在可见区域
+		Culled = 1 << 4,
+		// 被更高层的不透明组件完全遮挡，不收集自身渲染数据
+		Occluded = 1 << 5,
 	};
 
 	USING_BITMASK_OPERATORS()
@@ -39,10 +46,26 @@ namespace sz_gui
 		Frame,
 		// 按钮控件
 		Button,
+		// 虚拟列表控件
+		ListView,
+		// 图片控件
+		Image,
 	};
 
 	// 前置声明
 	class IUIManager;
+	class IRender;
+
+	// 收集渲染数据上下文，只在收集过程中有效，不持有所有权
+	struct RenderContext
+	{
+		// 渲染器
+		IRender* m_render = nullptr;
+		// 父组件区域，顶层UI为窗口区域
+		sz_ds::AABB2D m_parentBox;
+		// 剪裁区域，所有祖先剪裁区域的交集，顶层UI为窗口区域
+		sz_ds::AABB2D m_clipBox;
+	};
 
 	// UI抽象
 	class IUIBase
@@ -65,6 +88,12 @@ namespace sz_gui
 		virtual void SetParent(const std::weak_ptr<IUIBase>&) = 0;
 		// 获取父组件
 		virtual const std::weak_ptr<IUIBase>& GetParent() const = 0;
+		// 获取父组件句柄
+		virtual UIHandle GetParentHandle() const = 0;
+		// 获取在UI管理器中的句柄
+		virtual UIHandle GetHandle() const = 0;
+		// 设置在UI管理器中的句柄
+		virtual void setHandle(UIHandle) = 0;
 		// 添加子组件
 		virtual bool addChild(const std::shared_ptr<IUIBase>&) = 0;
 		// 移除子组件
@@ -112,6 +141,10 @@ namespace sz_gui
 		virtual bool IsVisible() const = 0;
 		// 是否可交互
 		virtual bool IsInteractive() const = 0;
+		// 是否不透明并且填满自身矩形，可以作为遮挡物
+		virtual bool IsOpaque() const = 0;
+		// 子组件的剪裁矩形，没有时子组件沿用父组件的剪裁区域
+		virtual std::optional<sz_ds::Rect> GetChildClipRect() const = 0;
 		// 获取当前UI和父UI的AABB2D交集
 		virtual sz_ds::AABB2D getIntersectWithParent() const = 0;
 		// 鼠标左键点击事件，返回false将会阻止冒泡
@@ -120,16 +153,22 @@ namespace sz_gui
 		virtual void OnMouseLeftButtonDown() = 0;
 		// 鼠标左键抬起事件
 		virtual void OnMouseLeftButtonUp() = 0;
-		// 窗户发生变化事件
-		virtual void OnWindowResize() = 0;
+		// 更新布局，只重新计算约束或父区域发生变化的子组件
+		virtual void UpdateLayout() = 0;
+		// 子组件布局约束发生变化
+		virtual void InvalidateChildLayout(IUIBase*) = 0;
 		// 鼠标移动进入事件
 		virtual void OnMouseMoveEnter() = 0;
 		// 鼠标移动事件
 		virtual void OnMouseMove() = 0;
 		// 鼠标移动离开事件
 		virtual void OnMouseMoveLeave() = 0;
+		// 鼠标滚轮事件，返回true表示已处理，停止冒泡
+		virtual bool OnMouseWheel(float, float) = 0;
+		// 准备渲染数据事件，在遮挡剔除和收集渲染数据之前调用，组件在这里确定子组件的位置和可见性
+		virtual void OnPrepareRenderData() = 0;
 		// 收集渲染数据事件
-		virtual bool OnCollectRenderData() = 0;
+		virtual bool OnCollectRenderData(const RenderContext&) = 0;
 		// 设置颜色主题
 		virtual void SetColorTheme(ColorTheme) = 0;
 	};
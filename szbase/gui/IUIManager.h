@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "IUIBase.h"
+#include "Common.h"
 
 namespace sz_gui 
 {
@@ -13,6 +14,8 @@ namespace sz_gui
 	class IRender;
 	class ILayout;
 	class InputControl;
+	struct FrameStats;
+	class LatencyTracker;
 
 	// UI管理器抽象
 	class IUIManager
@@ -34,6 +37,10 @@ namespace sz_gui
 		virtual void RunBeforWork() = 0;
 		// 获取render
 		virtual const std::shared_ptr<IRender>& GetRender() const = 0;
+		// 获取句柄
+		virtual UIManagerHandle GetHandle() const = 0;
+		// 根据句柄获取UI，句柄失效返回nullptr，不持有所有权
+		virtual IUIBase* GetUI(UIHandle) const = 0;
 		// 注册顶层UI
 		virtual bool RegTopUI(std::shared_ptr<IUIBase>) = 0;
 		// 注销顶层UI
@@ -50,9 +57,35 @@ namespace sz_gui
 		virtual bool LayoutAddWidget(std::shared_ptr<IUIBase>) = 0;
 		// 布局移除widget
 		virtual bool LayoutDelWidget(std::shared_ptr<IUIBase>) = 0;
+		// 顶层布局中widget的布局约束发生变化
+		virtual void InvalidateWidgetLayout(IUIBase*) = 0;
+		// 标记UI布局需要更新，绘制前统一更新
+		virtual void MarkLayoutDirty(UIHandle) = 0;
+		// 标记遮挡剔除需要重新收集组件，组件矩形、Z值、可见性变化时调用，并行布局时会在工作线程调用
+		virtual void InvalidateOcclusion() = 0;
+		// 设置并行布局，workerCount为0时关闭，各脏子树的后代总数达到threshold时才并行
+		virtual void SetParallelLayout(size_t workerCount, size_t threshold) = 0;
 		// 绘制
 		virtual void Render() = 0;
 		// 获取输入控制
 		virtual const InputControl* GetInputControl() const = 0;
+		// 获取上一帧的统计
+		virtual const FrameStats& GetFrameStats() const = 0;
+		// 获取输入延迟跟踪
+		virtual LatencyTracker& GetLatencyTracker() = 0;
+		virtual const LatencyTracker& GetLatencyTracker() const = 0;
+
+	public:
+		// UI管理器句柄表，不持有所有权
+		static sz_ds::HandleTable<IUIManager>& GetHandleTable()
+		{
+			static sz_ds::HandleTable<IUIManager> table;
+			return table;
+		}
+		// 根据句柄获取UI管理器，句柄失效返回nullptr
+		static IUIManager* FromHandle(UIManagerHandle handle)
+		{
+			return GetHandleTable().Get(handle);
+		}
 	};
 }
\ No newline at end of file
@@ -52,4 +52,21 @@ namespace sz_gui
 		m_currentX = event->motion.x;
 		m_currentY = event->motion.y;
 	}
+
+	void InputControl::OnMouseWheel(std::any eventContainer)
+	{
+		const SDL_Event* event = std::any_cast<SDL_Event*>(eventContainer);
+		if (!event)
+		{
+			return;
+		}
+
+		m_currentX = event->wheel.mouse_x;
+		m_currentY = event->wheel.mouse_y;
+
+		// 统一成非翻转方向
+		float direction = (event->wheel.direction == SDL_MOUSEWHEEL_FLIPPED) ? -1.0f : 1.0f;
+		m_wheelX = event->wheel.x * direction;
+		m_wheelY = event->wheel.y * direction;
+	}
 }
\ No newline at end of file
@@ -17,6 +17,8 @@ namespace sz_gui
 		virtual void OnMouseButton(std::any eventContainer);
 		// 鼠标移动事件
 		virtual void OnMouseMotion(std::any eventContainer);
+		// 鼠标滚轮事件
+		virtual void OnMouseWheel(std::any eventContainer);
 
 	public:
 		// 鼠标左键是否按下
@@ -28,5 +30,8 @@ namespace sz_gui
 		// 当前鼠标的位置
 		float m_currentX = 0.0f;
 		float m_currentY = 0.0f;
+		// 最近一次滚轮滚动量，y正数表示向上滚动
+		float m_wheelX = 0.0f;
+		float m_wheelY = 0.0f;
 	};
 }
\ No newline at end of file
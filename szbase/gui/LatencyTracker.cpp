@@ -0,0 +1,124 @@
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace sz_gui
+{
+	namespace
+	{
+		double toMs(uint64_t from, uint64_t to)
+		{
+			return to > from ? double(to - from) / 1e6 : 0.0;
+		}
+
+		double percentile(std::vector<double>& values, size_t numerator)
+		{
+			if (values.empty())
+			{
+				return 0.0;
+			}
+			const size_t index = std::min(values.size() - 1, values.size() * numerator / 100);
+			std::nth_element(values.begin(), values.begin() + index, values.end());
+			return values[index];
+		}
+	}
+
+	LatencyTracker::LatencyTracker(size_t capacity) :
+		m_capacity(std::max<size_t>(capacity, 1))
+	{
+		m_samples.reserve(m_capacity);
+	}
+
+	void LatencyTracker::OnInputBegin(uint64_t timestamp)
+	{
+		const uint64_t now = Now();
+		m_current.m_eventNs = timestamp != 0 && timestamp <= now ? timestamp : now;
+		m_current.m_beginNs = now;
+	}
+
+	void LatencyTracker::OnInputEnd()
+	{
+		m_current.m_endNs = Now();
+		m_pending.push_back(m_current);
+	}
+
+	void LatencyTracker::OnFrameBegin()
+	{
+		m_frameBeginNs = Now();
+	}
+
+	void LatencyTracker::OnFramePresented()
+	{
+		if (m_pending.empty())
+		{
+			return;
+		}
+
+		const uint64_t now = Now();
+		for (const auto& pending : m_pending)
+		{
+			LatencySample sample;
+			sample.m_queueMs = toMs(pending.m_eventNs, pending.m_beginNs);
+			sample.m_waitMs = toMs(pending.m_endNs, m_frameBeginNs);
+			sample.m_frameMs = toMs(m_frameBeginNs, now);
+			sample.m_totalMs = toMs(pending.m_eventNs, now);
+			if (m_samples.size() < m_capacity)
+			{
+				m_samples.push_back(sample);
+			}
+			else
+			{
+				m_samples[m_next] = sample;
+			}
+			m_next = (m_next + 1) % m_capacity;
+			++m_count;
+		}
+		m_pending.resize(0);
+	}
+
+	LatencyStats LatencyTracker::GetStats() const
+	{
+		LatencyStats stats;
+		stats.m_count = m_count;
+		if (m_samples.empty())
+		{
+			return stats;
+		}
+
+		std::vector<double> values(m_samples.size());
+		auto collect = [this, &values](double LatencySample::* field) {
+			for (size_t i = 0; i < m_samples.size(); ++i)
+			{
+				values[i] = m_samples[i].*field;
+			}
+		};
+
+		collect(&LatencySample::m_totalMs);
+		stats.m_maxMs = *std::max_element(values.begin(), values.end());
+		stats.m_p99Ms = percentile(values, 99);
+		stats.m_p95Ms = percentile(values, 95);
+		stats.m_medianMs = percentile(values, 50);
+		collect(&LatencySample::m_queueMs);
+		stats.m_queueMedianMs = percentile(values, 50);
+		collect(&LatencySample::m_waitMs);
+		stats.m_waitMedianMs = percentile(values, 50);
+		collect(&LatencySample::m_frameMs);
+		stats.m_frameMedianMs = percentile(values, 50);
+		return stats;
+	}
+
+	void LatencyTracker::Reset()
+	{
+		m_pending.resize(0);
+		m_samples.resize(0);
+		m_next = 0;
+		m_count = 0;
+	}
+
+	uint64_t LatencyTracker::steadyNow()
+	{
+		return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
@@ -0,0 +1,101 @@
+// comment: 输入延迟统计，从输入事件时间戳到第一次反映该输入的帧呈现完成
+// 窗口大小改变每帧合并为一次记录，从本帧第一次改变算起，渲染器调整缓冲区的耗时算在排队时间里
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace sz_gui
+{
+	// 一次输入的延迟，单位毫秒
+	struct LatencySample
+	{
+		// 事件产生到开始处理
+		double m_queueMs = 0.0;
+		// 处理完到帧开始
+		double m_waitMs = 0.0;
+		// 帧开始到呈现完成，包括布局、收集和提交
+		double m_frameMs = 0.0;
+		// 端到端
+		double m_totalMs = 0.0;
+	};
+
+	// 延迟分布，单位毫秒
+	struct LatencyStats
+	{
+		// 累计记录的输入个数
+		uint64_t m_count = 0;
+		// 以下基于最近的采样
+		double m_medianMs = 0.0;
+		double m_p95Ms = 0.0;
+		double m_p99Ms = 0.0;
+		double m_maxMs = 0.0;
+		// 各阶段中位数
+		double m_queueMedianMs = 0.0;
+		double m_waitMedianMs = 0.0;
+		double m_frameMedianMs = 0.0;
+	};
+
+	// 输入延迟跟踪，事件处理时打上时间戳，帧呈现后把本帧之前处理的输入全部记为该帧反映
+	class LatencyTracker
+	{
+	public:
+		// 时钟，返回纳秒，需要和事件时间戳同一时间基准
+		using Clock = uint64_t(*)();
+
+		// capacity为保留的最近采样个数
+		explicit LatencyTracker(size_t capacity = 1024);
+
+	public:
+		// 设置时钟，SDL事件的时间戳来自SDL_GetTicksNS
+		void SetClock(Clock clock) { m_clock = clock; }
+		// 当前时间，单位纳秒
+		uint64_t Now() const { return m_clock(); }
+		// 输入事件处理前调用，timestamp为事件产生时间，为0时视为当前时间
+		void OnInputBegin(uint64_t timestamp);
+		// 输入事件处理完调用
+		void OnInputEnd();
+		// 帧开始
+		void OnFrameBegin();
+		// 帧呈现完成，记录本帧之前处理的所有输入
+		void OnFramePresented();
+		// 获取延迟分布
+		LatencyStats GetStats() const;
+		// 最近的采样，环形存放，顺序不保证
+		const std::vector<LatencySample>& GetSamples() const { return m_samples; }
+		// 清空采样
+		void Reset();
+
+	private:
+		// 默认时钟
+		static uint64_t steadyNow();
+
+	private:
+		// 已处理还未呈现的输入
+		struct Pending
+		{
+			uint64_t m_eventNs = 0;
+			uint64_t m_beginNs = 0;
+			uint64_t m_endNs = 0;
+		};
+
+		// 时钟
+		Clock m_clock = &steadyNow;
+		// 已处理还未呈现的输入
+		std::vector<Pending> m_pending;
+		// 当前正在处理的输入
+		Pending m_current;
+		// 帧开始时间
+		uint64_t m_frameBeginNs = 0;
+		// 最近的采样
+		std::vector<LatencySample> m_samples;
+		// 采样容量
+		size_t m_capacity;
+		// 下一个写入位置
+		size_t m_next = 0;
+		// 累计记录的输入个数
+		uint64_t m_count = 0;
+	};
+}
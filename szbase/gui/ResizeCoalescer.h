@@ -0,0 +1,54 @@
+// comment: 窗口大小改变合并，拖动窗口边缘一帧内会收到大量事件，只保留最后一次，绘制前统一处理
+
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdint>
+
+namespace sz_gui
+{
+	class ResizeCoalescer
+	{
+	public:
+		// 记录窗口大小改变事件，覆盖本帧之前记录的事件
+		void Push(const SDL_Event& event)
+		{
+			if (m_pending)
+			{
+				++m_coalescedCount;
+			}
+			else
+			{
+				m_firstTimestamp = event.common.timestamp;
+			}
+			m_event = event;
+			m_pending = true;
+		}
+		// 取出本帧最后一次事件，时间戳改为本帧第一次事件的，延迟从开始拖动算起，没有时返回false
+		bool Take(SDL_Event& event)
+		{
+			if (!m_pending)
+			{
+				return false;
+			}
+			m_pending = false;
+			event = m_event;
+			event.common.timestamp = m_firstTimestamp;
+			return true;
+		}
+		// 是否有待处理的事件
+		bool IsPending() const { return m_pending; }
+		// 累计被合并丢弃的事件数
+		uint64_t GetCoalescedCount() const { return m_coalescedCount; }
+
+	private:
+		// 本帧最后一次事件
+		SDL_Event m_event{};
+		// 本帧第一次事件的时间戳
+		uint64_t m_firstTimestamp = 0;
+		bool m_pending = false;
+		// 累计被合并丢弃的事件数
+		uint64_t m_coalescedCount = 0;
+	};
+}
@@ -31,7 +31,10 @@ namespace sz_gui
         return { std::move(errMsg), true };
     }
 
-    SDLApp::SDLApp() {}
+    SDLApp::SDLApp()
+    {
+        m_wakeEventType = SDL_RegisterEvents(1);
+    }
 
     SDLApp::~SDLApp()
     {
@@ -95,6 +98,8 @@ namespace sz_gui
 
         m_uiManager = std::make_shared<UIManager>(m_render);
         m_uiManager->Init(width, height);
+        // 和事件时间戳使用同一个时钟
+        m_uiManager->GetLatencyTracker().SetClock(&SDL_GetTicksNS);
 
         return { std::move(errMsg), true };
     }
@@ -110,10 +115,15 @@ namespace sz_gui
         SDL_Event event{};
 
         m_uiManager->RunBeforWork();
+        // 先出一帧，之后没有事件时循环会阻塞
+        m_uiManager->Render();
 
         while (running)
         {
-            while (SDL_PollEvent(&event))
+            // 没有跨帧的工作时阻塞到有事件为止，其他线程投递任务会推送唤醒事件
+            const Sint32 timeoutMs = m_render->HasPendingWork() ? 0 : -1;
+            bool hasEvent = SDL_WaitEventTimeout(&event, timeoutMs);
+            for (; hasEvent; hasEvent = SDL_PollEvent(&event))
             {
                 if (event.type == SDL_EVENT_QUIT)
                 {
@@ -121,16 +131,64 @@ namespace sz_gui
                 }
                 else if (event.type == SDL_EVENT_WINDOW_RESIZED)
                 {
-                    m_width = event.window.data1;
-                    m_height = event.window.data2;
-                    m_render->OnWindowResize(m_width, m_height);
+                    // 拖动窗口边缘会产生大量事件，只记录最后一次
+                    m_resizeCoalescer.Push(event);
+                    continue;
+                }
+                else if (m_wakeEventType != 0 && event.type == m_wakeEventType)
+                {
+                    // 只用来唤醒事件循环，任务在下面统一执行
+                    continue;
                 }
                 m_uiManager->HandleEvent(&event);
             }
+            flushResize();
+            drainUITasks();
             m_uiManager->Render();
         }
     }
 
+    void SDLApp::flushResize()
+    {
+        SDL_Event event{};
+        if (!m_resizeCoalescer.Take(event))
+        {
+            return;
+        }
+
+        m_width = event.window.data1;
+        m_height = event.window.data2;
+        m_render->OnWindowResize(m_width, m_height);
+        m_uiManager->HandleEvent(&event);
+    }
+
+    void SDLApp::PostToUI(UITask task)
+    {
+        m_uiTasks.Push(std::move(task));
+
+        // 事件循环阻塞等待时靠SDL事件唤醒
+        if (m_wakeEventType != 0 && !m_wakePending.exchange(true, std::memory_order_acq_rel))
+        {
+            SDL_Event wake{};
+            wake.type = m_wakeEventType;
+            SDL_PushEvent(&wake);
+        }
+    }
+
+    void SDLApp::drainUITasks()
+    {
+        // 先清标记，执行期间新投递的任务会重新唤醒
+        // 用读改写清除，和生产者的exchange同步，生产者看到标记还在时它的任务一定能在下面取到
+        // 单纯store后再读队列会被重排到store前面，生产者跳过唤醒，任务就留在队列里
+        m_wakePending.exchange(false, std::memory_order_acq_rel);
+
+        UITask task;
+        while (m_uiTasks.TryPop(task))
+        {
+            task();
+        }
+    }
+
     void SDLApp::DoRender()
     {
         m_uiManager->Render();
@@ -186,4 +244,26 @@ namespace sz_gui
         
 		return m_uiManager->LayoutDelWidget(widget);
 	}
+
+	bool SDLApp::SetParallelLayout(size_t workerCount, size_t threshold)
+	{
+        if (!m_uiManager)
+        {
+            return false;
+        }
+
+		m_uiManager->SetParallelLayout(workerCount, threshold);
+		return true;
+	}
+
+    const FrameStats& SDLApp::GetFrameStats() const
+    {
+        static const FrameStats empty;
+        return m_uiManager ? m_uiManager->GetFrameStats() : empty;
+    }
+
+    LatencyStats SDLApp::GetLatencyStats() const
+    {
+        return m_uiManager ? m_uiManager->GetLatencyTracker().GetStats() : LatencyStats{};
+    }
 }
\ No newline at end of file
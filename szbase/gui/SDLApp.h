@@ -6,14 +6,24 @@
 #include <string>
 #include <tuple>
 #include <memory>
+#include <atomic>
 
 #include "IRender.h"
 #include "IUIManager.h"
+#include "LatencyTracker.h"
+#include "ResizeCoalescer.h"
+#include "../ds/Delegate.h"
+#include "../ds/EventBus.h"
+#include "../ds/MPSCQueue.h"
 
 namespace sz_gui 
 {
 	class SDLApp 
 	{
+	public:
+		// UI线程任务，捕获不超过委托内部缓冲区时投递不会分配内存
+		using UITask = sz_ds::Delegate<void>;
+
 	public:
 		// 初始化SDL
 		static std::tuple<std::string, bool> InitSDL();
@@ -41,6 +51,33 @@ namespace sz_gui
 		bool LayoutAddWidget(std::shared_ptr<IUIBase> widget);
 		// 布局移除widget
 		bool LayoutDelWidget(std::shared_ptr<IUIBase> widget);
+		// 设置并行布局，workerCount为0时关闭
+		bool SetParallelLayout(size_t workerCount, size_t threshold);
+		// 获取上一帧的统计
+		const FrameStats& GetFrameStats() const;
+		// 获取输入到呈现的延迟分布
+		LatencyStats GetLatencyStats() const;
+		// 从任意线程投递任务，在UI线程处理完本帧事件之后、布局和绘制之前执行
+		void PostToUI(UITask task);
+		template<typename HandlerFunc>
+		void PostToUI(HandlerFunc handler)
+		{
+			UITask task;
+			task.Bind(std::move(handler));
+			PostToUI(std::move(task));
+		}
+		// 从任意线程投递事件，在UI线程发布到全局事件总线
+		template<typename EventType>
+		void PostEvent(typename EventType::Type data)
+		{
+			PostToUI([data]() { sz_ds::PublishEvent<EventType>(data); });
+		}
+
+	private:
+		// 处理本帧合并后的窗口大小改变
+		void flushResize();
+		// 执行其他线程投递的任务
+		void drainUITasks();
 
 	private:
 		// SDL窗口指针
@@ -53,5 +90,13 @@ namespace sz_gui
 		// 窗口宽高
 		int m_width = 0;
 		int m_height = 0;
+		// 窗口大小改变合并，每帧只处理一次
+		ResizeCoalescer m_resizeCoalescer;
+		// 其他线程投递的任务
+		sz_ds::MPSCQueue<UITask> m_uiTasks;
+		// 唤醒事件类型
+		Uint32 m_wakeEventType = 0;
+		// 已经投递了唤醒事件还未处理，一批任务只唤醒一次
+		std::atomic<bool> m_wakePending{ false };
 	};
 }
\ No newline at end of file
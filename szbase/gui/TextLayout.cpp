@@ -0,0 +1,185 @@
+#include "TextLayout.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace sz_gui
+{
+	void TextLayout::SetFontMetrics(float ascent, float descent, float lineGap, float scale)
+	{
+		m_ascent = ascent;
+		m_descent = descent;
+		m_lineGap = lineGap;
+		m_scale = scale;
+	}
+
+	void TextLayout::SetAtlas(uint32_t width, uint32_t height, int32_t maxLayer)
+	{
+		m_atlasWidth = std::max(1u, width);
+		m_atlasHeight = std::max(1u, height);
+		m_maxLayer = maxLayer;
+	}
+
+	void TextLayout::AddGlyph(int32_t codepoint, const TextGlyph& glyph)
+	{
+		m_glyphs[codepoint] = glyph;
+	}
+
+	const TextGlyph* TextLayout::FindGlyph(int32_t codepoint) const
+	{
+		auto it = m_glyphs.find(codepoint);
+		return it != m_glyphs.end() ? &it->second : nullptr;
+	}
+
+	bool TextLayout::Layout(const TextAlignment ta, const float areaWidth, const float areaHeight,
+		const std::vector<int32_t>& codepoints, std::vector<float>& positions,
+		std::vector<float>& uvs, std::vector<uint32_t>& indices, std::vector<float>& layers)
+	{
+		if (codepoints.empty() || areaWidth < 0.0001f || areaHeight < 0.0001f)
+		{
+			return false;
+		}
+
+		// 顶点位置超出定点数范围会被截断，区域过大时按最大范围排版
+		const float limitWidth = std::min(areaWidth, MAX_EXTENT);
+		const float limitHeight = std::min(areaHeight, MAX_EXTENT);
+
+		positions.clear();
+		uvs.clear();
+		indices.clear();
+		layers.clear();
+
+		// 字形只查找一次，后面几遍都直接使用
+		m_lineGlyphs.clear();
+		m_lineGlyphs.reserve(codepoints.size());
+		for (int32_t codepoint : codepoints)
+		{
+			const TextGlyph* glyph = FindGlyph(codepoint);
+			if (!glyph || glyph->m_layer < 0 || glyph->m_layer > m_maxLayer)
+			{
+				return false;
+			}
+			m_lineGlyphs.push_back(glyph);
+		}
+
+		// 一个字符框从最高点到最低点，再加上额外行间距的总垂直高度
+		const float lineHeight = (m_ascent - m_descent + m_lineGap) * m_scale;
+
+		// 不缩放情况下计算绘制文本需要的总高度和总宽度
+		float maxWidth = 0.0f;
+		float maxHeight = 0.0f;
+		measure(1.0f, limitWidth, maxWidth, maxHeight);
+
+		// 缩放比例取最小值
+		const float scaleX = maxWidth > limitWidth ? limitWidth / maxWidth : 1.0f;
+		const float scaleY = maxHeight > limitHeight ? limitHeight / maxHeight : 1.0f;
+		const float scale = std::min(scaleX, scaleY);
+
+		// 缩放以后，存在以前需要3行变成2行或者1行就够了
+		measure(scale, limitWidth, maxWidth, maxHeight);
+
+		// 水平偏移量
+		float horizontalOffset = 0.0f;
+		// 垂直偏移量
+		float verticalOffset = 0.0f;
+		if (ta == (TextAlignment::HCenter | TextAlignment::VCenter))
+		{
+			if (maxWidth < limitWidth)
+			{
+				horizontalOffset = (limitWidth - maxWidth) / 2.0f;
+			}
+
+			if (maxHeight < limitHeight)
+			{
+				verticalOffset = (limitHeight - maxHeight) / 2.0f;
+			}
+		}
+		else
+		{
+			assert(0);
+		}
+
+		const size_t count = m_lineGlyphs.size();
+		positions.reserve(count * 12);
+		uvs.reserve(count * 8);
+		indices.reserve(count * 6);
+		layers.reserve(count * 4);
+
+		// 重新布局并生成顶点数据
+		const float texWidth = static_cast<float>(m_atlasWidth);
+		const float texHeight = static_cast<float>(m_atlasHeight);
+		const float baseline = m_ascent * m_scale * scale;
+		float currentX = 0.0f;
+		float currentY = 0.0f;
+		uint32_t vertexOffset = 0;
+		for (const TextGlyph* glyph : m_lineGlyphs)
+		{
+			// 换行判断
+			if (currentX + glyph->m_xadvance * scale > limitWidth)
+			{
+				currentX = 0.0f;
+				currentY += lineHeight * scale;
+			}
+
+			// 字符左上角，yoff为基线到字符顶部的距离，通常是负数
+			const float charX = horizontalOffset + currentX + glyph->m_xoff * scale;
+			const float charY = verticalOffset + currentY + baseline + glyph->m_yoff * scale;
+			const float charW = (glyph->m_x1 - glyph->m_x0) * scale;
+			const float charH = (glyph->m_y1 - glyph->m_y0) * scale;
+
+			// 纹理坐标，标准化
+			const float u0 = glyph->m_x0 / texWidth;
+			const float v0 = glyph->m_y0 / texHeight;
+			const float u1 = glyph->m_x1 / texWidth;
+			const float v1 = glyph->m_y1 / texHeight;
+
+			// 位置数据，左下、右下、右上、左上
+			positions.insert(positions.end(),
+			{
+				charX, charY + charH, 0.0f,
+				charX + charW, charY + charH, 0.0f,
+				charX + charW, charY, 0.0f,
+				charX, charY, 0.0f
+			});
+
+			// UV数据
+			uvs.insert(uvs.end(), { u0, v1, u1, v1, u1, v0, u0, v0 });
+
+			// 索引数据，每个字符2个顺时针三角形
+			indices.insert(indices.end(),
+			{
+				vertexOffset, vertexOffset + 2, vertexOffset + 1,
+				vertexOffset, vertexOffset + 3, vertexOffset + 2
+			});
+
+			// 纹理层数据
+			const float layer = float(glyph->m_layer);
+			layers.insert(layers.end(), { layer, layer, layer, layer });
+
+			currentX += glyph->m_xadvance * scale;
+			vertexOffset += 4;
+		}
+
+		return !positions.empty();
+	}
+
+	void TextLayout::measure(float scale, float limitWidth, float& maxWidth, float& maxHeight) const
+	{
+		const float lineHeight = (m_ascent - m_descent + m_lineGap) * m_scale * scale;
+		float currentX = 0.0f;
+		maxWidth = 0.0f;
+		maxHeight = lineHeight;
+		for (const TextGlyph* glyph : m_lineGlyphs)
+		{
+			const float advance = glyph->m_xadvance * scale;
+			if (currentX + advance > limitWidth)
+			{
+				maxWidth = std::max(maxWidth, currentX);
+				currentX = 0.0f;
+				maxHeight += lineHeight;
+			}
+			currentX += advance;
+		}
+		maxWidth = std::max(maxWidth, currentX);
+	}
+}
@@ -0,0 +1,79 @@
+// comment: 文字排版，根据字形度量生成文字顶点数据，不依赖图形接口
+
+#pragma once
+
+#include "IRender.h"
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace sz_gui
+{
+	// 字形度量，坐标单位为图集像素
+	struct TextGlyph
+	{
+		// 所在纹理层
+		int32_t m_layer = 0;
+		// 在图集中的左上角和右下角
+		float m_x0 = 0.0f;
+		float m_y0 = 0.0f;
+		float m_x1 = 0.0f;
+		float m_y1 = 0.0f;
+		// 从原点到字符左边缘和顶部的距离
+		float m_xoff = 0.0f;
+		float m_yoff = 0.0f;
+		// 绘制完该字符后光标的水平移动距离
+		float m_xadvance = 0.0f;
+	};
+
+	// 文字排版
+	class TextLayout
+	{
+	public:
+		// 排版区域的最大宽高，文字顶点位置是1/16像素的int16定点数，只能表示±2047像素
+		// 留出字形超出步进宽度的余量，限定区域比这个大时按这个大小折行、缩放和居中
+		static constexpr float MAX_EXTENT = 2016.0f;
+
+	public:
+		TextLayout() = default;
+
+	public:
+		// 设置字体垂直度量，单位为字体设计单位，scale转换到像素
+		void SetFontMetrics(float ascent, float descent, float lineGap, float scale);
+		// 设置图集尺寸和最大纹理层
+		void SetAtlas(uint32_t width, uint32_t height, int32_t maxLayer);
+		// 添加字形
+		void AddGlyph(int32_t codepoint, const TextGlyph& glyph);
+		// 查找字形，不存在返回nullptr
+		const TextGlyph* FindGlyph(int32_t codepoint) const;
+		// 在限定区域内排版，超出时整体缩小，生成位置、UV、索引和纹理层数据
+		// 限定区域每边最多MAX_EXTENT，单行文字不会超过这个宽度
+		bool Layout(const TextAlignment ta, const float limitWidth, const float limitHeight,
+			const std::vector<int32_t>& codepoints, std::vector<float>& positions,
+			std::vector<float>& uvs, std::vector<uint32_t>& indices, std::vector<float>& layers);
+
+	private:
+		// 按限定宽度折行，返回最宽行宽度和总高度
+		void measure(float scale, float limitWidth, float& maxWidth, float& maxHeight) const;
+
+	private:
+		// codepoint->字形
+		std::unordered_map<int32_t, TextGlyph> m_glyphs;
+		// 本次排版的字形，只查找一次
+		std::vector<const TextGlyph*> m_lineGlyphs;
+		// 基线到字体中最高字符的距离
+		float m_ascent = 0.0f;
+		// 基线到字体中最低字符的距离
+		float m_descent = 0.0f;
+		// 行间距
+		float m_lineGap = 0.0f;
+		// 字体设计单位到像素的转换比例
+		float m_scale = 0.0f;
+		// 图集尺寸
+		uint32_t m_atlasWidth = 1;
+		uint32_t m_atlasHeight = 1;
+		// 最大纹理层
+		int32_t m_maxLayer = 0;
+	};
+}
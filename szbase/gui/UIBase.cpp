@@ -4,8 +4,8 @@ namespace sz_gui
 {
 	void UIBase::SetUIManager(const std::weak_ptr<IUIManager>& uiManger)
 	{
-		assert(!uiManger.expired());
 		m_uiManager = uiManger;
+		m_uiManagerHandle = uiManger.expired() ? UIManagerHandle{} : uiManger.lock()->GetHandle();
 	}
 
 	void UIBase::SetParent(const std::weak_ptr<IUIBase>& parent)
@@ -20,6 +20,7 @@ namespace sz_gui
 				ok = m_parent.lock()->removeChild(shared_from_this());
 				if (!ok) [[unlikely]] assert(0);
 				m_parent = parent;
+				m_parentHandle = parent.lock()->GetHandle();
 				ok = parent.lock()->addChild(shared_from_this());
 				if (!ok) [[unlikely]] assert(0);
 			}
@@ -27,10 +28,11 @@ namespace sz_gui
 			{
 				// 没有父亲，直接设置
 				m_parent = parent;
+				m_parentHandle = parent.lock()->GetHandle();
 				ok = parent.lock()->addChild(shared_from_this());
 				if (!ok) [[unlikely]] assert(0);
 				// 还要加入到全局
-				m_uiManager = parent.lock()->GetUIManager();
+				SetUIManager(parent.lock()->GetUIManager());
 				ok = m_uiManager.lock()->RegUI(shared_from_this());
 				if (!ok) [[unlikely]] assert(0);
 			}
@@ -46,6 +48,73 @@ namespace sz_gui
 			ok = m_uiManager.lock()->UnRegUI(shared_from_this());
 			if (!ok) [[unlikely]] assert(0);
 			m_parent.reset();
+			m_parentHandle = UIHandle{};
+		}
+	}
+
+	void UIBase::SetRect(const sz_ds::Rect& rect)
+	{
+		auto old = GetRect();
+		if (old == rect)
+		{
+			return;
+		}
+
+		m_x = rect.m_x;
+		m_y = rect.m_y;
+		m_width = rect.m_width;
+		m_height = rect.m_height;
+
+		// 顶点相对于组件左上角，只移动位置不需要重新上传
+		bool resized = !sz_ds::float_equal(old.m_width, rect.m_width) ||
+			!sz_ds::float_equal(old.m_height, rect.m_height);
+		if (resized)
+		{
+			setUploadOp(UploadOperation::UploadPos);
+			setUploadOp(UploadOperation::UploadText);
+		}
+		onRectChanged(resized);
+		invalidateOcclusion();
+	}
+
+	void UIBase::InvalidateLayout()
+	{
+		if (HasUIFlag(UIFlag::LayoutDirty))
+		{
+			return;
+		}
+
+		SetUIFlag(UIFlag::LayoutDirty);
+		// 未注册时由注册流程加入更新队列
+		auto uiManager = getUIManagerRaw();
+		if (uiManager && !m_handle.IsNull())
+		{
+			uiManager->MarkLayoutDirty(m_handle);
+		}
+	}
+
+	void UIBase::invalidateParentLayout()
+	{
+		auto parent = getParentRaw();
+		if (parent)
+		{
+			parent->InvalidateChildLayout(this);
+			return;
+		}
+
+		auto uiManager = getUIManagerRaw();
+		if (uiManager)
+		{
+			uiManager->InvalidateWidgetLayout(this);
+		}
+	}
+
+	void UIBase::invalidateOcclusion() const
+	{
+		auto uiManager = getUIManagerRaw();
+		if (uiManager)
+		{
+			uiManager->InvalidateOcclusion();
 		}
 	}
 
@@ -99,11 +168,12 @@ namespace sz_gui
 
 	sz_ds::AABB2D UIBase::getIntersectWithParent() const
 	{
-		if (m_parent.expired()) 
+		auto parent = getParentRaw();
+		if (!parent) 
 		{
 			return sz_ds::AABB2D(0.f, 0.f, 0.f, 0.f);
 		}
 		
-		return GetRect().ToAABB2D().Intersection(m_parent.lock()->GetRect().ToAABB2D());
+		return GetRect().ToAABB2D().Intersection(parent->GetRect().ToAABB2D());
 	}
 }
\ No newline at end of file
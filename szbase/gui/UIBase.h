@@ -41,6 +41,12 @@ namespace sz_gui
 		void SetParent(const std::weak_ptr<IUIBase>& parent) override;
 		// 获取父组件
 		const std::weak_ptr<IUIBase>& GetParent() const override { return m_parent; }
+		// 获取父组件句柄
+		UIHandle GetParentHandle() const override { return m_parentHandle; }
+		// 获取在UI管理器中的句柄
+		UIHandle GetHandle() const override { return m_handle; }
+		// 设置在UI管理器中的句柄
+		void setHandle(UIHandle handle) override { m_handle = handle; }
 		// 获取对应在父组件中的ID
 		uint64_t GetChildIdForUIBase() const override { return m_childIdForUIBase; }
 		// 获取对应在UI管理器中的ID
@@ -58,7 +64,15 @@ namespace sz_gui
 		// 判断点是否在组件内
 		bool ContainsPoint(float x, float y) const override;
 		// 设置UI的ZValue
-		void SetZValue(float z) override { m_z = z; }
+		void SetZValue(float z) override
+		{
+			if (m_z == z)
+			{
+				return;
+			}
+			m_z = z;
+			invalidateOcclusion();
+		}
 		// 获取UI的ZValue
 		float GetZValue() const override { return m_z; }
 		// 获取宽高
@@ -66,14 +80,8 @@ namespace sz_gui
 		float GetHeight() const override { return m_height; };
 		// 获取矩形
 		const sz_ds::Rect GetRect() const override { return sz_ds::Rect{ m_x, m_y, m_width, m_height }; }
-		// 设置矩形
-		void SetRect(const sz_ds::Rect& rect)
-		{
-			m_x = rect.m_x;
-			m_y = rect.m_y;
-			m_width = rect.m_width;
-			m_height = rect.m_height;
-		}
+		// 设置矩形，尺寸变化时才重新上传顶点
+		void SetRect(const sz_ds::Rect& rect) override;
 		// 获取期望宽高
 		std::tuple<float, float> GetDisireWH() const override { return { m_desireWidth, m_desireHeight }; }
 		// 获取坐标
@@ -82,27 +90,49 @@ namespace sz_gui
 		layout::AnchorPoint GetAnchorPoint() const override { return m_anchorPoint; };
 		// 获取边距
 		layout::Margins GetMargins() const override  { return m_margins; };
+		// 设置AnchorPoint
+		void SetAnchorPoint(layout::AnchorPoint type)
+		{
+			m_anchorPoint = type;
+			invalidateParentLayout();
+		}
+		// 设置边距
+		void SetMargins(layout::Margins margins)
+		{
+			m_margins = std::move(margins);
+			invalidateParentLayout();
+		}
+		// 设置期望宽高
+		void SetDisireWH(uint32_t desiredW, uint32_t desiredH)
+		{
+			m_desireWidth = (float)desiredW;
+			m_desireHeight = (float)desiredH;
+			invalidateParentLayout();
+		}
 		// 鼠标左键点击事件，返回false将会阻止冒泡
 		bool OnMouseLeftButtonClick() override  { return false; };
 		// 鼠标左键按下事件
 		void OnMouseLeftButtonDown() override  { return; };
 		// 鼠标左键抬起事件
 		void OnMouseLeftButtonUp() override  { return; };
-		// 窗户发生变化事件
-		void OnWindowResize() override 
-		{ 
-			setUploadOp(UploadOperation::UploadPos);
-			setUploadOp(UploadOperation::UploadText);
-			return; 
-		};
+		// 更新布局
+		void UpdateLayout() override { ClearUIFlag(UIFlag::LayoutDirty); }
+		// 子组件布局约束发生变化
+		void InvalidateChildLayout(IUIBase*) override {}
+		// 标记布局需要更新，绘制前由UI管理器统一更新
+		void InvalidateLayout();
 		// 鼠标移动进入事件
 		void OnMouseMoveEnter() {};
 		// 鼠标移动事件
 		void OnMouseMove() {};
 		// 鼠标移动离开事件
 		void OnMouseMoveLeave() {};
+		// 鼠标滚轮事件，返回true表示已处理，停止冒泡
+		bool OnMouseWheel(float, float) override { return false; };
+		// 准备渲染数据事件
+		void OnPrepareRenderData() override {};
 		// 收集渲染数据事件
-		bool OnCollectRenderData() override { return false; };
+		bool OnCollectRenderData(const RenderContext&) override { return false; };
 		// 获取名称
 		const std::string& GetName() override 
 		{ 
@@ -113,21 +143,31 @@ namespace sz_gui
 			return m_fullName;
 		};
 		// 设置UI标记
-		void SetUIFlag(UIFlag flag) override  { m_flag |= flag; }
+		void SetUIFlag(UIFlag flag) override  { setUIFlags(m_flag | flag); }
 		// 清除UI标记
-		void ClearUIFlag(UIFlag flag) override { m_flag &= ~flag; }
+		void ClearUIFlag(UIFlag flag) override { setUIFlags(m_flag & ~flag); }
 		// 是否有UI标记
 		bool HasUIFlag(UIFlag flag) const override { return HasFlag(m_flag, flag); }
 		// 是否可见
 		virtual bool IsVisible() const override
 		{
-			return HasUIFlag(UIFlag::Visibale);
+			return HasUIFlag(UIFlag::Visibale) && !HasUIFlag(UIFlag::Culled);
 		}
 		// 是否可交互
 		virtual bool IsInteractive() const override
 		{
 			return HasUIFlag(UIFlag::Interactive);
 		}
+		// 默认不作为遮挡物
+		virtual bool IsOpaque() const override
+		{
+			return false;
+		}
+		// 默认不剪裁子组件
+		virtual std::optional<sz_ds::Rect> GetChildClipRect() const override
+		{
+			return std::nullopt;
+		}
 		// 获取当前UI和父UI的AABB2D交集
 		sz_ds::AABB2D getIntersectWithParent() const override;
 		// 设置颜色主题
@@ -138,6 +178,62 @@ namespace sz_gui
 		}
 
 	protected:
+		// 矩形发生变化，resized表示宽高是否变化
+		virtual void onRectChanged(bool /*resized*/) {}
+		// 通知父布局本组件约束发生变化
+		void invalidateParentLayout();
+		// 通知UI管理器重新收集遮挡剔除的组件
+		void invalidateOcclusion() const;
+		// 替换UI标记，可见性变化时重新收集遮挡剔除的组件
+		void setUIFlags(UIFlag flag)
+		{
+			const auto visibility = UIFlag::Visibale | UIFlag::Culled;
+			const bool changed = (m_flag & visibility) != (flag & visibility);
+			m_flag = flag;
+			if (changed)
+			{
+				invalidateOcclusion();
+			}
+		}
+		// 获取UI管理器，不增加引用计数
+		IUIManager* getUIManagerRaw() const { return IUIManager::FromHandle(m_uiManagerHandle); }
+		// 获取父组件，不增加引用计数
+		IUIBase* getParentRaw() const
+		{
+			auto uiManager = getUIManagerRaw();
+			return uiManager ? uiManager->GetUI(m_parentHandle) : nullptr;
+		}
+		// 获取当前UI和上下文中父组件区域的交集
+		sz_ds::AABB2D getIntersectWithParent(const RenderContext& ctx) const
+		{
+			return GetRect().ToAABB2D().Intersection(ctx.m_parentBox);
+		}
+		// 和父组件区域或者剪裁区域不相交，整个子树都不可见，不用收集渲染数据，已上传的GPU资源保留到重新可见
+		bool isOutsideContext(const RenderContext& ctx) const
+		{
+			const auto box = GetRect().ToAABB2D();
+			return box.Intersection(ctx.m_parentBox).IsNull() || box.Intersection(ctx.m_clipBox).IsNull();
+		}
+		// 生成子组件的收集渲染数据上下文，有子组件剪裁矩形时和父组件剪裁区域取交集
+		RenderContext makeChildContext(const RenderContext& ctx) const
+		{
+			auto clip = GetChildClipRect();
+			if (!clip)
+			{
+				return RenderContext{ ctx.m_render, GetRect().ToAABB2D(), ctx.m_clipBox };
+			}
+			return RenderContext{ ctx.m_render, GetRect().ToAABB2D(), clip->ToAABB2D().Intersection(ctx.m_clipBox) };
+		}
+		// 上下文剪裁区域转成绘制命令的剪裁矩形，完全在剪裁区域内时不剪裁，着色器不用discard
+		glm::vec4 getClipRect(const RenderContext& ctx) const
+		{
+			const auto& box = ctx.m_clipBox;
+			if (box.Contains(GetRect().ToAABB2D()))
+			{
+				return NO_CLIP_RECT;
+			}
+			return glm::vec4(box.GetMinimum(), box.GetMaximum());
+		}
 		// 获取上传操作
 		UploadOperation getUploadOp()  
 		{
@@ -155,8 +251,14 @@ namespace sz_gui
 	protected:
 		// UI管理器
 		std::weak_ptr<IUIManager> m_uiManager;
+		// UI管理器句柄
+		UIManagerHandle m_uiManagerHandle;
 		// 父组件
 		std::weak_ptr<IUIBase> m_parent;
+		// 父组件句柄
+		UIHandle m_parentHandle;
+		// 在UI管理器中的句柄
+		UIHandle m_handle;
 		// 孩子组件们，按照Z值由小到大排序，Z值一样按照创建顺序排序
 		ChildMultimap m_childMultimap;
 		// 孩子组件Id <-> 孩子组件迭代器
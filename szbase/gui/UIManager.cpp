@@ -4,15 +4,20 @@
 #include <SDL3/SDL.h>
 
 #include <map>
+#include <algorithm>
+#include <chrono>
 
 namespace sz_gui
 {
 	UIManager::UIManager(std::shared_ptr<IRender> render) :
 		m_render(render)
-	{ }
+	{
+		m_handle = IUIManager::GetHandleTable().Insert(this);
+	}
 
 	UIManager::~UIManager() 
 	{
+		IUIManager::GetHandleTable().Remove(m_handle);
 		m_render = nullptr;
 	}
 
@@ -26,12 +31,7 @@ namespace sz_gui
     {
         // 重新布局
         m_layout->SetParentRect({ 0.0f, 0.0f, (float)m_width, (float)m_height });
-        m_layout->PerformLayout();
-        // 子组件重新布局
-        for (auto& it : m_topUIMultimap)
-        {
-            it.second->OnWindowResize();
-        }
+        updateLayout();
     }
 
     bool UIManager::RegTopUI(std::shared_ptr<IUIBase> topUI)
@@ -109,6 +109,13 @@ namespace sz_gui
 		}
         m_allUIUnorderedmap[id] = m_allUIMultimap.insert({ std::make_pair(id, ui->GetZValue()), ui });
         m_allNameUIUnorderedmap[ui->GetName()] = id;
+        ui->setHandle(m_uiHandleTable.Insert(ui.get()));
+        InvalidateOcclusion();
+        // 注册前已标记的布局更新
+        if (ui->HasUIFlag(UIFlag::LayoutDirty))
+        {
+            MarkLayoutDirty(ui->GetHandle());
+        }
         
         return true;
     }
@@ -134,10 +141,14 @@ namespace sz_gui
 			return false;
 		}
 
-        m_topUIMultimap.erase(it);
+        m_uiHandleTable.Remove(ui->GetHandle());
+        ui->setHandle(UIHandle{});
+        m_allUIMultimap.erase(it);
         m_allUIUnorderedmap.erase(ui->GetChildIdForUIManager());
         m_allNameUIUnorderedmap.erase(ui->GetName());
         ui->setChildIdForUIManager(0);
+        // 遮挡剔除的组件列表里可能还有它
+        InvalidateOcclusion();
  
         return true;
     }
@@ -150,6 +161,7 @@ namespace sz_gui
 			return false;
 		}
 
+        m_latencyTracker.OnInputBegin(event->common.timestamp);
         switch (event->type)
         {
         case SDL_EVENT_QUIT:
@@ -163,14 +175,9 @@ namespace sz_gui
             m_width = event->window.data1;
             m_height = event->window.data2;
 
-            // 重新布局
+            // 标记顶层布局需要更新，绘制前只重新计算矩形发生变化的UI
             m_layout->SetParentRect({ 0.0f, 0.0f, (float)m_width, (float)m_height });
-            m_layout->PerformLayout();
-            // 子组件重新布局
-            for (auto& it : m_topUIMultimap)
-            {
-                it.second->OnWindowResize();
-            }
+            InvalidateOcclusion();
         }
         break;
         case SDL_EVENT_MOUSE_BUTTON_DOWN:
@@ -195,9 +202,17 @@ namespace sz_gui
             mouseMoveEvent();
         }
         break;
+        case SDL_EVENT_MOUSE_WHEEL:
+        {
+            // 鼠标滚轮
+            m_inputControl.OnMouseWheel(eventContainer);
+            mouseWheelEvent();
+        }
+        break;
         default:
             return false;
         }
+        m_latencyTracker.OnInputEnd();
         return true;
 	}
 
@@ -207,17 +222,37 @@ namespace sz_gui
         assert(m_allUIMultimap.size() == m_allUIUnorderedmap.size());
         assert(m_allNameUIUnorderedmap.size() == m_allUIUnorderedmap.size());
 
+        m_latencyTracker.OnFrameBegin();
+        using Clock = std::chrono::steady_clock;
+        auto layoutBegin = Clock::now();
+        updateLayout();
+        auto occlusionBegin = Clock::now();
+        auto occludedWidgets = updateOcclusion();
+
+        // 顶层UI以窗口区域为父组件区域和剪裁区域
+        auto collectBegin = Clock::now();
+        const sz_ds::AABB2D windowBox(0.0f, 0.0f, (float)m_width, (float)m_height);
+        RenderContext ctx{ m_render.get(), windowBox, windowBox };
         for (auto& it : m_topUIMultimap)
         {
-            it.second->OnCollectRenderData();
+            it.second->OnCollectRenderData(ctx);
         }
+        auto collectEnd = Clock::now();
 
         // 渲染所有UI组件
         m_render->Render();
+        // 提交和交换缓冲区返回即视为呈现完成，驱动可能还在排队
+        m_latencyTracker.OnFramePresented();
+
+        m_frameStats = m_render->GetFrameStats();
+        m_frameStats.m_layoutMs = std::chrono::duration<double, std::milli>(occlusionBegin - layoutBegin).count();
+        m_frameStats.m_occlusionMs = std::chrono::duration<double, std::milli>(collectBegin - occlusionBegin).count();
+        m_frameStats.m_collectMs = std::chrono::duration<double, std::milli>(collectEnd - collectBegin).count();
+        m_frameStats.m_occludedWidgets = occludedWidgets;
     }
 
     bool UIManager::findTargetWriteChainAtPoint(const std::shared_ptr<IUIBase>& findChild, 
-        std::vector<std::weak_ptr<IUIBase>>& chain)
+        std::vector<UIHandle>& chain)
     {
         chain.resize(0);
 
@@ -225,16 +260,16 @@ namespace sz_gui
         {
             return false;
         }
-        chain.push_back(findChild);
+        chain.push_back(findChild->GetHandle());
 
-        auto current = findChild->GetParent();
-        while (!current.expired())
+        auto current = m_uiHandleTable.Get(findChild->GetParentHandle());
+        while (current)
         {
-            if (current.lock()->ContainsPoint(m_inputControl.m_currentX, m_inputControl.m_currentY))
+            if (current->ContainsPoint(m_inputControl.m_currentX, m_inputControl.m_currentY))
             {
-                chain.push_back(current);
+                chain.push_back(current->GetHandle());
             }
-            current = current.lock()->GetParent();
+            current = m_uiHandleTable.Get(current->GetParentHandle());
         }
         return true;
     }
@@ -242,7 +277,7 @@ namespace sz_gui
     void UIManager::bubbleEvent(const std::shared_ptr<IUIBase>& findChild)
     {   
         // 命中情况下，深度+冒泡，规则：最近者(深度最大者)优先
-        static std::vector<std::weak_ptr<IUIBase>> propagationChain;
+        static std::vector<UIHandle> propagationChain;
         propagationChain.resize(0);
 
         auto bFind = findTargetWriteChainAtPoint(findChild, propagationChain);
@@ -255,11 +290,17 @@ namespace sz_gui
         propagationChain.resize(0);
     }
 
-    void UIManager::triggerMouseButton(const std::vector<std::weak_ptr<IUIBase>>& propagationChain)
+    void UIManager::triggerMouseButton(const std::vector<UIHandle>& propagationChain)
     {
         for (auto it = propagationChain.begin(); it != propagationChain.end(); ++it)
         {
-            if (it->lock()->OnMouseLeftButtonClick())
+            // 事件处理中可能注销UI，每次都通过句柄重新获取
+            auto ui = m_uiHandleTable.Get(*it);
+            if (!ui)
+            {
+                continue;
+            }
+            if (ui->OnMouseLeftButtonClick())
             {
                 break;
             }
@@ -268,22 +309,7 @@ namespace sz_gui
 
     void UIManager::mouseLeftButtonEvent()
     {
-        std::shared_ptr<IUIBase> findChild;
-        // m_allUIMultimap，倒叙，按照Z值由大到小排序，Z值一样按照创建顺序排序
-        for (auto it = m_allUIMultimap.rbegin(); it != m_allUIMultimap.rend(); ++it)
-        {
-            if (!it->second->IsInteractive() || !it->second->IsVisible())
-			{
-				continue;
-			}
-
-			if (it->second->ContainsPoint(m_inputControl.m_currentX, m_inputControl.m_currentY))
-			{
-				// 最近者优先
-                findChild = it->second;
-				break;
-			}
-        }
+        auto findChild = findInteractiveAtPoint(m_inputControl.m_currentX, m_inputControl.m_currentY);
 
         if (!findChild)
         {
@@ -319,22 +345,7 @@ namespace sz_gui
 
     void UIManager::mouseMoveEvent()
     {
-        std::shared_ptr<IUIBase> findChilds;
-        // m_allUIMultimap，倒叙，按照Z值由大到小排序，Z值一样按照创建顺序排序
-        for (auto it = m_allUIMultimap.rbegin(); it != m_allUIMultimap.rend(); ++it)
-        {
-            if (!it->second->IsInteractive() || !it->second->IsVisible())
-            {
-                continue;
-            }
-
-            if (it->second->ContainsPoint(m_inputControl.m_currentX, m_inputControl.m_currentY))
-            {
-                // 最近者优先
-                findChilds = it->second;
-                break;
-            }
-        }
+        auto findChilds = findInteractiveAtPoint(m_inputControl.m_currentX, m_inputControl.m_currentY);
 
         if (!findChilds)
         {
@@ -363,4 +374,277 @@ namespace sz_gui
 			m_mouseMoveEnterUI->OnMouseMoveEnter();
         }
     }
-}
\ No newline at end of file
+
+    void UIManager::mouseWheelEvent()
+    {
+        auto target = findInteractiveAtPoint(m_inputControl.m_currentX, m_inputControl.m_currentY);
+
+        if (!target)
+        {
+            return;
+        }
+
+        // 从命中UI开始向父组件冒泡，直到有UI处理
+        // 事件处理中可能注销UI，每次都通过句柄重新获取
+        auto handle = target->GetHandle();
+        while (auto current = m_uiHandleTable.Get(handle))
+        {
+            handle = current->GetParentHandle();
+            if (current->IsVisible() &&
+                current->OnMouseWheel(m_inputControl.m_wheelX, m_inputControl.m_wheelY))
+            {
+                break;
+            }
+        }
+    }
+
+    std::shared_ptr<IUIBase> UIManager::findInteractiveAtPoint(float x, float y) const
+    {
+        // m_allUIMultimap，倒叙，按照Z值由大到小排序，Z值一样按照创建顺序排序
+        for (auto it = m_allUIMultimap.rbegin(); it != m_allUIMultimap.rend(); ++it)
+        {
+            if (!it->second->IsInteractive() || !it->second->IsVisible())
+            {
+                continue;
+            }
+
+            if (it->second->ContainsPoint(x, y))
+            {
+                // 最近者优先
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    // 并行布局时当前线程正在更新的子树收集队列
+    static thread_local std::vector<UIHandle>* t_layoutCollector = nullptr;
+
+    // 累加子树的后代个数，达到limit就停止，只需要知道是否达到并行阈值
+    static void countDescendants(const IUIBase* ui, size_t limit, size_t& count)
+    {
+        for (auto& child : ui->getChilds())
+        {
+            if (++count >= limit)
+            {
+                return;
+            }
+            countDescendants(child.second.get(), limit, count);
+            if (count >= limit)
+            {
+                return;
+            }
+        }
+    }
+
+    void UIManager::MarkLayoutDirty(UIHandle handle)
+    {
+        if (t_layoutCollector)
+        {
+            t_layoutCollector->push_back(handle);
+            return;
+        }
+        m_layoutDirtyUIs.push_back(handle);
+    }
+
+    void UIManager::SetParallelLayout(size_t workerCount, size_t threshold)
+    {
+        m_layoutPool.reset();
+        if (workerCount > 0)
+        {
+            m_layoutPool = std::make_unique<sz_ds::TaskPool>(workerCount);
+        }
+        m_parallelLayoutThreshold = threshold;
+    }
+
+    void UIManager::updateLayout()
+    {
+        if (m_layout && m_layout->IsDirty())
+        {
+            m_layout->PerformLayout();
+        }
+
+        if (m_layoutPool && m_layoutDirtyUIs.size() > 1)
+        {
+            updateLayoutParallel();
+        }
+
+        // 更新过程中矩形发生变化的UI会继续加入队列
+        for (size_t i = 0; i < m_layoutDirtyUIs.size(); ++i)
+        {
+            auto ui = m_uiHandleTable.Get(m_layoutDirtyUIs[i]);
+            if (!ui || !ui->HasUIFlag(UIFlag::LayoutDirty))
+            {
+                continue;
+            }
+            ui->UpdateLayout();
+        }
+        m_layoutDirtyUIs.clear();
+    }
+
+    void UIManager::updateLayoutParallel()
+    {
+        // 祖先也脏的UI矩形还会被祖先的布局修改，留到并行结束后串行处理
+        std::vector<IUIBase*> roots;
+        std::vector<UIHandle> deferred;
+        size_t descendantCount = 0;
+        for (auto handle : m_layoutDirtyUIs)
+        {
+            auto ui = m_uiHandleTable.Get(handle);
+            if (!ui || !ui->HasUIFlag(UIFlag::LayoutDirty))
+            {
+                continue;
+            }
+            if (hasDirtyAncestor(ui))
+            {
+                deferred.push_back(handle);
+                continue;
+            }
+            roots.push_back(ui);
+            if (descendantCount < m_parallelLayoutThreshold)
+            {
+                countDescendants(ui, m_parallelLayoutThreshold, descendantCount);
+            }
+        }
+
+        // 子树太小时线程同步的开销比布局本身大
+        if (roots.size() < 2 || descendantCount < m_parallelLayoutThreshold)
+        {
+            return;
+        }
+
+        // 各子树互不相交，子树内的UI只被一个任务修改，脏UI收集到各自的队列
+        if (m_layoutCollectors.size() < roots.size())
+        {
+            m_layoutCollectors.resize(roots.size());
+        }
+        m_layoutPool->ParallelFor(roots.size(), [this, &roots](size_t i) {
+            auto& collector = m_layoutCollectors[i];
+            t_layoutCollector = &collector;
+            roots[i]->UpdateLayout();
+            for (size_t j = 0; j < collector.size(); ++j)
+            {
+                auto ui = m_uiHandleTable.Get(collector[j]);
+                if (!ui || !ui->HasUIFlag(UIFlag::LayoutDirty))
+                {
+                    continue;
+                }
+                ui->UpdateLayout();
+            }
+            collector.clear();
+            t_layoutCollector = nullptr;
+        });
+
+        m_layoutDirtyUIs.swap(deferred);
+    }
+
+    bool UIManager::hasDirtyAncestor(const IUIBase* ui) const
+    {
+        auto parent = m_uiHandleTable.Get(ui->GetParentHandle());
+        while (parent)
+        {
+            if (parent->HasUIFlag(UIFlag::LayoutDirty))
+            {
+                return true;
+            }
+            parent = m_uiHandleTable.Get(parent->GetParentHandle());
+        }
+        return false;
+    }
+
+    uint32_t UIManager::updateOcclusion()
+    {
+        // 每帧都按树的顺序准备渲染数据并收集，每个组件只准备一次
+        // 之前和准备时（比如列表滚动后重新绑定行）都没有改动时沿用上次结果，省掉排序和覆盖计算
+        const bool dirty = m_occlusionDirty.exchange(false, std::memory_order_relaxed);
+        m_occlusionItems.clear();
+        bool hasOccluder = false;
+        const sz_ds::AABB2D windowBox(0.0f, 0.0f, (float)m_width, (float)m_height);
+        for (auto& it : m_topUIMultimap)
+        {
+            gatherOcclusionItems(it.second.get(), windowBox, windowBox, hasOccluder);
+        }
+        // 先准备父组件再收集子组件，收集时的改动已经包含在列表里
+        if (!m_occlusionDirty.exchange(false, std::memory_order_relaxed) && !dirty)
+        {
+            return m_occludedCount;
+        }
+        m_occludedCount = 0;
+
+        if (!hasOccluder)
+        {
+            for (auto& item : m_occlusionItems)
+            {
+                item.m_ui->ClearUIFlag(UIFlag::Occluded);
+            }
+            return 0;
+        }
+
+        // 由近到远处理，Z值一样的组件之间按绘制顺序覆盖，深度测试不保证谁在上面，互相不遮挡
+        std::stable_sort(m_occlusionItems.begin(), m_occlusionItems.end(),
+            [](const OcclusionItem& a, const OcclusionItem& b) { return a.m_z > b.m_z; });
+        m_coverageGrid.Reset((float)m_width, (float)m_height);
+        for (size_t begin = 0; begin < m_occlusionItems.size();)
+        {
+            size_t end = begin;
+            for (; end < m_occlusionItems.size() && m_occlusionItems[end].m_z == m_occlusionItems[begin].m_z; ++end)
+            {
+                auto& item = m_occlusionItems[end];
+                if (m_coverageGrid.IsCovered(item.m_box))
+                {
+                    item.m_ui->SetUIFlag(UIFlag::Occluded);
+                    ++m_occludedCount;
+                }
+                else
+                {
+                    item.m_ui->ClearUIFlag(UIFlag::Occluded);
+                }
+            }
+            for (; begin < end; ++begin)
+            {
+                auto& item = m_occlusionItems[begin];
+                if (item.m_ui->IsOpaque())
+                {
+                    m_coverageGrid.AddOccluder(item.m_box);
+                }
+            }
+        }
+        return m_occludedCount;
+    }
+
+    void UIManager::gatherOcclusionItems(IUIBase* ui, const sz_ds::AABB2D& parentBox, const sz_ds::AABB2D& clipBox,
+        bool& hasOccluder)
+    {
+        // 和收集渲染数据一样，不可见或者不在父组件区域和剪裁区域内的子树不处理
+        if (!ui->IsVisible())
+        {
+            return;
+        }
+        const auto outside = [&](const sz_ds::AABB2D& rect)
+        {
+            return rect.Intersection(parentBox).IsNull() || rect.Intersection(clipBox).IsNull();
+        };
+        if (outside(ui->GetRect().ToAABB2D()))
+        {
+            return;
+        }
+
+        // 准备时可能改了自身的矩形或可见性，收集用准备之后的状态
+        ui->OnPrepareRenderData();
+        const auto rect = ui->GetRect().ToAABB2D();
+        if (!ui->IsVisible() || outside(rect))
+        {
+            return;
+        }
+        const auto box = rect.Intersection(clipBox);
+        m_occlusionItems.push_back({ ui, box, ui->GetZValue() });
+        hasOccluder = hasOccluder || ui->IsOpaque();
+
+        auto childClip = ui->GetChildClipRect();
+        const auto childClipBox = childClip ? childClip->ToAABB2D().Intersection(clipBox) : clipBox;
+        for (auto& child : ui->getChilds())
+        {
+            gatherOcclusionItems(child.second.get(), rect, childClipBox, hasOccluder);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <cassert>
 #include <cstdint>
@@ -13,6 +14,9 @@
 #include "Common.h"
 #include "ILayout.h"
 #include "InputControl.h"
+#include "LatencyTracker.h"
+#include "../ds/TaskPool.h"
+#include "../ds/CoverageGrid.h"
 
 namespace sz_gui 
 {
@@ -48,6 +52,10 @@ namespace sz_gui
 		{
 			return m_render;
 		}
+		// 获取句柄
+		UIManagerHandle GetHandle() const override { return m_handle; }
+		// 根据句柄获取UI，句柄失效返回nullptr，不持有所有权
+		IUIBase* GetUI(UIHandle handle) const override { return m_uiHandleTable.Get(handle); }
 		// 注册顶层UI
 		bool RegTopUI(std::shared_ptr<IUIBase> topUI) override;
 		// 注销顶层UI
@@ -67,23 +75,51 @@ namespace sz_gui
 		bool LayoutAddWidget(std::shared_ptr<IUIBase> widget) override { return m_layout->AddWidget(widget); }
 		// 布局移除widget
 		bool LayoutDelWidget(std::shared_ptr<IUIBase> widget) override { return m_layout->DelWidget(widget); }
+		// 顶层布局中widget的布局约束发生变化
+		void InvalidateWidgetLayout(IUIBase* widget) override { m_layout->InvalidateWidget(widget); }
+		// 标记UI布局需要更新，绘制前统一更新
+		void MarkLayoutDirty(UIHandle handle) override;
+		// 标记遮挡剔除需要重新收集组件，可以在布局线程调用
+		void InvalidateOcclusion() override { m_occlusionDirty.store(true, std::memory_order_relaxed); }
+		// 设置并行布局，workerCount为0时关闭，子树子组件总数达到threshold时才并行
+		void SetParallelLayout(size_t workerCount, size_t threshold) override;
 		// 绘制
 		void Render() override;
 		// 获取输入控制
 		const InputControl* GetInputControl() const override { return &m_inputControl; };
+		// 获取上一帧的统计
+		const FrameStats& GetFrameStats() const override { return m_frameStats; }
+		// 获取输入延迟跟踪
+		LatencyTracker& GetLatencyTracker() override { return m_latencyTracker; }
+		const LatencyTracker& GetLatencyTracker() const override { return m_latencyTracker; }
 
 	private:
 		// 根据位置填充UI链
 		bool findTargetWriteChainAtPoint(const std::shared_ptr<IUIBase>& findChild,
-			std::vector<std::weak_ptr<IUIBase>>& chain);
+			std::vector<UIHandle>& chain);
 		// 事件冒泡
 		void bubbleEvent(const std::shared_ptr<IUIBase>& findChild);
 		// 触发鼠标点击事件
-		void triggerMouseButton(const std::vector<std::weak_ptr<IUIBase>>& propagationChain);
+		void triggerMouseButton(const std::vector<UIHandle>& propagationChain);
 		// 鼠标左键事件
 		void mouseLeftButtonEvent();
 		// 鼠标移动事件
 		void mouseMoveEvent();
+		// 鼠标滚轮事件
+		void mouseWheelEvent();
+		// 查找位置上最近的可交互UI
+		std::shared_ptr<IUIBase> findInteractiveAtPoint(float x, float y) const;
+		// 更新布局，只处理矩形或约束发生变化的UI
+		void updateLayout();
+		// 把互不包含的脏子树分发到任务池，返回后只剩祖先也脏的UI
+		void updateLayoutParallel();
+		// 是否有祖先也需要更新布局
+		bool hasDirtyAncestor(const IUIBase* ui) const;
+		// 遮挡剔除，被更高层不透明组件完全覆盖的组件打上Occluded标记，返回被遮挡的组件数，组件没有变化时沿用上次结果
+		uint32_t updateOcclusion();
+		// 按收集渲染数据的顺序准备子树并记录可见组件，每个组件每帧只在这里准备一次，parentBox和clipBox和收集时的上下文一致
+		void gatherOcclusionItems(IUIBase* ui, const sz_ds::AABB2D& parentBox, const sz_ds::AABB2D& clipBox,
+			bool& hasOccluder);
 
 	private:
 		// 渲染器
@@ -100,16 +136,48 @@ namespace sz_gui
 		std::unordered_map<std::string, uint64_t> m_allNameUIUnorderedmap;
 		// UIID生成器
 		uint64_t m_nextUIId = 1;
+		// 所有UI组件句柄表，不持有所有权，所有权在m_allUIMultimap
+		sz_ds::HandleTable<IUIBase> m_uiHandleTable;
+		// 句柄
+		UIManagerHandle m_handle;
 		// 窗口宽高
 		int m_width = 0;
 		int m_height = 0;
 		// 布局
 		std::unique_ptr<ILayout> m_layout;
+		// 布局需要更新的UI
+		std::vector<UIHandle> m_layoutDirtyUIs;
+		// 并行布局任务池，为空时串行
+		std::unique_ptr<sz_ds::TaskPool> m_layoutPool;
+		// 并行布局阈值，脏子树的后代总数
+		size_t m_parallelLayoutThreshold = 0;
+		// 并行布局时每个子树收集的脏UI
+		std::vector<std::vector<UIHandle>> m_layoutCollectors;
+		// 遮挡剔除的组件，可见区域是自身矩形和剪裁区域的交集
+		struct OcclusionItem
+		{
+			IUIBase* m_ui = nullptr;
+			sz_ds::AABB2D m_box;
+			float m_z = 0.0f;
+		};
+		// 每帧收集时重建，重新计算时由近到远排序
+		// 沿用上次的遮挡结果，只因为注册注销、矩形、Z值和可见性的每处改动都调用了InvalidateOcclusion，漏掉一处结果就会过期
+		std::vector<OcclusionItem> m_occlusionItems;
+		// 组件矩形、Z值、可见性或者层级变化后需要重新计算，并行布局时工作线程也会写
+		std::atomic<bool> m_occlusionDirty{ true };
+		// 上次遮挡剔除被遮挡的组件数
+		uint32_t m_occludedCount = 0;
+		// 遮挡覆盖位图，重新收集时重置
+		sz_ds::CoverageGrid m_coverageGrid;
 		// 鼠标移动进入UI
 		std::shared_ptr<IUIBase> m_mouseMoveEnterUI;
 		// 鼠标左键按下UI
 		std::shared_ptr<IUIBase> m_mouseLeftPressUI;
 		// 输入控制
 		InputControl m_inputControl;
+		// 上一帧的统计
+		FrameStats m_frameStats;
+		// 输入延迟跟踪
+		LatencyTracker m_latencyTracker;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+// comment: 控件工厂，控件对象和shared_ptr控制块一起从对象池分配
+
+#pragma once
+
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "../ds/ObjectPool.h"
+#include "IUIBase.h"
+
+namespace sz_gui
+{
+	// 获取某类控件的内存统计，分配和释放只算这类控件，容量和块数是控件所在共享池的
+	template<typename T>
+	sz_ds::PoolStats& GetWidgetPoolStats()
+	{
+		static sz_ds::PoolStats stats;
+		return stats;
+	}
+
+	// 池化创建控件
+	template<typename T, typename... Args>
+	std::shared_ptr<T> MakeWidget(Args&&... args)
+	{
+		static_assert(std::is_base_of_v<IUIBase, T>, "T must derive from IUIBase");
+		return std::allocate_shared<T>(sz_ds::PoolAllocator<T>(&GetWidgetPoolStats<T>()),
+			std::forward<Args>(args)...);
+	}
+
+	// 批量池化创建控件，首个控件分配前一次性预留count个控件的内存
+	// argsFactory(size_t index)返回构造参数的std::tuple
+	template<typename T, typename ArgsFactory>
+	std::vector<std::shared_ptr<T>> MakeWidgets(size_t count, ArgsFactory&& argsFactory)
+	{
+		static_assert(std::is_base_of_v<IUIBase, T>, "T must derive from IUIBase");
+
+		std::vector<std::shared_ptr<T>> widgets;
+		widgets.reserve(count);
+
+		size_t reserve = count;
+		sz_ds::PoolAllocator<T> alloc(&GetWidgetPoolStats<T>(), &reserve);
+		for (size_t i = 0; i < count; ++i)
+		{
+			widgets.push_back(std::apply([&alloc](auto&&... args) {
+				return std::allocate_shared<T>(alloc, std::forward<decltype(args)>(args)...);
+			}, argsFactory(i)));
+		}
+
+		return widgets;
+	}
+}
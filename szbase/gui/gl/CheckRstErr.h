@@ -6,8 +6,8 @@
 #include <glad/glad.h>
 #endif
 
-#include <format>
 #include <iostream>
+#include <sstream>
 
 #ifdef _DEBUG
 	#define GL_STRINGIFY(x) #x
@@ -21,8 +21,9 @@ static void checkRstErr(const char* szFuncName, const char* szFileName, int iLin
 	GLenum errorCode = glGetError();
 	if (errorCode != GL_NO_ERROR) 
 	{
-		const std::string& errorMessage = std::format("exec opengl function error,{},{},{},{}", 
-			errorCode, szFuncName, szFileName, iLine);
-		std::cerr << errorMessage << std::endl;
+		std::ostringstream oss;
+		oss << "exec opengl function error," << errorCode << "," << szFuncName << ","
+			<< szFileName << "," << iLine;
+		std::cerr << oss.str() << std::endl;
 	}
 }
\ No newline at end of file
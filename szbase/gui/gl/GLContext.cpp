@@ -5,9 +5,9 @@
 #include "../../macro/Macro.h"
 
 #include <unordered_set>
-#include <format>
 #include <algorithm>
 #include <fstream>
+#include <chrono>
 
 #define STB_TRUETYPE_IMPLEMENTATION 1
 #include <stb/stb_truetype.h>
@@ -16,6 +16,9 @@ namespace sz_gui
 {
     namespace gl
     {
+        // 文字排版区域要在文字顶点定点数范围内
+        static_assert(TextLayout::MAX_EXTENT < MaxFixedPosition(TEXT_POSITION_FRACTION_BITS));
+
         std::tuple<std::string, bool> GLContext::InitGLAttributes()
         {
             std::string errMsg = "success";
@@ -73,6 +76,23 @@ namespace sz_gui
 
             if (m_glContext)
             {
+                // 几何体要在堆之前归还区间，堆要在上下文销毁前释放缓冲
+                m_opacityUIUnmap.clear();
+                m_opacityTextUnmap.clear();
+                m_transparentUIUnmap.clear();
+                m_transparentTextUnmap.clear();
+                m_opacityItems.clear();
+                m_transparentItems.clear();
+                m_colorHeap.reset();
+                m_textHeap.reset();
+                m_textureHeap.reset();
+                m_imageAtlas.reset();
+                m_gpuTimer.Release();
+                m_indirectBatcher.Release();
+                m_overdrawCounter.Release();
+                m_colorBatchShader.reset();
+                m_colorClipBatchShader.reset();
+                m_textBatchShader.reset();
                 SDL_GL_DestroyContext(m_glContext);
                 m_glContext = nullptr;
             }
@@ -95,24 +115,106 @@ namespace sz_gui
                 return { std::move(errMsg), false };
             }
 
+            // 程序二进制缓存，默认放在用户数据目录
+            if (!m_programCacheDirectory)
+            {
+                m_programCacheDirectory = "";
+                if (char* prefPath = SDL_GetPrefPath("szgui", "szgui"))
+                {
+                    m_programCacheDirectory = std::string(prefPath) + "shader_cache";
+                    SDL_free(prefPath);
+                }
+            }
+            m_programCache.Init(*m_programCacheDirectory);
+
+            // 顶点位置的定点缩放按几何体的小数位数注入
+            const std::string colorVS = InjectPositionScale(ColorVS, COLOR_POSITION_FRACTION_BITS);
+            const std::string textVS = InjectPositionScale(TextVS, TEXT_POSITION_FRACTION_BITS);
+            const std::string textureVS = InjectPositionScale(TextureVS, TEXTURE_POSITION_FRACTION_BITS);
+
             m_colorShader = std::make_unique<Shader>();
-            auto [err, ok] = m_colorShader->LoadFromString(ColorVS, ColorFS);
+            auto [err, ok] = m_colorShader->LoadFromString(colorVS.c_str(), ColorFS, &m_programCache);
+            if (!ok)
+			{
+				return { err, false };
+			}
+
+            m_colorClipShader = std::make_unique<Shader>();
+            std::tie(err, ok) = m_colorClipShader->LoadFromString(colorVS.c_str(), ColorClipFS, &m_programCache);
             if (!ok)
 			{
 				return { err, false };
 			}
 
             m_textShader = std::make_unique<Shader>();
-            std::tie(err, ok) = m_textShader->LoadFromString(TextVS, TextFS);
+            std::tie(err, ok) = m_textShader->LoadFromString(textVS.c_str(), TextFS, &m_programCache);
             if (!ok)
 			{
 				return { err, false };
 			}
 
+            m_textureShader = std::make_unique<Shader>();
+            std::tie(err, ok) = m_textureShader->LoadFromString(textureVS.c_str(), TextureFS, &m_programCache);
+            if (!ok)
+			{
+				return { err, false };
+			}
+
+            m_overdrawShader = std::make_unique<Shader>();
+            std::tie(err, ok) = m_overdrawShader->LoadFromString(OverdrawVS, OverdrawFS, &m_programCache);
+            if (!ok)
+			{
+				return { err, false };
+			}
+
+            // 所有几何体从这三个堆中分配，容量不够时自动扩容
+            // 贴图和文字顶点格式相同，位置精度不同，所以各用一个堆
+            m_colorHeap = std::make_unique<GeometryHeap>(true, COLOR_POSITION_FRACTION_BITS,
+                COLOR_HEAP_VERTICES, COLOR_HEAP_INDICES);
+            m_textHeap = std::make_unique<GeometryHeap>(false, TEXT_POSITION_FRACTION_BITS,
+                TEXT_HEAP_VERTICES, TEXT_HEAP_INDICES);
+            m_textureHeap = std::make_unique<GeometryHeap>(false, TEXTURE_POSITION_FRACTION_BITS,
+                TEXTURE_HEAP_VERTICES, TEXTURE_HEAP_INDICES);
+
+            // 贴图材质的图片都放在图集中
+            m_imageAtlas = std::make_unique<ImageAtlas>(IMAGE_ATLAS_UNIT, m_imageAtlasBudget, m_imageUploadBytesPerFrame);
+
             SetColorTheme(m_colorTheme);
 
             OnWindowResize(width, height);
 
+            // 不支持计时查询时GPU耗时为负数
+            m_gpuTimer.Init();
+
+            #ifndef USE_OPENGL_ES
+            // 支持4.6时不透明物体走多重间接绘制，否则逐个绘制
+            if (m_indirectBatcher.Init())
+            {
+                const std::string colorBatchVS = InjectPositionScale(ColorBatchVS, COLOR_POSITION_FRACTION_BITS);
+                const std::string textBatchVS = InjectPositionScale(TextBatchVS, TEXT_POSITION_FRACTION_BITS);
+
+                m_colorBatchShader = std::make_unique<Shader>();
+                std::tie(err, ok) = m_colorBatchShader->LoadFromString(colorBatchVS.c_str(), ColorFS, &m_programCache);
+                if (ok)
+                {
+                    m_colorClipBatchShader = std::make_unique<Shader>();
+                    std::tie(err, ok) = m_colorClipBatchShader->LoadFromString(colorBatchVS.c_str(), ColorClipBatchFS, &m_programCache);
+                }
+                if (ok)
+                {
+                    m_textBatchShader = std::make_unique<Shader>();
+                    std::tie(err, ok) = m_textBatchShader->LoadFromString(textBatchVS.c_str(), TextBatchFS, &m_programCache);
+                }
+                if (!ok)
+                {
+                    m_indirectBatcher.Release();
+                    m_colorBatchShader.reset();
+                    m_colorClipBatchShader.reset();
+                    m_textBatchShader.reset();
+                }
+            }
+            #endif
+
             return { std::move(errMsg), true };
         }
 
@@ -247,6 +349,17 @@ namespace sz_gui
                 curOffset += numToPack;
                 curTextureUnit++;
             }
+
+            // 烘焙结果交给排版
+            m_textLayout.SetFontMetrics(float(m_fontAscent), float(m_fontDescent), float(m_fontLineGap), m_fontScale);
+            m_textLayout.SetAtlas(uint32_t(m_fontTextureArray->GetWidth()), uint32_t(m_fontTextureArray->GetHeight()),
+                m_fontTextureArray->GetMaxLayer());
+            for (const auto& [codepoint, packed] : m_packedCharUnmap)
+            {
+                const auto& pc = packed.second;
+                m_textLayout.AddGlyph(codepoint, TextGlyph{ packed.first, float(pc.x0), float(pc.y0),
+                    float(pc.x1), float(pc.y1), pc.xoff, pc.yoff, pc.xadvance });
+            }
 			return { errMsg, true };
         }
 
@@ -255,198 +368,7 @@ namespace sz_gui
             std::vector<float>& positions, std::vector<float>& uvs, std::vector<uint32_t>& indices, 
             std::vector<float>& layers)
         {
-            if (codepoints.empty() || limitWidth < 0.0001f || limitHeight < 0.0001f)
-            {
-                return false;
-            }
-
-            positions.clear();
-            uvs.clear();
-            indices.clear();
-            layers.clear();
-            
-            auto textureWidth = m_fontTextureArray->GetWidth();
-            auto textureHeight = m_fontTextureArray->GetHeight();
-            auto maxLayer = m_fontTextureArray->GetMaxLayer();
-            int32_t layer = -1;
-            stbtt_packedchar* pcData = nullptr;
-            float current_x = 0.0f;
-            float current_y = 0.0f;
-            // 一个字符框从最高点到最低点，再加上额外行间距的总垂直高度
-            float line_height = (m_fontAscent - m_fontDescent + m_fontLineGap) * m_fontScale;
-            float max_w = 0.0f;
-            float max_h = line_height;
-
-            // 不缩放情况下计算绘制文本需要的总高度和总宽度
-            for (int32_t codepoint : codepoints) 
-            {
-                std::tie(layer, pcData) = getPackedCharData(codepoint);
-                if (!pcData || layer < 0 || layer > maxLayer)
-				{
-					return false;
-				}
-                
-                // pcData->xadvance，渲染完这个字符后，光标应该向右移动多少距离，以便开始绘制下一个字符
-                if (current_x + pcData->xadvance > limitWidth)
-                {
-                    max_w = std::max(max_w, current_x);
-                    current_x = 0.0f;
-                    max_h += line_height;
-                }
-                current_x += pcData->xadvance;
-            }
-            max_w = std::max(max_w, current_x);
-
-            // 计算缩放比例
-            float scale_x = max_w > limitWidth ? limitWidth / max_w : 1.0f;
-            float scale_y = max_h > limitHeight ? limitHeight / max_h : 1.0f;
-            // 缩放比例取最小值
-            float scale = std::min(scale_x, scale_y);
-           
-            // 上面在计算缩放的时候使用的最小值，缩放以后，存在以前需要3行变成2行或者1行就够了
-            max_w = 0.0f;
-            max_h = line_height * scale;
-            current_x = 0.0f;
-            current_y = 0.0f;
-            for (int32_t codepoint : codepoints)
-            {
-                std::tie(layer, pcData) = getPackedCharData(codepoint);
-                if (current_x + pcData->xadvance * scale > limitWidth)
-                {
-                    max_w = std::max(max_w, current_x);
-                    current_x = 0.0f;
-                    max_h += line_height * scale;
-                }
-                current_x += pcData->xadvance * scale;
-            }
-            max_w = std::max(max_w, current_x);
-            // 水平偏移量
-            float horizontal_offset = 0.0f;
-            // 垂直偏移量
-            float vertical_offset = 0.0f;
-            if (ta == (TextAlignment::HCenter | TextAlignment::VCenter))
-            {
-                if (max_w < limitWidth)
-                {
-                    horizontal_offset = (limitWidth - max_w) / 2.0f;
-                }
-
-                if (max_h < limitHeight)
-				{
-					vertical_offset = (limitHeight - max_h) / 2.0f;
-				}
-            }
-            else
-            {
-                assert(0);
-            }
-
-            // 重新布局并生成顶点数据
-            current_x = 0.0f;
-            current_y = 0.0f;
-            uint32_t vertex_offset = 0;
-            for (int32_t codepoint : codepoints)
-            {
-                std::tie(layer, pcData) = getPackedCharData(codepoint);
-
-                // 换行判断
-                if (current_x + pcData->xadvance * scale > limitWidth)
-                {
-                    current_x = 0.0f;
-                    current_y += line_height * scale;
-                }
-                
-                // 计算字符的屏幕坐标
-                // pcData->x0, pcData->y0, pcData->x1, pcData->y1
-                // 是字符在纹理图集中的左上角和右下角坐标，需要标准化为[0,1]
-                // pcData->xoff, pcData->yoff
-                // https://learnopengl-cn.github.io/06%20In%20Practice/02%20Text%20Rendering/
-                // xoff，bearingX从origin到字符左边缘的水平距离(通常是正数)
-                // yoff，bearingY从origin到字符顶部的垂直距离(通常是负数)
-                 
-                // 字符左上角X坐标
-                float char_x = horizontal_offset + current_x + pcData->xoff * scale;
-                // 字符左上角Y坐标
-                // vertical_center_offset，整体居中偏移量
-                // current_y，当前行起始位置
-                // (m_fontAscent * m_fontScale * scale)
-                // 基线到字体中最高字符的距离
-                // (pcData->yoff * scale)
-                // 基线到当前字符顶部的距离，负数
-                float char_y = vertical_offset + current_y
-                    + (m_fontAscent * m_fontScale * scale)
-                    + (pcData->yoff * scale);
-                // float char_y = 0.0f;
-                float char_w = (pcData->x1 - pcData->x0) * scale;
-                // 字符渲染高度
-                float char_h = (pcData->y1 - pcData->y0) * scale;
-
-                // 计算纹理坐标，标准化
-                float tex_width = static_cast<float>(textureWidth);
-                float tex_height = static_cast<float>(textureHeight);
-                float u0 = pcData->x0 / tex_width;
-                float v0 = pcData->y0 / tex_height;
-                float u1 = pcData->x1 / tex_width;
-                float v1 = pcData->y1 / tex_height;
-
-                // 位置数据
-                positions.insert(positions.end(), 
-                {
-                    // 左下
-                    char_x, char_y + char_h, 0.0f,
-                    // 右下
-                    char_x + char_w, char_y + char_h, 0.0f, 
-                    // 右上
-                    char_x + char_w, char_y, 0.0f,
-                    // 左上
-                    char_x, char_y, 0.0f              
-                });
-
-                // UV数据
-                uvs.insert(uvs.end(), 
-                {
-                    // 左下
-                    u0, v1,
-                    // 右下
-                    u1, v1,
-                    // 右上
-                    u1, v0,
-                    // 左上
-                    u0, v0
-                });
-
-                // 索引数据，每个字符2个三角形，6个索引
-                indices.insert(indices.end(), 
-                {
-                     // 第一个三角形: 顺时针 (左下 -> 右上 -> 右下)
-                     vertex_offset,
-                     vertex_offset + 2,
-                     vertex_offset + 1,
-
-                     // 第二个三角形: 顺时针 (左下 -> 左上 -> 右上)
-                     vertex_offset,
-                     vertex_offset + 3,
-                     vertex_offset + 2
-                });
-
-                // 纹理层数据
-                layers.insert(layers.end(),
-                {
-                    // 左下
-                    float(layer),
-                    // 右下
-                    float(layer),
-                    // 右上
-                    float(layer),
-                    // 左上
-                    float(layer)
-                });
-
-                current_x += pcData->xadvance * scale;
-                vertex_offset += 4;
-            }
-
-            return !positions.empty();
+            return m_textLayout.Layout(ta, limitWidth, limitHeight, codepoints, positions, uvs, indices, layers);
         }
 
         void GLContext::AppendDrawData(const std::vector<float>& positions, 
@@ -458,6 +380,7 @@ namespace sz_gui
             assert(cmd.m_materialType == MaterialType::ColorMaterial ||
                 cmd.m_materialType == MaterialType::TextureMaterial);
             RenderItem* ri = nullptr;
+            RenderItemPtr newItem = nullptr;
             bool oldOpcacity = false;
             bool oldTransparent = false;
 
@@ -465,13 +388,13 @@ namespace sz_gui
             auto tIt = m_transparentUIUnmap.find(cmd.m_onlyId);
             if (oIt == m_opacityUIUnmap.end() && tIt == m_transparentUIUnmap.end())
             {
-                ri = new RenderItem();
+                newItem = createRenderItem();
+                ri = newItem.get();
                 bool useColor = (cmd.m_materialType == MaterialType::ColorMaterial);
-                ri->m_geo = std::make_unique<Geometry>(
-                    positions.size(),
-                    colorOrUVs.size(),
-                    indices.size(), 
-                    useColor
+                ri->m_geo = sz_ds::MakePooled(m_geometryPool,
+                    useColor ? m_colorHeap.get() : m_textureHeap.get(),
+                    positions.size() / 3,
+                    indices.size()
                 );
             }
             else if (oIt == m_opacityUIUnmap.end())
@@ -489,6 +412,7 @@ namespace sz_gui
             {
                 auto oldRenderItem = std::move(*(oIt->second));
                 m_opacityItems.erase(oIt->second);
+                m_opaqueBatchDirty = true;
                 m_opacityUIUnmap.erase(oIt);
 
                 auto it = m_transparentItems.insert(m_transparentItems.end(), std::move(oldRenderItem));
@@ -497,9 +421,18 @@ namespace sz_gui
                 oldTransparent = true;
             }
 
+            // 上一帧绘制过的不透明对象，合批用到的状态不变时沿用上一次的合批
+            const bool drawnLastFrame = oldOpcacity && ri->m_frameIndex + 1 == m_frameIndex;
+            const auto batchState = IndirectItemState::From(*ri);
+            ri->m_frameIndex = m_frameIndex;
+            if (oldOpcacity && ri->m_position.z != cmd.m_worldPos.z)
+            {
+                m_opaqueOrderDirty = true;
+            }
             ri->m_position = cmd.m_worldPos;
             ri->m_drawMode = getDrawMode(cmd.m_drawMode);
             ri->m_materialType = cmd.m_materialType;
+            ri->m_imageId = cmd.m_imageId;
             uploadToGPU(ri, positions, colorOrUVs, indices, nullptr, cmd);
 
             if (sz_utils::HasFlag(cmd.m_renderState, RenderState::EnableFaceCulling))
@@ -539,33 +472,36 @@ namespace sz_gui
 				ri->m_blend = false;
 			}
 
-            if (sz_utils::HasFlag(cmd.m_renderState, RenderState::EnableScissorSet))
-            {
-                ri->m_scissorSet = true;
-                ri->m_scissorTest = cmd.m_scissorTest.m_scissorTest;
-                ri->m_scissorX = cmd.m_scissorTest.m_x;
-                ri->m_scissorY = cmd.m_scissorTest.m_y;
-                ri->m_scissorW = cmd.m_scissorTest.m_width;
-                ri->m_scissorH = cmd.m_scissorTest.m_height;
-            }
-            else
+            ri->m_clipRect = cmd.m_clipRect;
+
+            if (oldOpcacity)
             {
-                ri->m_scissorSet = false;
+                ++m_opaqueDrawCount;
+                DISABLE_MSVC_WARNING(26813);
+                if (!drawnLastFrame || cmd.m_uploadOp != UploadOperation::Retain ||
+                    IndirectItemState::From(*ri) != batchState)
+                {
+                    m_opaqueBatchDirty = true;
+                }
+                RESTORE_MSVC_WARNING();
+                return;
             }
 
-            if (oldOpcacity || oldTransparent)
+            if (oldTransparent)
             {
                 return;
             }
 
             if (ri->m_blend)
             {
-                m_transparentItems.push_back(std::unique_ptr<RenderItem>(ri));
+                m_transparentItems.push_back(std::move(newItem));
                 m_transparentUIUnmap[cmd.m_onlyId] = std::prev(m_transparentItems.end());
                 return;
             }
 
-            m_opacityItems.push_back(std::unique_ptr<RenderItem>(ri));
+            m_opacityItems.push_back(std::move(newItem));
+            m_opaqueOrderDirty = true;
+            ++m_opaqueDrawCount;
             m_opacityUIUnmap[cmd.m_onlyId] = std::prev(m_opacityItems.end());
         }
 
@@ -578,6 +514,7 @@ namespace sz_gui
             assert(cmd.m_materialType == MaterialType::TextMaterial);
 
             RenderItem* ri = nullptr;
+            RenderItemPtr newItem = nullptr;
             bool oldOpcacity = false;
             bool oldTransparent = false;
 
@@ -585,11 +522,11 @@ namespace sz_gui
             auto tIt = m_transparentTextUnmap.find(cmd.m_onlyId);
             if (oIt == m_opacityTextUnmap.end() && tIt == m_transparentTextUnmap.end())
             {
-                ri = new RenderItem();
-                ri->m_geo = std::make_unique<Geometry>(
-                    positions.size(),
-                    uvs.size(), 
-                    layers.size(),
+                newItem = createRenderItem();
+                ri = newItem.get();
+                ri->m_geo = sz_ds::MakePooled(m_geometryPool,
+                    m_textHeap.get(),
+                    positions.size() / 3,
                     indices.size()
                 );
             }
@@ -608,6 +545,7 @@ namespace sz_gui
             {
                 auto oldRenderItem = std::move(*(oIt->second));
                 m_opacityItems.erase(oIt->second);
+                m_opaqueBatchDirty = true;
                 m_opacityTextUnmap.erase(oIt);
 
                 auto it = m_transparentItems.insert(m_transparentItems.end(), std::move(oldRenderItem));
@@ -616,6 +554,14 @@ namespace sz_gui
                 oldTransparent = true;
             }
 
+            // 上一帧绘制过的不透明对象，合批用到的状态不变时沿用上一次的合批
+            const bool drawnLastFrame = oldOpcacity && ri->m_frameIndex + 1 == m_frameIndex;
+            const auto batchState = IndirectItemState::From(*ri);
+            ri->m_frameIndex = m_frameIndex;
+            if (oldOpcacity && ri->m_position.z != cmd.m_worldPos.z)
+            {
+                m_opaqueOrderDirty = true;
+            }
             ri->m_position = cmd.m_worldPos;
             ri->m_drawMode = getDrawMode(cmd.m_drawMode);
             ri->m_materialType = cmd.m_materialType;
@@ -658,77 +604,42 @@ namespace sz_gui
 				ri->m_blend = false;
 			}
 
-            if (sz_utils::HasFlag(cmd.m_renderState, RenderState::EnableScissorSet))
+            ri->m_clipRect = cmd.m_clipRect;
+
+            if (oldOpcacity)
             {
-                ri->m_scissorSet = true;
-                ri->m_scissorTest = cmd.m_scissorTest.m_scissorTest;
-                ri->m_scissorX = cmd.m_scissorTest.m_x;
-                ri->m_scissorY = cmd.m_scissorTest.m_y;
-                ri->m_scissorW = cmd.m_scissorTest.m_width;
-                ri->m_scissorH = cmd.m_scissorTest.m_height;
+                ++m_opaqueDrawCount;
+                DISABLE_MSVC_WARNING(26813);
+                if (!drawnLastFrame || cmd.m_uploadOp != UploadOperation::Retain ||
+                    IndirectItemState::From(*ri) != batchState)
+                {
+                    m_opaqueBatchDirty = true;
+                }
+                RESTORE_MSVC_WARNING();
+                return;
             }
-            else
-			{
-				ri->m_scissorSet = false;
-			}
 
-            if (oldOpcacity || oldTransparent)
+            if (oldTransparent)
             {
                 return;
             }
 
             if (ri->m_blend)
             {
-                m_transparentItems.push_back(std::unique_ptr<RenderItem>(ri));
+                m_transparentItems.push_back(std::move(newItem));
                 m_transparentTextUnmap[cmd.m_onlyId] = std::prev(m_transparentItems.end());
                 return;
             }
 
-            m_opacityItems.push_back(std::unique_ptr<RenderItem>(ri));
+            m_opacityItems.push_back(std::move(newItem));
+            m_opaqueOrderDirty = true;
+            ++m_opaqueDrawCount;
             m_opacityTextUnmap[cmd.m_onlyId] = std::prev(m_opacityItems.end());
         }
 
-        void GLContext::ExtraAppendDrawCommand(DrawCommand cmd)
+        uint32_t GLContext::LoadImageFile(const std::string& path)
         {
-            assert(cmd.m_onlyId);
-            if (cmd.m_drawTarget != DrawTarget::UI)
-            {
-                return;
-            }
- 
-            RenderItem* ri = nullptr;
-            bool oldOpcacity = false;
-            bool oldTransparent = false;
-            auto oIt = m_opacityUIUnmap.find(cmd.m_onlyId);
-            auto tIt = m_transparentUIUnmap.find(cmd.m_onlyId);
-            if (oIt == m_opacityUIUnmap.end() && tIt == m_transparentUIUnmap.end())
-            {
-                return;
-            }
-            else if (oIt == m_opacityUIUnmap.end())
-            {
-                oldTransparent = true;
-                ri = tIt->second->get();
-            }
-            else
-            {
-                oldOpcacity = true;
-                ri = oIt->second->get();
-            }
-
-            if (sz_utils::HasFlag(cmd.m_renderState, RenderState::EnableScissorSet))
-            {
-                ri->m_scissorSet = true;
-                ri->m_scissorTest = cmd.m_scissorTest.m_scissorTest;
-                ri->m_scissorX = cmd.m_scissorTest.m_x;
-                ri->m_scissorY = cmd.m_scissorTest.m_y;
-                ri->m_scissorW = cmd.m_scissorTest.m_width;
-                ri->m_scissorH = cmd.m_scissorTest.m_height;
-            }
-            else
-            {
-                ri->m_scissorSet = false;
-            }
+            return m_imageAtlas ? m_imageAtlas->Load(path) : 0;
         }
 
         void GLContext::uploadToGPU(RenderItem* ri, const std::vector<float>& positions,
@@ -742,35 +653,25 @@ namespace sz_gui
             }
             RESTORE_MSVC_WARNING();
 
-            if (cmd.m_materialType == MaterialType::ColorMaterial)
+            // 贴图和颜色一样按属性上传，只是顶点格式不同
+            if (cmd.m_materialType == MaterialType::ColorMaterial ||
+                cmd.m_materialType == MaterialType::TextureMaterial)
             {
-                if (cmd.m_uploadOp == (UploadOperation::UploadPos |
-                    UploadOperation::UploadColorOrUv | UploadOperation::UploadIndex))
+                // 变化的顶点属性合并成一次上传
+                const bool uploadPos = sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadPos);
+                const bool uploadColor = sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadColorOrUv);
+                if (uploadPos || uploadColor)
                 {
-                    ri->m_geo->UploadAll(positions, colorOrUVs, indices);
-					return;
+                    m_frameStats.m_uploadBytes += ri->m_geo->UploadVertices(uploadPos ? &positions : nullptr,
+                        uploadColor ? &colorOrUVs : nullptr, nullptr);
                 }
-
-                if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadPos))
-				{
-					ri->m_geo->UploadPositions(positions);
-				}
-				if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadColorOrUv))
-				{
-					ri->m_geo->UploadColorsOrUVs(colorOrUVs);
-				}
 				if (sz_utils::HasFlag(cmd.m_uploadOp, UploadOperation::UploadIndex))
 				{
-					ri->m_geo->UploadIndices(indices);
+					m_frameStats.m_uploadBytes += ri->m_geo->UploadIndices(indices);
 				}
                 return;
             }
 
-            if (cmd.m_materialType == MaterialType::TextureMaterial)
-            {
-                assert(0);
-            }
-
             if (cmd.m_materialType == MaterialType::TextMaterial)
             {
                 assert(layers != nullptr);
@@ -779,14 +680,12 @@ namespace sz_gui
                 {
                     return;
                 }
-                ri->m_geo->UploadAll(positions, colorOrUVs, *layers, indices);
+                m_frameStats.m_uploadBytes += ri->m_geo->UploadAll(positions, colorOrUVs, *layers, indices);
             }
         }
 
         void GLContext::Render()
         {
-            assert(m_scissorStack.empty());
-
             // 设置当前帧，绘制的时候，opengl的必要状态机参数
             // 默认开启面剔除
             GL_CALL(glEnable(GL_CULL_FACE));
@@ -801,12 +700,25 @@ namespace sz_gui
             // 默认关闭颜色混合
             GL_CALL(glDisable(GL_BLEND));
 
+            auto submitBegin = std::chrono::steady_clock::now();
+            m_gpuTimer.Begin();
+
+            // 取回解码完成的图片，回收完成的上传，按预算提交新的上传
+            m_frameStats.m_uploadBytes += m_imageAtlas->Update(m_frameIndex);
+
+            // 过度绘制模式下场景画到离屏帧缓冲，同时计数
+            const bool countOverdraw = m_overdrawMode && m_overdrawCounter.Begin(m_viewportWidth, m_viewportHeight);
+
             // 清理画布 
             GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
+            // 上传阶段可能因为堆扩容改变了vao绑定
+            m_boundVao = 0;
+            GL_CALL(glBindVertexArray(0));
+
             // 先绘制不透明物体，透明物体按照距离摄像机远近排序，由远到近绘制
             m_transparentItems.sort(
-                [this](const std::unique_ptr<RenderItem>& a, const std::unique_ptr<RenderItem>& b) {
+                [this](const RenderItemPtr& a, const RenderItemPtr& b) {
                     auto viewMatrix = m_camera->GetViewMatrix();
 
                     // 计算a的相机系的Z
@@ -823,19 +735,62 @@ namespace sz_gui
                 }
             );
 
+            // 不透明物体由近到远绘制，被挡住的片元由提前深度测试拒绝，对象集合或z变化时才重新排序
+            if (m_opaqueOrderDirty)
+            {
+                // 摄像机看向-Z，z越大越近，list::sort是稳定排序，z相同的保持原来的顺序
+                m_opacityItems.sort([](const RenderItemPtr& a, const RenderItemPtr& b) {
+                    return a->m_position.z > b->m_position.z;
+                });
+                m_opaqueOrderDirty = false;
+                m_opaqueBatchDirty = true;
+            }
+
             // 先绘制不透明物体
-            for (const auto& item : m_opacityItems)
+            if (m_indirectBatcher.IsSupported())
             {
-                renderObject(item);
+                renderOpaqueBatched();
+            }
+            else
+            {
+                for (const auto& item : m_opacityItems)
+                {
+                    if (item->m_frameIndex != m_frameIndex)
+                    {
+                        continue;
+                    }
+                    renderObject(item);
+                }
             }
 
             // 透明物体按照距离摄像机远近排序，由远到近绘制
             for (const auto& item : m_transparentItems)
             {
+                if (item->m_frameIndex != m_frameIndex)
+                {
+                    continue;
+                }
                 renderObject(item);
             }
 
+            if (countOverdraw)
+            {
+                const auto overdraw = m_overdrawCounter.End(*m_overdrawShader);
+                m_frameStats.m_fragments = overdraw.m_fragments;
+                m_frameStats.m_coveredPixels = overdraw.m_coveredPixels;
+            }
+
+            m_gpuTimer.End();
+            m_frameStats.m_submitMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - submitBegin).count();
+            m_frameStats.m_gpuMs = m_gpuTimer.GetLastMs();
+            m_frameStats.m_frameIndex = m_frameIndex;
+            m_lastFrameStats = m_frameStats;
+            m_frameStats = FrameStats{};
+
             SDL_GL_SwapWindow(m_window);
+            ++m_frameIndex;
+            m_opaqueDrawCount = 0;
         }
 
         void GLContext::SetColorTheme(ColorTheme theme) 
@@ -850,6 +805,38 @@ namespace sz_gui
             }
         }
 
+        void GLContext::ReserveDrawData(size_t count)
+        {
+            m_renderItemPool.Reserve(count);
+            m_geometryPool.Reserve(count);
+            // 不知道控件和文字各占多少，四个索引都按总数预留，避免第一帧大量创建时重新哈希
+            m_opacityUIUnmap.reserve(count);
+            m_opacityTextUnmap.reserve(count);
+            m_transparentUIUnmap.reserve(count);
+            m_transparentTextUnmap.reserve(count);
+        }
+
+        RenderPoolStats GLContext::GetPoolStats() const
+        {
+            RenderPoolStats stats;
+            stats.m_renderItem = m_renderItemPool.GetStats();
+            stats.m_geometry = m_geometryPool.GetStats();
+            for (auto* heap : { m_colorHeap.get(), m_textHeap.get(), m_textureHeap.get() })
+            {
+                if (heap)
+                {
+                    stats.m_vertexHeap.Merge(heap->GetVertexStats());
+                    stats.m_indexHeap.Merge(heap->GetIndexStats());
+                }
+            }
+            return stats;
+        }
+
+        RenderItemPtr GLContext::createRenderItem()
+        {
+            return sz_ds::MakePooled(m_renderItemPool);
+        }
+
         GLenum GLContext::getDrawMode(DrawMode mode)
         {
             switch (mode)
@@ -864,15 +851,30 @@ namespace sz_gui
             return GL_TRIANGLES;
         }
 
-        void GLContext::renderObject(const std::unique_ptr<RenderItem>& ri)
+        void GLContext::renderObject(const RenderItemPtr& ri)
         {
+            // 图片还没准备好时绘制占位，加载失败时跳过绘制
+            const ImageRegion* region = nullptr;
+            if (ri->m_materialType == MaterialType::TextureMaterial)
+            {
+                region = m_imageAtlas->Use(ri->m_imageId, m_frameIndex);
+                if (!region && m_imageAtlas->GetState(ri->m_imageId) != ImageState::Failed)
+                {
+                    region = &m_imageAtlas->GetPlaceholder();
+                }
+                if (!region)
+                {
+                    return;
+                }
+            }
+
             // 设置渲染状态
             setFaceCullingState(ri);
             setDepthState(ri);
             setBlendState(ri);
             
             // 决定使用哪个Shader 
-            auto& shader = pickShader(ri->m_materialType);
+            auto& shader = pickShader(ri);
             shader->Begin();
 
             switch (ri->m_materialType)
@@ -882,9 +884,25 @@ namespace sz_gui
                 shader->SetUniformMatrix4x4("modelMatrix", ri->GetModelMatrix());
                 shader->SetUniformMatrix4x4("viewMatrix", m_camera->GetViewMatrix());
                 shader->SetUniformMatrix4x4("projectionMatrix", m_camera->GetProjectionMatrix());
+                // 剪裁矩形，没有超出剪裁区域的用不带剪裁的shader
+                if (ri->IsClipped())
+                {
+                    shader->SetUniformVector4("clipRect", ri->m_clipRect);
+                }
 				break;
 			case MaterialType::TextureMaterial:
-                assert(0);
+                // mvp
+                shader->SetUniformMatrix4x4("modelMatrix", ri->GetModelMatrix());
+                shader->SetUniformMatrix4x4("viewMatrix", m_camera->GetViewMatrix());
+                shader->SetUniformMatrix4x4("projectionMatrix", m_camera->GetProjectionMatrix());
+                // 图集页面
+                shader->SetUniformInt("sampler", (int)m_imageAtlas->GetUnit());
+                m_imageAtlas->Bind(region->m_texture);
+                shader->SetUniformVector4("uvRect", region->m_uvRect);
+                // 透明度
+                shader->SetUniformFloat("opacity", ri->m_opacity);
+                // 剪裁矩形
+                shader->SetUniformVector4("clipRect", ri->m_clipRect);
 				break;
 			case MaterialType::TextMaterial:
                 // mvp
@@ -898,26 +916,90 @@ namespace sz_gui
                 shader->SetUniformFloat("opacity", ri->m_opacity);
                 // 文字颜色
                 shader->SetUniformVector3("textColor", ri->m_textInfo.m_color);
+                // 剪裁矩形
+                shader->SetUniformVector4("clipRect", ri->m_clipRect);
 				break;
 			default:
                 assert(0);
             }
 
-            // 绑定vao
-            GL_CALL(glBindVertexArray(ri->m_geo->GetVao()));
-            // 绘制
-            GL_CALL(glDrawElements(ri->m_drawMode, (GLsizei)ri->m_geo->GetIndicesCount(), GL_UNSIGNED_INT, 0));
+            ++m_frameStats.m_drawCalls;
 
-            // 设置剪裁状态
-            setScissorState(ri);
+            // 同一个堆的几何体共用vao，没变就不重新绑定
+            if (ri->m_geo->GetVao() != m_boundVao)
+            {
+                m_boundVao = ri->m_geo->GetVao();
+                GL_CALL(glBindVertexArray(m_boundVao));
+            }
+            // 按索引区间绘制
+            GL_CALL(glDrawElements(ri->m_drawMode, (GLsizei)ri->m_geo->GetIndicesCount(), GL_UNSIGNED_INT,
+                (const void*)ri->m_geo->GetIndicesByteOffset()));
         }
 
-        std::unique_ptr<Shader>& GLContext::pickShader(MaterialType type)
+        void GLContext::renderOpaqueBatched()
         {
-            switch (type)
+            // 对象集合、顺序和状态都没变时沿用上一次的命令和绘制数据，有对象本帧没绘制时个数会变少
+            if (m_opaqueBatchDirty || m_opaqueDrawCount != m_batchedOpaqueCount)
+            {
+                m_indirectBatcher.Begin();
+                for (const auto& item : m_opacityItems)
+                {
+                    if (item->m_frameIndex != m_frameIndex)
+                    {
+                        continue;
+                    }
+                    m_indirectBatcher.Add(item);
+                }
+                m_frameStats.m_uploadBytes += m_indirectBatcher.Upload();
+                m_batchedOpaqueCount = m_opaqueDrawCount;
+                m_opaqueBatchDirty = false;
+            }
+
+            for (const auto& batch : m_indirectBatcher.GetBatches())
+            {
+                const auto& ri = *batch.m_first;
+                // 贴图不合批，每批只有一个
+                if (ri->m_materialType == MaterialType::TextureMaterial)
+                {
+                    renderObject(ri);
+                    continue;
+                }
+                setFaceCullingState(ri);
+                setDepthState(ri);
+                setBlendState(ri);
+
+                // 同一批的剪裁状态相同，剪裁矩形从SSBO读取
+                auto& shader = ri->m_materialType == MaterialType::TextMaterial ? m_textBatchShader :
+                    (ri->IsClipped() ? m_colorClipBatchShader : m_colorBatchShader);
+                shader->Begin();
+                shader->SetUniformInt("drawBase", (int)batch.m_commandOffset);
+                shader->SetUniformMatrix4x4("viewMatrix", m_camera->GetViewMatrix());
+                shader->SetUniformMatrix4x4("projectionMatrix", m_camera->GetProjectionMatrix());
+                if (ri->m_materialType == MaterialType::TextMaterial)
+                {
+                    shader->SetUniformInt("sampler", (int)m_fontTextureArray->GetUnit());
+                    m_fontTextureArray->Bind();
+                }
+
+                ++m_frameStats.m_drawCalls;
+
+                if (ri->m_geo->GetVao() != m_boundVao)
+                {
+                    m_boundVao = ri->m_geo->GetVao();
+                    GL_CALL(glBindVertexArray(m_boundVao));
+                }
+                m_indirectBatcher.Draw(batch);
+            }
+        }
+
+        std::unique_ptr<Shader>& GLContext::pickShader(const RenderItemPtr& ri)
+        {
+            switch (ri->m_materialType)
             {
             case MaterialType::ColorMaterial:
-                return m_colorShader;
+                return ri->IsClipped() ? m_colorClipShader : m_colorShader;
+			case MaterialType::TextureMaterial:
+				return m_textureShader;
 			case MaterialType::TextMaterial:
 				return m_textShader;
 			default:
@@ -964,7 +1046,7 @@ namespace sz_gui
 			}
         }
         
-        void GLContext::setFaceCullingState(const std::unique_ptr<RenderItem>& ri)
+        void GLContext::setFaceCullingState(const RenderItemPtr& ri)
         {
             if (ri->m_faceCulling)
             {
@@ -978,7 +1060,7 @@ namespace sz_gui
             }
         }
 
-        void GLContext::setDepthState(const std::unique_ptr<RenderItem>& ri)
+        void GLContext::setDepthState(const RenderItemPtr& ri)
         {
             if (ri->m_depthTest)
             {
@@ -1000,7 +1082,7 @@ namespace sz_gui
             }
         }
 
-        void GLContext::setBlendState(const std::unique_ptr<RenderItem>& ri)
+        void GLContext::setBlendState(const RenderItemPtr& ri)
         {
             if (ri->m_blend)
             {
@@ -1012,38 +1094,5 @@ namespace sz_gui
                 GL_CALL(glDisable(GL_BLEND));
             }
         }
-
-        void GLContext::setScissorState(const std::unique_ptr<RenderItem>& ri)
-        {
-            if (!ri->m_scissorSet)
-            {
-                return;
-            }
-
-            if (ri->m_scissorTest)
-			{
-                m_scissorStack.push(true);
-
-				GL_CALL(glEnable(GL_SCISSOR_TEST));
-                GL_CALL(glScissor(ri->m_scissorX, ri->m_scissorY, ri->m_scissorW, ri->m_scissorH));
-			}
-			else
-			{
-                m_scissorStack.pop();
-
-				GL_CALL(glDisable(GL_SCISSOR_TEST));
-			}
-        }
-
-        std::tuple<int32_t, stbtt_packedchar*>
-            GLContext::getPackedCharData(int32_t codepoint)
-        {
-            const auto& it = m_packedCharUnmap.find(codepoint);
-            if (it != m_packedCharUnmap.end())
-            {
-                return { it->second.first, &it->second.second};
-            }
-            return { -1, nullptr};
-        }
     }
 }
\ No newline at end of file
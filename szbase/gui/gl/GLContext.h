@@ -16,15 +16,24 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <stack>
+#include <list>
+#include <unordered_map>
+#include <optional>
 
 #include "../IRender.h"
+#include "../TextLayout.h"
+#include "../../ds/ObjectPool.h"
 #include "Shader.h"
 #include "Camera.h"
 #include "OrthographicCamera.h"
 #include "RenderItem.h"
 #include "CheckRstErr.h"
 #include "TextureArray.h"
+#include "GpuTimer.h"
+#include "GeometryHeap.h"
+#include "IndirectBatcher.h"
+#include "ImageAtlas.h"
+#include "OverdrawCounter.h"
 
 namespace sz_gui 
 {
@@ -57,52 +66,88 @@ namespace sz_gui
             void AppendTextDrawData(const std::vector<float>& positions,
                 const std::vector<float>& uvs, const std::vector<uint32_t>& indices,
                 const std::vector<float>& layers, DrawCommand cmd) override;
-            // 额外加入绘制指令
-            void ExtraAppendDrawCommand(DrawCommand cmd) override;
+            // 加载图片到图集
+            uint32_t LoadImageFile(const std::string& path) override;
             // 渲染
             void Render() override;
             // 窗口大小改变事件
             void OnWindowResize(int width, int height) override
             {
+                if (m_camera && width == m_viewportWidth && height == m_viewportHeight)
+                {
+                    return;
+                }
+                m_viewportWidth = width;
+                m_viewportHeight = height;
                 GL_CALL(glViewport(0, 0, width, height));
                 prepareCamera(width, height);
             }
             // 设置颜色主题
             void SetColorTheme(ColorTheme theme) override;
+            // 预留绘制数据容量
+            void ReserveDrawData(size_t count) override;
+            // 获取渲染对象内存统计
+            RenderPoolStats GetPoolStats() const override;
+            // 获取上一帧的统计
+            const FrameStats& GetFrameStats() const override { return m_lastFrameStats; }
+            // 是否还有图片在解码或者上传
+            bool HasPendingWork() const override { return m_imageAtlas && m_imageAtlas->HasPendingWork(); }
+            // 设置着色器程序二进制缓存目录，需要在Init前调用，默认为SDL用户数据目录下的shader_cache，设为空不缓存
+            void SetProgramCacheDirectory(const std::string& directory) { m_programCacheDirectory = directory; }
+            // 获取着色器构建统计
+            const ShaderBuildStats& GetShaderBuildStats() const { return m_programCache.GetStats(); }
+            // 设置图集显存预算，单位字节，需要在Init前调用，至少要放得下一个共享页面(4MB)
+            void SetImageAtlasBudget(size_t bytes) { m_imageAtlasBudget = bytes; }
+            // 设置每帧图片上传字节数上限，需要在Init前调用
+            void SetImageUploadBudget(size_t bytesPerFrame) { m_imageUploadBytesPerFrame = bytesPerFrame; }
+            // 获取图集统计
+            ImageAtlasStats GetImageAtlasStats() const { return m_imageAtlas ? m_imageAtlas->GetStats() : ImageAtlasStats{}; }
+            // 设置过度绘制模式，开启后屏幕显示热度图，帧统计中带片元数，只用于测量
+            // 开启后每帧都用glReadPixels同步回读整个帧缓冲，会等GPU画完，帧耗时不能代表正常模式
+            void SetOverdrawMode(bool enable) { m_overdrawMode = enable; }
+            // 是否开启过度绘制模式
+            bool IsOverdrawMode() const { return m_overdrawMode; }
+            // 过度绘制热度纹理，开启过度绘制模式并渲染过一帧后有效
+            GLuint GetOverdrawHeatTexture() const { return m_overdrawCounter.GetHeatTexture(); }
 
         private:
             // 上传数据到GPU
             void uploadToGPU(RenderItem* ri, const std::vector<float>& positions,
                 const std::vector<float>& colorOrUVs, const std::vector<uint32_t>& indices,
                 const std::vector<float>* const layers, DrawCommand cmd);
+            // 从对象池创建渲染对象
+            RenderItemPtr createRenderItem();
             // 获取绘制命令
             GLenum getDrawMode(DrawMode mode);
             // 绘制对象
-            void renderObject(const std::unique_ptr<RenderItem>& ri);
-            // 根据Material类型不同，挑选不同的shader
-            std::unique_ptr<Shader>& pickShader(MaterialType type);
+            void renderObject(const RenderItemPtr& ri);
+            // 不透明物体合批绘制，只在支持多重间接绘制时使用
+            void renderOpaqueBatched();
+            // 根据Material类型和是否剪裁，挑选不同的shader
+            std::unique_ptr<Shader>& pickShader(const RenderItemPtr& ri);
             // 混合相关，获取混合因子
             GLenum getBlendSFactor(BlendFuncType type);
             GLenum getBlendDFactor(BlendFuncType type);
             // 深度测试相关，获取深度测试函数
             GLenum getDepthFunc(DepthFuncType type);
             //  设置面剔除状态
-            void setFaceCullingState(const std::unique_ptr<RenderItem>& ri);
+            void setFaceCullingState(const RenderItemPtr& ri);
             // 设置深度测试状态
-            void setDepthState(const std::unique_ptr<RenderItem>& ri);
+            void setDepthState(const RenderItemPtr& ri);
             // 设置混合状态
-            void setBlendState(const std::unique_ptr<RenderItem>& ri);
-            // 设置裁剪测试状态
-            void setScissorState(const std::unique_ptr<RenderItem>& ri);
+            void setBlendState(const RenderItemPtr& ri);
             // 准备摄像机
             void prepareCamera(int width, int height)
             {
+                if (m_camera)
+                {
+                    // 原地重置投影盒子，不重新分配
+                    m_camera->Reset(0.0f, float(width), 0.0f, float(height), 0.0f, 1000.f);
+                    return;
+                }
                 m_camera = std::make_unique<OrthographicCamera>(0.0f, float(width), 0.0f,
                     float(height), 0.0f, 1000.f);
             }
-            // 根据codepoint获取数据
-            std::tuple<int32_t, stbtt_packedchar*>
-                getPackedCharData(int32_t codepoint);
 
         public:
             // 字体渲染相关静态成员
@@ -122,35 +167,74 @@ namespace sz_gui
             static const int CJK_BATCH_SIZE = 16384;
             // 字体图集层数
             static const int FONT_LAYERS = 1 + ((CJK_END_CODEPOINT - CJK_START_CODEPOINT + 1) + CJK_BATCH_SIZE - 1) / CJK_BATCH_SIZE;
+            // 几何体堆初始容量，单位顶点/索引个数，约能放下上千个控件
+            static constexpr size_t COLOR_HEAP_VERTICES = 16 * 1024;
+            static constexpr size_t COLOR_HEAP_INDICES = 32 * 1024;
+            static constexpr size_t TEXT_HEAP_VERTICES = 64 * 1024;
+            static constexpr size_t TEXT_HEAP_INDICES = 96 * 1024;
+            static constexpr size_t TEXTURE_HEAP_VERTICES = 1024;
+            static constexpr size_t TEXTURE_HEAP_INDICES = 1536;
+            // 图集纹理单元，0给字体纹理数组
+            static constexpr uint32_t IMAGE_ATLAS_UNIT = 1;
+            // 图集默认显存预算
+            static constexpr size_t DEFAULT_IMAGE_ATLAS_BUDGET = 64 * 1024 * 1024;
 
         private:
-            using RenderItemLiist = std::list<std::unique_ptr<RenderItem>>;
-            using RenderItemIdUnmap = std::unordered_map<uint64_t, RenderItemLiist::iterator>;
+            // 链表和哈希表节点也走对象池，避免逐个new
+            using RenderItemLiist = std::list<RenderItemPtr, sz_ds::PoolAllocator<RenderItemPtr>>;
+            using RenderItemIdUnmap = std::unordered_map<uint64_t, RenderItemLiist::iterator,
+                std::hash<uint64_t>, std::equal_to<uint64_t>,
+                sz_ds::PoolAllocator<std::pair<const uint64_t, RenderItemLiist::iterator>>>;
 
             // SDL窗口指针
             SDL_Window* m_window = nullptr;
             // gl上下文
             SDL_GLContext m_glContext = nullptr;
             // 摄像机
-            std::unique_ptr<Camera> m_camera = nullptr;
+            std::unique_ptr<OrthographicCamera> m_camera = nullptr;
+            // 视口宽高
+            int m_viewportWidth = 0;
+            int m_viewportHeight = 0;
             // err shader
             std::unique_ptr<Shader> m_errShader{ nullptr };
             // 颜色shader
             std::unique_ptr<Shader> m_colorShader{ nullptr };
+            // 带剪裁的颜色shader
+            std::unique_ptr<Shader> m_colorClipShader{ nullptr };
             // 材质shader
             std::unique_ptr<Shader> m_textureShader{ nullptr };
             // 文字shader
             std::unique_ptr<Shader> m_textShader{ nullptr };
+            // 着色器程序二进制缓存
+            ProgramCache m_programCache;
+            // 缓存目录，nullopt表示使用默认目录
+            std::optional<std::string> m_programCacheDirectory;
+            // 颜色、文字和贴图几何体的GPU堆，需要先于几何体池声明
+            std::unique_ptr<GeometryHeap> m_colorHeap;
+            std::unique_ptr<GeometryHeap> m_textHeap;
+            std::unique_ptr<GeometryHeap> m_textureHeap;
+            // 当前绑定的vao
+            GLuint m_boundVao = 0;
+            // 渲染对象池和几何体池，需要先于绘制对象容器声明，保证最后析构
+            sz_ds::ObjectPool<RenderItem> m_renderItemPool;
+            sz_ds::ObjectPool<Geometry> m_geometryPool;
             // 不透明绘制对象
             RenderItemIdUnmap m_opacityUIUnmap;
             RenderItemIdUnmap m_opacityTextUnmap;
             RenderItemLiist m_opacityItems;
+            // 不透明对象需要重新按z排序
+            bool m_opaqueOrderDirty = false;
+            // 不透明对象的合批需要重建，对象集合、顺序、几何区间或者合批用到的状态变化时标记
+            bool m_opaqueBatchDirty = true;
+            // 本帧收集的不透明对象个数，和上次合批时不同说明有对象本帧没有绘制
+            size_t m_opaqueDrawCount = 0;
+            size_t m_batchedOpaqueCount = 0;
             // 透明绘制对象
             RenderItemIdUnmap m_transparentUIUnmap;
             RenderItemIdUnmap m_transparentTextUnmap;
             RenderItemLiist m_transparentItems;
-            // 裁剪测试栈
-            std::stack<bool> m_scissorStack;
+            // 当前帧序号
+            uint64_t m_frameIndex = 1;
             // 颜色主题
             ColorTheme m_colorTheme = ColorTheme::LightMode;
             // 字体烘焙结果，codepoint<->(layer, stbtt_packedchar)
@@ -167,6 +251,34 @@ namespace sz_gui
             int32_t m_fontLineGap{ 0 };
             // 字体设计单位到FONT_HEIGHT的转换比例
             float m_fontScale{ 0.0 };
+            // 文字排版
+            TextLayout m_textLayout;
+            // 图片图集
+            std::unique_ptr<ImageAtlas> m_imageAtlas;
+            // 图集显存预算
+            size_t m_imageAtlasBudget = DEFAULT_IMAGE_ATLAS_BUDGET;
+            // 每帧图片上传预算
+            size_t m_imageUploadBytesPerFrame = ImageAtlas::DEFAULT_UPLOAD_BYTES_PER_FRAME;
+            // GPU计时
+            GpuTimer m_gpuTimer;
+            // 不透明物体合批
+            IndirectBatcher m_indirectBatcher;
+            // 合批颜色shader
+            std::unique_ptr<Shader> m_colorBatchShader{ nullptr };
+            // 合批带剪裁的颜色shader
+            std::unique_ptr<Shader> m_colorClipBatchShader{ nullptr };
+            // 合批文字shader
+            std::unique_ptr<Shader> m_textBatchShader{ nullptr };
+            // 过度绘制统计
+            OverdrawCounter m_overdrawCounter;
+            // 过度绘制热度shader
+            std::unique_ptr<Shader> m_overdrawShader{ nullptr };
+            // 是否开启过度绘制模式
+            bool m_overdrawMode = false;
+            // 当前帧的统计，上传发生在收集阶段，绘制结束时归档
+            FrameStats m_frameStats;
+            // 上一帧的统计
+            FrameStats m_lastFrameStats;
         };
     }
 }
\ No newline at end of file
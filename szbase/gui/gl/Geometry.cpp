@@ -2,280 +2,273 @@
 #include "CheckRstErr.h"
 
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
 
 namespace sz_gui
 {
 	namespace gl
 	{
-		Geometry::Geometry(size_t posSize, size_t colorOrUVSize,
-			size_t indicesSize, bool useColor)
+		namespace
 		{
-			m_useColor = useColor;
-			m_posCapacity = posSize * sizeof(float);
-			m_colorOrUVCapacity = colorOrUVSize * sizeof(float);
-			m_indicesCapacity = indicesSize * sizeof(uint32_t);
-
-			GL_CALL(glGenBuffers(1, &m_posVbo));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_posCapacity, 0, GL_DYNAMIC_DRAW));
-
-			if (m_useColor)
+			uint16_t quantizeUnit16(float value)
 			{
-				GL_CALL(glGenBuffers(1, &m_colorVbo));
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo));
-				GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_colorOrUVCapacity, 0, GL_DYNAMIC_DRAW));
+				return uint16_t(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
 			}
-			else
-			{
-				GL_CALL(glGenBuffers(1, &m_uvVbo));
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-				GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_colorOrUVCapacity, 0, GL_DYNAMIC_DRAW));
-			}
-
-			GL_CALL(glGenBuffers(1, &m_ebo));
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-			GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indicesCapacity, 0, GL_DYNAMIC_DRAW));
-
-			GL_CALL(glGenVertexArrays(1, &m_vao));
-			GL_CALL(glBindVertexArray(m_vao));
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glEnableVertexAttribArray(0));
-			GL_CALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0));
-
-			if (m_useColor)
-			{
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo));
-				GL_CALL(glEnableVertexAttribArray(1));
-				GL_CALL(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0));
-			}
-			else
+			uint8_t quantizeUnit8(float value)
 			{
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-				GL_CALL(glEnableVertexAttribArray(1));
-				GL_CALL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, (void*)0));
+				return uint8_t(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
 			}
-
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-
-			GL_CALL(glBindVertexArray(0));
 		}
-		
-		Geometry::Geometry(size_t posSize, size_t uvSize,
-			size_t layerSize, size_t indicesSize)
-		{
-			m_useColor = false;
-			m_posCapacity = posSize * sizeof(float);
-			m_colorOrUVCapacity = uvSize * sizeof(float);
-			m_layerCapacity = layerSize * sizeof(float);
-			m_indicesCapacity = indicesSize * sizeof(uint32_t);
 
-			GL_CALL(glGenBuffers(1, &m_posVbo));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_posCapacity, 0, GL_DYNAMIC_DRAW));
-
-			GL_CALL(glGenBuffers(1, &m_uvVbo));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-			GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_colorOrUVCapacity, 0, GL_DYNAMIC_DRAW));
-			
-			GL_CALL(glGenBuffers(1, &m_layerVbo));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_layerVbo));
-			GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_layerCapacity, 0, GL_DYNAMIC_DRAW));
-
-			GL_CALL(glGenBuffers(1, &m_ebo));
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-			GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indicesCapacity, 0, GL_DYNAMIC_DRAW));
-
-			GL_CALL(glGenVertexArrays(1, &m_vao));
-			GL_CALL(glBindVertexArray(m_vao));
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glEnableVertexAttribArray(0));
-			GL_CALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0));
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-			GL_CALL(glEnableVertexAttribArray(1));
-			GL_CALL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, (void*)0));
-			
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_layerVbo));
-			GL_CALL(glEnableVertexAttribArray(2));
-			GL_CALL(glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(float) * 1, (void*)0));
-
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+		std::string InjectPositionScale(const char* source, int fractionBits)
+		{
+			std::string code(source);
+			const size_t versionEnd = code.find('\n');
+			assert(code.compare(0, 8, "#version") == 0 && versionEnd != std::string::npos);
+			code.insert(versionEnd + 1, "#define POSITION_SCALE (1.0 / " + std::to_string(1 << fractionBits) + ".0)\n");
+			return code;
+		}
 
-			GL_CALL(glBindVertexArray(0));
+		Geometry::Geometry(GeometryHeap* heap, size_t vertexCount, size_t indicesSize)
+		{
+			assert(heap);
+			m_heap = heap;
+			m_useColor = heap->UseColor();
+			m_positionFractionBits = heap->GetPositionFractionBits();
+			reserveVertices(vertexCount);
+			reserveIndices(indicesSize);
 		}
 
 		Geometry::~Geometry()
 		{
-			if (glIsVertexArray(m_vao))
-			{
-				GL_CALL(glDeleteVertexArrays(1, &m_vao));
-				m_vao = 0;
-			}
-
-			if (glIsBuffer(m_posVbo))
-			{
-				GL_CALL(glDeleteBuffers(1, &m_posVbo));
-				m_posVbo = 0;
-			}
-
-			if (glIsBuffer(m_colorVbo))
-			{
-				GL_CALL(glDeleteBuffers(1, &m_colorVbo));
-				m_colorVbo = 0;
-			}
-
-			if (glIsBuffer(m_uvVbo))
-			{
-				GL_CALL(glDeleteBuffers(1, &m_uvVbo));
-				m_uvVbo = 0;
-			}
-
-			if (glIsBuffer(m_ebo))
-			{
-				GL_CALL(glDeleteBuffers(1, &m_ebo));
-				m_ebo = 0;
-			}
-
-			if (glIsBuffer(m_layerVbo))
-			{
-				GL_CALL(glDeleteBuffers(1, &m_layerVbo));
-				m_layerVbo = 0;
-			}
+			m_heap->FreeVertices(m_vertexOffset, m_vertexReserved);
+			m_heap->FreeIndices(m_indexOffset, m_indexReserved);
 		}
 
-		void Geometry::UploadPositions(const std::vector<float>& positions)
+		size_t Geometry::UploadPositions(const std::vector<float>& positions)
 		{
-			assert((positions.size() * sizeof(float)) <= m_posCapacity);
+			return UploadVertices(&positions, nullptr, nullptr);
+		}
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float),
-				positions.data()));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		size_t Geometry::UploadColorsOrUVs(const std::vector<float>& colorsOruvs)
+		{
+			return UploadVertices(nullptr, &colorsOruvs, nullptr);
 		}
 
-		void Geometry::UploadColorsOrUVs(const std::vector<float>& colorsOruvs)
+		size_t Geometry::UploadIndices(const std::vector<uint32_t>& indices)
 		{
-			assert((colorsOruvs.size() * sizeof(float)) <= m_colorOrUVCapacity);
+			m_indicesCount = indices.size();
+			reserveIndices(m_indicesCount);
 
-			if (m_useColor)
+			// 没有BaseVertex绘制，顶点偏移直接加到索引上
+			const uint32_t base = (uint32_t)m_vertexOffset;
+			m_indices.resize(m_indicesCount);
+			for (size_t i = 0; i < m_indicesCount; ++i)
 			{
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo));
-				GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, colorsOruvs.size() * sizeof(float),
-					colorsOruvs.data()));
-				GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-				return;
+				m_indices[i] = indices[i] + base;
 			}
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, colorsOruvs.size() * sizeof(float),
-				colorsOruvs.data()));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+			return uploadIndices();
 		}
 
-		void Geometry::UploadIndices(const std::vector<uint32_t>& indices)
+		size_t Geometry::UploadLayers(const std::vector<float>& layers)
 		{
-			assert((indices.size() * sizeof(uint32_t)) <= m_indicesCapacity);
-
-			m_indicesCount = indices.size();
-
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-			GL_CALL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t),
-				indices.data()));
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+			assert(!m_useColor);
+			return UploadVertices(nullptr, nullptr, &layers);
 		}
 
-		void Geometry::UploadLayers(const std::vector<float>& layers)
+		size_t Geometry::UploadVertices(const std::vector<float>* positions,
+			const std::vector<float>* colorsOrUVs,
+			const std::vector<float>* layers
+		)
 		{
-			assert(!m_useColor);
-			assert((layers.size() * sizeof(float)) <= m_layerCapacity);
+			size_t bytes = 0;
+			if (positions)
+			{
+				const size_t vertexCount = positions->size() / 3;
+				const size_t oldOffset = m_vertexOffset;
+				if (reserveVertices(vertexCount))
+				{
+					// 顶点区间移动了，已上传的索引跟着平移
+					const uint32_t delta = (uint32_t)m_vertexOffset - (uint32_t)oldOffset;
+					for (auto& index : m_indices)
+					{
+						index += delta;
+					}
+					bytes += uploadIndices();
+				}
+				resizeVertices(vertexCount);
+				packPositions(*positions);
+			}
+			if (colorsOrUVs)
+			{
+				if (m_useColor)
+				{
+					packColors(*colorsOrUVs);
+				}
+				else
+				{
+					packUVs(*colorsOrUVs);
+				}
+			}
+			if (layers)
+			{
+				packLayers(*layers);
+			}
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_layerVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, layers.size() * sizeof(float), 
-				layers.data()));
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+			const void* data = m_useColor ? (const void*)m_colorVertices.data() : (const void*)m_textVertices.data();
+			const size_t count = m_useColor ? m_colorVertices.size() : m_textVertices.size();
+			m_heap->UploadVertices(m_vertexOffset, data, count);
+			return bytes + count * GetVertexStride();
 		}
 
-		void Geometry::UploadAll(const std::vector<float>& positions,
+		size_t Geometry::UploadAll(const std::vector<float>& positions,
 			const std::vector<float>& uvsOrColors,
 			const std::vector<uint32_t>& indices
 		)
 		{
 			if (m_useColor)
 			{
-				UploadColors(positions, uvsOrColors, indices);
-				return;
+				return UploadColors(positions, uvsOrColors, indices);
 			}
-			UploadUVs(positions, uvsOrColors, indices);
+			return UploadUVs(positions, uvsOrColors, indices);
 		}
 
-		void Geometry::UploadAll(const std::vector<float>& positions,
+		size_t Geometry::UploadAll(const std::vector<float>& positions,
 			const std::vector<float>& uvs,
 			const std::vector<float>& layers,
 			const std::vector<uint32_t>& indices
 		)
 		{
 			assert(!m_useColor);
-			UploadUVs(positions, uvs, indices);
-			UploadLayers(layers);
+			return UploadVertices(&positions, &uvs, &layers) + UploadIndices(indices);
 		}
 
-		void Geometry::UploadUVs(const std::vector<float>& positions,
+		size_t Geometry::UploadUVs(const std::vector<float>& positions,
 			const std::vector<float>& uvs,
 			const std::vector<uint32_t>& indices
 		)
 		{
 			assert(!m_useColor);
-			assert((positions.size() * sizeof(float)) <= m_posCapacity);
-			assert((uvs.size() * sizeof(float)) <= m_colorOrUVCapacity);
-			assert((indices.size() * sizeof(uint32_t)) <= m_indicesCapacity);
-
-			m_indicesCount = indices.size();
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float),
-				positions.data()));
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_uvVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, uvs.size() * sizeof(float),
-				uvs.data()));
-
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-			GL_CALL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t),
-				indices.data()));
-
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+			return UploadVertices(&positions, &uvs, nullptr) + UploadIndices(indices);
 		}
 
-		void Geometry::UploadColors(
+		size_t Geometry::UploadColors(
 			const std::vector<float>& positions,
 			const std::vector<float>& colors,
 			const std::vector<uint32_t>& indices
 		)
 		{
 			assert(m_useColor);
-			assert((positions.size() * sizeof(float)) <= m_posCapacity);
-			assert((colors.size() * sizeof(float)) <= m_colorOrUVCapacity);
-			assert((indices.size() * sizeof(uint32_t)) <= m_indicesCapacity);
+			return UploadVertices(&positions, &colors, nullptr) + UploadIndices(indices);
+		}
 
-			m_indicesCount = indices.size();
+		void Geometry::resizeVertices(size_t vertexCount)
+		{
+			if (m_useColor)
+			{
+				m_colorVertices.resize(vertexCount, ColorVertex{ 0, 0, 255, 255, 255, 255 });
+				return;
+			}
+			m_textVertices.resize(vertexCount, TextVertex{});
+		}
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_posVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float),
-				positions.data()));
+		void Geometry::packPositions(const std::vector<float>& positions)
+		{
+			const size_t count = positions.size() / 3;
+			for (size_t i = 0; i < count; ++i)
+			{
+				assert(positions[i * 3 + 2] == 0.0f);
+				const int16_t x = QuantizePosition(positions[i * 3], m_positionFractionBits);
+				const int16_t y = QuantizePosition(positions[i * 3 + 1], m_positionFractionBits);
+				if (m_useColor)
+				{
+					m_colorVertices[i].m_x = x;
+					m_colorVertices[i].m_y = y;
+				}
+				else
+				{
+					m_textVertices[i].m_x = x;
+					m_textVertices[i].m_y = y;
+				}
+			}
+		}
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo));
-			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, colors.size() * sizeof(float),
-				colors.data()));
+		void Geometry::packColors(const std::vector<float>& colors)
+		{
+			// 每个顶点RGB或RGBA
+			const size_t count = m_colorVertices.size();
+			if (count == 0)
+			{
+				return;
+			}
+			const size_t components = colors.size() / count;
+			assert(components == 3 || components == 4);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float* c = colors.data() + i * components;
+				auto& vertex = m_colorVertices[i];
+				vertex.m_r = quantizeUnit8(c[0]);
+				vertex.m_g = quantizeUnit8(c[1]);
+				vertex.m_b = quantizeUnit8(c[2]);
+				vertex.m_a = components == 4 ? quantizeUnit8(c[3]) : 255;
+			}
+		}
+
+		void Geometry::packUVs(const std::vector<float>& uvs)
+		{
+			const size_t count = std::min(m_textVertices.size(), uvs.size() / 2);
+			for (size_t i = 0; i < count; ++i)
+			{
+				m_textVertices[i].m_u = quantizeUnit16(uvs[i * 2]);
+				m_textVertices[i].m_v = quantizeUnit16(uvs[i * 2 + 1]);
+			}
+		}
+
+		void Geometry::packLayers(const std::vector<float>& layers)
+		{
+			const size_t count = std::min(m_textVertices.size(), layers.size());
+			for (size_t i = 0; i < count; ++i)
+			{
+				assert(layers[i] >= 0.0f && layers[i] < 256.0f);
+				m_textVertices[i].m_layer = uint8_t(layers[i]);
+			}
+		}
 
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
-			GL_CALL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(uint32_t),
-				indices.data()));
+		bool Geometry::reserveVertices(size_t vertexCount)
+		{
+			if (vertexCount <= m_vertexReserved)
+			{
+				return false;
+			}
 
-			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+			// 容量不够时按倍数重新分配区间，旧区间还给堆
+			const size_t reserved = std::max(vertexCount, m_vertexReserved * 2);
+			m_heap->FreeVertices(m_vertexOffset, m_vertexReserved);
+			m_vertexOffset = m_heap->AllocateVertices(reserved);
+			m_vertexReserved = reserved;
+			return true;
+		}
+
+		void Geometry::reserveIndices(size_t indicesSize)
+		{
+			if (indicesSize <= m_indexReserved)
+			{
+				return;
+			}
+
+			const size_t reserved = std::max(indicesSize, m_indexReserved * 2);
+			m_heap->FreeIndices(m_indexOffset, m_indexReserved);
+			m_indexOffset = m_heap->AllocateIndices(reserved);
+			m_indexReserved = reserved;
+		}
+
+		size_t Geometry::uploadIndices()
+		{
+			m_heap->UploadIndices(m_indexOffset, m_indices.data(), m_indices.size());
+			return m_indices.size() * sizeof(uint32_t);
 		}
 	}
-}
\ No newline at end of file
+}
@@ -8,75 +8,161 @@
 #include <glad/glad.h>
 #endif
 
+#include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "GeometryHeap.h"
+
 namespace sz_gui
 {
 	namespace gl
 	{
+		// 顶点位置存成int16定点数，局部像素坐标乘以2^小数位数，着色器里的缩放由InjectPositionScale按这里的位数生成
+		// 颜色顶点1/4像素精度，范围约±8191像素，可以覆盖整个窗口大小的控件
+		constexpr int COLOR_POSITION_FRACTION_BITS = 2;
+		// 文字顶点1/16像素精度，范围约±2047像素，字形亚像素位置不变形，单行宽度由TextLayout限制
+		constexpr int TEXT_POSITION_FRACTION_BITS = 4;
+		// 贴图顶点和文字同一格式，但用1/4像素精度，范围约±8191像素，4K全屏图片也放得下
+		constexpr int TEXTURE_POSITION_FRACTION_BITS = 2;
+		// 超出范围是调用方的错误，调试版断言，发布版截断到边界
+
+		// 定点位置能表示的最大像素坐标
+		constexpr float MaxFixedPosition(int fractionBits)
+		{
+			return 32767.0f / float(1 << fractionBits);
+		}
+
+		// 局部像素坐标转成定点数
+		inline int16_t QuantizePosition(float value, int fractionBits)
+		{
+			const float fixed = std::round(value * float(1 << fractionBits));
+			assert(fixed >= -32768.0f && fixed <= 32767.0f && "vertex position out of fixed point range");
+			return int16_t(std::clamp(fixed, -32768.0f, 32767.0f));
+		}
+
+		// 在着色器源码的#version行之后注入POSITION_SCALE宏，把定点顶点位置还原为像素
+		std::string InjectPositionScale(const char* source, int fractionBits);
+
+		// 颜色顶点，交错存放，8字节
+		struct ColorVertex
+		{
+			// 局部坐标，定点数
+			int16_t m_x;
+			int16_t m_y;
+			// 标准化RGBA8
+			uint8_t m_r;
+			uint8_t m_g;
+			uint8_t m_b;
+			uint8_t m_a;
+		};
+		static_assert(sizeof(ColorVertex) == 8);
+
+		// 文字顶点，交错存放，12字节
+		struct TextVertex
+		{
+			// 局部坐标，定点数
+			int16_t m_x;
+			int16_t m_y;
+			// 标准化uint16纹理坐标
+			uint16_t m_u;
+			uint16_t m_v;
+			// 纹理层
+			uint8_t m_layer;
+			// 属性按4字节对齐
+			uint8_t m_padding[3];
+		};
+		static_assert(sizeof(TextVertex) == 12);
+
+		// 几何体，顶点属性量化后交错存放，输入仍然是float数组
+		// 位置每个顶点3个float，局部z必须为0，深度由模型矩阵给出
+		// 顶点和索引是GeometryHeap中的一段区间，索引上传时加上顶点偏移，所有几何体共用堆的VAO
 		class Geometry
 		{
 		public:
-			Geometry(size_t posSize, size_t colorOruvSize, 
-				size_t indicesSize, bool useColor);
-			Geometry(size_t posSize, size_t uvSize,
-				size_t layerSize, size_t indicesSize);
+			// 顶点格式和位置精度由heap决定，vertexCount和indicesSize是预留的顶点和索引个数
+			Geometry(GeometryHeap* heap, size_t vertexCount, size_t indicesSize);
 			~Geometry();
 
-			// 上传
-			void UploadPositions(const std::vector<float>& positions);
-			void UploadColorsOrUVs(const std::vector<float>& colorsOruvs);
-			void UploadIndices(const std::vector<uint32_t>& indices);
-			void UploadLayers(const std::vector<float>& layers);
+			Geometry(const Geometry&) = delete;
+			Geometry& operator=(const Geometry&) = delete;
+
+			// 上传，返回上传的字节数
+			size_t UploadPositions(const std::vector<float>& positions);
+			size_t UploadColorsOrUVs(const std::vector<float>& colorsOruvs);
+			size_t UploadIndices(const std::vector<uint32_t>& indices);
+			size_t UploadLayers(const std::vector<float>& layers);
+			// 更新顶点属性，为nullptr的属性保持不变，只上传一次VBO
+			size_t UploadVertices(const std::vector<float>* positions,
+				const std::vector<float>* colorsOrUVs,
+				const std::vector<float>* layers
+			);
 			// 上传所有
-			void UploadAll(const std::vector<float>& positions,
+			size_t UploadAll(const std::vector<float>& positions,
 				const std::vector<float>& uvsOrColors,
 				const std::vector<uint32_t>& indices
 			);
-			void UploadAll(const std::vector<float>& positions,
+			size_t UploadAll(const std::vector<float>& positions,
 				const std::vector<float>& uvs,
 				const std::vector<float>& layers,
 				const std::vector<uint32_t>& indices
 			);
-			void UploadUVs(const std::vector<float>& positions,
+			size_t UploadUVs(const std::vector<float>& positions,
 				const std::vector<float>& uvs,
 				const std::vector<uint32_t>& indices
 			);
-			void UploadColors(const std::vector<float>& positions,
+			size_t UploadColors(const std::vector<float>& positions,
 				const std::vector<float>& colors,
 				const std::vector<uint32_t>& indices
 			);
-			
-			// 获取VAO
-			GLuint GetVao() const { return m_vao; }
+
+			// 获取VAO，同一个堆的几何体相同
+			GLuint GetVao() const { return m_heap->GetVao(); }
 			// 获取绘制索引个数
 			size_t GetIndicesCount() const { return m_indicesCount; }
+			// 索引在堆的索引缓冲中的字节偏移，作为glDrawElements的indices参数
+			size_t GetIndicesByteOffset() const { return m_indexReserved ? m_indexOffset * sizeof(uint32_t) : 0; }
+			// 每个顶点的字节数
+			size_t GetVertexStride() const { return m_heap->GetVertexStride(); }
+
+		private:
+			// 保证预留的顶点区间至少能放下vertexCount个顶点，区间移动时返回true
+			bool reserveVertices(size_t vertexCount);
+			// 保证预留的索引区间至少能放下indicesSize个索引
+			void reserveIndices(size_t indicesSize);
+			// 上传已加上顶点偏移的索引
+			size_t uploadIndices();
+			// 量化写入暂存区
+			void packPositions(const std::vector<float>& positions);
+			void packColors(const std::vector<float>& colors);
+			void packUVs(const std::vector<float>& uvs);
+			void packLayers(const std::vector<float>& layers);
+			// 暂存区顶点个数变化时调整大小
+			void resizeVertices(size_t vertexCount);
 
 		private:
-			// 顶点数组对象，用来存储一个Mesh网格所有的顶点属性描述信息
-			GLuint m_vao{ 0 };
-			// 顶点缓冲对象，用来存储顶点属性数据
-			// 顶点坐标vbo
-			GLuint m_posVbo{ 0 };
-			// 顶点颜色vbo
-			GLuint m_colorVbo{ 0 };
-			// 顶点uv坐标vbo
-			GLuint m_uvVbo{ 0 };
-			// 顶点层vbo
-			GLuint m_layerVbo{ 0 };
-			// 元素缓冲对象/索引缓冲对象，用来存储顶点绘制顺序索引号
-			GLuint m_ebo{ 0 };
+			// 所在的堆
+			GeometryHeap* m_heap{ nullptr };
 			// 绘制索引个数
 			size_t m_indicesCount{ 0 };
 			// 是否使用颜色
 			bool m_useColor{ false };
-			// 顶点容量
-			size_t m_posCapacity{ 0 };
-			size_t m_colorOrUVCapacity{ 0 };
-			size_t m_layerCapacity{ 0 };
-			size_t m_indicesCapacity{ 0 };
+			// 位置定点数的小数位数
+			int m_positionFractionBits{ 0 };
+			// 量化后的顶点暂存，部分属性更新时保留其他属性，整体上传
+			std::vector<ColorVertex> m_colorVertices;
+			std::vector<TextVertex> m_textVertices;
+			// 已加上顶点偏移的索引，顶点区间移动时重新计算
+			std::vector<uint32_t> m_indices;
+			// 堆中的顶点区间
+			size_t m_vertexOffset{ 0 };
+			size_t m_vertexReserved{ 0 };
+			// 堆中的索引区间
+			size_t m_indexOffset{ 0 };
+			size_t m_indexReserved{ 0 };
 		};
 	}
-}
\ No newline at end of file
+}
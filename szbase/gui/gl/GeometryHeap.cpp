@@ -0,0 +1,173 @@
+#include "GeometryHeap.h"
+#include "Geometry.h"
+#include "CheckRstErr.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		GeometryHeap::GeometryHeap(bool useColor, int positionFractionBits, size_t vertexCapacity, size_t indexCapacity) :
+			m_useColor(useColor),
+			m_positionFractionBits(positionFractionBits),
+			m_vertexStride(useColor ? sizeof(ColorVertex) : sizeof(TextVertex)),
+			m_vertexAllocator(std::max<size_t>(vertexCapacity, 1)),
+			m_indexAllocator(std::max<size_t>(indexCapacity, 1))
+		{
+			GL_CALL(glGenBuffers(1, &m_vbo));
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+			GL_CALL(glBufferData(GL_ARRAY_BUFFER, m_vertexAllocator.GetCapacity() * m_vertexStride, 0, GL_DYNAMIC_DRAW));
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+			GL_CALL(glGenBuffers(1, &m_ebo));
+			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+			GL_CALL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexAllocator.GetCapacity() * sizeof(uint32_t), 0,
+				GL_DYNAMIC_DRAW));
+			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+
+			GL_CALL(glGenVertexArrays(1, &m_vao));
+			setupVao();
+		}
+
+		GeometryHeap::~GeometryHeap()
+		{
+			if (glIsVertexArray(m_vao))
+			{
+				GL_CALL(glDeleteVertexArrays(1, &m_vao));
+				m_vao = 0;
+			}
+
+			if (glIsBuffer(m_vbo))
+			{
+				GL_CALL(glDeleteBuffers(1, &m_vbo));
+				m_vbo = 0;
+			}
+
+			if (glIsBuffer(m_ebo))
+			{
+				GL_CALL(glDeleteBuffers(1, &m_ebo));
+				m_ebo = 0;
+			}
+		}
+
+		size_t GeometryHeap::AllocateVertices(size_t count)
+		{
+			auto offset = m_vertexAllocator.Allocate(count);
+			if (offset != sz_ds::RangeAllocator::INVALID_OFFSET)
+			{
+				return offset;
+			}
+
+			// 按倍数扩容，已有区间的偏移不变
+			const size_t oldCapacity = m_vertexAllocator.GetCapacity();
+			const size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + count);
+			growBuffer(m_vbo, oldCapacity * m_vertexStride, newCapacity * m_vertexStride);
+			m_vertexAllocator.Grow(newCapacity);
+			setupVao();
+			offset = m_vertexAllocator.Allocate(count);
+			assert(offset != sz_ds::RangeAllocator::INVALID_OFFSET);
+			return offset;
+		}
+
+		size_t GeometryHeap::AllocateIndices(size_t count)
+		{
+			auto offset = m_indexAllocator.Allocate(count);
+			if (offset != sz_ds::RangeAllocator::INVALID_OFFSET)
+			{
+				return offset;
+			}
+
+			const size_t oldCapacity = m_indexAllocator.GetCapacity();
+			const size_t newCapacity = std::max(oldCapacity * 2, oldCapacity + count);
+			growBuffer(m_ebo, oldCapacity * sizeof(uint32_t), newCapacity * sizeof(uint32_t));
+			m_indexAllocator.Grow(newCapacity);
+			setupVao();
+			offset = m_indexAllocator.Allocate(count);
+			assert(offset != sz_ds::RangeAllocator::INVALID_OFFSET);
+			return offset;
+		}
+
+		void GeometryHeap::UploadVertices(size_t offset, const void* data, size_t count)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+			GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, offset * m_vertexStride, count * m_vertexStride, data));
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		}
+
+		void GeometryHeap::UploadIndices(size_t offset, const uint32_t* data, size_t count)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+			// 索引缓冲绑定在VAO上，通过拷贝目标上传，不影响VAO
+			GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo));
+			GL_CALL(glBufferSubData(GL_COPY_WRITE_BUFFER, offset * sizeof(uint32_t), count * sizeof(uint32_t), data));
+			GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+		}
+
+		void GeometryHeap::growBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes)
+		{
+			// 新建更大的缓冲，在GPU上拷贝旧数据
+			GLuint newBuffer = 0;
+			GL_CALL(glGenBuffers(1, &newBuffer));
+			GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer));
+			GL_CALL(glBufferData(GL_COPY_WRITE_BUFFER, newBytes, 0, GL_DYNAMIC_DRAW));
+			GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, buffer));
+			GL_CALL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes));
+			GL_CALL(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+			GL_CALL(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+			GL_CALL(glDeleteBuffers(1, &buffer));
+			buffer = newBuffer;
+		}
+
+		void GeometryHeap::setupVao()
+		{
+			GL_CALL(glBindVertexArray(m_vao));
+
+			// 一个VBO，按偏移绑定各属性
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+			const GLsizei stride = (GLsizei)m_vertexStride;
+			if (m_useColor)
+			{
+				GL_CALL(glEnableVertexAttribArray(0));
+				GL_CALL(glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, stride,
+					(void*)offsetof(ColorVertex, m_x)));
+				GL_CALL(glEnableVertexAttribArray(1));
+				GL_CALL(glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+					(void*)offsetof(ColorVertex, m_r)));
+			}
+			else
+			{
+				GL_CALL(glEnableVertexAttribArray(0));
+				GL_CALL(glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, stride,
+					(void*)offsetof(TextVertex, m_x)));
+				GL_CALL(glEnableVertexAttribArray(1));
+				GL_CALL(glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+					(void*)offsetof(TextVertex, m_u)));
+				GL_CALL(glEnableVertexAttribArray(2));
+				GL_CALL(glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, stride,
+					(void*)offsetof(TextVertex, m_layer)));
+			}
+
+			GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+
+			GL_CALL(glBindVertexArray(0));
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		}
+
+		sz_ds::RangeAllocatorStats GeometryHeap::toBytes(sz_ds::RangeAllocatorStats stats, size_t unit)
+		{
+			stats.m_capacity *= unit;
+			stats.m_used *= unit;
+			stats.m_largestFree *= unit;
+			return stats;
+		}
+	}
+}
@@ -0,0 +1,84 @@
+// comment: 几何体GPU堆，同一顶点格式的所有几何体共用一个VAO、一个大VBO和一个大EBO，按区间分配
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <cstdint>
+#include <cstddef>
+
+#include "../../ds/RangeAllocator.h"
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		class GeometryHeap
+		{
+		public:
+			// useColor为true时是颜色顶点格式，否则是文字顶点格式，容量单位为顶点和索引个数
+			// positionFractionBits是顶点位置定点数的小数位数，要和使用这个堆的着色器注入的缩放一致
+			GeometryHeap(bool useColor, int positionFractionBits, size_t vertexCapacity, size_t indexCapacity);
+			~GeometryHeap();
+
+			GeometryHeap(const GeometryHeap&) = delete;
+			GeometryHeap& operator=(const GeometryHeap&) = delete;
+
+		public:
+			// 分配count个顶点，空间不足时扩容，返回顶点偏移
+			size_t AllocateVertices(size_t count);
+			// 释放顶点区间
+			void FreeVertices(size_t offset, size_t count) { m_vertexAllocator.Free(offset, count); }
+			// 分配count个索引，空间不足时扩容，返回索引偏移
+			size_t AllocateIndices(size_t count);
+			// 释放索引区间
+			void FreeIndices(size_t offset, size_t count) { m_indexAllocator.Free(offset, count); }
+			// 上传顶点数据到offset开始的区间
+			void UploadVertices(size_t offset, const void* data, size_t count);
+			// 上传索引数据到offset开始的区间
+			void UploadIndices(size_t offset, const uint32_t* data, size_t count);
+
+			// 获取VAO
+			GLuint GetVao() const { return m_vao; }
+			// 是否是颜色顶点格式
+			bool UseColor() const { return m_useColor; }
+			// 顶点位置定点数的小数位数
+			int GetPositionFractionBits() const { return m_positionFractionBits; }
+			// 每个顶点的字节数
+			size_t GetVertexStride() const { return m_vertexStride; }
+			// 顶点和索引区间统计，单位字节
+			sz_ds::RangeAllocatorStats GetVertexStats() const { return toBytes(m_vertexAllocator.GetStats(), m_vertexStride); }
+			sz_ds::RangeAllocatorStats GetIndexStats() const { return toBytes(m_indexAllocator.GetStats(), sizeof(uint32_t)); }
+
+		private:
+			// 扩容缓冲，保留原有数据
+			void growBuffer(GLuint& buffer, size_t oldBytes, size_t newBytes);
+			// 按顶点格式设置VAO的属性和缓冲
+			void setupVao();
+			// 单位换算成字节
+			static sz_ds::RangeAllocatorStats toBytes(sz_ds::RangeAllocatorStats stats, size_t unit);
+
+		private:
+			// 顶点格式
+			bool m_useColor;
+			// 顶点位置定点数的小数位数
+			int m_positionFractionBits;
+			// 每个顶点的字节数
+			size_t m_vertexStride;
+			// 顶点数组对象
+			GLuint m_vao{ 0 };
+			// 顶点缓冲
+			GLuint m_vbo{ 0 };
+			// 索引缓冲
+			GLuint m_ebo{ 0 };
+			// 顶点区间分配，单位顶点
+			sz_ds::RangeAllocator m_vertexAllocator;
+			// 索引区间分配，单位索引
+			sz_ds::RangeAllocator m_indexAllocator;
+		};
+	}
+}
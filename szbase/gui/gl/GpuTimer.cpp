@@ -0,0 +1,151 @@
+#include "GpuTimer.h"
+#include "CheckRstErr.h"
+
+#include <SDL3/SDL.h>
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        GpuTimer::~GpuTimer()
+        {
+            Release();
+        }
+
+        bool GpuTimer::Init()
+        {
+            if (m_supported)
+            {
+                return true;
+            }
+
+#ifdef USE_OPENGL_ES
+            if (!SDL_GL_ExtensionSupported("GL_EXT_disjoint_timer_query"))
+            {
+                return false;
+            }
+            m_genQueries = (PFNGLGENQUERIESEXTPROC)SDL_GL_GetProcAddress("glGenQueriesEXT");
+            m_deleteQueries = (PFNGLDELETEQUERIESEXTPROC)SDL_GL_GetProcAddress("glDeleteQueriesEXT");
+            m_beginQuery = (PFNGLBEGINQUERYEXTPROC)SDL_GL_GetProcAddress("glBeginQueryEXT");
+            m_endQuery = (PFNGLENDQUERYEXTPROC)SDL_GL_GetProcAddress("glEndQueryEXT");
+            m_getQueryObjectuiv = (PFNGLGETQUERYOBJECTUIVEXTPROC)SDL_GL_GetProcAddress("glGetQueryObjectuivEXT");
+            m_getQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC)SDL_GL_GetProcAddress("glGetQueryObjectui64vEXT");
+            if (!m_genQueries || !m_deleteQueries || !m_beginQuery || !m_endQuery ||
+                !m_getQueryObjectuiv || !m_getQueryObjectui64v)
+            {
+                return false;
+            }
+            m_genQueries(QUERY_COUNT, m_queries);
+#else
+            GL_CALL(glGenQueries(QUERY_COUNT, m_queries));
+#endif
+            m_supported = true;
+            return true;
+        }
+
+        void GpuTimer::Release()
+        {
+            if (!m_supported)
+            {
+                return;
+            }
+#ifdef USE_OPENGL_ES
+            m_deleteQueries(QUERY_COUNT, m_queries);
+#else
+            glDeleteQueries(QUERY_COUNT, m_queries);
+#endif
+            m_supported = false;
+            m_active = false;
+            for (auto& pending : m_pending)
+            {
+                pending = false;
+            }
+        }
+
+        void GpuTimer::Begin()
+        {
+            m_active = false;
+            if (!m_supported)
+            {
+                return;
+            }
+
+            collect(m_current);
+            if (m_pending[m_current])
+            {
+                // GPU落后太多，跳过本帧
+                return;
+            }
+
+#ifdef USE_OPENGL_ES
+            // 清除之前的disjoint状态
+            GLint disjoint = 0;
+            glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+            m_beginQuery(GL_TIME_ELAPSED_EXT, m_queries[m_current]);
+#else
+            GL_CALL(glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]));
+#endif
+            m_active = true;
+        }
+
+        void GpuTimer::End()
+        {
+            if (!m_active)
+            {
+                return;
+            }
+
+#ifdef USE_OPENGL_ES
+            m_endQuery(GL_TIME_ELAPSED_EXT);
+#else
+            GL_CALL(glEndQuery(GL_TIME_ELAPSED));
+#endif
+            m_pending[m_current] = true;
+            m_active = false;
+            m_current = (m_current + 1) % QUERY_COUNT;
+
+            // 从旧到新读取其他已经完成的查询，保证结果尽快更新
+            for (uint32_t i = 0; i + 1 < QUERY_COUNT; ++i)
+            {
+                collect((m_current + i) % QUERY_COUNT);
+            }
+        }
+
+        void GpuTimer::collect(uint32_t index)
+        {
+            if (!m_pending[index])
+            {
+                return;
+            }
+
+            GLuint available = 0;
+            GLuint64 elapsed = 0;
+#ifdef USE_OPENGL_ES
+            m_getQueryObjectuiv(m_queries[index], GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+            if (!available)
+            {
+                return;
+            }
+            m_getQueryObjectui64v(m_queries[index], GL_QUERY_RESULT_EXT, &elapsed);
+            m_pending[index] = false;
+
+            // 期间发生过频率变化等情况，结果不可信
+            GLint disjoint = 0;
+            glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+            if (disjoint)
+            {
+                return;
+            }
+#else
+            GL_CALL(glGetQueryObjectuiv(m_queries[index], GL_QUERY_RESULT_AVAILABLE, &available));
+            if (!available)
+            {
+                return;
+            }
+            GL_CALL(glGetQueryObjectui64v(m_queries[index], GL_QUERY_RESULT, &elapsed));
+            m_pending[index] = false;
+#endif
+            m_lastMs = double(elapsed) / 1e6;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+// comment: GPU计时，环形使用多个计时查询，只读取已经完成的结果，不等待GPU
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#include <GLES2/gl2ext.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <cstdint>
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        class GpuTimer
+        {
+        public:
+            GpuTimer() = default;
+            ~GpuTimer();
+
+            GpuTimer(const GpuTimer&) = delete;
+            GpuTimer& operator=(const GpuTimer&) = delete;
+
+        public:
+            // 创建查询对象，需要在GL上下文创建后调用，不支持计时查询返回false
+            bool Init();
+            // 删除查询对象，需要在GL上下文销毁前调用
+            void Release();
+            // 开始计时，上一轮同一个查询还没完成时本帧不计时
+            void Begin();
+            // 结束计时
+            void End();
+            // 最近一次完成的结果，单位毫秒，不支持时为负数
+            double GetLastMs() const { return m_lastMs; }
+            // 是否支持计时查询
+            bool IsSupported() const { return m_supported; }
+
+        private:
+            // 读取已经完成的查询结果
+            void collect(uint32_t index);
+
+        private:
+            // 查询对象个数，结果延迟QUERY_COUNT-1帧
+            static constexpr uint32_t QUERY_COUNT = 4;
+
+            // 查询对象
+            GLuint m_queries[QUERY_COUNT]{};
+            // 查询已提交还未读取结果
+            bool m_pending[QUERY_COUNT]{};
+            // 当前使用的查询
+            uint32_t m_current = 0;
+            // 本帧是否在计时
+            bool m_active = false;
+            // 是否支持计时查询
+            bool m_supported = false;
+            // 最近一次完成的结果
+            double m_lastMs = -1.0;
+#ifdef USE_OPENGL_ES
+            // GLES通过GL_EXT_disjoint_timer_query扩展计时
+            PFNGLGENQUERIESEXTPROC m_genQueries = nullptr;
+            PFNGLDELETEQUERIESEXTPROC m_deleteQueries = nullptr;
+            PFNGLBEGINQUERYEXTPROC m_beginQuery = nullptr;
+            PFNGLENDQUERYEXTPROC m_endQuery = nullptr;
+            PFNGLGETQUERYOBJECTUIVEXTPROC m_getQueryObjectuiv = nullptr;
+            PFNGLGETQUERYOBJECTUI64VEXTPROC m_getQueryObjectui64v = nullptr;
+#endif
+        };
+    }
+}
@@ -0,0 +1,511 @@
+#include "ImageAtlas.h"
+#include "CheckRstErr.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		ImageAtlas::ImageAtlas(uint32_t unit, size_t budgetBytes, size_t uploadBytesPerFrame) :
+			m_unit(unit),
+			m_budgetBytes(budgetBytes),
+			m_uploadBytesPerFrame(std::max<size_t>(1, uploadBytesPerFrame))
+		{
+			// 浅灰色占位
+			const uint8_t placeholder[4] = { 0xE0, 0xE0, 0xE0, 0xFF };
+			GL_CALL(glGenTextures(1, &m_placeholder.m_texture));
+			Bind(m_placeholder.m_texture);
+			GL_CALL(glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1));
+			GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, placeholder));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+			Bind(0);
+			m_placeholder.m_uvRect = glm::vec4(0.5f, 0.5f, 0.0f, 0.0f);
+		}
+
+		ImageAtlas::~ImageAtlas()
+		{
+			for (auto& slot : m_slots)
+			{
+				if (slot.m_fence)
+				{
+					glDeleteSync(slot.m_fence);
+					slot.m_fence = nullptr;
+				}
+				if (slot.m_buffer)
+				{
+					glDeleteBuffers(1, &slot.m_buffer);
+					slot.m_buffer = 0;
+				}
+			}
+			for (auto& page : m_pages)
+			{
+				if (page.m_texture)
+				{
+					glDeleteTextures(1, &page.m_texture);
+					page.m_texture = 0;
+				}
+			}
+			glDeleteTextures(1, &m_placeholder.m_texture);
+		}
+
+		uint32_t ImageAtlas::Load(const std::string& path)
+		{
+			if (path.empty())
+			{
+				return 0;
+			}
+
+			auto it = m_pathToId.find(path);
+			if (it != m_pathToId.end())
+			{
+				return it->second;
+			}
+
+			Image image;
+			image.m_path = path;
+			m_images.push_back(std::move(image));
+			const uint32_t id = uint32_t(m_images.size());
+			m_pathToId.emplace(path, id);
+			decode(id);
+			return id;
+		}
+
+		size_t ImageAtlas::Update(uint64_t frameIndex)
+		{
+			m_frameIndex = frameIndex;
+			collect();
+			receiveDecoded(frameIndex);
+
+			// 每帧上传量受预算限制，大图分多帧上传
+			size_t uploaded = 0;
+			for (auto& slot : m_slots)
+			{
+				if (m_uploadQueue.empty() || uploaded >= m_uploadBytesPerFrame)
+				{
+					break;
+				}
+				if (slot.m_fence)
+				{
+					continue;
+				}
+				uploaded += submit(slot, m_uploadBytesPerFrame - uploaded, uploaded == 0);
+			}
+			return uploaded;
+		}
+
+		const ImageRegion* ImageAtlas::Use(uint32_t id, uint64_t frameIndex)
+		{
+			if (id == 0 || id > m_images.size())
+			{
+				return nullptr;
+			}
+
+			auto& image = m_images[id - 1];
+			image.m_lastUsedFrame = frameIndex;
+			switch (image.m_state)
+			{
+			case ImageState::Ready:
+				return &image.m_region;
+			case ImageState::Evicted:
+				// 被淘汰的图片重新解码
+				decode(id);
+				return nullptr;
+			case ImageState::Waiting:
+				// 每帧最多重试一次分配
+				if (image.m_lastPlaceFrame != frameIndex)
+				{
+					place(id, frameIndex);
+				}
+				return nullptr;
+			default:
+				return nullptr;
+			}
+		}
+
+		void ImageAtlas::Bind(GLuint texture) const
+		{
+			GL_CALL(glActiveTexture(GL_TEXTURE0 + m_unit));
+			GL_CALL(glBindTexture(GL_TEXTURE_2D, texture));
+		}
+
+		ImageState ImageAtlas::GetState(uint32_t id) const
+		{
+			if (id == 0 || id > m_images.size())
+			{
+				return ImageState::Failed;
+			}
+			return m_images[id - 1].m_state;
+		}
+
+		ImageAtlasStats ImageAtlas::GetStats() const
+		{
+			ImageAtlasStats stats;
+			stats.m_budgetBytes = m_budgetBytes;
+			stats.m_residentBytes = m_residentBytes;
+			stats.m_images = m_images.size();
+			stats.m_uploadedBytes = m_uploadedBytes;
+			stats.m_evictedPages = m_evictedPages;
+			for (const auto& page : m_pages)
+			{
+				stats.m_pages += page.m_texture ? 1 : 0;
+			}
+			for (const auto& image : m_images)
+			{
+				stats.m_readyImages += image.m_state == ImageState::Ready ? 1 : 0;
+				stats.m_decodingImages += image.m_state == ImageState::Decoding ? 1 : 0;
+				if (image.m_state == ImageState::Uploading)
+				{
+					stats.m_pendingUploadBytes += size_t(image.m_height - image.m_submittedRows) * image.m_width * 4;
+				}
+			}
+			return stats;
+		}
+
+		bool ImageAtlas::HasPendingWork() const
+		{
+			if (m_decoder.GetPendingCount() != 0 || !m_uploadQueue.empty())
+			{
+				return true;
+			}
+			for (const auto& slot : m_slots)
+			{
+				if (slot.m_fence)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void ImageAtlas::decode(uint32_t id)
+		{
+			auto& image = m_images[id - 1];
+			image.m_state = ImageState::Decoding;
+			// 第一行是图片顶部，和界面坐标一致，不翻转
+			m_decoder.Submit(id, image.m_path, false);
+		}
+
+		void ImageAtlas::receiveDecoded(uint64_t frameIndex)
+		{
+			DecodedImage decoded;
+			while (m_decoder.TryPop(decoded))
+			{
+				auto& image = m_images[decoded.m_id - 1];
+				assert(image.m_state == ImageState::Decoding);
+				if (!decoded.m_ok)
+				{
+					image.m_state = ImageState::Failed;
+					continue;
+				}
+
+				image.m_width = decoded.m_width;
+				image.m_height = decoded.m_height;
+				image.m_pixels = std::move(decoded.m_pixels);
+				image.m_state = ImageState::Waiting;
+				place(decoded.m_id, frameIndex);
+			}
+		}
+
+		bool ImageAtlas::place(uint32_t id, uint64_t frameIndex)
+		{
+			auto& image = m_images[id - 1];
+			assert(image.m_state == ImageState::Waiting);
+			image.m_lastPlaceFrame = frameIndex;
+
+			const bool dedicated = image.m_width > DEDICATED_SIZE || image.m_height > DEDICATED_SIZE;
+			while (true)
+			{
+				if (dedicated)
+				{
+					const int32_t page = createPage(image.m_width, image.m_height, true);
+					if (page >= 0)
+					{
+						image.m_page = page;
+						image.m_x = 0;
+						image.m_y = 0;
+						break;
+					}
+				}
+				else
+				{
+					if (placeShared(image))
+					{
+						break;
+					}
+					const int32_t page = createPage(PAGE_SIZE, PAGE_SIZE, false);
+					if (page >= 0)
+					{
+						m_pages[page].m_packer.Allocate(image.m_width, image.m_height, image.m_x, image.m_y);
+						image.m_page = page;
+						break;
+					}
+				}
+
+				// 超出预算，淘汰不再使用的页面后重试，都在使用时等到后面的帧
+				if (!evictPage(frameIndex))
+				{
+					return false;
+				}
+			}
+
+			m_pages[image.m_page].m_images.push_back(id);
+			image.m_state = ImageState::Uploading;
+			image.m_submittedRows = 0;
+			updateRegion(image);
+			m_uploadQueue.push_back(id);
+			return true;
+		}
+
+		bool ImageAtlas::placeShared(Image& image)
+		{
+			for (size_t i = 0; i < m_pages.size(); ++i)
+			{
+				auto& page = m_pages[i];
+				if (!page.m_texture || page.m_dedicated)
+				{
+					continue;
+				}
+				if (page.m_packer.Allocate(image.m_width, image.m_height, image.m_x, image.m_y))
+				{
+					image.m_page = int32_t(i);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		int32_t ImageAtlas::createPage(int32_t width, int32_t height, bool dedicated)
+		{
+			const size_t bytes = size_t(width) * height * 4;
+			if (m_residentBytes + bytes > m_budgetBytes)
+			{
+				return -1;
+			}
+
+			// 复用空槽位，保证页面号不变
+			int32_t index = -1;
+			for (size_t i = 0; i < m_pages.size(); ++i)
+			{
+				if (!m_pages[i].m_texture)
+				{
+					index = int32_t(i);
+					break;
+				}
+			}
+			if (index < 0)
+			{
+				m_pages.emplace_back();
+				index = int32_t(m_pages.size() - 1);
+			}
+
+			auto& page = m_pages[index];
+			page.m_dedicated = dedicated;
+			page.m_packer = sz_ds::ShelfPacker(width, height, dedicated ? 0 : 1);
+			page.m_images.clear();
+
+			GL_CALL(glGenTextures(1, &page.m_texture));
+			Bind(page.m_texture);
+			GL_CALL(glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+			GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+			Bind(0);
+
+			m_residentBytes += bytes;
+			return index;
+		}
+
+		bool ImageAtlas::evictPage(uint64_t frameIndex)
+		{
+			// 页面上所有图片都已上传完成且最近没有使用，取最后使用时间最早的
+			int32_t victim = -1;
+			uint64_t victimLastUsed = UINT64_MAX;
+			for (size_t i = 0; i < m_pages.size(); ++i)
+			{
+				const auto& page = m_pages[i];
+				if (!page.m_texture)
+				{
+					continue;
+				}
+
+				uint64_t lastUsed = 0;
+				bool evictable = true;
+				for (auto id : page.m_images)
+				{
+					const auto& image = m_images[id - 1];
+					if (image.m_state == ImageState::Uploading ||
+						image.m_lastUsedFrame + EVICT_AFTER_FRAMES > frameIndex)
+					{
+						evictable = false;
+						break;
+					}
+					lastUsed = std::max(lastUsed, image.m_lastUsedFrame);
+				}
+				if (evictable && lastUsed < victimLastUsed)
+				{
+					victim = int32_t(i);
+					victimLastUsed = lastUsed;
+				}
+			}
+			if (victim < 0)
+			{
+				return false;
+			}
+
+			auto& page = m_pages[victim];
+			for (auto id : page.m_images)
+			{
+				auto& image = m_images[id - 1];
+				image.m_state = ImageState::Evicted;
+				image.m_page = -1;
+			}
+			page.m_images.clear();
+			m_residentBytes -= size_t(page.m_packer.GetWidth()) * page.m_packer.GetHeight() * 4;
+			GL_CALL(glDeleteTextures(1, &page.m_texture));
+			page.m_texture = 0;
+			++m_evictedPages;
+			return true;
+		}
+
+		void ImageAtlas::collect()
+		{
+			for (auto& slot : m_slots)
+			{
+				if (!slot.m_fence)
+				{
+					continue;
+				}
+
+				// 不等待，GPU还没读完就下一帧再看
+				const GLenum status = glClientWaitSync(slot.m_fence, 0, 0);
+				if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				{
+					continue;
+				}
+				glDeleteSync(slot.m_fence);
+				slot.m_fence = nullptr;
+
+				for (auto id : slot.m_completed)
+				{
+					auto& image = m_images[id - 1];
+					if (image.m_state == ImageState::Uploading)
+					{
+						image.m_state = ImageState::Ready;
+					}
+				}
+				slot.m_completed.clear();
+			}
+		}
+
+		size_t ImageAtlas::submit(StagingSlot& slot, size_t maxBytes, bool mustProgress)
+		{
+			// 按行切分，一块暂存缓冲可以装多张小图，大图分多帧上传
+			auto& bands = m_bands;
+			bands.clear();
+			const size_t limit = std::min(SLOT_BYTES, maxBytes);
+			size_t offset = 0;
+			while (!m_uploadQueue.empty())
+			{
+				const uint32_t id = m_uploadQueue.front();
+				auto& image = m_images[id - 1];
+				const size_t rowBytes = size_t(image.m_width) * 4;
+				int32_t fitRows = int32_t((limit - offset) / rowBytes);
+				if (fitRows <= 0 && offset == 0 && mustProgress)
+				{
+					// 每帧预算不够一行时至少上传一行，保证能前进
+					fitRows = 1;
+				}
+				if (fitRows <= 0)
+				{
+					break;
+				}
+
+				const int32_t rows = std::min(image.m_height - image.m_submittedRows, fitRows);
+				bands.push_back(UploadBand{ id, image.m_submittedRows, rows, offset });
+				offset += size_t(rows) * rowBytes;
+				image.m_submittedRows += rows;
+				if (image.m_submittedRows == image.m_height)
+				{
+					m_uploadQueue.pop_front();
+					slot.m_completed.push_back(id);
+				}
+			}
+			if (bands.empty())
+			{
+				return 0;
+			}
+
+			if (!slot.m_buffer)
+			{
+				GL_CALL(glGenBuffers(1, &slot.m_buffer));
+				GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.m_buffer));
+				GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, SLOT_BYTES, nullptr, GL_STREAM_DRAW));
+			}
+			else
+			{
+				GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.m_buffer));
+			}
+
+			// 栅栏保证GPU已经读完这块缓冲，映射时不需要同步
+			auto* dst = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, offset,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+			if (dst)
+			{
+				for (const auto& band : bands)
+				{
+					const auto& image = m_images[band.m_image - 1];
+					const size_t rowBytes = size_t(image.m_width) * 4;
+					std::memcpy(dst + band.m_offset, image.m_pixels.data() + size_t(band.m_row) * rowBytes,
+						size_t(band.m_rows) * rowBytes);
+				}
+				GL_CALL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+			}
+			else
+			{
+				// 映射失败时直接从内存上传
+				GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+			}
+
+			GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+			for (const auto& band : bands)
+			{
+				const auto& image = m_images[band.m_image - 1];
+				const void* pixels = dst ? (const void*)band.m_offset :
+					(const void*)(image.m_pixels.data() + size_t(band.m_row) * image.m_width * 4);
+				Bind(m_pages[image.m_page].m_texture);
+				GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, image.m_x, image.m_y + band.m_row,
+					image.m_width, band.m_rows, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+			}
+			Bind(0);
+			GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+			slot.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_uploadedBytes += offset;
+
+			// 像素已经拷进暂存缓冲，释放内存
+			for (auto id : slot.m_completed)
+			{
+				std::vector<uint8_t>().swap(m_images[id - 1].m_pixels);
+			}
+			return offset;
+		}
+
+		void ImageAtlas::updateRegion(Image& image)
+		{
+			// 纹理坐标缩进半个像素，线性采样不会采到相邻图片
+			const auto& page = m_pages[image.m_page];
+			const float pageW = float(page.m_packer.GetWidth());
+			const float pageH = float(page.m_packer.GetHeight());
+			image.m_region.m_texture = page.m_texture;
+			image.m_region.m_uvRect = glm::vec4(
+				(float(image.m_x) + 0.5f) / pageW,
+				(float(image.m_y) + 0.5f) / pageH,
+				float(image.m_width - 1) / pageW,
+				float(image.m_height - 1) / pageH);
+		}
+	}
+}
@@ -0,0 +1,230 @@
+// comment: 图片图集，小图片和图标装进共享的RGBA页面，同一页面的图片只需要绑定一次纹理
+// 图片在工作线程解码，像素经过像素缓冲对象(PBO)按每帧字节预算分帧上传，用栅栏判断完成，不阻塞当前帧
+// 总显存受预算限制，超出时淘汰最久未使用的页面
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../ds/ShelfPacker.h"
+#include "ImageDecoder.h"
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		// 图片状态
+		enum class ImageState
+		{
+			// 正在工作线程解码
+			Decoding,
+			// 等待页面空间
+			Waiting,
+			// 已放入页面，正在上传
+			Uploading,
+			// 可以绘制
+			Ready,
+			// 被淘汰，再次使用时重新加载
+			Evicted,
+			// 加载失败
+			Failed,
+		};
+
+		// 可以绘制的图片区域
+		struct ImageRegion
+		{
+			// 页面纹理
+			GLuint m_texture;
+			// 纹理坐标偏移和缩放，图片内0~1的uv映射到uv*zw+xy
+			glm::vec4 m_uvRect;
+		};
+
+		// 图集统计，单位字节
+		struct ImageAtlasStats
+		{
+			// 显存预算
+			size_t m_budgetBytes = 0;
+			// 页面占用的显存
+			size_t m_residentBytes = 0;
+			// 页面个数
+			size_t m_pages = 0;
+			// 图片个数
+			size_t m_images = 0;
+			// 可以绘制的图片个数
+			size_t m_readyImages = 0;
+			// 正在解码的图片个数
+			size_t m_decodingImages = 0;
+			// 等待上传的字节数
+			size_t m_pendingUploadBytes = 0;
+			// 累计上传的字节数
+			uint64_t m_uploadedBytes = 0;
+			// 累计淘汰的页面个数
+			uint64_t m_evictedPages = 0;
+		};
+
+		class ImageAtlas
+		{
+		public:
+			// unit为绑定页面纹理的纹理单元，budgetBytes为页面显存上限，uploadBytesPerFrame为每帧最多上传的字节数
+			ImageAtlas(uint32_t unit, size_t budgetBytes, size_t uploadBytesPerFrame = DEFAULT_UPLOAD_BYTES_PER_FRAME);
+			~ImageAtlas();
+
+			ImageAtlas(const ImageAtlas&) = delete;
+			ImageAtlas& operator=(const ImageAtlas&) = delete;
+
+		public:
+			// 加载图片，提交到工作线程解码后立即返回，同一路径返回同一个id，路径为空返回0
+			uint32_t Load(const std::string& path);
+			// 每帧开始时调用，取回解码结果，回收已完成的上传，提交新的上传，返回本帧上传的字节数
+			size_t Update(uint64_t frameIndex);
+			// 本帧要绘制图片，返回可以绘制的区域，还没上传完成时返回nullptr
+			const ImageRegion* Use(uint32_t id, uint64_t frameIndex);
+			// 图片还没准备好时绘制的占位区域
+			const ImageRegion& GetPlaceholder() const { return m_placeholder; }
+			// 绑定页面纹理
+			void Bind(GLuint texture) const;
+			// 纹理单元
+			uint32_t GetUnit() const { return m_unit; }
+			// 图片状态
+			ImageState GetState(uint32_t id) const;
+			// 统计
+			ImageAtlasStats GetStats() const;
+			// 是否还有图片在解码或者上传，需要继续出帧
+			bool HasPendingWork() const;
+
+		private:
+			// 页面
+			struct Page
+			{
+				// 纹理对象，为0时是空槽位
+				GLuint m_texture = 0;
+				// 装箱
+				sz_ds::ShelfPacker m_packer;
+				// 单独一张大图独占的页面
+				bool m_dedicated = false;
+				// 页面上的图片
+				std::vector<uint32_t> m_images;
+			};
+
+			// 图片
+			struct Image
+			{
+				std::string m_path;
+				ImageState m_state = ImageState::Evicted;
+				int32_t m_width = 0;
+				int32_t m_height = 0;
+				// 等待上传的像素，上传完成后释放
+				std::vector<uint8_t> m_pixels;
+				// 所在页面和位置
+				int32_t m_page = -1;
+				int32_t m_x = 0;
+				int32_t m_y = 0;
+				// 已提交上传的行数
+				int32_t m_submittedRows = 0;
+				// 最近一次使用的帧
+				uint64_t m_lastUsedFrame = 0;
+				// 最近一次尝试分配页面空间的帧
+				uint64_t m_lastPlaceFrame = 0;
+				// 可以绘制时的区域
+				ImageRegion m_region{};
+			};
+
+			// 暂存缓冲，一块PBO，提交后用栅栏等待GPU读取完成
+			struct StagingSlot
+			{
+				GLuint m_buffer = 0;
+				GLsync m_fence = nullptr;
+				// 本次提交中上传完最后一行的图片
+				std::vector<uint32_t> m_completed;
+			};
+
+			// 一段待上传的行
+			struct UploadBand
+			{
+				uint32_t m_image;
+				int32_t m_row;
+				int32_t m_rows;
+				size_t m_offset;
+			};
+
+		private:
+			// 提交解码
+			void decode(uint32_t id);
+			// 取回解码结果，成功的分配页面空间
+			void receiveDecoded(uint64_t frameIndex);
+			// 为图片分配页面空间，成功后进入上传队列
+			bool place(uint32_t id, uint64_t frameIndex);
+			// 在已有共享页面中分配
+			bool placeShared(Image& image);
+			// 新建页面，超出预算时返回-1
+			int32_t createPage(int32_t width, int32_t height, bool dedicated);
+			// 淘汰最久未使用的页面，返回是否淘汰了
+			bool evictPage(uint64_t frameIndex);
+			// 回收栅栏已完成的暂存缓冲
+			void collect();
+			// 填充一块暂存缓冲并提交，最多maxBytes字节，mustProgress时至少提交一行，返回提交的字节数
+			size_t submit(StagingSlot& slot, size_t maxBytes, bool mustProgress);
+			// 计算图片在页面中的纹理坐标
+			void updateRegion(Image& image);
+
+		private:
+			// 共享页面大小
+			static constexpr int32_t PAGE_SIZE = 1024;
+			// 超过这个尺寸的图片独占页面
+			static constexpr int32_t DEDICATED_SIZE = PAGE_SIZE / 2;
+			// 暂存缓冲个数和大小，每帧最多上传SLOT_COUNT*SLOT_BYTES字节
+			static constexpr uint32_t SLOT_COUNT = 3;
+			static constexpr size_t SLOT_BYTES = 4 * 1024 * 1024;
+			// 使用后至少经过这么多帧才能被淘汰
+			static constexpr uint64_t EVICT_AFTER_FRAMES = 2;
+
+		public:
+			// 默认每帧上传字节数
+			static constexpr size_t DEFAULT_UPLOAD_BYTES_PER_FRAME = SLOT_BYTES;
+
+		private:
+
+			// 纹理单元
+			uint32_t m_unit;
+			// 显存预算
+			size_t m_budgetBytes;
+			// 每帧上传预算
+			size_t m_uploadBytesPerFrame;
+			// 页面占用的显存
+			size_t m_residentBytes = 0;
+			// 页面，下标即页面号
+			std::vector<Page> m_pages;
+			// 图片，id为下标+1
+			std::vector<Image> m_images;
+			// 路径->id
+			std::unordered_map<std::string, uint32_t> m_pathToId;
+			// 等待上传的图片
+			std::deque<uint32_t> m_uploadQueue;
+			// 暂存缓冲
+			StagingSlot m_slots[SLOT_COUNT];
+			// 本次提交的行，复用避免每帧分配
+			std::vector<UploadBand> m_bands;
+			// 统计
+			uint64_t m_uploadedBytes = 0;
+			uint64_t m_evictedPages = 0;
+			// 当前帧
+			uint64_t m_frameIndex = 0;
+			// 占位纹理，1x1
+			ImageRegion m_placeholder{};
+			// 解码器，第一次加载图片时才启动线程，最后声明，先于其他成员析构
+			ImageDecoder m_decoder;
+		};
+	}
+}
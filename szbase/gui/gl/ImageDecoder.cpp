@@ -0,0 +1,80 @@
+#include "ImageDecoder.h"
+#include "../../utils/PixelConvert.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		bool ImageDecoder::Decode(const std::string& path, bool flipVertically, DecodedImage& out)
+		{
+			// 按原始通道数解码，转换RGBA由SIMD完成
+			int width = 0;
+			int height = 0;
+			int channels = 0;
+			unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+			if (!data)
+			{
+				out.m_ok = false;
+				return false;
+			}
+
+			const size_t pixels = size_t(width) * height;
+			out.m_width = width;
+			out.m_height = height;
+			out.m_pixels.resize(pixels * 4);
+			sz_utils::ConvertToRGBA(data, channels, out.m_pixels.data(), pixels);
+			stbi_image_free(data);
+
+			if (flipVertically)
+			{
+				sz_utils::FlipRowsVertically(out.m_pixels.data(), size_t(width) * 4, size_t(height));
+			}
+			out.m_ok = true;
+			return true;
+		}
+
+		size_t ImageDecoder::DefaultWorkerCount()
+		{
+			const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+			return std::clamp<size_t>(cores / 2, 1, 4);
+		}
+
+		ImageDecoder::ImageDecoder(size_t workerCount) :
+			m_workerCount(std::max<size_t>(1, workerCount)),
+			m_completed(256)
+		{
+		}
+
+		void ImageDecoder::Submit(uint32_t id, const std::string& path, bool flipVertically)
+		{
+			if (!m_pool)
+			{
+				m_pool = std::make_unique<sz_ds::TaskPool>(m_workerCount);
+			}
+
+			m_pending.fetch_add(1, std::memory_order_relaxed);
+			// 路径复制一份，捕获要放得进委托内部缓冲区
+			m_pool->Post([this, id, flipVertically, path = std::string(path)]() {
+				DecodedImage result;
+				result.m_id = id;
+				Decode(path, flipVertically, result);
+				m_completed.Push(std::move(result));
+			});
+		}
+
+		bool ImageDecoder::TryPop(DecodedImage& out)
+		{
+			if (!m_completed.TryPop(out))
+			{
+				return false;
+			}
+			m_pending.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+}
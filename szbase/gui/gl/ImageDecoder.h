@@ -0,0 +1,63 @@
+// comment: 异步图片解码，任务池的工作线程解码并转换成RGBA，结果通过无锁队列交给GL线程
+// 任务池在第一次提交时创建，不加载图片时不启动线程
+// 不使用stb_image的全局翻转开关，翻转在解码后自己做，多个线程同时解码互不影响
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../../ds/MPSCQueue.h"
+#include "../../ds/TaskPool.h"
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		// 解码结果，像素为RGBA8，第一行是图片顶部(翻转时为底部)
+		struct DecodedImage
+		{
+			uint32_t m_id = 0;
+			bool m_ok = false;
+			int32_t m_width = 0;
+			int32_t m_height = 0;
+			std::vector<uint8_t> m_pixels;
+		};
+
+		class ImageDecoder
+		{
+		public:
+			// 同步解码，任意线程可调用
+			static bool Decode(const std::string& path, bool flipVertically, DecodedImage& out);
+			// 默认工作线程数，解码线程不宜太多，避免和布局、渲染抢核
+			static size_t DefaultWorkerCount();
+
+		public:
+			explicit ImageDecoder(size_t workerCount = DefaultWorkerCount());
+
+			ImageDecoder(const ImageDecoder&) = delete;
+			ImageDecoder& operator=(const ImageDecoder&) = delete;
+
+		public:
+			// 提交解码，id由调用方决定，结果原样带回，第一次提交时创建任务池
+			void Submit(uint32_t id, const std::string& path, bool flipVertically = false);
+			// 取出一个完成的结果，只能在一个线程调用
+			bool TryPop(DecodedImage& out);
+			// 已提交还没取出的个数
+			size_t GetPendingCount() const { return m_pending.load(std::memory_order_relaxed); }
+
+		private:
+			// 任务池的工作线程数
+			size_t m_workerCount;
+			// 完成的结果
+			sz_ds::MPSCQueue<DecodedImage> m_completed;
+			// 已提交还没取出的个数
+			std::atomic<size_t> m_pending{ 0 };
+			// 解码任务池，最后声明，先于结果队列析构，析构时等待正在解码的任务结束
+			std::unique_ptr<sz_ds::TaskPool> m_pool;
+		};
+	}
+}
@@ -0,0 +1,182 @@
+#include "IndirectBatcher.h"
+#include "CheckRstErr.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        namespace
+        {
+            template <typename T>
+            bool sameContent(const std::vector<T>& a, const std::vector<T>& b)
+            {
+                return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+            }
+        }
+
+        IndirectBatcher::~IndirectBatcher()
+        {
+            Release();
+        }
+
+        bool IndirectBatcher::Init()
+        {
+            if (m_supported)
+            {
+                return true;
+            }
+
+#ifdef USE_OPENGL_ES
+            return false;
+#else
+            // gl_DrawID和glMultiDrawElementsIndirect都需要4.6
+            GLint major = 0;
+            GLint minor = 0;
+            glGetIntegerv(GL_MAJOR_VERSION, &major);
+            glGetIntegerv(GL_MINOR_VERSION, &minor);
+            if (major < 4 || (major == 4 && minor < 6))
+            {
+                return false;
+            }
+
+            GL_CALL(glGenBuffers(1, &m_commandBuffer));
+            GL_CALL(glGenBuffers(1, &m_drawDataBuffer));
+            m_supported = true;
+            return true;
+#endif
+        }
+
+        void IndirectBatcher::Release()
+        {
+            if (!m_supported)
+            {
+                return;
+            }
+            glDeleteBuffers(1, &m_commandBuffer);
+            glDeleteBuffers(1, &m_drawDataBuffer);
+            m_commandBuffer = 0;
+            m_drawDataBuffer = 0;
+            m_commandCapacity = 0;
+            m_drawDataCapacity = 0;
+            m_uploadedCommands.clear();
+            m_uploadedDrawData.clear();
+            m_supported = false;
+        }
+
+        void IndirectBatcher::Begin()
+        {
+            m_commands.clear();
+            m_drawData.clear();
+            m_batches.clear();
+        }
+
+        void IndirectBatcher::Add(const RenderItemPtr& ri)
+        {
+            const auto& geo = *ri->m_geo;
+            m_commands.push_back(DrawElementsIndirectCommand{
+                GLuint(geo.GetIndicesCount()),
+                1,
+                GLuint(geo.GetIndicesByteOffset() / sizeof(uint32_t)),
+                0,
+                0
+            });
+            m_drawData.push_back(IndirectDrawData{
+                glm::vec4(ri->m_position, 0.0f),
+                glm::vec4(ri->m_textInfo.m_color, ri->m_opacity),
+                ri->m_clipRect
+            });
+
+            if (!m_batches.empty() && canMerge(**m_batches.back().m_last, *ri))
+            {
+                auto& batch = m_batches.back();
+                batch.m_last = &ri;
+                ++batch.m_drawCount;
+                return;
+            }
+            m_batches.push_back(IndirectBatch{ &ri, &ri, uint32_t(m_commands.size() - 1), 1 });
+        }
+
+        size_t IndirectBatcher::Upload()
+        {
+            size_t bytes = 0;
+#ifndef USE_OPENGL_ES
+            // 绘制对象集合和几何区间不变时命令不变，只有平移颜色等变化时只上传绘制数据
+            if (!sameContent(m_commands, m_uploadedCommands))
+            {
+                const size_t size = m_commands.size() * sizeof(DrawElementsIndirectCommand);
+                uploadBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer, m_commandCapacity, m_commands.data(), size);
+                m_uploadedCommands = m_commands;
+                bytes += size;
+            }
+            if (!sameContent(m_drawData, m_uploadedDrawData))
+            {
+                const size_t size = m_drawData.size() * sizeof(IndirectDrawData);
+                uploadBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer, m_drawDataCapacity, m_drawData.data(), size);
+                m_uploadedDrawData = m_drawData;
+                bytes += size;
+            }
+#endif
+            return bytes;
+        }
+
+        void IndirectBatcher::Draw([[maybe_unused]] const IndirectBatch& batch) const
+        {
+#ifndef USE_OPENGL_ES
+            GL_CALL(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer));
+            GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_drawDataBuffer));
+            GL_CALL(glMultiDrawElementsIndirect((*batch.m_first)->m_drawMode, GL_UNSIGNED_INT,
+                (const void*)(size_t(batch.m_commandOffset) * sizeof(DrawElementsIndirectCommand)),
+                GLsizei(batch.m_drawCount), 0));
+            GL_CALL(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+#endif
+        }
+
+        bool IndirectBatcher::canMerge(const RenderItem& a, const RenderItem& b)
+        {
+            // 贴图的页面纹理和uv是逐个绘制设置的，不合批
+            if (a.m_materialType == MaterialType::TextureMaterial)
+            {
+                return false;
+            }
+
+            // 颜色材质剪裁和不剪裁的shader不同
+            if (a.m_materialType == MaterialType::ColorMaterial && a.IsClipped() != b.IsClipped())
+            {
+                return false;
+            }
+
+            return a.m_materialType == b.m_materialType &&
+                a.m_geo->GetVao() == b.m_geo->GetVao() &&
+                a.m_drawMode == b.m_drawMode &&
+                a.m_faceCulling == b.m_faceCulling &&
+                a.m_frontFace == b.m_frontFace &&
+                a.m_cullFace == b.m_cullFace &&
+                a.m_depthTest == b.m_depthTest &&
+                a.m_depthFunc == b.m_depthFunc &&
+                a.m_depthWrite == b.m_depthWrite &&
+                a.m_blend == b.m_blend &&
+                a.m_sFactor == b.m_sFactor &&
+                a.m_dFactor == b.m_dFactor;
+        }
+
+        void IndirectBatcher::uploadBuffer(GLenum target, GLuint buffer, size_t& capacity, const void* data, size_t bytes)
+        {
+            if (bytes == 0)
+            {
+                return;
+            }
+
+            GL_CALL(glBindBuffer(target, buffer));
+            if (bytes > capacity)
+            {
+                capacity = std::max(bytes, capacity * 2);
+                GL_CALL(glBufferData(target, capacity, nullptr, GL_DYNAMIC_DRAW));
+            }
+            GL_CALL(glBufferSubData(target, 0, bytes, data));
+            GL_CALL(glBindBuffer(target, 0));
+        }
+    }
+}
@@ -0,0 +1,140 @@
+// comment: 不透明物体合批，状态相同的连续绘制合成一次glMultiDrawElementsIndirect，每个绘制的数据放在SSBO中通过gl_DrawID读取
+// 只在桌面GL4.6下可用，GLES3没有多重间接绘制和SSBO，走逐个绘制
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "RenderItem.h"
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        // 间接绘制命令，布局由GL规定
+        struct DrawElementsIndirectCommand
+        {
+            GLuint m_count;
+            GLuint m_instanceCount;
+            GLuint m_firstIndex;
+            GLint m_baseVertex;
+            GLuint m_baseInstance;
+        };
+        static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+        // 每个绘制的数据，std430布局
+        struct IndirectDrawData
+        {
+            // 模型平移，w不使用
+            glm::vec4 m_translation;
+            // 文字颜色和透明度
+            glm::vec4 m_color;
+            // 剪裁矩形
+            glm::vec4 m_clipRect;
+        };
+        static_assert(sizeof(IndirectDrawData) == 48);
+
+        // 一批连续的绘制，渲染状态取第一个绘制对象，剪裁矩形逐个绘制从SSBO读取
+        struct IndirectBatch
+        {
+            const RenderItemPtr* m_first;
+            const RenderItemPtr* m_last;
+            // 第一个命令的下标
+            uint32_t m_commandOffset;
+            // 命令个数
+            uint32_t m_drawCount;
+        };
+
+        // 合批用到的渲染对象状态，上一帧绘制过且这些状态不变的对象不需要重建合批
+        struct IndirectItemState
+        {
+            glm::vec3 m_position;
+            glm::vec4 m_clipRect;
+            glm::vec3 m_textColor;
+            float m_opacity;
+            GLenum m_drawMode;
+            MaterialType m_materialType;
+            bool m_depthTest;
+            GLenum m_depthFunc;
+            bool m_depthWrite;
+            bool m_faceCulling;
+            GLenum m_frontFace;
+            GLenum m_cullFace;
+            bool m_blend;
+            GLenum m_sFactor;
+            GLenum m_dFactor;
+
+            static IndirectItemState From(const RenderItem& ri)
+            {
+                return IndirectItemState{ ri.m_position, ri.m_clipRect, ri.m_textInfo.m_color, ri.m_opacity,
+                    ri.m_drawMode, ri.m_materialType, ri.m_depthTest, ri.m_depthFunc, ri.m_depthWrite,
+                    ri.m_faceCulling, ri.m_frontFace, ri.m_cullFace, ri.m_blend, ri.m_sFactor, ri.m_dFactor };
+            }
+
+            bool operator==(const IndirectItemState&) const = default;
+        };
+
+        class IndirectBatcher
+        {
+        public:
+            IndirectBatcher() = default;
+            ~IndirectBatcher();
+
+            IndirectBatcher(const IndirectBatcher&) = delete;
+            IndirectBatcher& operator=(const IndirectBatcher&) = delete;
+
+        public:
+            // 创建缓冲，需要在GL上下文创建后调用，不支持多重间接绘制返回false
+            bool Init();
+            // 删除缓冲，需要在GL上下文销毁前调用
+            void Release();
+            // 是否可用
+            bool IsSupported() const { return m_supported; }
+
+            // 开始重新收集绘制，对象集合、顺序或者状态没变时可以沿用上一次的批次，不需要调用
+            void Begin();
+            // 加入一个绘制对象，和上一个绘制状态相同时并入同一批
+            void Add(const RenderItemPtr& ri);
+            // 命令或绘制数据和上一次上传的不同时才上传，返回上传的字节数
+            size_t Upload();
+            // 绑定缓冲并提交一批
+            void Draw(const IndirectBatch& batch) const;
+            // 最近一次收集的所有批次
+            const std::vector<IndirectBatch>& GetBatches() const { return m_batches; }
+
+        private:
+            // 能否和上一个绘制合成一批
+            static bool canMerge(const RenderItem& a, const RenderItem& b);
+            // 上传到缓冲，容量不够时按倍数扩容
+            static void uploadBuffer(GLenum target, GLuint buffer, size_t& capacity, const void* data, size_t bytes);
+
+        private:
+            // 是否可用
+            bool m_supported = false;
+            // 间接绘制命令缓冲
+            GLuint m_commandBuffer = 0;
+            // 绘制数据SSBO
+            GLuint m_drawDataBuffer = 0;
+            // 缓冲容量，单位字节
+            size_t m_commandCapacity = 0;
+            size_t m_drawDataCapacity = 0;
+            // 本帧的命令和绘制数据
+            std::vector<DrawElementsIndirectCommand> m_commands;
+            std::vector<IndirectDrawData> m_drawData;
+            // 已上传的命令和绘制数据，用来判断是否需要重新上传
+            std::vector<DrawElementsIndirectCommand> m_uploadedCommands;
+            std::vector<IndirectDrawData> m_uploadedDrawData;
+            // 最近一次收集的所有批次
+            std::vector<IndirectBatch> m_batches;
+        };
+    }
+}
@@ -0,0 +1,158 @@
+#include "OverdrawCounter.h"
+#include "CheckRstErr.h"
+
+#include <algorithm>
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        OverdrawCounter::~OverdrawCounter()
+        {
+            Release();
+        }
+
+        void OverdrawCounter::Release()
+        {
+            if (m_framebuffer)
+            {
+                glDeleteFramebuffers(1, &m_framebuffer);
+                glDeleteTextures(1, &m_heatTexture);
+                glDeleteRenderbuffers(1, &m_depthStencil);
+                glDeleteVertexArrays(1, &m_vao);
+            }
+            m_framebuffer = 0;
+            m_heatTexture = 0;
+            m_depthStencil = 0;
+            m_vao = 0;
+            m_width = 0;
+            m_height = 0;
+            m_active = false;
+            m_pixels.clear();
+        }
+
+        bool OverdrawCounter::Begin(int width, int height)
+        {
+            m_active = false;
+            if (width <= 0 || height <= 0)
+            {
+                return false;
+            }
+            // 创建帧缓冲会改变绑定，先记下原来的帧缓冲
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_targetFramebuffer);
+            if ((width != m_width || height != m_height) && !create(width, height))
+            {
+                return false;
+            }
+
+            GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer));
+            // 深度测试通过的片元模板值加一，discard和被深度测试拒绝的片元不计
+            GL_CALL(glEnable(GL_STENCIL_TEST));
+            GL_CALL(glStencilMask(0xFF));
+            GL_CALL(glStencilFunc(GL_ALWAYS, 0, 0xFF));
+            GL_CALL(glStencilOp(GL_KEEP, GL_KEEP, GL_INCR));
+            GL_CALL(glClearStencil(0));
+            GL_CALL(glClear(GL_STENCIL_BUFFER_BIT));
+            m_active = true;
+            return true;
+        }
+
+        OverdrawStats OverdrawCounter::End(const Shader& shader)
+        {
+            OverdrawStats stats;
+            if (!m_active)
+            {
+                return stats;
+            }
+            m_active = false;
+
+            // 场景颜色换成热度，模板保留
+            const GLfloat clearColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            GL_CALL(glClearBufferfv(GL_COLOR, 0, clearColor));
+            GL_CALL(glDisable(GL_DEPTH_TEST));
+            GL_CALL(glDisable(GL_BLEND));
+            GL_CALL(glDisable(GL_CULL_FACE));
+            GL_CALL(glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP));
+
+            shader.Begin();
+            GL_CALL(glBindVertexArray(m_vao));
+            for (uint32_t level = 1; level <= MAX_LEVEL; ++level)
+            {
+                // 最后一层包括所有更高的层，ref<=模板值即通过
+                GL_CALL(glStencilFunc(level == MAX_LEVEL ? GL_LEQUAL : GL_EQUAL, GLint(level), 0xFF));
+                shader.SetUniformVector4("heatColor", heatColor(level));
+                GL_CALL(glDrawArrays(GL_TRIANGLES, 0, 3));
+            }
+            GL_CALL(glBindVertexArray(0));
+            GL_CALL(glDisable(GL_STENCIL_TEST));
+
+            // 回读热度纹理统计，层数存在alpha中
+            m_pixels.resize(size_t(m_width) * size_t(m_height) * 4);
+            GL_CALL(glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data()));
+            for (size_t i = 3; i < m_pixels.size(); i += 4)
+            {
+                const uint8_t level = m_pixels[i];
+                stats.m_fragments += level;
+                stats.m_coveredPixels += level ? 1 : 0;
+            }
+
+            // 热度图显示到原来的帧缓冲
+            GL_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(m_targetFramebuffer)));
+            GL_CALL(glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                GL_COLOR_BUFFER_BIT, GL_NEAREST));
+            GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_targetFramebuffer)));
+            return stats;
+        }
+
+        bool OverdrawCounter::create(int width, int height)
+        {
+            Release();
+
+            GL_CALL(glGenTextures(1, &m_heatTexture));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, m_heatTexture));
+            GL_CALL(glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+
+            GL_CALL(glGenRenderbuffers(1, &m_depthStencil));
+            GL_CALL(glBindRenderbuffer(GL_RENDERBUFFER, m_depthStencil));
+            GL_CALL(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height));
+            GL_CALL(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+            GL_CALL(glGenFramebuffers(1, &m_framebuffer));
+            GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer));
+            GL_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_heatTexture, 0));
+            GL_CALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthStencil));
+            const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, GLuint(m_targetFramebuffer)));
+
+            GL_CALL(glGenVertexArrays(1, &m_vao));
+
+            m_width = width;
+            m_height = height;
+            if (status != GL_FRAMEBUFFER_COMPLETE)
+            {
+                Release();
+                return false;
+            }
+            return true;
+        }
+
+        glm::vec4 OverdrawCounter::heatColor(uint32_t level)
+        {
+            // 四段线性插值，第一层为蓝色，最后一层为红色
+            static const glm::vec3 stops[5] = {
+                { 0.0f, 0.0f, 1.0f },
+                { 0.0f, 1.0f, 1.0f },
+                { 0.0f, 1.0f, 0.0f },
+                { 1.0f, 1.0f, 0.0f },
+                { 1.0f, 0.0f, 0.0f },
+            };
+            const float t = float(level - 1) / float(MAX_LEVEL - 1) * 4.0f;
+            const uint32_t index = std::min<uint32_t>(uint32_t(t), 3);
+            const glm::vec3 rgb = glm::mix(stops[index], stops[index + 1], t - float(index));
+            return glm::vec4(rgb, float(level) / 255.0f);
+        }
+    }
+}
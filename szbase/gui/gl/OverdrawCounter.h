@@ -0,0 +1,81 @@
+// comment: 过度绘制统计，场景画到离屏帧缓冲，每个通过深度测试的片元把模板值加一，
+// 结束后按模板值分层画出热度纹理并显示到原来的帧缓冲，同时回读统计片元数，只用于测量，会拖慢帧率
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "Shader.h"
+
+namespace sz_gui
+{
+    namespace gl
+    {
+        // 过度绘制统计结果
+        struct OverdrawStats
+        {
+            // 写入的片元数，超过MAX_LEVEL层的像素按MAX_LEVEL计
+            uint64_t m_fragments = 0;
+            // 至少写入一次的像素数
+            uint64_t m_coveredPixels = 0;
+        };
+
+        class OverdrawCounter
+        {
+        public:
+            OverdrawCounter() = default;
+            ~OverdrawCounter();
+
+            OverdrawCounter(const OverdrawCounter&) = delete;
+            OverdrawCounter& operator=(const OverdrawCounter&) = delete;
+
+        public:
+            // 删除帧缓冲，需要在GL上下文销毁前调用
+            void Release();
+            // 绑定离屏帧缓冲并开始计数，大小变化时重建，需要在清屏前调用
+            bool Begin(int width, int height);
+            // 画出热度纹理，显示到Begin时绑定的帧缓冲并回读统计，回读整个帧缓冲是同步的，要等GPU画完
+            OverdrawStats End(const Shader& shader);
+            // 热度纹理，rgb为热度颜色，a为层数/255
+            GLuint GetHeatTexture() const { return m_heatTexture; }
+
+        public:
+            // 热度分层数，模板值不小于MAX_LEVEL的像素画成最热的颜色
+            static constexpr uint32_t MAX_LEVEL = 16;
+
+        private:
+            // 创建帧缓冲
+            bool create(int width, int height);
+            // 第level层的热度颜色，蓝->青->绿->黄->红
+            static glm::vec4 heatColor(uint32_t level);
+
+        private:
+            // 帧缓冲
+            GLuint m_framebuffer = 0;
+            // 热度纹理，计数时也作为场景颜色缓冲
+            GLuint m_heatTexture = 0;
+            // 深度模板缓冲
+            GLuint m_depthStencil = 0;
+            // Begin时绑定的帧缓冲，一般是默认帧缓冲0
+            GLint m_targetFramebuffer = 0;
+            // 空顶点数组，全屏三角形不需要顶点数据
+            GLuint m_vao = 0;
+            // 帧缓冲大小
+            int m_width = 0;
+            int m_height = 0;
+            // 本帧是否在计数
+            bool m_active = false;
+            // 回读缓冲
+            std::vector<uint8_t> m_pixels;
+        };
+    }
+}
@@ -0,0 +1,198 @@
+#include "ProgramCache.h"
+#include "CheckRstErr.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		namespace
+		{
+			// 缓存文件头
+			struct ProgramCacheHeader
+			{
+				uint32_t m_magic;
+				uint32_t m_version;
+				uint64_t m_key;
+				uint32_t m_format;
+				uint32_t m_size;
+			};
+
+			constexpr uint32_t CACHE_MAGIC = 0x42505A53; // "SZPB"
+			constexpr uint32_t CACHE_VERSION = 1;
+
+			// FNV-1a 64位
+			uint64_t hashAppend(uint64_t hash, const char* str)
+			{
+				for (; str && *str; ++str)
+				{
+					hash ^= uint8_t(*str);
+					hash *= 0x100000001B3ull;
+				}
+				// 分隔符，避免拼接后相同
+				hash ^= 0xFF;
+				hash *= 0x100000001B3ull;
+				return hash;
+			}
+
+			double elapsedMs(std::chrono::steady_clock::time_point begin)
+			{
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+			}
+		}
+
+		void ProgramCache::Init(const std::string& directory)
+		{
+			m_enabled = false;
+			if (directory.empty())
+			{
+				return;
+			}
+
+			// 驱动不提供任何程序二进制格式时无法缓存
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			if (formats <= 0)
+			{
+				return;
+			}
+
+			std::error_code ec;
+			std::filesystem::create_directories(directory, ec);
+			if (ec)
+			{
+				return;
+			}
+
+			m_directory = directory;
+			if (m_directory.back() != '/' && m_directory.back() != '\\')
+			{
+				m_directory.push_back('/');
+			}
+			m_driver = std::string((const char*)glGetString(GL_RENDERER)) + "|" +
+				std::string((const char*)glGetString(GL_VERSION));
+			m_enabled = true;
+		}
+
+		uint64_t ProgramCache::MakeKey(const char* vertexSource, const char* fragmentSource) const
+		{
+			uint64_t hash = 0xCBF29CE484222325ull;
+			hash = hashAppend(hash, vertexSource);
+			hash = hashAppend(hash, fragmentSource);
+			hash = hashAppend(hash, m_driver.c_str());
+			return hash;
+		}
+
+		bool ProgramCache::Load(uint64_t key, GLuint program)
+		{
+			if (!m_enabled)
+			{
+				return false;
+			}
+
+			auto begin = std::chrono::steady_clock::now();
+			std::ifstream file(filePath(key), std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			ProgramCacheHeader header{};
+			std::vector<char> binary;
+			bool valid = bool(file.read(reinterpret_cast<char*>(&header), sizeof(header))) &&
+				header.m_magic == CACHE_MAGIC && header.m_version == CACHE_VERSION && header.m_key == key;
+			if (valid)
+			{
+				binary.resize(header.m_size);
+				valid = bool(file.read(binary.data(), binary.size()));
+			}
+			file.close();
+
+			if (valid)
+			{
+				// 驱动升级后可能拒绝旧的二进制，链接状态为失败
+				glProgramBinary(program, header.m_format, binary.data(), GLsizei(binary.size()));
+				GLint linked = 0;
+				glGetProgramiv(program, GL_LINK_STATUS, &linked);
+				valid = linked;
+			}
+
+			if (!valid)
+			{
+				++m_stats.m_cacheStale;
+				std::error_code ec;
+				std::filesystem::remove(filePath(key), ec);
+				return false;
+			}
+
+			++m_stats.m_cacheHits;
+			m_stats.m_loadMs += elapsedMs(begin);
+			return true;
+		}
+
+		void ProgramCache::Store(uint64_t key, GLuint program)
+		{
+			if (!m_enabled)
+			{
+				return;
+			}
+
+			GLint length = 0;
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+			if (length <= 0)
+			{
+				return;
+			}
+
+			ProgramCacheHeader header{ CACHE_MAGIC, CACHE_VERSION, key, 0, 0 };
+			std::vector<char> binary(length);
+			GLenum format = 0;
+			GLsizei size = 0;
+			glGetProgramBinary(program, length, &size, &format, binary.data());
+			if (size <= 0)
+			{
+				return;
+			}
+			header.m_format = format;
+			header.m_size = uint32_t(size);
+
+			// 先写临时文件再改名，避免多个进程同时启动时读到写了一半的文件
+			const std::string path = filePath(key);
+			const std::string tmpPath = path + ".tmp";
+			{
+				std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+				if (!file.is_open())
+				{
+					return;
+				}
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(binary.data(), size);
+				if (!file)
+				{
+					return;
+				}
+			}
+			std::error_code ec;
+			std::filesystem::rename(tmpPath, path, ec);
+		}
+
+		void ProgramCache::RecordBuild(double compileMs, double linkMs)
+		{
+			++m_stats.m_cacheMisses;
+			m_stats.m_compileMs += compileMs;
+			m_stats.m_linkMs += linkMs;
+		}
+
+		std::string ProgramCache::filePath(uint64_t key) const
+		{
+			char name[32] = {};
+			std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+			return m_directory + name;
+		}
+	}
+}
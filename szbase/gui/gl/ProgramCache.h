@@ -0,0 +1,74 @@
+// comment: 着色器程序二进制缓存，按shader源码和驱动信息的哈希存到磁盘，驱动或源码变化后自动失效，重新编译
+
+#pragma once
+
+#ifdef USE_OPENGL_ES
+#include <GLES3/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+
+#include <cstdint>
+#include <string>
+
+namespace sz_gui
+{
+	namespace gl
+	{
+		// 着色器构建统计，时间单位为毫秒
+		struct ShaderBuildStats
+		{
+			// 从源码编译耗时
+			double m_compileMs = 0.0;
+			// 链接耗时
+			double m_linkMs = 0.0;
+			// 从缓存加载耗时
+			double m_loadMs = 0.0;
+			// 命中缓存的程序个数
+			uint32_t m_cacheHits = 0;
+			// 从源码构建的程序个数
+			uint32_t m_cacheMisses = 0;
+			// 缓存存在但已经失效的个数
+			uint32_t m_cacheStale = 0;
+		};
+
+		class ProgramCache
+		{
+		public:
+			ProgramCache() = default;
+
+			ProgramCache(const ProgramCache&) = delete;
+			ProgramCache& operator=(const ProgramCache&) = delete;
+
+		public:
+			// 设置缓存目录，需要在GL上下文创建后调用，目录为空或驱动不支持程序二进制时不缓存
+			void Init(const std::string& directory);
+			// 是否启用
+			bool IsEnabled() const { return m_enabled; }
+			// 计算缓存键，包含shader源码和驱动的GL_RENDERER/GL_VERSION
+			uint64_t MakeKey(const char* vertexSource, const char* fragmentSource) const;
+			// 从缓存加载到program，缓存不存在或失效返回false
+			bool Load(uint64_t key, GLuint program);
+			// 把链接好的program存入缓存
+			void Store(uint64_t key, GLuint program);
+			// 记录从源码构建的耗时
+			void RecordBuild(double compileMs, double linkMs);
+			// 构建统计
+			const ShaderBuildStats& GetStats() const { return m_stats; }
+
+		private:
+			// 缓存文件路径
+			std::string filePath(uint64_t key) const;
+
+		private:
+			// 是否启用
+			bool m_enabled = false;
+			// 缓存目录，以分隔符结尾
+			std::string m_directory;
+			// 驱动信息
+			std::string m_driver;
+			// 构建统计
+			ShaderBuildStats m_stats;
+		};
+	}
+}
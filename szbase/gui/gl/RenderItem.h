@@ -12,6 +12,7 @@
 #include <memory>
 
 #include "../IRender.h"
+#include "../../ds/ObjectPool.h"
 #include "Geometry.h"
 
 namespace sz_gui
@@ -25,13 +26,18 @@ namespace sz_gui
 			{
 				return glm::translate(glm::mat4(1.0f), m_position);
 			}
+			// 是否需要在着色器中剪裁
+			bool IsClipped() const
+			{
+				return m_clipRect != NO_CLIP_RECT;
+			}
 
 			// 世界坐标系位置
 			glm::vec3 m_position{ 0.0f };
 			// 绘制指令
 			GLenum m_drawMode{ GL_TRIANGLES  };
 			// 几何
-			std::unique_ptr<Geometry> m_geo = nullptr;
+			sz_ds::PoolPtr<Geometry> m_geo = nullptr;
 			// 材质类型
 			MaterialType m_materialType = MaterialType::ColorMaterial;
 			// 深度检测相关
@@ -56,16 +62,20 @@ namespace sz_gui
 			// 剔除正面还是背面
 			GLenum m_cullFace{ GL_BACK };
 
-			// 剪裁测试相关
-			// 是否开启剪裁设置
-			bool m_scissorSet{ false };
-			// 是否开启剪裁测试
-			bool m_scissorTest{ false };
-			int32_t m_scissorX, m_scissorY;
-			int32_t m_scissorW, m_scissorH;
+			// 剪裁矩形，UI坐标(minX, minY, maxX, maxY)
+			glm::vec4 m_clipRect{ NO_CLIP_RECT };
 
 			// 文字相关
 			TextInfo m_textInfo;
+
+			// 贴图相关，图集中的图片id
+			uint32_t m_imageId{ 0 };
+
+			// 最近一次被收集的帧序号，本帧未收集的对象不绘制，但保留GPU资源
+			uint64_t m_frameIndex{ 0 };
 		};
+
+		// 渲染对象独占指针，内存来自GLContext的对象池
+		using RenderItemPtr = sz_ds::PoolPtr<RenderItem>;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Shader.h"
 #include "CheckRstErr.h"
 
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
@@ -63,10 +64,26 @@ namespace sz_gui
 		}
 
 		std::tuple<std::string, bool> Shader::LoadFromString(const char* vertexShaderSource,
-			const char* fragmentShaderSource)
+			const char* fragmentShaderSource, ProgramCache* cache)
 		{
 			std::string errMsg = "success";
 
+			// 先尝试程序二进制缓存
+			uint64_t cacheKey = 0;
+			if (cache && cache->IsEnabled())
+			{
+				cacheKey = cache->MakeKey(vertexShaderSource, fragmentShaderSource);
+				m_program = glCreateProgram();
+				if (cache->Load(cacheKey, m_program))
+				{
+					return { std::move(errMsg), true };
+				}
+				glDeleteProgram(m_program);
+				m_program = 0;
+			}
+
+			auto compileBegin = std::chrono::steady_clock::now();
+
 			// 创建shader程序
 			GLuint vertex, fragment;
 			vertex = glCreateShader(GL_VERTEX_SHADER);
@@ -99,8 +116,15 @@ namespace sz_gui
 				return { std::move(errMsg), false };
 			}
 
+			auto linkBegin = std::chrono::steady_clock::now();
+
 			// 创建一个Program壳子
 			m_program = glCreateProgram();
+			if (cache && cache->IsEnabled())
+			{
+				// 允许链接后取回二进制
+				glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
 
 			// 将vs与fs编译好的结果放到program
 			glAttachShader(m_program, vertex);
@@ -125,6 +149,14 @@ namespace sz_gui
 			glDeleteShader(vertex);
 			glDeleteShader(fragment);
 
+			if (cache)
+			{
+				auto linkEnd = std::chrono::steady_clock::now();
+				cache->RecordBuild(std::chrono::duration<double, std::milli>(linkBegin - compileBegin).count(),
+					std::chrono::duration<double, std::milli>(linkEnd - linkBegin).count());
+				cache->Store(cacheKey, m_program);
+			}
+
 			return { std::move(errMsg), true };
 		}
 
@@ -163,6 +195,12 @@ namespace sz_gui
 			GL_CALL(glUniform3fv(location, 1, glm::value_ptr(value)));
 		}
 
+		void Shader::SetUniformVector4(const std::string& name, const glm::vec4 value) const
+		{
+			GLint location = glGetUniformLocation(m_program, name.c_str());
+			GL_CALL(glUniform4fv(location, 1, glm::value_ptr(value)));
+		}
+
 		void Shader::SetUniformInt(const std::string& name, int value) const
 		{
 			GLint location = glGetUniformLocation(m_program, name.c_str());
@@ -9,9 +9,12 @@
 #endif
 
 #include <string>
+#include <tuple>
 
 #include <glm/glm.hpp>
 
+#include "ProgramCache.h"
+
 namespace sz_gui
 {
 	namespace gl
@@ -25,9 +28,9 @@ namespace sz_gui
 			// 从文件加载着色器
 			std::tuple<std::string, bool> LoadFromFile(const char* vertexShaderPath, 
 				const char* fragmentShaderPath);
-			// 从字符串加载着色器
+			// 从字符串加载着色器，传入cache时先尝试从程序二进制缓存加载，编译成功后写入缓存
 			std::tuple<std::string, bool> LoadFromString(const char* vertexShaderSource,
-				const char* fragmentShaderSource);
+				const char* fragmentShaderSource, ProgramCache* cache = nullptr);
 
 			// 开始使用当前Shader
 			void Begin() const;
@@ -38,6 +41,7 @@ namespace sz_gui
 			void SetUniformVector3(const std::string& name, float x, float y, float z) const;
 			void SetUniformVector3(const std::string& name, const float* values) const;
 			void SetUniformVector3(const std::string& name, const glm::vec3 value) const;
+			void SetUniformVector4(const std::string& name, const glm::vec4 value) const;
 			void SetUniformInt(const std::string& name, int value) const;
 			void SetUniformMatrix4x4(const std::string& name, glm::mat4 value) const;
 			void SetUniformBool(const std::string& name, bool bValue) const;
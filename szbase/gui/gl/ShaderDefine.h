@@ -7,54 +7,100 @@ const char* ColorVS =
 #ifdef USE_OPENGL_ES
 R"(#version 300 es
 precision highp float;
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-out vec3 color;
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+out vec4 color;
+out vec2 clipPos;
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 void main()
 {
-	vec4 transformPosition = vec4(aPos, 1.0);
-	gl_Position = projectionMatrix * viewMatrix * modelMatrix * transformPosition;
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
 	color = aColor;
 }
 )";
 #else
 R"(#version 460 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
-out vec3 color;
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+out vec4 color;
+out vec2 clipPos;
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 void main()
 {
-	vec4 transformPosition = vec4(aPos, 1.0);
-	gl_Position = projectionMatrix * viewMatrix * modelMatrix * transformPosition;
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
 	color = aColor;
 }
 )";
 #endif
-// 颜色片元着色器
+// 颜色片元着色器，没有discard，不影响提前深度测试
 const char* ColorFS =
 #ifdef USE_OPENGL_ES
 R"(#version 300 es
 precision highp float;
-in vec3 color;
+in vec4 color;
 out vec4 FragColor;
 void main()
 {
-	FragColor = vec4(color, 1.0);
+	FragColor = color;
 }
 )";
 #else
 R"(#version 460 core
-in vec3 color;
+in vec4 color;
 out vec4 FragColor;
 void main()
 {
-	FragColor = vec4(color, 1.0);
+	FragColor = color;
+}
+)";
+#endif
+// 带剪裁的颜色片元着色器，只给超出剪裁区域的对象使用
+const char* ColorClipFS =
+#ifdef USE_OPENGL_ES
+R"(#version 300 es
+precision highp float;
+in vec4 color;
+in vec2 clipPos;
+out vec4 FragColor;
+uniform vec4 clipRect;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	FragColor = color;
+}
+)";
+#else
+R"(#version 460 core
+in vec4 color;
+in vec2 clipPos;
+out vec4 FragColor;
+uniform vec4 clipRect;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	FragColor = color;
 }
 )";
 #endif
@@ -64,36 +110,46 @@ const char* TextVS =
 #ifdef USE_OPENGL_ES
 R"(#version 300 es
 precision highp float;
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aUV;
 layout (location = 2) in float aLayer;
 out vec2 uv;
 out float layer;
+out vec2 clipPos;
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 void main()
 {
-	vec4 transformPosition = vec4(aPos, 1.0);
-	gl_Position = projectionMatrix * viewMatrix * modelMatrix * transformPosition;
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
 	uv = aUV;
 	layer = aLayer;
 }
 )";
 #else
 R"(#version 460 core
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aUV;
 layout (location = 2) in float aLayer;
 out vec2 uv;
 out float layer;
+out vec2 clipPos;
 uniform mat4 modelMatrix;
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 void main()
 {
-	vec4 transformPosition = vec4(aPos, 1.0);
-	gl_Position = projectionMatrix * viewMatrix * modelMatrix * transformPosition;
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
 	uv = aUV;
 	layer = aLayer;
 }
@@ -107,12 +163,19 @@ precision highp float;
 precision highp sampler2DArray;
 in vec2 uv;
 in float layer;
+in vec2 clipPos;
 out vec4 FragColor;
 uniform sampler2DArray sampler;
 uniform vec3 textColor;
 uniform float opacity;
+uniform vec4 clipRect;
 void main()
 {
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
 	float mask = texture(sampler, vec3(uv, layer)).r;
 	if (mask < 0.1) 
 	{
@@ -127,12 +190,19 @@ void main()
 R"(#version 460 core
 in vec2 uv;
 in float layer;
+in vec2 clipPos;
 out vec4 FragColor;
 uniform sampler2DArray sampler;
 uniform vec3 textColor;
 uniform float opacity;
+uniform vec4 clipRect;
 void main()
 {
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
 	float mask = texture(sampler, vec3(uv, layer)).r;
 	if (mask < 0.1) 
 	{
@@ -143,4 +213,259 @@ void main()
 	FragColor = vec4(finalRGB, opacity * mask);
 }
 )";
-#endif
\ No newline at end of file
+#endif
+
+// 贴图顶点着色器，和文字共用顶点格式，不使用纹理层
+const char* TextureVS =
+#ifdef USE_OPENGL_ES
+R"(#version 300 es
+precision highp float;
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aUV;
+out vec2 uv;
+out vec2 clipPos;
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+uniform vec4 uvRect;
+void main()
+{
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
+	// 图片内的uv映射到图集页面
+	uv = uvRect.xy + aUV * uvRect.zw;
+}
+)";
+#else
+R"(#version 460 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aUV;
+out vec2 uv;
+out vec2 clipPos;
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+uniform vec4 uvRect;
+void main()
+{
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	vec4 worldPosition = modelMatrix * transformPosition;
+	gl_Position = projectionMatrix * viewMatrix * worldPosition;
+	// 世界坐标就是UI坐标，用于剪裁
+	clipPos = worldPosition.xy;
+	// 图片内的uv映射到图集页面
+	uv = uvRect.xy + aUV * uvRect.zw;
+}
+)";
+#endif
+// 贴图片元着色器
+const char* TextureFS =
+#ifdef USE_OPENGL_ES
+R"(#version 300 es
+precision highp float;
+in vec2 uv;
+in vec2 clipPos;
+out vec4 FragColor;
+uniform sampler2D sampler;
+uniform float opacity;
+uniform vec4 clipRect;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	vec4 color = texture(sampler, uv);
+	FragColor = vec4(color.rgb, color.a * opacity);
+}
+)";
+#else
+R"(#version 460 core
+in vec2 uv;
+in vec2 clipPos;
+out vec4 FragColor;
+uniform sampler2D sampler;
+uniform float opacity;
+uniform vec4 clipRect;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	vec4 color = texture(sampler, uv);
+	FragColor = vec4(color.rgb, color.a * opacity);
+}
+)";
+#endif
+// 过度绘制热度顶点着色器，按gl_VertexID生成一个盖住整个屏幕的三角形
+const char* OverdrawVS =
+#ifdef USE_OPENGL_ES
+R"(#version 300 es
+precision highp float;
+void main()
+{
+	vec2 pos = vec2(float((gl_VertexID & 1) << 2) - 1.0, float((gl_VertexID & 2) << 1) - 1.0);
+	gl_Position = vec4(pos, 0.0, 1.0);
+}
+)";
+#else
+R"(#version 460 core
+void main()
+{
+	vec2 pos = vec2(float((gl_VertexID & 1) << 2) - 1.0, float((gl_VertexID & 2) << 1) - 1.0);
+	gl_Position = vec4(pos, 0.0, 1.0);
+}
+)";
+#endif
+// 过度绘制热度片元着色器
+const char* OverdrawFS =
+#ifdef USE_OPENGL_ES
+R"(#version 300 es
+precision highp float;
+out vec4 FragColor;
+uniform vec4 heatColor;
+void main()
+{
+	FragColor = heatColor;
+}
+)";
+#else
+R"(#version 460 core
+out vec4 FragColor;
+uniform vec4 heatColor;
+void main()
+{
+	FragColor = heatColor;
+}
+)";
+#endif
+
+#ifndef USE_OPENGL_ES
+// 合批颜色顶点着色器，平移和剪裁矩形从SSBO按gl_DrawID读取
+const char* ColorBatchVS =
+R"(#version 460 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+out vec4 color;
+out vec2 clipPos;
+flat out vec4 clipRect;
+struct DrawData
+{
+	vec4 translation;
+	vec4 color;
+	vec4 clipRect;
+};
+layout (std430, binding = 0) readonly buffer DrawDataBuffer
+{
+	DrawData drawData[];
+};
+uniform int drawBase;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+void main()
+{
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	DrawData data = drawData[drawBase + gl_DrawID];
+	transformPosition.xyz += data.translation.xyz;
+	gl_Position = projectionMatrix * viewMatrix * transformPosition;
+	color = aColor;
+	clipPos = transformPosition.xy;
+	clipRect = data.clipRect;
+}
+)";
+
+// 合批文字顶点着色器，平移、文字颜色、透明度和剪裁矩形从SSBO按gl_DrawID读取
+const char* TextBatchVS =
+R"(#version 460 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aUV;
+layout (location = 2) in float aLayer;
+out vec2 uv;
+out float layer;
+flat out vec4 textColor;
+out vec2 clipPos;
+flat out vec4 clipRect;
+struct DrawData
+{
+	vec4 translation;
+	vec4 color;
+	vec4 clipRect;
+};
+layout (std430, binding = 0) readonly buffer DrawDataBuffer
+{
+	DrawData drawData[];
+};
+uniform int drawBase;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+void main()
+{
+	DrawData data = drawData[drawBase + gl_DrawID];
+	// 顶点位置是定点数，POSITION_SCALE在加载时按几何体的定点小数位数注入
+	vec4 transformPosition = vec4(aPos * POSITION_SCALE, 0.0, 1.0);
+	transformPosition.xyz += data.translation.xyz;
+	gl_Position = projectionMatrix * viewMatrix * transformPosition;
+	uv = aUV;
+	layer = aLayer;
+	textColor = data.color;
+	clipPos = transformPosition.xy;
+	clipRect = data.clipRect;
+}
+)";
+
+// 合批带剪裁的颜色片元着色器，剪裁矩形从顶点着色器传入
+const char* ColorClipBatchFS =
+R"(#version 460 core
+in vec4 color;
+in vec2 clipPos;
+flat in vec4 clipRect;
+out vec4 FragColor;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	FragColor = color;
+}
+)";
+
+// 合批文字片元着色器
+const char* TextBatchFS =
+R"(#version 460 core
+in vec2 uv;
+in float layer;
+flat in vec4 textColor;
+in vec2 clipPos;
+flat in vec4 clipRect;
+out vec4 FragColor;
+uniform sampler2DArray sampler;
+void main()
+{
+	// 剪裁矩形之外的片元丢弃
+	if (any(lessThan(clipPos, clipRect.xy)) || any(greaterThanEqual(clipPos, clipRect.zw)))
+	{
+		discard;
+	}
+	float mask = texture(sampler, vec3(uv, layer)).r;
+	if (mask < 0.1) 
+	{
+		// 丢弃纯色背景
+		discard;
+	}
+	float opacity = textColor.a;
+	vec3 finalRGB = textColor.rgb * opacity * mask;
+	FragColor = vec4(finalRGB, opacity * mask);
+}
+)";
+#endif
@@ -1,9 +1,10 @@
 #include "Texture.h"
+#include "ImageDecoder.h"
 
 #define STB_IMAGE_IMPLEMENTATION 1
 #include <stb/stb_image.h>
 
-#include <format>
+#include <string>
 
 namespace sz_gui
 {
@@ -59,16 +60,15 @@ namespace sz_gui
 		{
 			std::string errMsg = "success";
 
-			int channels;
-			// 反转y轴
-			stbi_set_flip_vertically_on_load(true);
-			unsigned char* data = stbi_load(path.c_str(), &m_width, &m_height, &channels, STBI_rgb_alpha);
-			if (!data)
+			// 反转y轴，不改stb_image的全局开关，避免影响解码线程
+			DecodedImage image;
+			if (!ImageDecoder::Decode(path, true, image))
 			{
-				errMsg = std::format("stbi_load error,{},{}", stbi_failure_reason(), path);
+				errMsg = std::string("stbi_load error,") + stbi_failure_reason() + "," + path;
 				return { std::move(errMsg), false };
 			}
-			(void)channels;
+			m_width = image.m_width;
+			m_height = image.m_height;
 
 			// 创建纹理对象
 			GL_CALL(glGenTextures(1, &m_texture));
@@ -79,14 +79,11 @@ namespace sz_gui
 			// 纹理对象m_texture就被对应到了纹理单元GL_TEXTURE0+m_unit
 			// 开辟显存，并上传数据
 			GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 
-				m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+				m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.m_pixels.data()));
 
 			// 自动生成mipmap
 			GL_CALL(glGenerateMipmap(m_textureTarget));
 
-			// 释放数据
-			stbi_image_free(data);
-
 			// 设置纹理的过滤方式
 			// 采样(Sampling)：动作。是从纹理或场景中读取一个或多个点的数据的过程。
 			// 过滤(Filtering)：方法/处理。是根据采样的点和预设的算法（如平均、插值）来计算出一个最终颜色的过程。
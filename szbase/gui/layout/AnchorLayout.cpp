@@ -12,8 +12,7 @@ namespace sz_gui
         {
             sz_ds::Rect result{};
 
-            const Margins pixelMargins = calculateActualMargins(item.margins, m_parentRect.m_width, 
-                m_parentRect.m_height);
+            const Margins pixelMargins = item.margins.ToPixels(m_parentRect.m_width, m_parentRect.m_height);
 
             // 计算父容器在减去边距后，为控件留下的可用空间
             const float availableWidth = std::max(0.0f, 
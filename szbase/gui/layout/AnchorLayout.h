@@ -7,7 +7,9 @@
 
 #include <memory>
 #include <list>
+#include <vector>
 #include <unordered_map>
+#include <algorithm>
 #include <cstdint>
 
 namespace sz_gui 
@@ -25,6 +27,8 @@ namespace sz_gui
             Margins margins;
             // 计算后的实际位置和大小
             sz_ds::Rect calculatedRect;
+            // 约束发生变化，需要重新计算
+            bool m_dirty = false;
         };
 
         // 锚点布局
@@ -37,12 +41,21 @@ namespace sz_gui
             std::list<AnchorLayoutItem> m_items;
             // 记录需要布局的控件
             std::unordered_map<uint64_t, std::list<AnchorLayoutItem>::iterator> m_records;
+            // 约束发生变化的控件
+            std::vector<std::list<AnchorLayoutItem>::iterator> m_dirtyItems;
+            // 父容器矩形发生变化，所有控件需要重新计算
+            bool m_parentDirty = true;
 
         public:
             // 设置父容器边界
             void SetParentRect(const sz_ds::Rect& rect) override
             {
+                if (m_parentRect == rect)
+                {
+                    return;
+                }
                 m_parentRect = rect;
+                m_parentDirty = true;
             }
             // 添加需要布局的控件
             bool AddWidget(std::shared_ptr<IUIBase> widget) override
@@ -60,6 +73,7 @@ namespace sz_gui
                 m_items.emplace_back(widget, widget->GetAnchorPoint(), widget->GetMargins(), sz_ds::Rect());
                 auto it = std::prev(m_items.end());
                 m_records.emplace(widget->GetChildIdForUIManager(), it);
+                markDirty(it);
                 return true;
             }
             // 删除布局控件
@@ -75,32 +89,78 @@ namespace sz_gui
                     return false;
                 }
 
-                m_items.erase(m_records[widget->GetChildIdForUIManager()]);
+                auto it = m_records[widget->GetChildIdForUIManager()];
+                if (it->m_dirty)
+                {
+                    m_dirtyItems.erase(std::find(m_dirtyItems.begin(), m_dirtyItems.end(), it));
+                }
+                m_items.erase(it);
                 m_records.erase(widget->GetChildIdForUIManager());
                 return true;
             }
-            // 执行布局计算
+            // 控件布局约束发生变化，下次布局时重新计算
+            void InvalidateWidget(IUIBase* widget) override
+            {
+                if (!widget)
+                {
+                    return;
+                }
+
+                auto record = m_records.find(widget->GetChildIdForUIManager());
+                if (record == m_records.end())
+                {
+                    return;
+                }
+                markDirty(record->second);
+            }
+            // 是否需要重新布局
+            bool IsDirty() const override
+            {
+                return m_parentDirty || !m_dirtyItems.empty();
+            }
+            // 执行布局计算，只计算父容器区域或约束发生变化的控件
             void PerformLayout() override
             {
-                for (auto& item : m_items)
+                if (m_parentDirty)
+                {
+                    for (auto& item : m_items)
+                    {
+                        updateItem(item);
+                    }
+                }
+                else
                 {
-                    item.calculatedRect = calculateItemRect(item);
-                    item.m_widget->SetRect(item.calculatedRect);
+                    for (auto& it : m_dirtyItems)
+                    {
+                        updateItem(*it);
+                    }
                 }
+                m_dirtyItems.clear();
+                m_parentDirty = false;
             }
 
         private:
-            // 计算实际边距值
-            Margins calculateActualMargins(const Margins& margins, float parentWidth, float parentHeight) const
+            // 标记控件约束发生变化
+            void markDirty(std::list<AnchorLayoutItem>::iterator it)
             {
-                Margins actual;
-
-                actual.m_left = margins.m_isPercentage[0] ? (margins.m_left * 0.01f * parentWidth) : margins.m_left;
-                actual.m_top = margins.m_isPercentage[1] ? (margins.m_top * 0.01f * parentHeight) : margins.m_top;
-                actual.m_right = margins.m_isPercentage[2] ? (margins.m_right * 0.01f * parentWidth) : margins.m_right;
-                actual.m_bottom = margins.m_isPercentage[3] ? (margins.m_bottom * 0.01f * parentHeight) : margins.m_bottom;
-
-                return actual;
+                if (it->m_dirty)
+                {
+                    return;
+                }
+                it->m_dirty = true;
+                m_dirtyItems.push_back(it);
+            }
+            // 重新计算控件矩形，矩形不变时控件不会有任何更新
+            void updateItem(AnchorLayoutItem& item)
+            {
+                if (item.m_dirty)
+                {
+                    item.anchor = item.m_widget->GetAnchorPoint();
+                    item.margins = item.m_widget->GetMargins();
+                    item.m_dirty = false;
+                }
+                item.calculatedRect = calculateItemRect(item);
+                item.m_widget->SetRect(item.calculatedRect);
             }
             // 计算控件矩形
             sz_ds::Rect calculateItemRect(const AnchorLayoutItem& item) const;
@@ -0,0 +1,215 @@
+#include "ConstraintLayout.h"
+
+#include <algorithm>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        using namespace sz_ds::solver;
+
+        ConstraintLayout::ConstraintLayout()
+        {
+            m_parent.m_left = m_solver.NewVariable();
+            m_parent.m_top = m_solver.NewVariable();
+            m_parent.m_width = m_solver.NewVariable();
+            m_parent.m_height = m_solver.NewVariable();
+            m_solver.AddEditVariable(m_parent.m_left, Strength::Strong);
+            m_solver.AddEditVariable(m_parent.m_top, Strength::Strong);
+            m_solver.AddEditVariable(m_parent.m_width, Strength::Strong);
+            m_solver.AddEditVariable(m_parent.m_height, Strength::Strong);
+        }
+
+        void ConstraintLayout::SetParentRect(const sz_ds::Rect& rect)
+        {
+            if (m_parentRect == rect)
+            {
+                return;
+            }
+            m_parentRect = rect;
+
+            // 窗口缩放和拖动分割条都只改建议值，从上次的解继续求解
+            m_solver.SuggestValue(m_parent.m_left, rect.m_x);
+            m_solver.SuggestValue(m_parent.m_top, rect.m_y);
+            m_solver.SuggestValue(m_parent.m_width, rect.m_width);
+            m_solver.SuggestValue(m_parent.m_height, rect.m_height);
+            m_dirty = true;
+        }
+
+        bool ConstraintLayout::AddWidget(std::shared_ptr<IUIBase> widget)
+        {
+            if (!widget || widget->GetChildIdForUIManager() == 0)
+            {
+                return false;
+            }
+
+            if (m_records.find(widget->GetChildIdForUIManager()) != m_records.end())
+            {
+                return false;
+            }
+
+            ConstraintAnchors anchors;
+            anchors.m_left = m_solver.NewVariable();
+            anchors.m_top = m_solver.NewVariable();
+            anchors.m_width = m_solver.NewVariable();
+            anchors.m_height = m_solver.NewVariable();
+
+            m_items.emplace_back(widget, anchors);
+            auto it = std::prev(m_items.end());
+            m_records.emplace(widget->GetChildIdForUIManager(), it);
+            for (auto variable : { anchors.m_left, anchors.m_top, anchors.m_width, anchors.m_height })
+            {
+                m_variableOwners.emplace(variable.m_id, it);
+            }
+
+            addItemConstraint(Expression(anchors.m_width) >= 0.0);
+            addItemConstraint(Expression(anchors.m_height) >= 0.0);
+            addItemConstraint((Expression(anchors.m_left) == m_parent.m_left) | Strength::Weak);
+            addItemConstraint((Expression(anchors.m_top) == m_parent.m_top) | Strength::Weak);
+
+            auto [desireWidth, desireHeight] = widget->GetDisireWH();
+            suggestDesire(anchors.m_width, desireWidth);
+            suggestDesire(anchors.m_height, desireHeight);
+            m_dirty = true;
+            return true;
+        }
+
+        bool ConstraintLayout::DelWidget(std::shared_ptr<IUIBase> widget)
+        {
+            if (!widget || widget->GetChildIdForUIManager() == 0)
+            {
+                return false;
+            }
+
+            auto record = m_records.find(widget->GetChildIdForUIManager());
+            if (record == m_records.end())
+            {
+                return false;
+            }
+
+            // 约束可能已经随其他控件删除
+            auto it = record->second;
+            for (auto id : it->m_constraints)
+            {
+                m_solver.RemoveConstraint(id);
+            }
+            const auto& anchors = it->m_anchors;
+            m_solver.RemoveEditVariable(anchors.m_width);
+            m_solver.RemoveEditVariable(anchors.m_height);
+            for (auto variable : { anchors.m_left, anchors.m_top, anchors.m_width, anchors.m_height })
+            {
+                m_variableOwners.erase(variable.m_id);
+            }
+
+            m_items.erase(it);
+            m_records.erase(record);
+            m_dirty = true;
+            return true;
+        }
+
+        void ConstraintLayout::InvalidateWidget(IUIBase* widget)
+        {
+            if (!widget)
+            {
+                return;
+            }
+
+            auto record = m_records.find(widget->GetChildIdForUIManager());
+            if (record == m_records.end())
+            {
+                return;
+            }
+
+            auto [desireWidth, desireHeight] = widget->GetDisireWH();
+            suggestDesire(record->second->m_anchors.m_width, desireWidth);
+            suggestDesire(record->second->m_anchors.m_height, desireHeight);
+            m_dirty = true;
+        }
+
+        void ConstraintLayout::PerformLayout()
+        {
+            m_dirty = false;
+            m_solver.UpdateVariables();
+            for (auto& item : m_items)
+            {
+                const auto& anchors = item.m_anchors;
+                sz_ds::Rect rect;
+                rect.m_x = (float)m_solver.GetValue(anchors.m_left);
+                rect.m_y = (float)m_solver.GetValue(anchors.m_top);
+                rect.m_width = std::max(0.0f, (float)m_solver.GetValue(anchors.m_width));
+                rect.m_height = std::max(0.0f, (float)m_solver.GetValue(anchors.m_height));
+                item.m_widget->SetRect(rect);
+            }
+        }
+
+        const ConstraintAnchors* ConstraintLayout::GetAnchors(const std::shared_ptr<IUIBase>& widget) const
+        {
+            if (!widget)
+            {
+                return nullptr;
+            }
+
+            auto record = m_records.find(widget->GetChildIdForUIManager());
+            if (record == m_records.end())
+            {
+                return nullptr;
+            }
+            return &record->second->m_anchors;
+        }
+
+        ConstraintId ConstraintLayout::AddConstraint(const Constraint& constraint)
+        {
+            return addItemConstraint(constraint);
+        }
+
+        bool ConstraintLayout::RemoveConstraint(ConstraintId id)
+        {
+            if (!m_solver.RemoveConstraint(id))
+            {
+                return false;
+            }
+            m_dirty = true;
+            return true;
+        }
+
+        ConstraintId ConstraintLayout::addItemConstraint(const Constraint& constraint)
+        {
+            const ConstraintId id = m_solver.AddConstraint(constraint);
+            if (id == 0)
+            {
+                return 0;
+            }
+
+            for (const auto& term : constraint.m_expression.m_terms)
+            {
+                auto owner = m_variableOwners.find(term.m_variable.m_id);
+                if (owner == m_variableOwners.end())
+                {
+                    continue;
+                }
+                auto& constraints = owner->second->m_constraints;
+                if (constraints.empty() || constraints.back() != id)
+                {
+                    constraints.push_back(id);
+                }
+            }
+            m_dirty = true;
+            return id;
+        }
+
+        void ConstraintLayout::suggestDesire(Variable variable, float desire)
+        {
+            if (desire <= 0.0f)
+            {
+                m_solver.RemoveEditVariable(variable);
+                return;
+            }
+
+            if (!m_solver.HasEditVariable(variable))
+            {
+                m_solver.AddEditVariable(variable, Strength::Medium);
+            }
+            m_solver.SuggestValue(variable, desire);
+        }
+	}
+}
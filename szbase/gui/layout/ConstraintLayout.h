@@ -0,0 +1,110 @@
+// comment: 约束布局，控件边界用线性约束描述，父容器边界和期望尺寸作为编辑变量增量求解
+
+#pragma once
+
+#include "../IUIBase.h"
+#include "../ILayout.h"
+#include "../../ds/ConstraintSolver.h"
+
+#include <memory>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        // 控件边界变量，坐标和父容器相同，都是窗口坐标
+        struct ConstraintAnchors
+        {
+            sz_ds::solver::Variable m_left;
+            sz_ds::solver::Variable m_top;
+            sz_ds::solver::Variable m_width;
+            sz_ds::solver::Variable m_height;
+
+            // 右边缘
+            sz_ds::solver::Expression Right() const { return sz_ds::solver::Expression(m_left) + m_width; }
+            // 下边缘
+            sz_ds::solver::Expression Bottom() const { return sz_ds::solver::Expression(m_top) + m_height; }
+            // 水平中心
+            sz_ds::solver::Expression CenterX() const { return sz_ds::solver::Expression(m_left) + m_width * 0.5; }
+            // 垂直中心
+            sz_ds::solver::Expression CenterY() const { return sz_ds::solver::Expression(m_top) + m_height * 0.5; }
+        };
+
+        // 约束布局项
+        struct ConstraintLayoutItem
+        {
+            // 控件
+            std::shared_ptr<IUIBase> m_widget;
+            // 边界变量
+            ConstraintAnchors m_anchors;
+            // 引用了该控件变量的约束，删除控件时一起删除
+            std::vector<sz_ds::solver::ConstraintId> m_constraints;
+        };
+
+        // 约束布局
+        // 控件默认弱约束在父容器左上角，期望尺寸非0时以中等强度保持期望尺寸，
+        // 控件自身的锚点和边距不参与，间距由约束表达
+        class ConstraintLayout final : public ILayout
+        {
+        private:
+            using ItemIterator = std::list<ConstraintLayoutItem>::iterator;
+
+        private:
+            // 父容器矩形
+            sz_ds::Rect m_parentRect;
+            // 求解器
+            sz_ds::solver::Solver m_solver;
+            // 父容器边界变量，都是编辑变量
+            ConstraintAnchors m_parent;
+            // 需要布局的控件
+            std::list<ConstraintLayoutItem> m_items;
+            // 记录需要布局的控件
+            std::unordered_map<uint64_t, ItemIterator> m_records;
+            // 变量所属控件
+            std::unordered_map<uint32_t, ItemIterator> m_variableOwners;
+            // 需要重新布局
+            bool m_dirty = true;
+
+        public:
+            ConstraintLayout();
+
+        public:
+            // 设置父容器边界，只修改编辑变量的建议值
+            void SetParentRect(const sz_ds::Rect& rect) override;
+            // 添加需要布局的控件
+            bool AddWidget(std::shared_ptr<IUIBase> widget) override;
+            // 删除布局控件和引用它的约束
+            bool DelWidget(std::shared_ptr<IUIBase> widget) override;
+            // 控件期望尺寸发生变化，修改编辑变量的建议值
+            void InvalidateWidget(IUIBase* widget) override;
+            // 是否需要重新布局
+            bool IsDirty() const override { return m_dirty; }
+            // 执行布局计算
+            void PerformLayout() override;
+
+        public:
+            // 获取父容器边界变量
+            const ConstraintAnchors& GetParent() const { return m_parent; }
+            // 获取控件边界变量，控件不在布局中返回nullptr
+            const ConstraintAnchors* GetAnchors(const std::shared_ptr<IUIBase>& widget) const;
+            // 添加约束，必须约束无法满足时返回0
+            sz_ds::solver::ConstraintId AddConstraint(const sz_ds::solver::Constraint& constraint);
+            // 删除约束
+            bool RemoveConstraint(sz_ds::solver::ConstraintId id);
+            // 获取约束个数
+            size_t GetConstraintCount() const { return m_solver.GetConstraintCount(); }
+            // 获取累计主元变换次数
+            uint64_t GetPivotCount() const { return m_solver.GetPivotCount(); }
+
+        private:
+            // 添加约束并记录到引用的控件
+            sz_ds::solver::ConstraintId addItemConstraint(const sz_ds::solver::Constraint& constraint);
+            // 更新尺寸变量的期望值，0表示不期望
+            void suggestDesire(sz_ds::solver::Variable variable, float desire);
+        };
+	}
+}
@@ -0,0 +1,422 @@
+#include "GridLayout.h"
+
+#include <algorithm>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        GridLayout::GridLayout(std::vector<GridTrack> columns, std::vector<GridTrack> rows, float spacing)
+            : m_spacing(spacing)
+        {
+            m_columns.m_tracks = std::move(columns);
+            m_rows.m_tracks = std::move(rows);
+            m_columns.m_offsets.assign(m_columns.m_tracks.size() + 1, 0.0f);
+            m_rows.m_offsets.assign(m_rows.m_tracks.size() + 1, 0.0f);
+            m_rowItems.resize(m_rows.m_tracks.size());
+            updateHasAuto(m_columns);
+            updateHasAuto(m_rows);
+        }
+
+        void GridLayout::SetParentRect(const sz_ds::Rect& rect)
+        {
+            if (m_parentRect == rect)
+            {
+                return;
+            }
+
+            // 只移动位置时轨道尺寸不变，百分比边距按父容器尺寸换算，自适应尺寸也要重新统计
+            if (!sz_ds::float_equal(m_parentRect.m_width, rect.m_width))
+            {
+                m_columns.m_dirty = true;
+                m_columns.m_autoDirty = m_columns.m_autoDirty || m_columns.m_hasAuto;
+            }
+            if (!sz_ds::float_equal(m_parentRect.m_height, rect.m_height))
+            {
+                m_rows.m_dirty = true;
+                m_rows.m_autoDirty = m_rows.m_autoDirty || m_rows.m_hasAuto;
+            }
+            m_parentRect = rect;
+            m_dirty = true;
+        }
+
+        bool GridLayout::AddWidget(std::shared_ptr<IUIBase> widget)
+        {
+            const auto colCount = (uint32_t)m_columns.m_tracks.size();
+            if (colCount == 0)
+            {
+                return false;
+            }
+
+            const uint32_t cell = m_nextAutoCell;
+            if (!AddWidget(widget, cell / colCount, cell % colCount))
+            {
+                return false;
+            }
+            ++m_nextAutoCell;
+            return true;
+        }
+
+        bool GridLayout::AddWidget(std::shared_ptr<IUIBase> widget, uint32_t row, uint32_t col,
+            uint32_t rowSpan, uint32_t colSpan)
+        {
+            if (!widget || widget->GetChildIdForUIManager() == 0)
+            {
+                return false;
+            }
+
+            if (rowSpan == 0 || colSpan == 0 || col + colSpan > m_columns.m_tracks.size())
+            {
+                return false;
+            }
+
+            if (m_records.find(widget->GetChildIdForUIManager()) != m_records.end())
+            {
+                return false;
+            }
+
+            ensureRowCount(row + rowSpan);
+
+            m_items.emplace_back(widget, row, col, rowSpan, colSpan);
+            auto it = std::prev(m_items.end());
+            m_records.emplace(widget->GetChildIdForUIManager(), it);
+            m_rowItems[row].push_back(it);
+            m_maxRowSpan = std::max(m_maxRowSpan, rowSpan);
+            markAutoDirty(*it);
+
+            // 摆放前不显示
+            widget->SetUIFlag(UIFlag::Culled);
+            m_dirty = true;
+            return true;
+        }
+
+        bool GridLayout::DelWidget(std::shared_ptr<IUIBase> widget)
+        {
+            if (!widget || widget->GetChildIdForUIManager() == 0)
+            {
+                return false;
+            }
+
+            auto record = m_records.find(widget->GetChildIdForUIManager());
+            if (record == m_records.end())
+            {
+                return false;
+            }
+
+            auto it = record->second;
+            auto& bucket = m_rowItems[it->m_row];
+            bucket.erase(std::find(bucket.begin(), bucket.end(), it));
+            auto arranged = std::find(m_arrangedItems.begin(), m_arrangedItems.end(), it);
+            if (arranged != m_arrangedItems.end())
+            {
+                m_arrangedItems.erase(arranged);
+            }
+            markAutoDirty(*it);
+            widget->ClearUIFlag(UIFlag::Culled);
+
+            m_items.erase(it);
+            m_records.erase(record);
+            m_dirty = true;
+            return true;
+        }
+
+        void GridLayout::InvalidateWidget(IUIBase* widget)
+        {
+            if (!widget)
+            {
+                return;
+            }
+
+            auto record = m_records.find(widget->GetChildIdForUIManager());
+            if (record == m_records.end())
+            {
+                return;
+            }
+            markAutoDirty(*record->second);
+            m_dirty = true;
+        }
+
+        void GridLayout::SetVisibleRect(const sz_ds::Rect& rect)
+        {
+            if (m_hasVisibleRect && m_visibleRect == rect)
+            {
+                return;
+            }
+            m_visibleRect = rect;
+            m_hasVisibleRect = true;
+            m_dirty = true;
+        }
+
+        void GridLayout::SetColumn(uint32_t index, GridTrack track)
+        {
+            if (index >= m_columns.m_tracks.size())
+            {
+                return;
+            }
+
+            auto& old = m_columns.m_tracks[index];
+            if (old.m_type == TrackType::Auto || track.m_type == TrackType::Auto)
+            {
+                m_columns.m_autoDirty = true;
+            }
+            old = track;
+            updateHasAuto(m_columns);
+            m_columns.m_dirty = true;
+            m_dirty = true;
+        }
+
+        void GridLayout::SetRow(uint32_t index, GridTrack track)
+        {
+            if (index >= m_rows.m_tracks.size())
+            {
+                return;
+            }
+
+            auto& old = m_rows.m_tracks[index];
+            if (old.m_type == TrackType::Auto || track.m_type == TrackType::Auto)
+            {
+                m_rows.m_autoDirty = true;
+            }
+            old = track;
+            updateHasAuto(m_rows);
+            m_rows.m_dirty = true;
+            m_dirty = true;
+        }
+
+        void GridLayout::PerformLayout()
+        {
+            m_dirty = false;
+            ++m_pass;
+
+            // 轨道偏移只在轨道定义、内容尺寸或父容器尺寸变化时重新计算
+            updateAutoSizes(m_columns, true);
+            updateAutoSizes(m_rows, false);
+            if (m_columns.m_dirty)
+            {
+                updateOffsets(m_columns, m_parentRect.m_width);
+            }
+            if (m_rows.m_dirty)
+            {
+                updateOffsets(m_rows, m_parentRect.m_height);
+            }
+
+            // 可见区域转换到父容器局部坐标，内容可以超出父容器由滚动决定可见区域
+            sz_ds::AABB2D visible = m_hasVisibleRect ? m_visibleRect.ToAABB2D() : m_parentRect.ToAABB2D();
+
+            std::vector<ItemIterator> arranged;
+            arranged.reserve(m_arrangedItems.size());
+            const auto rowCount = (uint32_t)m_rows.m_tracks.size();
+            const auto colCount = (uint32_t)m_columns.m_tracks.size();
+            if (!visible.IsNull() && rowCount > 0 && colCount > 0)
+            {
+                const auto visibleRect = visible.GetRect();
+                const float left = visibleRect.m_x - m_parentRect.m_x;
+                const float right = left + visibleRect.m_width;
+                const float top = visibleRect.m_y - m_parentRect.m_y;
+                const float bottom = top + visibleRect.m_height;
+
+                // 二分查找可见行范围，向前扩展以包含跨行控件
+                const auto& rowOffsets = m_rows.m_offsets;
+                auto firstIt = std::upper_bound(rowOffsets.begin(), rowOffsets.begin() + rowCount, top);
+                uint32_t firstRow = firstIt == rowOffsets.begin() ? 0 : uint32_t(firstIt - rowOffsets.begin() - 1);
+                firstRow = firstRow >= m_maxRowSpan - 1 ? firstRow - (m_maxRowSpan - 1) : 0;
+                auto lastIt = std::lower_bound(rowOffsets.begin(), rowOffsets.begin() + rowCount, bottom);
+                uint32_t lastRow = uint32_t(lastIt - rowOffsets.begin());
+
+                const auto& colOffsets = m_columns.m_offsets;
+                for (uint32_t row = firstRow; row < lastRow; ++row)
+                {
+                    for (auto& it : m_rowItems[row])
+                    {
+                        float x0 = colOffsets[it->m_col];
+                        float x1 = colOffsets[it->m_col + it->m_colSpan];
+                        float y0 = rowOffsets[it->m_row];
+                        float y1 = rowOffsets[std::min(it->m_row + it->m_rowSpan, rowCount)];
+                        if (x1 <= left || x0 >= right || y1 <= top || y0 >= bottom)
+                        {
+                            continue;
+                        }
+
+                        arrangeItem(*it);
+                        it->m_pass = m_pass;
+                        arranged.push_back(it);
+                    }
+                }
+            }
+
+            // 上次摆放本次不可见的控件剔除
+            for (auto& it : m_arrangedItems)
+            {
+                if (it->m_pass != m_pass)
+                {
+                    cullItem(*it);
+                }
+            }
+            m_arrangedItems.swap(arranged);
+        }
+
+        void GridLayout::ensureRowCount(uint32_t count)
+        {
+            if (m_rows.m_tracks.size() >= count)
+            {
+                return;
+            }
+
+            m_rows.m_tracks.resize(count, m_implicitRow);
+            m_rows.m_offsets.resize(count + 1, 0.0f);
+            m_rowItems.resize(count);
+            if (m_implicitRow.m_type == TrackType::Auto)
+            {
+                m_rows.m_autoDirty = true;
+            }
+            updateHasAuto(m_rows);
+            m_rows.m_dirty = true;
+        }
+
+        void GridLayout::markAutoDirty(const GridLayoutItem& item)
+        {
+            if (item.m_colSpan == 1 && m_columns.m_tracks[item.m_col].m_type == TrackType::Auto)
+            {
+                m_columns.m_autoDirty = true;
+            }
+            if (item.m_rowSpan == 1 && m_rows.m_tracks[item.m_row].m_type == TrackType::Auto)
+            {
+                m_rows.m_autoDirty = true;
+            }
+        }
+
+        void GridLayout::updateAutoSizes(TrackAxis& axis, bool isColumn)
+        {
+            if (!axis.m_autoDirty)
+            {
+                return;
+            }
+            axis.m_autoDirty = false;
+            axis.m_autoSizes.assign(axis.m_tracks.size(), 0.0f);
+            if (!axis.m_hasAuto)
+            {
+                return;
+            }
+
+            // 只统计不跨轨道的控件
+            for (auto& item : m_items)
+            {
+                const uint32_t index = isColumn ? item.m_col : item.m_row;
+                const uint32_t span = isColumn ? item.m_colSpan : item.m_rowSpan;
+                if (span != 1 || axis.m_tracks[index].m_type != TrackType::Auto)
+                {
+                    continue;
+                }
+
+                auto [desireWidth, desireHeight] = item.m_widget->GetDisireWH();
+                auto margins = resolveMargins(item);
+                const float size = isColumn ?
+                    desireWidth + margins.m_left + margins.m_right :
+                    desireHeight + margins.m_top + margins.m_bottom;
+                axis.m_autoSizes[index] = std::max(axis.m_autoSizes[index], size);
+            }
+            axis.m_dirty = true;
+        }
+
+        void GridLayout::updateOffsets(TrackAxis& axis, float available)
+        {
+            axis.m_dirty = false;
+
+            const size_t count = axis.m_tracks.size();
+            axis.m_offsets.resize(count + 1);
+            axis.m_autoSizes.resize(count, 0.0f);
+            if (count == 0)
+            {
+                axis.m_offsets[0] = 0.0f;
+                return;
+            }
+
+            // 固定和自适应轨道先占用，剩余空间按比例分配
+            float used = m_spacing * float(count - 1);
+            float totalFraction = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& track = axis.m_tracks[i];
+                switch (track.m_type)
+                {
+                case TrackType::Fixed:
+                    used += track.m_value;
+                break;
+                case TrackType::Auto:
+                    used += axis.m_autoSizes[i];
+                break;
+                case TrackType::Fraction:
+                    totalFraction += std::max(0.0f, track.m_value);
+                break;
+                }
+            }
+            const float freeSpace = std::max(0.0f, available - used);
+
+            // 前缀和
+            float offset = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& track = axis.m_tracks[i];
+                float size = 0.0f;
+                switch (track.m_type)
+                {
+                case TrackType::Fixed:
+                    size = track.m_value;
+                break;
+                case TrackType::Auto:
+                    size = axis.m_autoSizes[i];
+                break;
+                case TrackType::Fraction:
+                    size = totalFraction > 0.0f ? freeSpace * std::max(0.0f, track.m_value) / totalFraction : 0.0f;
+                break;
+                }
+                axis.m_offsets[i] = offset;
+                offset += size + m_spacing;
+            }
+            axis.m_offsets[count] = offset - m_spacing;
+        }
+
+        void GridLayout::arrangeItem(GridLayoutItem& item)
+        {
+            const auto colCount = (uint32_t)m_columns.m_tracks.size();
+            const auto rowCount = (uint32_t)m_rows.m_tracks.size();
+            const uint32_t colEnd = item.m_col + item.m_colSpan;
+            const uint32_t rowEnd = std::min(item.m_row + item.m_rowSpan, rowCount);
+
+            // 单元格不含尾部间距
+            const float x0 = m_columns.m_offsets[item.m_col];
+            const float x1 = colEnd < colCount ? m_columns.m_offsets[colEnd] - m_spacing : m_columns.m_offsets[colCount];
+            const float y0 = m_rows.m_offsets[item.m_row];
+            const float y1 = rowEnd < rowCount ? m_rows.m_offsets[rowEnd] - m_spacing : m_rows.m_offsets[rowCount];
+            const float cellW = std::max(0.0f, x1 - x0);
+            const float cellH = std::max(0.0f, y1 - y0);
+
+            auto margins = resolveMargins(item);
+            sz_ds::Rect rect;
+            rect.m_x = m_parentRect.m_x + x0 + margins.m_left;
+            rect.m_y = m_parentRect.m_y + y0 + margins.m_top;
+            rect.m_width = std::max(0.0f, cellW - margins.m_left - margins.m_right);
+            rect.m_height = std::max(0.0f, cellH - margins.m_top - margins.m_bottom);
+
+            item.m_widget->SetRect(rect);
+            item.m_widget->ClearUIFlag(UIFlag::Culled);
+        }
+
+        Margins GridLayout::resolveMargins(const GridLayoutItem& item) const
+        {
+            // 按单元格换算时自适应轨道的尺寸依赖边距，边距又依赖轨道尺寸，统计和摆放的结果会不一致
+            return item.m_widget->GetMargins().ToPixels(m_parentRect.m_width, m_parentRect.m_height);
+        }
+
+        void GridLayout::cullItem(GridLayoutItem& item)
+        {
+            item.m_widget->SetUIFlag(UIFlag::Culled);
+        }
+
+        void GridLayout::updateHasAuto(TrackAxis& axis)
+        {
+            axis.m_hasAuto = std::any_of(axis.m_tracks.begin(), axis.m_tracks.end(),
+                [](const GridTrack& track) { return track.m_type == TrackType::Auto; });
+        }
+	}
+}
@@ -0,0 +1,170 @@
+// comment: 网格布局，行列轨道支持固定、比例和自适应尺寸，只摆放与可见区域相交的单元格
+
+#pragma once
+
+#include "../IUIBase.h"
+#include "../ILayout.h"
+
+#include <memory>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        // 轨道尺寸类型
+        enum class TrackType
+        {
+            // 固定像素
+            Fixed,
+            // 按比例分配剩余空间
+            Fraction,
+            // 取轨道内单元格期望尺寸的最大值
+            Auto,
+        };
+
+        // 行或列轨道
+        struct GridTrack
+        {
+            // 尺寸类型
+            TrackType m_type = TrackType::Fixed;
+            // 固定像素或比例权重
+            float m_value = 0.0f;
+
+            // 固定像素轨道
+            static GridTrack Fixed(float pixels) { return { TrackType::Fixed, pixels }; }
+            // 比例轨道
+            static GridTrack Fraction(float weight) { return { TrackType::Fraction, weight }; }
+            // 自适应轨道
+            static GridTrack Auto() { return { TrackType::Auto, 0.0f }; }
+        };
+
+        // 网格布局项
+        struct GridLayoutItem
+        {
+            // 控件
+            std::shared_ptr<IUIBase> m_widget;
+            // 起始行列
+            uint32_t m_row = 0;
+            uint32_t m_col = 0;
+            // 跨越的行列数
+            uint32_t m_rowSpan = 1;
+            uint32_t m_colSpan = 1;
+            // 最后一次摆放的布局轮次
+            uint64_t m_pass = 0;
+        };
+
+        // 网格布局
+        class GridLayout final : public ILayout
+        {
+        private:
+            using ItemIterator = std::list<GridLayoutItem>::iterator;
+
+            // 轨道组，尺寸和偏移前缀和
+            struct TrackAxis
+            {
+                // 轨道定义
+                std::vector<GridTrack> m_tracks;
+                // 自适应轨道的内容尺寸
+                std::vector<float> m_autoSizes;
+                // 偏移前缀和，m_offsets[i]为第i条轨道起点，大小为轨道数+1
+                std::vector<float> m_offsets;
+                // 轨道定义或可用尺寸变化，需要重新计算偏移
+                bool m_dirty = true;
+                // 自适应轨道的内容变化，需要重新统计
+                bool m_autoDirty = true;
+                // 是否包含自适应轨道
+                bool m_hasAuto = false;
+            };
+
+        private:
+            // 父容器矩形
+            sz_ds::Rect m_parentRect;
+            // 可见区域，未设置时使用父容器矩形
+            sz_ds::Rect m_visibleRect;
+            bool m_hasVisibleRect = false;
+            // 需要布局的控件
+            std::list<GridLayoutItem> m_items;
+            // 记录需要布局的控件
+            std::unordered_map<uint64_t, ItemIterator> m_records;
+            // 按起始行分桶的控件
+            std::vector<std::vector<ItemIterator>> m_rowItems;
+            // 列和行
+            TrackAxis m_columns;
+            TrackAxis m_rows;
+            // 自动放置时超出行数追加的行轨道
+            GridTrack m_implicitRow = GridTrack::Auto();
+            // 轨道间距
+            float m_spacing = 0.0f;
+            // 自动放置的下一个单元格
+            uint32_t m_nextAutoCell = 0;
+            // 跨越行数的最大值，可见行向前扩展这么多行查找跨行控件
+            uint32_t m_maxRowSpan = 1;
+            // 上次摆放的控件
+            std::vector<ItemIterator> m_arrangedItems;
+            // 布局轮次
+            uint64_t m_pass = 0;
+            // 需要重新布局
+            bool m_dirty = true;
+
+        public:
+            GridLayout(std::vector<GridTrack> columns, std::vector<GridTrack> rows, float spacing = 0.0f);
+
+        public:
+            // 设置父容器边界
+            void SetParentRect(const sz_ds::Rect& rect) override;
+            // 按行优先顺序自动放置控件
+            bool AddWidget(std::shared_ptr<IUIBase> widget) override;
+            // 放置控件到指定单元格
+            bool AddWidget(std::shared_ptr<IUIBase> widget, uint32_t row, uint32_t col,
+                uint32_t rowSpan = 1, uint32_t colSpan = 1);
+            // 删除布局控件
+            bool DelWidget(std::shared_ptr<IUIBase> widget) override;
+            // 控件布局约束发生变化，在自适应轨道中时重新统计轨道尺寸
+            void InvalidateWidget(IUIBase* widget) override;
+            // 是否需要重新布局
+            bool IsDirty() const override { return m_dirty; }
+            // 执行布局计算，只摆放与可见区域相交的控件
+            void PerformLayout() override;
+
+        public:
+            // 设置可见区域，滚动时只需重新摆放可见控件
+            void SetVisibleRect(const sz_ds::Rect& rect);
+            // 设置列轨道，只重新计算列偏移
+            void SetColumn(uint32_t index, GridTrack track);
+            // 设置行轨道，只重新计算行偏移
+            void SetRow(uint32_t index, GridTrack track);
+            // 设置自动放置超出行数时追加的行轨道
+            void SetImplicitRow(GridTrack track) { m_implicitRow = track; }
+            // 获取列数和行数
+            size_t GetColumnCount() const { return m_columns.m_tracks.size(); }
+            size_t GetRowCount() const { return m_rows.m_tracks.size(); }
+            // 获取列和行相对父容器的起点，index等于轨道数时为总长度
+            float GetColumnOffset(uint32_t index) const { return m_columns.m_offsets[index]; }
+            float GetRowOffset(uint32_t index) const { return m_rows.m_offsets[index]; }
+            // 获取上次摆放的控件个数
+            size_t GetArrangedCount() const { return m_arrangedItems.size(); }
+
+        private:
+            // 追加行轨道到指定行数
+            void ensureRowCount(uint32_t count);
+            // 标记控件所在轨道的自适应尺寸需要重新统计
+            void markAutoDirty(const GridLayoutItem& item);
+            // 统计自适应轨道的内容尺寸
+            void updateAutoSizes(TrackAxis& axis, bool isColumn);
+            // 计算轨道尺寸和偏移前缀和
+            void updateOffsets(TrackAxis& axis, float available);
+            // 摆放控件
+            void arrangeItem(GridLayoutItem& item);
+            // 百分比边距统一按父容器尺寸换算，自适应统计和摆放使用同一个基准
+            Margins resolveMargins(const GridLayoutItem& item) const;
+            // 剔除不可见控件
+            void cullItem(GridLayoutItem& item);
+            // 重新统计是否包含自适应轨道
+            void updateHasAuto(TrackAxis& axis);
+        };
+	}
+}
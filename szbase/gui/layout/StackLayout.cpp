@@ -0,0 +1,145 @@
+#include "StackLayout.h"
+
+#include <algorithm>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        const MeasureCache& StackLayout::measureItem(StackLayoutItem& item, float availableW, float availableH)
+        {
+            auto& cache = item.m_measure;
+            if (cache.m_valid)
+            {
+                if (cache.m_availableW == availableW && cache.m_availableH == availableH)
+                {
+                    return cache;
+                }
+                // 固定尺寸且像素边距的控件，只要可用尺寸还放得下，结果不变
+                const auto& margins = cache.m_pixelMargins;
+                if (cache.m_fixedSize &&
+                    availableW >= cache.m_width + margins.m_left + margins.m_right &&
+                    availableH >= cache.m_height + margins.m_top + margins.m_bottom)
+                {
+                    return cache;
+                }
+            }
+
+            ++m_measureCount;
+            cache.m_availableW = availableW;
+            cache.m_availableH = availableH;
+            const auto widgetMargins = item.m_widget->GetMargins();
+            cache.m_pixelMargins = widgetMargins.ToPixels(availableW, availableH);
+
+            const auto& margins = cache.m_pixelMargins;
+            const float innerW = std::max(0.0f, availableW - margins.m_left - margins.m_right);
+            const float innerH = std::max(0.0f, availableH - margins.m_top - margins.m_bottom);
+
+            // 期望尺寸为0时，主轴不占空间只靠伸展，交叉轴铺满
+            auto [desireWidth, desireHeight] = item.m_widget->GetDisireWH();
+            const bool horizontal = m_direction == StackDirection::Horizontal;
+            if (desireWidth > 0.0f)
+            {
+                cache.m_width = std::min(desireWidth, innerW);
+            }
+            else
+            {
+                cache.m_width = horizontal ? 0.0f : innerW;
+            }
+            if (desireHeight > 0.0f)
+            {
+                cache.m_height = std::min(desireHeight, innerH);
+            }
+            else
+            {
+                cache.m_height = horizontal ? innerH : 0.0f;
+            }
+
+            const bool percentage = widgetMargins.m_isPercentage[0] || widgetMargins.m_isPercentage[1] ||
+                widgetMargins.m_isPercentage[2] || widgetMargins.m_isPercentage[3];
+            cache.m_fixedSize = !percentage &&
+                desireWidth > 0.0f && desireWidth <= innerW &&
+                desireHeight > 0.0f && desireHeight <= innerH;
+            cache.m_valid = true;
+            return cache;
+        }
+
+        void StackLayout::PerformLayout()
+        {
+            m_dirty = false;
+            if (m_items.empty())
+            {
+                return;
+            }
+
+            const bool horizontal = m_direction == StackDirection::Horizontal;
+            const float availableMain = horizontal ? m_parentRect.m_width : m_parentRect.m_height;
+            const float availableCross = horizontal ? m_parentRect.m_height : m_parentRect.m_width;
+
+            // 测量，统计主轴固定占用和伸展权重
+            float usedMain = m_spacing * float(m_items.size() - 1);
+            float totalGrow = 0.0f;
+            for (auto& item : m_items)
+            {
+                const auto& measure = measureItem(item, m_parentRect.m_width, m_parentRect.m_height);
+                const auto& margins = measure.m_pixelMargins;
+                usedMain += horizontal ?
+                    (measure.m_width + margins.m_left + margins.m_right) :
+                    (measure.m_height + margins.m_top + margins.m_bottom);
+                totalGrow += std::max(0.0f, item.m_grow);
+            }
+            const float freeMain = std::max(0.0f, availableMain - usedMain);
+
+            // 摆放
+            float cursor = horizontal ? m_parentRect.m_x : m_parentRect.m_y;
+            for (auto& item : m_items)
+            {
+                const auto& measure = item.m_measure;
+                const auto& margins = measure.m_pixelMargins;
+
+                const float marginMainStart = horizontal ? margins.m_left : margins.m_top;
+                const float marginMainEnd = horizontal ? margins.m_right : margins.m_bottom;
+                const float marginCrossStart = horizontal ? margins.m_top : margins.m_left;
+                const float marginCrossEnd = horizontal ? margins.m_bottom : margins.m_right;
+
+                float mainSize = horizontal ? measure.m_width : measure.m_height;
+                if (totalGrow > 0.0f && item.m_grow > 0.0f)
+                {
+                    mainSize += freeMain * item.m_grow / totalGrow;
+                }
+
+                const float crossSpace = std::max(0.0f, availableCross - marginCrossStart - marginCrossEnd);
+                float crossSize = horizontal ? measure.m_height : measure.m_width;
+                float crossOffset = marginCrossStart;
+                switch (item.m_align)
+                {
+                case CrossAlign::Start:
+                break;
+                case CrossAlign::Center:
+                    crossOffset += (crossSpace - crossSize) / 2.0f;
+                break;
+                case CrossAlign::End:
+                    crossOffset += crossSpace - crossSize;
+                break;
+                case CrossAlign::Stretch:
+                default:
+                    crossSize = crossSpace;
+                break;
+                }
+
+                cursor += marginMainStart;
+                sz_ds::Rect rect;
+                if (horizontal)
+                {
+                    rect = { cursor, m_parentRect.m_y + crossOffset, mainSize, crossSize };
+                }
+                else
+                {
+                    rect = { m_parentRect.m_x + crossOffset, cursor, crossSize, mainSize };
+                }
+                item.m_widget->SetRect(rect);
+                cursor += mainSize + marginMainEnd + m_spacing;
+            }
+        }
+	}
+}
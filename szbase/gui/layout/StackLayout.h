@@ -0,0 +1,207 @@
+// comment: 堆叠布局，沿主轴依次排列控件，先测量后摆放，测量结果按可用尺寸缓存
+
+#pragma once
+
+#include "../IUIBase.h"
+#include "../ILayout.h"
+
+#include <memory>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace sz_gui
+{
+	namespace layout
+	{
+        // 堆叠方向
+        enum class StackDirection
+        {
+            // 水平，从左到右
+            Horizontal,
+            // 垂直，从上到下
+            Vertical,
+        };
+
+        // 交叉轴对齐方式
+        enum class CrossAlign
+        {
+            // 起始边
+            Start,
+            // 居中
+            Center,
+            // 结束边
+            End,
+            // 拉伸铺满
+            Stretch,
+        };
+
+        // 测量缓存
+        struct MeasureCache
+        {
+            // 测量时的可用宽高
+            float m_availableW = -1.0f;
+            float m_availableH = -1.0f;
+            // 测量得到的宽高，不含边距
+            float m_width = 0.0f;
+            float m_height = 0.0f;
+            // 测量时的像素边距
+            Margins m_pixelMargins;
+            // 结果与可用尺寸无关，可用尺寸放得下时直接复用
+            bool m_fixedSize = false;
+            // 是否有效
+            bool m_valid = false;
+        };
+
+        // 堆叠布局项
+        struct StackLayoutItem
+        {
+            // 控件
+            std::shared_ptr<IUIBase> m_widget;
+            // 主轴剩余空间分配权重，0表示不伸展
+            float m_grow = 0.0f;
+            // 交叉轴对齐方式
+            CrossAlign m_align = CrossAlign::Stretch;
+            // 测量缓存
+            MeasureCache m_measure;
+        };
+
+        // 堆叠布局
+        class StackLayout final : public ILayout
+        {
+        private:
+            // 父容器矩形
+            sz_ds::Rect m_parentRect;
+            // 需要布局的控件
+            std::list<StackLayoutItem> m_items;
+            // 记录需要布局的控件
+            std::unordered_map<uint64_t, std::list<StackLayoutItem>::iterator> m_records;
+            // 堆叠方向
+            StackDirection m_direction = StackDirection::Vertical;
+            // 控件间距
+            float m_spacing = 0.0f;
+            // 需要重新布局
+            bool m_dirty = true;
+            // 实际测量次数，缓存命中不计数
+            uint64_t m_measureCount = 0;
+
+        public:
+            StackLayout(StackDirection direction = StackDirection::Vertical, float spacing = 0.0f)
+                : m_direction(direction), m_spacing(spacing)
+            {
+            }
+
+        public:
+            // 设置父容器边界
+            void SetParentRect(const sz_ds::Rect& rect) override
+            {
+                if (m_parentRect == rect)
+                {
+                    return;
+                }
+                m_parentRect = rect;
+                m_dirty = true;
+            }
+            // 添加需要布局的控件，主轴期望尺寸为0的控件伸展
+            bool AddWidget(std::shared_ptr<IUIBase> widget) override
+            {
+                if (!widget)
+                {
+                    return false;
+                }
+
+                auto [desireWidth, desireHeight] = widget->GetDisireWH();
+                float desireMain = m_direction == StackDirection::Horizontal ? desireWidth : desireHeight;
+                return AddWidget(widget, desireMain > 0.0f ? 0.0f : 1.0f, CrossAlign::Stretch);
+            }
+            // 添加需要布局的控件，指定伸展权重和交叉轴对齐方式
+            bool AddWidget(std::shared_ptr<IUIBase> widget, float grow, CrossAlign align)
+            {
+                if (!widget || widget->GetChildIdForUIManager() == 0)
+                {
+                    return false;
+                }
+
+                if (m_records.find(widget->GetChildIdForUIManager()) != m_records.end())
+                {
+                    return false;
+                }
+
+                m_items.emplace_back(widget, grow, align);
+                auto it = std::prev(m_items.end());
+                m_records.emplace(widget->GetChildIdForUIManager(), it);
+                m_dirty = true;
+                return true;
+            }
+            // 删除布局控件
+            bool DelWidget(std::shared_ptr<IUIBase> widget) override
+            {
+                if (!widget || widget->GetChildIdForUIManager() == 0)
+                {
+                    return false;
+                }
+
+                auto record = m_records.find(widget->GetChildIdForUIManager());
+                if (record == m_records.end())
+                {
+                    return false;
+                }
+
+                m_items.erase(record->second);
+                m_records.erase(record);
+                m_dirty = true;
+                return true;
+            }
+            // 控件布局约束发生变化，只丢弃该控件的测量缓存
+            void InvalidateWidget(IUIBase* widget) override
+            {
+                if (!widget)
+                {
+                    return;
+                }
+
+                auto record = m_records.find(widget->GetChildIdForUIManager());
+                if (record == m_records.end())
+                {
+                    return;
+                }
+                record->second->m_measure.m_valid = false;
+                m_dirty = true;
+            }
+            // 是否需要重新布局
+            bool IsDirty() const override { return m_dirty; }
+            // 执行布局计算
+            void PerformLayout() override;
+
+        public:
+            // 设置堆叠方向
+            void SetDirection(StackDirection direction)
+            {
+                if (m_direction == direction)
+                {
+                    return;
+                }
+                m_direction = direction;
+                // 测量结果和方向相关
+                for (auto& item : m_items)
+                {
+                    item.m_measure.m_valid = false;
+                }
+                m_dirty = true;
+            }
+            // 设置控件间距
+            void SetSpacing(float spacing)
+            {
+                m_spacing = spacing;
+                m_dirty = true;
+            }
+            // 获取实际测量次数
+            uint64_t GetMeasureCount() const { return m_measureCount; }
+
+        private:
+            // 测量控件，可用尺寸不变且约束未变化时直接返回缓存
+            const MeasureCache& measureItem(StackLayoutItem& item, float availableW, float availableH);
+        };
+	}
+}
@@ -71,15 +71,14 @@ namespace sz_gui
             setState(ButtonState::Normal);
         }
 
-		bool UIButton::OnCollectRenderData()
+		bool UIButton::OnCollectRenderData(const RenderContext& ctx)
 		{
-			if (!IsVisible())
+			if (!IsVisible() || HasUIFlag(UIFlag::Occluded))
 			{
 				return false;
 			}
 
-			auto aabb = getIntersectWithParent();
-			if (aabb.IsNull())
+			if (isOutsideContext(ctx))
 			{
 				return false;
 			}
@@ -114,11 +113,11 @@ namespace sz_gui
 			dCmd.m_worldPos = { m_x, m_y, m_z };
 			dCmd.m_uploadOp = uploadOp;
 			dCmd.m_drawMode = DrawMode::TRIANGLES;
+			dCmd.m_clipRect = getClipRect(ctx);
 
-			auto& render = m_uiManager.lock()->GetRender();
-			render->AppendDrawData(positions, colors, indices, dCmd);
+			ctx.m_render->AppendDrawData(positions, colors, indices, dCmd);
             // 加入绘制文字数据
-            appendTextDrawData(uploadOp);
+            appendTextDrawData(ctx, uploadOp);
 
 			return true;
 		}
@@ -193,8 +192,9 @@ namespace sz_gui
             setUploadOp(UploadOperation::UploadColorOrUv);
         }
 
-        void UIButton::appendTextDrawData(UploadOperation uploadOp)
+        void UIButton::appendTextDrawData(const RenderContext& ctx, UploadOperation uploadOp)
         {
+            auto render = ctx.m_render;
             if (sz_string::IsOnlyWhitespace(m_text))
             {
                 return;
@@ -208,7 +208,6 @@ namespace sz_gui
 
             auto limitWidth = m_width;
             auto limitHeight = m_height;
-            auto& render = m_uiManager.lock()->GetRender();
             if (sz_utils::HasFlag(uploadOp, UploadOperation::UploadText))
             {
                 if (!render->DrawTextToBuffer(m_ta, limitWidth, limitHeight, codepoints,
@@ -227,6 +226,7 @@ namespace sz_gui
             dCmd.m_drawMode = DrawMode::TRIANGLES;
             dCmd.m_renderState = dCmd.m_renderState | RenderState::EnableBlend;
             dCmd.m_materialType = MaterialType::TextMaterial;
+            dCmd.m_clipRect = getClipRect(ctx);
 
             render->AppendTextDrawData(m_textPositions, m_textUvs, m_textIndices, m_textLayers, dCmd);
         }
@@ -39,6 +39,20 @@ namespace sz_gui
             UIButton(std::string name, layout::AnchorPoint type, layout::Margins margins, 
                 uint32_t desiredW, uint32_t desiredH);
 
+        public:
+            // 设置按钮文本
+            void SetText(const std::string& text)
+            {
+                if (m_text == text)
+                {
+                    return;
+                }
+                m_text = text;
+                setUploadOp(UploadOperation::UploadText);
+            }
+            // 获取按钮文本
+            const std::string& GetText() const { return m_text; }
+
         public:
             // 订阅鼠标左键点击事件
             template<typename HandlerFunc>
@@ -61,7 +75,9 @@ namespace sz_gui
             // 鼠标移动离开事件
             void OnMouseMoveLeave() override;
             // 收集渲染数据事件
-            bool OnCollectRenderData() override;
+            bool OnCollectRenderData(const RenderContext& ctx) override;
+            // 按钮底色不透明并且填满矩形
+            bool IsOpaque() const override { return true; }
             // 设置颜色主题
             void SetColorTheme(ColorTheme theme) override;
 
@@ -69,7 +85,7 @@ namespace sz_gui
             // 设置按钮状态
             void setState(ButtonState state);
             // 加入文字渲染数据
-            void appendTextDrawData(UploadOperation uploadOp);
+            void appendTextDrawData(const RenderContext& ctx, UploadOperation uploadOp);
 
         protected:
             // 按钮颜色
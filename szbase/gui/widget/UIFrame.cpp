@@ -28,88 +28,93 @@ namespace sz_gui
 			return false;
 		}
 
-		void UIFrame::OnWindowResize()
+		void UIFrame::UpdateLayout()
 		{
-			UIBase::OnWindowResize();
+			UIBase::UpdateLayout();
 
-			// 重新布局
+			if (!m_layout)
+			{
+				return;
+			}
+
+			// 父区域不变时只重新计算约束变化的子组件
 			auto rect = GetRect().SubtractBorder(m_borderWidth);
 			m_layout->SetParentRect(rect);
-			m_layout->PerformLayout();
+			if (m_layout->IsDirty())
+			{
+				m_layout->PerformLayout();
+			}
 		}
 
-		bool UIFrame::OnCollectRenderData()
+		void UIFrame::InvalidateChildLayout(IUIBase* child)
+		{
+			if (!m_layout)
+			{
+				return;
+			}
+
+			m_layout->InvalidateWidget(child);
+			InvalidateLayout();
+		}
+
+		bool UIFrame::OnCollectRenderData(const RenderContext& ctx)
 		{
 			if (!IsVisible())
 			{
 				return false;
 			}
 
-			auto aabb = getIntersectWithParent();
-			if (aabb.IsNull())
+			if (isOutsideContext(ctx))
 			{
 				return false;
 			}
 
-			if (!m_parent.expired() && aabb.GetRect() != GetRect()) [[unlikely]]
+			if (!m_parentHandle.IsNull() && getIntersectWithParent(ctx).GetRect() != GetRect()) [[unlikely]]
 			{
 				// 布局引擎有bug
 				assert(0);
 			}
 
-			// 顶点位置信息索引
-			static std::vector<float> positions;
-			positions.clear();
-			positions =
+			// 被遮挡时只跳过自身边框，子组件单独判断
+			if (!HasUIFlag(UIFlag::Occluded))
 			{
-				// 左上角
-				0.0f, 0.0f, 0.0f,
-				// 右上角
-				m_width, 0.0f, 0.0f,
-				// 右下角
-				m_width, m_height, 0.0f,
-				// 左下角
-				0.0f, m_height, 0.0f,
-			};
-			// 顶点颜色信息
-			const std::vector<float>& colors = m_colors;
-			// 顶点数据索引
-			static std::vector<uint32_t> indices = { 0, 1, 2, 3 };
-
-			// 绘制命令
-			DrawCommand dCmd;
-			dCmd.m_onlyId = m_childIdForUIManager;
-			dCmd.m_worldPos = { m_x, m_y, m_z };
-			dCmd.m_uploadOp = getUploadOp();
-			dCmd.m_drawMode = DrawMode::LINE_LOOP;
-			dCmd.m_renderState |= RenderState::EnableScissorSet;
-			dCmd.m_scissorTest = {true, int32_t(m_x + m_borderWidth), int32_t(m_y + m_borderWidth),
-				int32_t(m_width - 2 * m_borderWidth), int32_t(m_height - 2 * m_borderWidth) };
-
-			auto& render = m_uiManager.lock()->GetRender();
-			render->AppendDrawData(positions, colors, indices, dCmd);
-
-			static bool isChildAppend = false;
-			// 递归收集子节点的渲染数据
-			for (auto& child : m_childMultimap)
-			{
-				if (child.second->OnCollectRenderData())
+				// 顶点位置信息索引
+				static std::vector<float> positions;
+				positions.clear();
+				positions =
 				{
-					isChildAppend = true;
-				}
+					// 左上角
+					0.0f, 0.0f, 0.0f,
+					// 右上角
+					m_width, 0.0f, 0.0f,
+					// 右下角
+					m_width, m_height, 0.0f,
+					// 左下角
+					0.0f, m_height, 0.0f,
+				};
+				// 顶点颜色信息
+				const std::vector<float>& colors = m_colors;
+				// 顶点数据索引
+				static std::vector<uint32_t> indices = { 0, 1, 2, 3 };
+
+				// 绘制命令
+				DrawCommand dCmd;
+				dCmd.m_onlyId = m_childIdForUIManager;
+				dCmd.m_worldPos = { m_x, m_y, m_z };
+				dCmd.m_uploadOp = getUploadOp();
+				dCmd.m_drawMode = DrawMode::LINE_LOOP;
+				dCmd.m_clipRect = getClipRect(ctx);
+
+				auto render = ctx.m_render;
+				render->AppendDrawData(positions, colors, indices, dCmd);
 			}
 
-			DrawCommand dExtraCmd;
-			dExtraCmd.m_onlyId = m_childIdForUIManager;
-			dExtraCmd.m_renderState = RenderState::None;
-			if (!m_childMultimap.empty() || isChildAppend)
+			// 递归收集子节点的渲染数据，子节点剪裁到边框内
+			auto childCtx = makeChildContext(ctx);
+			for (auto& child : m_childMultimap)
 			{
-				dExtraCmd.m_renderState = RenderState::EnableScissorSet;
-				dExtraCmd.m_scissorTest = { false };
-				dExtraCmd.m_onlyId = 
-					std::prev(m_childMultimap.end())->second->GetChildIdForUIManager();
+				child.second->OnCollectRenderData(childCtx);
 			}
-			render->ExtraAppendDrawCommand(dExtraCmd);
 
 			return true;
 		}
@@ -19,37 +19,51 @@ namespace sz_gui
                 uint32_t desiredW, uint32_t desiredH);
 
             // 设置布局
-            void SetLayout(ILayout* layout) { m_layout.reset(layout); };
+            void SetLayout(ILayout* layout) 
+            { 
+                m_layout.reset(layout); 
+                InvalidateLayout();
+            };
             // 添加需要布局的控件
             bool AddWidget(std::shared_ptr<IUIBase> widget) 
             {
-                if (!m_layout)
+                if (!m_layout || !m_layout->AddWidget(widget))
                 {
                     return false;
                 }
-                return m_layout->AddWidget(widget);
+                InvalidateLayout();
+                return true;
             }
             // 删除布局控件
             bool DelWidget(std::shared_ptr<IUIBase> widget)
             {
-                if (!m_layout)
+                if (!m_layout || !m_layout->DelWidget(widget))
                 {
                     return false;
                 }
-                return m_layout->DelWidget(widget);
+                InvalidateLayout();
+                return true;
             }
 
 
         public:
             // 鼠标左键点击事件，返回false将会阻止冒泡
             bool OnMouseLeftButtonClick() override;
-            // 窗户大小改变事件
-            void OnWindowResize() override;
+            // 更新布局
+            void UpdateLayout() override;
+            // 子组件布局约束发生变化
+            void InvalidateChildLayout(IUIBase* child) override;
             // 收集渲染数据事件
-            bool OnCollectRenderData() override;
+            bool OnCollectRenderData(const RenderContext& ctx) override;
+            // 子组件剪裁到边框内
+            std::optional<sz_ds::Rect> GetChildClipRect() const override { return GetRect().SubtractBorder(m_borderWidth); }
             // 设置颜色主题
             void SetColorTheme(ColorTheme theme) override;
 
+        protected:
+            // 矩形发生变化，子组件需要重新布局
+            void onRectChanged(bool /*resized*/) override { InvalidateLayout(); }
+
         private:
             // 布局
             std::unique_ptr<ILayout> m_layout;
@@ -0,0 +1,86 @@
+#include "UIImage.h"
+
+namespace sz_gui
+{
+	namespace widget
+	{
+		UIImage::UIImage(std::string name, layout::AnchorPoint type, layout::Margins margins,
+			uint32_t desiredW, uint32_t desiredH)
+		{
+			m_type = UIType::Image;
+
+			m_name = std::move(name);
+			m_anchorPoint = type;
+			m_margins = std::move(margins);
+			m_desireWidth = (float)desiredW;
+			m_desireHeight = (float)desiredH;
+		}
+
+		bool UIImage::OnCollectRenderData(const RenderContext& ctx)
+		{
+			if (!IsVisible() || HasUIFlag(UIFlag::Occluded) || m_path.empty() || m_loadFailed)
+			{
+				return false;
+			}
+
+			if (isOutsideContext(ctx))
+			{
+				return false;
+			}
+
+			if (!m_imageId)
+			{
+				m_imageId = ctx.m_render->LoadImageFile(m_path);
+				if (!m_imageId)
+				{
+					m_loadFailed = true;
+					return false;
+				}
+			}
+
+			// 顶点位置信息索引
+			static std::vector<float> positions;
+			positions.clear();
+			positions =
+			{
+				// 左上角
+				0.0f, 0.0f, 0.0f,
+				// 右上角
+				m_width, 0.0f, 0.0f,
+				// 右下角
+				m_width, m_height, 0.0f,
+				// 左下角
+				0.0f, m_height, 0.0f,
+			};
+			// 图片内的uv，图集负责映射到页面
+			static const std::vector<float> uvs =
+			{
+				0.0f, 0.0f,
+				1.0f, 0.0f,
+				1.0f, 1.0f,
+				0.0f, 1.0f,
+			};
+			// 顶点数据索引
+			static std::vector<uint32_t> indices =
+			{
+				0, 1, 2,
+				2, 3 ,0,
+			};
+
+			// 绘制命令，图片可能带透明通道
+			DrawCommand dCmd;
+			dCmd.m_onlyId = m_childIdForUIManager;
+			dCmd.m_worldPos = { m_x, m_y, m_z };
+			dCmd.m_uploadOp = getUploadOp();
+			dCmd.m_drawMode = DrawMode::TRIANGLES;
+			dCmd.m_renderState = dCmd.m_renderState | RenderState::EnableBlend;
+			dCmd.m_materialType = MaterialType::TextureMaterial;
+			dCmd.m_imageId = m_imageId;
+			dCmd.m_clipRect = getClipRect(ctx);
+
+			ctx.m_render->AppendDrawData(positions, uvs, indices, dCmd);
+
+			return true;
+		}
+	}
+}
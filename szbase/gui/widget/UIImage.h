@@ -0,0 +1,49 @@
+// comment: 图片控件，图片放在渲染器的图集中，解码和上传完成前显示占位
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "../UIBase.h"
+
+namespace sz_gui
+{
+    namespace widget
+    {
+        class UIImage : public UIBase
+        {
+        public:
+            // 锚点布局构造
+            UIImage(std::string name, layout::AnchorPoint type, layout::Margins margins,
+                uint32_t desiredW, uint32_t desiredH);
+
+        public:
+            // 设置图片路径，第一次收集渲染数据时开始异步加载
+            void SetImage(const std::string& path)
+            {
+                if (m_path == path)
+                {
+                    return;
+                }
+                m_path = path;
+                m_imageId = 0;
+                m_loadFailed = false;
+            }
+            // 获取图片路径
+            const std::string& GetImage() const { return m_path; }
+
+        public:
+            // 收集渲染数据事件
+            bool OnCollectRenderData(const RenderContext& ctx) override;
+
+        private:
+            // 图片路径
+            std::string m_path;
+            // 渲染器返回的图片id
+            uint32_t m_imageId = 0;
+            // 加载失败后不再重试，直到路径变化
+            bool m_loadFailed = false;
+        };
+    }
+}
@@ -0,0 +1,303 @@
+#include "UIListView.h"
+#include "../WidgetFactory.h"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+namespace sz_gui
+{
+	namespace widget
+	{
+		UIListRow::UIListRow(std::string name, uint32_t desiredW, uint32_t desiredH)
+			: UIButton(std::move(name), layout::AnchorPoint::TopLeft, layout::Margins(0.0f), desiredW, desiredH)
+		{
+			// 绑定行号前不显示
+			ClearUIFlag(UIFlag::Visibale);
+		}
+
+		bool UIListRow::ContainsPoint(float x, float y) const
+		{
+			// 部分滚出列表的行，只有可见部分响应
+			auto aabb = getIntersectWithParent();
+			if (aabb.IsNull())
+			{
+				return false;
+			}
+			return aabb.Contains({ x, y });
+		}
+
+		UIListView::UIListView(std::string name, layout::AnchorPoint type, layout::Margins margins,
+			uint32_t desiredW, uint32_t desiredH, float rowHeight)
+		{
+			m_type = UIType::ListView;
+
+			m_name = std::move(name);
+			m_anchorPoint = type;
+			m_margins = std::move(margins);
+			m_desireWidth = (float)desiredW;
+			m_desireHeight = (float)desiredH;
+			m_rowHeight = rowHeight;
+			assert(m_rowHeight > 0.0f);
+
+			// 空白区域也要接收滚轮
+			SetUIFlag(UIFlag::Interactive);
+			SetColorTheme(ColorTheme::LightMode);
+		}
+
+		void UIListView::SetRowCount(size_t count)
+		{
+			m_rowCount = count;
+			m_scrollOffset = clampScrollOffset(m_scrollOffset);
+			InvalidateAllRows();
+		}
+
+		void UIListView::SetRowBinder(RowBinder binder)
+		{
+			m_binder = std::move(binder);
+			InvalidateAllRows();
+		}
+
+		void UIListView::SetOverscan(size_t rows)
+		{
+			m_overscan = rows;
+			m_rowsDirty = true;
+		}
+
+		void UIListView::InvalidateRow(size_t row)
+		{
+			if (m_rowWidgets.empty())
+			{
+				return;
+			}
+
+			auto& rowWidget = m_rowWidgets[row % m_rowWidgets.size()];
+			if (rowWidget->GetRowIndex() == row)
+			{
+				rowWidget->SetRowIndex(INVALID_ROW);
+				m_rowsDirty = true;
+			}
+		}
+
+		void UIListView::InvalidateAllRows()
+		{
+			for (auto& rowWidget : m_rowWidgets)
+			{
+				rowWidget->SetRowIndex(INVALID_ROW);
+			}
+			m_rowsDirty = true;
+		}
+
+		void UIListView::ScrollTo(float offset)
+		{
+			offset = clampScrollOffset(offset);
+			if (sz_ds::float_equal(offset, m_scrollOffset))
+			{
+				return;
+			}
+
+			m_scrollOffset = offset;
+			m_rowsDirty = true;
+		}
+
+		float UIListView::GetMaxScrollOffset() const
+		{
+			auto content = getContentRect();
+			return std::max(0.0f, (float)m_rowCount * m_rowHeight - content.m_height);
+		}
+
+		bool UIListView::OnMouseWheel(float /*x*/, float y)
+		{
+			if (GetMaxScrollOffset() <= 0.0f)
+			{
+				// 不能滚动，交给父节点处理
+				return false;
+			}
+
+			// 滚轮向上为正，内容向下
+			ScrollBy(-y * m_wheelRows * m_rowHeight);
+			return true;
+		}
+
+		void UIListView::OnPrepareRenderData()
+		{
+			if (!IsVisible())
+			{
+				return;
+			}
+
+			ensureRowWidgets();
+			if (m_rowsDirty || getContentRect() != m_lastContentRect)
+			{
+				updateRows();
+			}
+		}
+
+		bool UIListView::OnCollectRenderData(const RenderContext& ctx)
+		{
+			if (!IsVisible())
+			{
+				return false;
+			}
+
+			if (isOutsideContext(ctx))
+			{
+				return false;
+			}
+
+			// 被遮挡时只跳过自身边框，行单独判断
+			if (!HasUIFlag(UIFlag::Occluded))
+			{
+				// 顶点位置信息索引
+				static std::vector<float> positions;
+				positions.clear();
+				positions =
+				{
+					// 左上角
+					0.0f, 0.0f, 0.0f,
+					// 右上角
+					m_width, 0.0f, 0.0f,
+					// 右下角
+					m_width, m_height, 0.0f,
+					// 左下角
+					0.0f, m_height, 0.0f,
+				};
+				// 顶点颜色信息
+				const std::vector<float>& colors = m_colors;
+				// 顶点数据索引
+				static std::vector<uint32_t> indices = { 0, 1, 2, 3 };
+
+				// 绘制命令，行只在内容区域内绘制
+				DrawCommand dCmd;
+				dCmd.m_onlyId = m_childIdForUIManager;
+				dCmd.m_worldPos = { m_x, m_y, m_z };
+				dCmd.m_uploadOp = getUploadOp();
+				dCmd.m_drawMode = DrawMode::LINE_LOOP;
+				dCmd.m_clipRect = getClipRect(ctx);
+
+				auto render = ctx.m_render;
+				render->AppendDrawData(positions, colors, indices, dCmd);
+			}
+
+			// 只收集已绑定的行，隐藏的行控件本帧不绘制，行剪裁到边框内
+			auto childCtx = makeChildContext(ctx);
+			for (auto& child : m_childMultimap)
+			{
+				child.second->OnCollectRenderData(childCtx);
+			}
+
+			return true;
+		}
+
+		void UIListView::SetColorTheme(ColorTheme theme)
+		{
+			UIBase::SetColorTheme(theme);
+
+			switch (theme)
+			{
+			case ColorTheme::LightMode:
+			m_colors =
+			{
+				0.85f, 0.85f, 0.85f,
+				0.85f, 0.85f, 0.85f,
+				0.85f, 0.85f, 0.85f,
+				0.85f, 0.85f, 0.85f,
+			};
+			break;
+			}
+
+			for (auto& rowWidget : m_rowWidgets)
+			{
+				rowWidget->SetColorTheme(theme);
+			}
+		}
+
+		void UIListView::ensureRowWidgets()
+		{
+			// 注册到UI管理器后才能挂子控件
+			if (!getUIManagerRaw() || m_childIdForUIManager == 0)
+			{
+				return;
+			}
+
+			auto content = getContentRect();
+			size_t visibleRows = (size_t)std::ceil(content.m_height / m_rowHeight) + 1;
+			size_t need = std::min(visibleRows + 2 * m_overscan, m_rowCount);
+			if (need <= m_rowWidgets.size())
+			{
+				return;
+			}
+
+			m_rowWidgets.reserve(need);
+			auto self = shared_from_this();
+			while (m_rowWidgets.size() < need)
+			{
+				auto rowWidget = MakeWidget<UIListRow>(GetName() + "_row" + std::to_string(m_rowWidgets.size()),
+					(uint32_t)content.m_width, (uint32_t)m_rowHeight);
+				rowWidget->SetZValue(m_z);
+				rowWidget->SetColorTheme(m_colorTheme);
+				rowWidget->SetParent(self);
+				m_rowWidgets.push_back(std::move(rowWidget));
+			}
+
+			// 行控件个数变化后行号到行控件的映射变了，全部重新绑定
+			InvalidateAllRows();
+		}
+
+		void UIListView::updateRows()
+		{
+			m_rowsDirty = false;
+
+			auto content = getContentRect();
+			m_lastContentRect = content;
+
+			if (m_rowWidgets.empty())
+			{
+				return;
+			}
+
+			// 绑定范围[firstRow, lastRow)，覆盖可见行和上下预加载行
+			size_t slotCount = m_rowWidgets.size();
+			size_t topRow = (size_t)(m_scrollOffset / m_rowHeight);
+			size_t firstRow = topRow > m_overscan ? topRow - m_overscan : 0;
+			size_t lastRow = std::min(m_rowCount, firstRow + slotCount);
+
+			for (size_t row = firstRow; row < lastRow; ++row)
+			{
+				auto& rowWidget = m_rowWidgets[row % slotCount];
+				if (rowWidget->GetRowIndex() != row)
+				{
+					rowWidget->SetRowIndex(row);
+					if (m_binder)
+					{
+						m_binder(row, *rowWidget);
+					}
+				}
+
+				// 行宽变化时行控件自己标记重新上传
+				float y = content.m_y + (float)((double)row * m_rowHeight - m_scrollOffset);
+				rowWidget->SetRect({ content.m_x, y, content.m_width, m_rowHeight });
+				rowWidget->SetUIFlag(UIFlag::Visibale);
+			}
+
+			// 绑定范围外的行控件隐藏
+			for (auto& rowWidget : m_rowWidgets)
+			{
+				size_t row = rowWidget->GetRowIndex();
+				if (row == INVALID_ROW || row < firstRow || row >= lastRow)
+				{
+					rowWidget->SetRowIndex(INVALID_ROW);
+					rowWidget->ClearUIFlag(UIFlag::Visibale);
+				}
+			}
+		}
+
+		float UIListView::clampScrollOffset(float offset) const
+		{
+			return std::clamp(offset, 0.0f, GetMaxScrollOffset());
+		}
+	}
+}
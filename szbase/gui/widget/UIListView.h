@@ -0,0 +1,130 @@
+// comment: 虚拟列表控件，只为可见行和预加载行创建行控件，滚出的行回收后重新绑定数据
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+#include "../UIBase.h"
+#include "../../ds/Delegate.h"
+#include "UIButton.h"
+
+namespace sz_gui
+{
+    namespace widget
+    {
+        // 列表行控件，点击测试限制在列表可见区域内
+        class UIListRow final : public UIButton
+        {
+        public:
+            UIListRow(std::string name, uint32_t desiredW, uint32_t desiredH);
+
+        public:
+            // 判断点是否在组件内
+            bool ContainsPoint(float x, float y) const override;
+            // 获取当前绑定的行号
+            size_t GetRowIndex() const { return m_rowIndex; }
+            // 设置当前绑定的行号，列表控件回收和绑定行时调用
+            void SetRowIndex(size_t row) { m_rowIndex = row; }
+
+        private:
+            // 当前绑定的行号
+            size_t m_rowIndex = std::numeric_limits<size_t>::max();
+        };
+
+        class UIListView : public UIBase
+        {
+        public:
+            // 行数据绑定回调，参数为行号和复用的行控件
+            using RowBinder = sz_ds::Delegate<void, size_t, UIListRow&>;
+            // 未绑定行号
+            static constexpr size_t INVALID_ROW = std::numeric_limits<size_t>::max();
+
+        public:
+            // 锚点布局构造
+            UIListView(std::string name, layout::AnchorPoint type, layout::Margins margins,
+                uint32_t desiredW, uint32_t desiredH, float rowHeight);
+
+        public:
+            // 设置行数
+            void SetRowCount(size_t count);
+            // 获取行数
+            size_t GetRowCount() const { return m_rowCount; }
+            // 设置行数据绑定回调，所有行重新绑定
+            void SetRowBinder(RowBinder binder);
+            // 设置可见区域外上下各预加载的行数
+            void SetOverscan(size_t rows);
+            // 某行数据发生变化，行可见时重新绑定
+            void InvalidateRow(size_t row);
+            // 所有行数据发生变化
+            void InvalidateAllRows();
+            // 滚动到指定偏移
+            void ScrollTo(float offset);
+            // 滚动指定距离
+            void ScrollBy(float delta) { ScrollTo(m_scrollOffset + delta); }
+            // 获取滚动偏移
+            float GetScrollOffset() const { return m_scrollOffset; }
+            // 获取最大滚动偏移
+            float GetMaxScrollOffset() const;
+            // 获取行高
+            float GetRowHeight() const { return m_rowHeight; }
+            // 获取已创建的行控件个数
+            size_t GetRowWidgetCount() const { return m_rowWidgets.size(); }
+
+        public:
+            // 鼠标左键点击事件，返回false将会阻止冒泡
+            bool OnMouseLeftButtonClick() override { return false; }
+            // 鼠标滚轮事件，返回true表示已处理，停止冒泡
+            bool OnMouseWheel(float x, float y) override;
+            // 准备渲染数据事件，摆放可见行
+            void OnPrepareRenderData() override;
+            // 收集渲染数据事件
+            bool OnCollectRenderData(const RenderContext& ctx) override;
+            // 行剪裁到边框内
+            std::optional<sz_ds::Rect> GetChildClipRect() const override { return getContentRect(); }
+            // 设置颜色主题
+            void SetColorTheme(ColorTheme theme) override;
+
+        private:
+            // 获取内容区域
+            sz_ds::Rect getContentRect() const { return GetRect().SubtractBorder(m_borderWidth); }
+            // 根据可见高度创建行控件，只增不减
+            void ensureRowWidgets();
+            // 计算可见行，回收并重新绑定滚出的行，摆放行位置
+            void updateRows();
+            // 限制滚动偏移范围
+            float clampScrollOffset(float offset) const;
+
+        private:
+            static constexpr float m_borderWidth = 1.0f;
+            // 行高
+            float m_rowHeight = 0.0f;
+            // 行数
+            size_t m_rowCount = 0;
+            // 可见区域外上下各预加载的行数
+            size_t m_overscan = 2;
+            // 滚动偏移
+            float m_scrollOffset = 0.0f;
+            // 每格滚轮滚动的行数
+            float m_wheelRows = 3.0f;
+            // 行数据绑定回调
+            RowBinder m_binder;
+            // 行控件，第row行使用m_rowWidgets[row % size]
+            std::vector<std::shared_ptr<UIListRow>> m_rowWidgets;
+            // 上次摆放时的内容区域
+            sz_ds::Rect m_lastContentRect;
+            // 行需要重新摆放
+            bool m_rowsDirty = true;
+            // 顶点颜色信息
+            std::vector<float> m_colors =
+            {
+                1.0f, 1.0f, 1.0f,
+                1.0f, 1.0f, 1.0f,
+                1.0f, 1.0f, 1.0f,
+                1.0f, 1.0f, 1.0f,
+            };
+        };
+    }
+}
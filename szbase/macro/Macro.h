@@ -1,9 +1,15 @@
 #pragma once
 
+#ifdef _MSC_VER
 // 禁用并保存警告状态
 #define DISABLE_MSVC_WARNING(warning_number) \
     __pragma(warning(push)) \
     __pragma(warning(disable: warning_number))
 // 恢复警告到之前保存的状态
 #define RESTORE_MSVC_WARNING() \
-    __pragma(warning(pop))
\ No newline at end of file
+    __pragma(warning(pop))
+#else
+// 其他编译器没有这些警告编号，展开为空
+#define DISABLE_MSVC_WARNING(warning_number)
+#define RESTORE_MSVC_WARNING()
+#endif
@@ -1,16 +1,40 @@
 #include <SDL3/SDL.h>
 
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <thread>
+
 #include "gui/SDLApp.h"
 
 // TEST
 #include "test/TestFramework.h"
 #include "ds/Delegate.h"
 #include "ds/EventBus.h"
+#include "ds/ObjectPool.h"
+#include "ds/Handle.h"
+#include "ds/TaskPool.h"
+#include "ds/MPSCQueue.h"
+#include "ds/RangeAllocator.h"
+#include "ds/ShelfPacker.h"
+#include "ds/CoverageGrid.h"
+#include "utils/PixelConvert.h"
 
 #include "gui/EventTypes.h"
 #include "gui/widget/UIFrame.h"
 #include "gui/widget/UIButton.h"
+#include "gui/widget/UIListView.h"
 #include "gui/layout/AnchorLayout.h"
+#include "gui/layout/StackLayout.h"
+#include "gui/layout/GridLayout.h"
+#include "gui/layout/ConstraintLayout.h"
+#include "gui/WidgetFactory.h"
+#include "gui/UIManager.h"
+#include "gui/LatencyTracker.h"
+#include "gui/ResizeCoalescer.h"
+#include "gui/TextLayout.h"
+#include "gui/gl/Geometry.h"
+#include "bench/NullRender.h"
 
 namespace Test_Delegate
 {
@@ -220,6 +244,81 @@ namespace Test_EventBus
             }
         );
 
+        TextEventData data2{ 2 };
+        bus.Publish<TestEvent>(&data2);
+        TEST_EQUAL(subA->val, 2, "Lambda handler called");
+
+        // 过期订阅ID不影响复用同一槽位的新订阅
+        bus.Unsubscribe<TestEvent>(id);
+        int calls = 0;
+        auto reused = bus.Subscribe<TestEvent>([&calls](const sz_ds::IEvent&) { ++calls; });
+        TEST_ASSERT(reused != id, "Reused slot gets new id");
+        bus.Unsubscribe<TestEvent>(id);
+        bus.Publish<TestEvent>(&data);
+        TEST_EQUAL(calls, 1, "Stale id does not unsubscribe");
+        bus.Unsubscribe<TestEvent>(reused);
+        bus.Publish<TestEvent>(&data);
+        TEST_EQUAL(calls, 1, "Unsubscribed handler not called");
+
+        // 分发中取消订阅和新增订阅
+        struct DispatchState
+        {
+            int first = 0;
+            int second = 0;
+            int added = 0;
+            uint64_t firstId = 0;
+            uint64_t secondId = 0;
+            uint64_t addedId = 0;
+        } state;
+        state.firstId = bus.Subscribe<TestEvent>([&bus, &state](const sz_ds::IEvent&) {
+            ++state.first;
+            bus.Unsubscribe<TestEvent>(state.firstId);
+            bus.Unsubscribe<TestEvent>(state.secondId);
+            if (state.addedId == 0)
+            {
+                state.addedId = bus.Subscribe<TestEvent>([&state](const sz_ds::IEvent&) { ++state.added; });
+            }
+        });
+        state.secondId = bus.Subscribe<TestEvent>([&state](const sz_ds::IEvent&) { ++state.second; });
+        bus.Publish<TestEvent>(&data);
+        TEST_EQUAL(state.first, 1, "Handler unsubscribing itself runs once");
+        TEST_EQUAL(state.second, 0, "Handler unsubscribed during dispatch skipped");
+        TEST_EQUAL(state.added, 0, "Handler subscribed during dispatch skipped");
+        bus.Publish<TestEvent>(&data);
+        TEST_EQUAL(state.first, 1, "Unsubscribed during dispatch stays removed");
+        TEST_EQUAL(state.added, 1, "Handler subscribed during dispatch called next time");
+        bus.Unsubscribe<TestEvent>(state.addedId);
+
+        // 类型编号稳定且不同
+        TEST_EQUAL(EventTypeId<TextEventData*>(), EventTypeId<TextEventData*>(), "Stable event type id");
+        TEST_ASSERT(EventTypeId<TextEventData*>() != EventTypeId<int>(), "Distinct event type id");
+
+        // 反复订阅和取消订阅后，只有最后一批处理函数被调用
+        const int subscribers = 16;
+        const int publishes = 100;
+        std::vector<uint64_t> ids;
+        int sum = 0;
+        for (int round = 0; round < 100; ++round)
+        {
+            for (int i = 0; i < subscribers; ++i)
+            {
+                ids.push_back(bus.Subscribe<TestEvent>([&sum](const sz_ds::IEvent&) { ++sum; }));
+            }
+            if (round < 99)
+            {
+                for (auto subscription : ids)
+                {
+                    bus.Unsubscribe<TestEvent>(subscription);
+                }
+                ids.clear();
+            }
+        }
+        for (int i = 0; i < publishes; ++i)
+        {
+            bus.Publish<TestEvent>(&data);
+        }
+        TEST_EQUAL(sum, subscribers * publishes, "Every handler called");
+
         print_subsection("All tests complete");
         return 0;
     }
@@ -227,10 +326,1315 @@ namespace Test_EventBus
     #pragma warning( pop )
 }
 
+namespace Test_ObjectPool
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    struct PoolItem
+    {
+        static int sAlive;
+        int value = 0;
+
+        PoolItem(int v) : value(v) { ++sAlive; }
+        ~PoolItem() { --sAlive; }
+    };
+    int PoolItem::sAlive = 0;
+
+    // 测试对象池
+    int Test_ObjectPool(int argc, char* argv[])
+    {
+        print_section("Test_ObjectPool");
+
+        ObjectPool<PoolItem> pool(4);
+        pool.Reserve(10);
+        TEST_EQUAL(pool.GetStats().m_slabCount, (size_t)1, "Reserve must allocate one slab");
+        TEST_EQUAL(pool.GetStats().m_capacity, (size_t)10, "Reserve capacity");
+
+        std::vector<PoolItem*> items;
+        for (int i = 0; i < 10; ++i)
+        {
+            items.push_back(pool.Create(i));
+        }
+        TEST_EQUAL(PoolItem::sAlive, 10, "All items constructed");
+        TEST_ASSERT(pool.GetStats().m_slabCount == 1, "Reserved capacity must not allocate new slab");
+
+        // 释放后再次分配复用空闲内存
+        PoolItem* freed = items[3];
+        pool.Destroy(freed);
+        PoolItem* reused = pool.Create(100);
+        TEST_ASSERT(reused == freed, "Freed block must be reused first");
+        TEST_EQUAL(reused->value, 100, "Reused item constructed");
+        items[3] = reused;
+
+        // 超出容量后按块增长
+        items.push_back(pool.Create(10));
+        TEST_EQUAL(pool.GetStats().m_slabCount, (size_t)2, "Pool grows by slab");
+        TEST_EQUAL(pool.GetStats().m_capacity, (size_t)14, "Pool capacity after growth");
+
+        for (auto* item : items)
+        {
+            pool.Destroy(item);
+        }
+        TEST_EQUAL(PoolItem::sAlive, 0, "All items destructed");
+        TEST_EQUAL(pool.GetStats().m_liveCount, (size_t)0, "No live items");
+        TEST_EQUAL(pool.GetStats().m_peakLiveCount, (size_t)11, "Peak live items");
+
+        {
+            auto ptr = MakePooled(pool, 7);
+            TEST_EQUAL(ptr->value, 7, "Pooled unique ptr");
+        }
+        TEST_EQUAL(pool.GetStats().m_liveCount, (size_t)0, "No live items");
+
+        // 池化创建控件
+        auto widgets = sz_gui::MakeWidgets<sz_gui::widget::UIButton>(16, [](size_t i) {
+            return std::make_tuple("PoolButton" + std::to_string(i),
+                sz_gui::layout::AnchorPoint::TopLeft, sz_gui::layout::Margins(0.0f), 80, 40);
+        });
+        TEST_EQUAL(widgets.size(), (size_t)16, "Bulk created widgets");
+        TEST_EQUAL(sz_gui::GetWidgetPoolStats<sz_gui::widget::UIButton>().m_liveCount, (size_t)16, "Widget pool live count");
+        TEST_ASSERT(sz_gui::GetWidgetPoolStats<sz_gui::widget::UIButton>().m_capacity >= 16, "Widget pool capacity");
+        TEST_ASSERT(sz_gui::GetWidgetPoolStats<sz_gui::widget::UIButton>().m_slabCount >= 1, "Widget pool slab count");
+        widgets.clear();
+        TEST_EQUAL(sz_gui::GetWidgetPoolStats<sz_gui::widget::UIButton>().m_liveCount, (size_t)0, "Widget pool released");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_Handle
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试代际索引句柄
+    int Test_Handle(int argc, char* argv[])
+    {
+        print_section("Test_Handle");
+
+        int a = 1, b = 2, c = 3;
+        HandleTable<int> table;
+
+        Handle<int> nullHandle;
+        TEST_ASSERT(nullHandle.IsNull(), "Default handle is null");
+        TEST_ASSERT(table.Get(nullHandle) == nullptr, "Null handle resolves to nullptr");
+
+        auto ha = table.Insert(&a);
+        auto hb = table.Insert(&b);
+        TEST_ASSERT(!ha.IsNull() && ha != hb, "Inserted handles are distinct");
+        TEST_ASSERT(table.Get(ha) == &a, "Resolve handle a");
+        TEST_ASSERT(table.Get(hb) == &b, "Resolve handle b");
+        TEST_EQUAL(table.Size(), (size_t)2, "Table size after insert");
+
+        // 移除后旧句柄失效，槽位复用代数增加
+        TEST_ASSERT(table.Remove(ha), "Remove handle a");
+        TEST_ASSERT(!table.Remove(ha), "Remove stale handle fails");
+        TEST_ASSERT(table.Get(ha) == nullptr, "Stale handle resolves to nullptr");
+        auto hc = table.Insert(&c);
+        TEST_EQUAL(hc.m_index, ha.m_index, "Freed slot is reused");
+        TEST_ASSERT(hc.m_generation != ha.m_generation, "Reused slot has new generation");
+        TEST_ASSERT(table.Get(ha) == nullptr, "Stale handle stays invalid after reuse");
+        TEST_ASSERT(table.Get(hc) == &c, "Resolve handle c");
+        TEST_EQUAL(table.Size(), (size_t)2, "Table size after reuse");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_AnchorLayout
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 测试增量锚点布局
+    int Test_AnchorLayout(int argc, char* argv[])
+    {
+        print_section("Test_AnchorLayout");
+
+        layout::AnchorLayout anchorLayout;
+        auto topLeft = MakeWidget<widget::UIButton>("LayoutTopLeft",
+            layout::AnchorPoint::TopLeft, layout::Margins(10.0f), 80, 40);
+        auto bottomRight = MakeWidget<widget::UIButton>("LayoutBottomRight",
+            layout::AnchorPoint::BottomRight, layout::Margins(10.0f), 80, 40);
+        topLeft->setChildIdForUIManager(1);
+        bottomRight->setChildIdForUIManager(2);
+        TEST_ASSERT(anchorLayout.AddWidget(topLeft), "Add top left widget");
+        TEST_ASSERT(anchorLayout.AddWidget(bottomRight), "Add bottom right widget");
+
+        anchorLayout.SetParentRect({ 0.0f, 0.0f, 400.0f, 300.0f });
+        TEST_ASSERT(anchorLayout.IsDirty(), "Layout dirty after parent rect set");
+        anchorLayout.PerformLayout();
+        TEST_ASSERT(!anchorLayout.IsDirty(), "Layout clean after perform");
+        TEST_ASSERT(topLeft->GetRect() == sz_ds::Rect(10.0f, 10.0f, 80.0f, 40.0f), "Top left rect");
+        TEST_ASSERT(bottomRight->GetRect() == sz_ds::Rect(310.0f, 250.0f, 80.0f, 40.0f), "Bottom right rect");
+
+        // 父容器区域不变不需要重新布局
+        anchorLayout.SetParentRect({ 0.0f, 0.0f, 400.0f, 300.0f });
+        TEST_ASSERT(!anchorLayout.IsDirty(), "Same parent rect keeps layout clean");
+
+        // 只重新计算约束变化的控件
+        topLeft->SetMargins(layout::Margins(20.0f));
+        anchorLayout.InvalidateWidget(topLeft.get());
+        TEST_ASSERT(anchorLayout.IsDirty(), "Layout dirty after widget invalidated");
+        anchorLayout.PerformLayout();
+        TEST_ASSERT(topLeft->GetRect() == sz_ds::Rect(20.0f, 20.0f, 80.0f, 40.0f), "Invalidated widget relayout");
+        TEST_ASSERT(bottomRight->GetRect() == sz_ds::Rect(310.0f, 250.0f, 80.0f, 40.0f), "Other widget unchanged");
+
+        // 父容器区域变化时所有控件重新计算
+        anchorLayout.SetParentRect({ 0.0f, 0.0f, 500.0f, 400.0f });
+        anchorLayout.PerformLayout();
+        TEST_ASSERT(bottomRight->GetRect() == sz_ds::Rect(410.0f, 350.0f, 80.0f, 40.0f), "Relayout after parent resize");
+
+        TEST_ASSERT(anchorLayout.DelWidget(topLeft), "Delete widget");
+        TEST_ASSERT(anchorLayout.DelWidget(bottomRight), "Delete widget");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_StackLayout
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 测试堆叠布局
+    int Test_StackLayout(int argc, char* argv[])
+    {
+        print_section("Test_StackLayout");
+
+        layout::StackLayout stack(layout::StackDirection::Vertical, 10.0f);
+        auto a = MakeWidget<widget::UIButton>("StackA", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 80, 40);
+        auto b = MakeWidget<widget::UIButton>("StackB", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 80, 0);
+        auto c = MakeWidget<widget::UIButton>("StackC", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 80, 40);
+        a->setChildIdForUIManager(1);
+        b->setChildIdForUIManager(2);
+        c->setChildIdForUIManager(3);
+        TEST_ASSERT(stack.AddWidget(a), "Add fixed widget");
+        TEST_ASSERT(stack.AddWidget(b), "Add growing widget");
+        TEST_ASSERT(stack.AddWidget(c, 0.0f, layout::CrossAlign::Center), "Add centered widget");
+
+        stack.SetParentRect({ 0.0f, 0.0f, 200.0f, 300.0f });
+        stack.PerformLayout();
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(0.0f, 0.0f, 200.0f, 40.0f), "Fixed widget stretched on cross axis");
+        TEST_ASSERT(b->GetRect() == sz_ds::Rect(0.0f, 50.0f, 200.0f, 200.0f), "Growing widget takes free space");
+        TEST_ASSERT(c->GetRect() == sz_ds::Rect(60.0f, 260.0f, 80.0f, 40.0f), "Centered widget");
+        TEST_EQUAL(stack.GetMeasureCount(), (uint64_t)3, "Each widget measured once");
+
+        // 可用尺寸不变，只移动位置时测量全部命中缓存
+        stack.SetParentRect({ 10.0f, 10.0f, 200.0f, 300.0f });
+        stack.PerformLayout();
+        TEST_EQUAL(stack.GetMeasureCount(), (uint64_t)3, "Move reuses measure cache");
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(10.0f, 10.0f, 200.0f, 40.0f), "Arrange after move");
+
+        // 只重新测量约束变化的控件
+        c->SetDisireWH(100, 40);
+        stack.InvalidateWidget(c.get());
+        TEST_ASSERT(stack.IsDirty(), "Layout dirty after invalidate");
+        stack.PerformLayout();
+        TEST_EQUAL(stack.GetMeasureCount(), (uint64_t)4, "Only invalidated widget measured");
+        TEST_ASSERT(c->GetRect() == sz_ds::Rect(60.0f, 270.0f, 100.0f, 40.0f), "Invalidated widget relayout");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_GridLayout
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 测试网格布局
+    int Test_GridLayout(int argc, char* argv[])
+    {
+        print_section("Test_GridLayout");
+
+        // 固定、比例和自适应轨道
+        layout::GridLayout grid({ layout::GridTrack::Fixed(100.0f), layout::GridTrack::Fraction(1.0f),
+            layout::GridTrack::Fraction(2.0f) }, { layout::GridTrack::Auto(), layout::GridTrack::Fraction(1.0f) });
+        auto a = MakeWidget<widget::UIButton>("GridA", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 30);
+        auto b = MakeWidget<widget::UIButton>("GridB", layout::AnchorPoint::TopLeft, layout::Margins(5.0f), 0, 50);
+        auto c = MakeWidget<widget::UIButton>("GridC", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 0);
+        a->setChildIdForUIManager(1);
+        b->setChildIdForUIManager(2);
+        c->setChildIdForUIManager(3);
+        TEST_ASSERT(grid.AddWidget(a), "Auto place first cell");
+        TEST_ASSERT(grid.AddWidget(b), "Auto place second cell");
+        TEST_ASSERT(grid.AddWidget(c, 1, 1, 1, 2), "Place spanning widget");
+        TEST_ASSERT(!grid.AddWidget(c, 1, 0), "Reject duplicate widget");
+
+        grid.SetParentRect({ 0.0f, 0.0f, 400.0f, 300.0f });
+        grid.PerformLayout();
+        TEST_EQUAL(grid.GetColumnOffset(1), 100.0f, "Fixed column");
+        TEST_EQUAL(grid.GetColumnOffset(2), 200.0f, "Fraction column");
+        TEST_EQUAL(grid.GetColumnOffset(3), 400.0f, "Total width");
+        TEST_EQUAL(grid.GetRowOffset(1), 60.0f, "Auto row fits content with margins");
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(0.0f, 0.0f, 100.0f, 60.0f), "Widget fills cell");
+        TEST_ASSERT(b->GetRect() == sz_ds::Rect(105.0f, 5.0f, 90.0f, 50.0f), "Cell inset by margins");
+        TEST_ASSERT(c->GetRect() == sz_ds::Rect(100.0f, 60.0f, 300.0f, 240.0f), "Spanning widget");
+
+        // 只改变一列，只重新计算列偏移
+        grid.SetColumn(0, layout::GridTrack::Fixed(40.0f));
+        TEST_ASSERT(grid.IsDirty(), "Layout dirty after column change");
+        grid.PerformLayout();
+        TEST_EQUAL(grid.GetColumnOffset(2), 160.0f, "Fraction columns take freed space");
+        TEST_ASSERT(c->GetRect() == sz_ds::Rect(40.0f, 60.0f, 360.0f, 240.0f), "Relayout after column change");
+
+        // 自适应行跟随内容
+        b->SetDisireWH(0, 80);
+        grid.InvalidateWidget(b.get());
+        grid.PerformLayout();
+        TEST_EQUAL(grid.GetRowOffset(1), 90.0f, "Auto row grows with content");
+
+        // 百分比边距在统计自适应尺寸和摆放时使用同一个基准，控件尺寸等于期望尺寸
+        layout::GridLayout percent({ layout::GridTrack::Auto(), layout::GridTrack::Fraction(1.0f) }, { layout::GridTrack::Auto() });
+        auto p = MakeWidget<widget::UIButton>("GridP", layout::AnchorPoint::TopLeft,
+            layout::Margins::Percentage(5.0f, 10.0f, 5.0f, 10.0f), 60, 20);
+        p->setChildIdForUIManager(4);
+        percent.AddWidget(p);
+        percent.SetParentRect({ 0.0f, 0.0f, 400.0f, 200.0f });
+        percent.PerformLayout();
+        TEST_EQUAL(percent.GetColumnOffset(1), 100.0f, "Auto column includes percentage margins");
+        TEST_ASSERT(p->GetRect() == sz_ds::Rect(20.0f, 20.0f, 60.0f, 20.0f), "Arranged size matches measured size");
+        percent.SetParentRect({ 0.0f, 0.0f, 800.0f, 200.0f });
+        percent.PerformLayout();
+        TEST_EQUAL(percent.GetColumnOffset(1), 140.0f, "Auto column remeasured on parent resize");
+        TEST_ASSERT(p->GetRect() == sz_ds::Rect(40.0f, 20.0f, 60.0f, 20.0f), "Size stable after parent resize");
+
+        TEST_ASSERT(grid.DelWidget(c), "Delete widget");
+        TEST_ASSERT(!grid.DelWidget(c), "Delete missing widget");
+
+        // 只摆放可见区域内的单元格
+        const uint32_t rows = 1000;
+        const uint32_t cols = 4;
+        layout::GridLayout big(std::vector<layout::GridTrack>(cols, layout::GridTrack::Fraction(1.0f)), {});
+        big.SetImplicitRow(layout::GridTrack::Fixed(20.0f));
+        std::vector<std::shared_ptr<widget::UIButton>> cells;
+        for (uint32_t i = 0; i < rows * cols; ++i)
+        {
+            auto cell = MakeWidget<widget::UIButton>("GridCell", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 0);
+            cell->setChildIdForUIManager(100 + i);
+            big.AddWidget(cell);
+            cells.push_back(cell);
+        }
+        TEST_EQUAL(big.GetRowCount(), (size_t)rows, "Implicit rows appended");
+
+        big.SetParentRect({ 0.0f, 0.0f, 400.0f, 600.0f });
+        big.SetVisibleRect({ 0.0f, 0.0f, 400.0f, 100.0f });
+        big.PerformLayout();
+        TEST_EQUAL(big.GetArrangedCount(), (size_t)(5 * cols), "Only visible rows arranged");
+        TEST_ASSERT(cells[0]->IsVisible(), "Visible cell shown");
+        TEST_ASSERT(!cells[5 * cols]->IsVisible(), "Offscreen cell culled");
+
+        // 滚动后旧单元格剔除，新单元格摆放
+        big.SetVisibleRect({ 0.0f, 10000.0f, 400.0f, 100.0f });
+        big.PerformLayout();
+        TEST_EQUAL(big.GetArrangedCount(), (size_t)(5 * cols), "Scrolled rows arranged");
+        TEST_ASSERT(!cells[0]->IsVisible(), "Scrolled out cell culled");
+        TEST_ASSERT(cells[500 * cols]->IsVisible(), "Scrolled in cell shown");
+        TEST_ASSERT(cells[500 * cols]->GetRect() == sz_ds::Rect(0.0f, 10000.0f, 100.0f, 20.0f), "Scrolled in cell rect");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_ConstraintLayout
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+    using namespace sz_ds::solver;
+
+    // 横向排列count个等宽控件，返回约束布局
+    std::unique_ptr<layout::ConstraintLayout> buildChain(size_t count, uint64_t& nextId,
+        std::vector<std::shared_ptr<widget::UIButton>>& widgets)
+    {
+        auto chain = std::make_unique<layout::ConstraintLayout>();
+        const auto& parent = chain->GetParent();
+        const layout::ConstraintAnchors* first = nullptr;
+        const layout::ConstraintAnchors* prev = nullptr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto button = MakeWidget<widget::UIButton>("ChainCell", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 20);
+            button->setChildIdForUIManager(nextId++);
+            chain->AddWidget(button);
+            widgets.push_back(button);
+
+            const auto* anchors = chain->GetAnchors(button);
+            chain->AddConstraint(Expression(anchors->m_left) == (prev ? prev->Right() : Expression(parent.m_left)) + 2.0);
+            chain->AddConstraint(Expression(anchors->m_top) == Expression(parent.m_top) + 4.0);
+            if (first)
+            {
+                chain->AddConstraint(Expression(anchors->m_width) == first->m_width);
+            }
+            first = first ? first : anchors;
+            prev = anchors;
+        }
+        chain->AddConstraint(prev->Right() == parent.Right() - 2.0);
+        return chain;
+    }
+
+    // 测试约束布局
+    int Test_ConstraintLayout(int argc, char* argv[])
+    {
+        print_section("Test_ConstraintLayout");
+
+        // A的右边缘等于B的左边缘减8
+        layout::ConstraintLayout layout;
+        auto a = MakeWidget<widget::UIButton>("ConstraintA", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 40);
+        auto b = MakeWidget<widget::UIButton>("ConstraintB", layout::AnchorPoint::TopLeft, layout::Margins(0.0f), 0, 40);
+        a->setChildIdForUIManager(1);
+        b->setChildIdForUIManager(2);
+        TEST_ASSERT(layout.AddWidget(a), "Add widget A");
+        TEST_ASSERT(layout.AddWidget(b), "Add widget B");
+        TEST_ASSERT(!layout.AddWidget(a), "Reject duplicate widget");
+
+        const auto& parent = layout.GetParent();
+        const auto* ca = layout.GetAnchors(a);
+        const auto* cb = layout.GetAnchors(b);
+        TEST_ASSERT(ca && cb, "Get anchors");
+        TEST_ASSERT(layout.AddConstraint(Expression(ca->m_left) == Expression(parent.m_left) + 10.0) != 0, "Left edge");
+        TEST_ASSERT(layout.AddConstraint(ca->Right() == Expression(cb->m_left) - 8.0) != 0, "Gap between widgets");
+        TEST_ASSERT(layout.AddConstraint(cb->Right() == parent.Right() - 10.0) != 0, "Right edge");
+        auto equalWidth = layout.AddConstraint(Expression(ca->m_width) == cb->m_width);
+        TEST_ASSERT(equalWidth != 0, "Equal width");
+        TEST_EQUAL(layout.AddConstraint(Expression(ca->m_width) == -1.0), (ConstraintId)0, "Reject unsatisfiable constraint");
+
+        layout.SetParentRect({ 0.0f, 0.0f, 400.0f, 300.0f });
+        layout.PerformLayout();
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(10.0f, 0.0f, 186.0f, 40.0f), "Solve A");
+        TEST_ASSERT(b->GetRect() == sz_ds::Rect(204.0f, 0.0f, 186.0f, 40.0f), "Solve B");
+
+        // 缩放只修改编辑变量
+        layout.SetParentRect({ 0.0f, 20.0f, 600.0f, 300.0f });
+        layout.PerformLayout();
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(10.0f, 20.0f, 286.0f, 40.0f), "Resize A");
+        TEST_ASSERT(b->GetRect() == sz_ds::Rect(304.0f, 20.0f, 286.0f, 40.0f), "Resize B");
+
+        // 替换约束
+        TEST_ASSERT(layout.RemoveConstraint(equalWidth), "Remove constraint");
+        TEST_ASSERT(!layout.RemoveConstraint(equalWidth), "Remove missing constraint");
+        layout.AddConstraint(Expression(ca->m_width) == 100.0);
+        layout.PerformLayout();
+        TEST_ASSERT(b->GetRect() == sz_ds::Rect(118.0f, 20.0f, 472.0f, 40.0f), "B takes remaining width");
+
+        // 期望尺寸变化
+        b->SetDisireWH(0, 60);
+        layout.InvalidateWidget(b.get());
+        TEST_ASSERT(layout.IsDirty(), "Layout dirty after invalidate");
+        layout.PerformLayout();
+        TEST_EQUAL(b->GetRect().m_height, 60.0f, "Desired height");
+
+        // 删除控件同时删除引用它的约束
+        const size_t before = layout.GetConstraintCount();
+        TEST_ASSERT(layout.DelWidget(b), "Delete widget");
+        TEST_ASSERT(layout.GetConstraintCount() < before, "Constraints of deleted widget removed");
+        layout.PerformLayout();
+        TEST_ASSERT(a->GetRect() == sz_ds::Rect(10.0f, 20.0f, 100.0f, 40.0f), "Remaining widget keeps constraints");
+
+        // 1k约束持续缩放，每帧只修改编辑变量
+        const size_t count = 125;
+        const int frames = 20;
+        uint64_t nextId = 100;
+        std::vector<std::shared_ptr<widget::UIButton>> widgets;
+        auto chain = buildChain(count, nextId, widgets);
+        TEST_ASSERT(chain->GetConstraintCount() >= 1000, "Chain has 1k constraints");
+        auto frameRect = [](int i) { return sz_ds::Rect(0.0f, 0.0f, 1600.0f + (i % 50) * 8.0f, 900.0f); };
+        for (int i = 0; i <= frames; ++i)
+        {
+            chain->SetParentRect(frameRect(i));
+            chain->PerformLayout();
+        }
+        const float expected = (frameRect(frames).m_width - 2.0f * (count + 1)) / count;
+        TEST_ASSERT(sz_ds::float_equal(widgets.back()->GetRect().m_width, expected, 0.01f), "Chain width after resize");
+        TEST_ASSERT(sz_ds::float_equal(widgets.back()->GetRect().m_x + expected + 2.0f, frameRect(frames).m_width, 0.01f),
+            "Chain fills parent");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_ParallelLayout
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 构建panels个面板，每个面板rows行cols列按钮，返回所有控件
+    std::vector<std::shared_ptr<IUIBase>> buildPanels(std::shared_ptr<UIManager> manager,
+        size_t panels, size_t rows, size_t cols)
+    {
+        std::vector<std::shared_ptr<IUIBase>> widgets;
+        const float panelPct = 100.0f / panels;
+        for (size_t p = 0; p < panels; ++p)
+        {
+            auto panel = MakeWidget<widget::UIFrame>("Panel" + std::to_string(p), layout::AnchorPoint::Fill,
+                layout::Margins::Percentage(p * panelPct, 0.0f, 100.0f - (p + 1) * panelPct, 0.0f), 0, 0);
+            manager->RegTopUI(panel);
+            manager->LayoutAddWidget(panel);
+            panel->SetLayout(new layout::AnchorLayout());
+            widgets.push_back(panel);
+
+            // 面板内一半是按钮，一半是嵌套边框里的按钮
+            auto inner = MakeWidget<widget::UIFrame>("Inner" + std::to_string(p), layout::AnchorPoint::Fill,
+                layout::Margins::Percentage(0.0f, 50.0f, 0.0f, 0.0f), 0, 0);
+            inner->SetParent(panel);
+            panel->AddWidget(inner);
+            inner->SetLayout(new layout::AnchorLayout());
+            widgets.push_back(inner);
+
+            for (size_t r = 0; r < rows; ++r)
+            {
+                for (size_t c = 0; c < cols; ++c)
+                {
+                    auto owner = r % 2 == 0 ? panel : inner;
+                    auto button = MakeWidget<widget::UIButton>("Cell" + std::to_string(p) + "_" + std::to_string(r) + "_" + std::to_string(c),
+                        r % 3 == 0 ? layout::AnchorPoint::TopLeft : layout::AnchorPoint::Center,
+                        layout::Margins::Mixed(c * 2.0f, true, r * 0.5f, true, 0.0f, false, 0.0f, false),
+                        10, c % 4 == 0 ? 0 : 8);
+                    button->SetParent(owner);
+                    owner->AddWidget(button);
+                    widgets.push_back(button);
+                }
+            }
+        }
+        return widgets;
+    }
+
+    // 记录布局所在线程的边框
+    class ThreadRecordFrame : public widget::UIFrame
+    {
+    public:
+        using widget::UIFrame::UIFrame;
+
+        void UpdateLayout() override
+        {
+            m_threadId = std::this_thread::get_id();
+            // 调用线程占住一个子树，另一个子树只能由工作线程领取
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            widget::UIFrame::UpdateLayout();
+        }
+
+        std::thread::id m_threadId;
+    };
+
+    // 测试并行布局
+    int Test_ParallelLayout(int argc, char* argv[])
+    {
+        print_section("Test_ParallelLayout");
+
+        // 任务池
+        {
+            sz_ds::TaskPool pool(3);
+            TEST_EQUAL(pool.GetWorkerCount(), (size_t)3, "Worker count");
+            std::vector<int> hits(10000, 0);
+            for (int round = 0; round < 100; ++round)
+            {
+                pool.ParallelFor(hits.size(), [&hits](size_t i) { ++hits[i]; });
+            }
+            TEST_ASSERT(std::all_of(hits.begin(), hits.end(), [](int n) { return n == 100; }), "Every index runs once per call");
+
+            std::atomic<size_t> nested = 0;
+            pool.ParallelFor(8, [&pool, &nested](size_t) {
+                pool.ParallelFor(4, [&nested](size_t) { ++nested; });
+            });
+            TEST_EQUAL(nested.load(), (size_t)32, "Nested call runs serially");
+
+            // 异步任务由工作线程执行，和ParallelFor交替提交
+            std::atomic<size_t> posted = 0;
+            std::atomic<bool> onWorker = true;
+            const auto mainThread = std::this_thread::get_id();
+            for (int i = 0; i < 64; ++i)
+            {
+                pool.Post([&posted, &onWorker, mainThread]() {
+                    onWorker = onWorker && std::this_thread::get_id() != mainThread;
+                    ++posted;
+                });
+                pool.ParallelFor(16, [&hits](size_t i) { ++hits[i]; });
+            }
+            for (int wait = 0; wait < 1000 && posted < 64; ++wait)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            TEST_EQUAL(posted.load(), (size_t)64, "Every posted task runs");
+            TEST_ASSERT(onWorker.load(), "Posted tasks run on workers");
+        }
+
+        // 同一棵树串行和并行布局结果完全一致
+        const size_t panels = 8;
+        const size_t rows = 40;
+        const size_t cols = 50;
+        auto serial = std::make_shared<UIManager>(nullptr);
+        auto parallel = std::make_shared<UIManager>(nullptr);
+        serial->SetLayout(new layout::AnchorLayout());
+        parallel->SetLayout(new layout::AnchorLayout());
+        parallel->SetParallelLayout(sz_ds::TaskPool::DefaultWorkerCount() > 0 ? sz_ds::TaskPool::DefaultWorkerCount() : 1, 256);
+        auto serialWidgets = buildPanels(serial, panels, rows, cols);
+        auto parallelWidgets = buildPanels(parallel, panels, rows, cols);
+        TEST_EQUAL(parallelWidgets.size(), serialWidgets.size(), "Same tree");
+
+        auto sameRects = [&]() {
+            for (size_t i = 0; i < serialWidgets.size(); ++i)
+            {
+                if (!(serialWidgets[i]->GetRect() == parallelWidgets[i]->GetRect()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto relayout = [](std::shared_ptr<UIManager>& manager, int width, int height) {
+            manager->Init(width, height);
+            manager->RunBeforWork();
+        };
+
+        relayout(serial, 3840, 2160);
+        relayout(parallel, 3840, 2160);
+        TEST_ASSERT(sameRects(), "Initial layout identical");
+        relayout(serial, 2560, 1440);
+        relayout(parallel, 2560, 1440);
+        TEST_ASSERT(sameRects(), "Resized layout identical");
+
+        // 两个面板内的约束变化，两个面板是互不包含的脏子树
+        const size_t perPanel = 2 + rows * cols;
+        for (size_t index : { (size_t)5, 3 * perPanel + 7 })
+        {
+            std::static_pointer_cast<UIBase>(serialWidgets[index])->SetMargins(layout::Margins(3.0f));
+            std::static_pointer_cast<UIBase>(parallelWidgets[index])->SetMargins(layout::Margins(3.0f));
+        }
+        relayout(serial, 2560, 1440);
+        relayout(parallel, 2560, 1440);
+        TEST_ASSERT(sameRects(), "Constraint change identical");
+
+        // 4K窗口持续缩放
+        for (int i = 0; i < 4; ++i)
+        {
+            relayout(serial, 3840 - (i % 2) * 40, 2160 - (i % 2) * 20);
+            relayout(parallel, 3840 - (i % 2) * 40, 2160 - (i % 2) * 20);
+        }
+        TEST_ASSERT(sameRects(), "Continuous resize identical");
+
+        // 阈值按后代总数计算，直接子组件很少但后代很多的子树也并行
+        {
+            auto manager = std::make_shared<UIManager>(nullptr);
+            manager->SetLayout(new layout::AnchorLayout());
+            manager->SetParallelLayout(1, 64);
+            std::vector<std::shared_ptr<ThreadRecordFrame>> roots;
+            for (size_t p = 0; p < 2; ++p)
+            {
+                auto root = MakeWidget<ThreadRecordFrame>("DeepRoot" + std::to_string(p), layout::AnchorPoint::Fill,
+                    layout::Margins::Percentage(p * 50.0f, 0.0f, 50.0f - p * 50.0f, 0.0f), 0, 0);
+                manager->RegTopUI(root);
+                manager->LayoutAddWidget(root);
+                root->SetLayout(new layout::AnchorLayout());
+                auto inner = MakeWidget<widget::UIFrame>("DeepInner" + std::to_string(p), layout::AnchorPoint::Fill,
+                    layout::Margins(2.0f), 0, 0);
+                inner->SetParent(root);
+                root->AddWidget(inner);
+                inner->SetLayout(new layout::AnchorLayout());
+                for (size_t i = 0; i < 100; ++i)
+                {
+                    auto button = MakeWidget<widget::UIButton>("DeepCell" + std::to_string(p) + "_" + std::to_string(i),
+                        layout::AnchorPoint::TopLeft, layout::Margins(float(i), 0.0f, 0.0f, 0.0f), 10, 10);
+                    button->SetParent(inner);
+                    inner->AddWidget(button);
+                }
+                roots.push_back(root);
+            }
+            manager->Init(800, 600);
+            manager->RunBeforWork();
+            TEST_ASSERT(roots[0]->m_threadId != roots[1]->m_threadId, "Deep subtrees with one child laid out in parallel");
+        }
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_MPSCQueue
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试多生产者单消费者队列
+    int Test_MPSCQueue(int argc, char* argv[])
+    {
+        print_section("Test_MPSCQueue");
+
+        MPSCQueue<int> simple(2);
+        int value = 0;
+        TEST_ASSERT(!simple.TryPop(value), "Empty queue");
+        for (int i = 1; i <= 5; ++i)
+        {
+            simple.Push(i);
+        }
+        bool ordered = true;
+        for (int i = 1; i <= 5; ++i)
+        {
+            ordered = ordered && simple.TryPop(value) && value == i;
+        }
+        TEST_ASSERT(ordered, "FIFO beyond pool capacity");
+        TEST_ASSERT(!simple.TryPop(value), "Drained queue");
+
+        // 多个生产者投递闭包，消费者同时执行，每个生产者内部保持顺序
+        const int producers = 4;
+        const int perProducer = 200000;
+        using Task = Delegate<void>;
+        MPSCQueue<Task> tasks(256);
+        std::vector<int> lastSeq(producers, -1);
+        bool inOrder = true;
+        int executed = 0;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&tasks, &lastSeq, &inOrder, &executed, p, perProducer]() {
+                for (int i = 0; i < perProducer; ++i)
+                {
+                    Task task;
+                    task.Bind([&lastSeq, &inOrder, &executed, p, i]() {
+                        inOrder = inOrder && lastSeq[p] + 1 == i;
+                        lastSeq[p] = i;
+                        ++executed;
+                    });
+                    tasks.Push(std::move(task));
+                }
+            });
+        }
+
+        Task task;
+        while (executed < producers * perProducer)
+        {
+            if (tasks.TryPop(task))
+            {
+                task();
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        TEST_EQUAL(executed, producers * perProducer, "Every task executed once");
+        TEST_ASSERT(inOrder, "Per-producer order kept");
+        TEST_ASSERT(!tasks.TryPop(task), "Queue empty after drain");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_MulticastDelegate
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试多播委托
+    int Test_MulticastDelegate(int argc, char* argv[])
+    {
+        print_section("Test_MulticastDelegate");
+
+        // 可平凡拷贝和需要管理的可调用对象
+        int base = 3;
+        Delegate<int, int> trivial;
+        trivial.Bind([&base](int x) { return base + x; });
+        auto shared = std::make_shared<int>(5);
+        Delegate<int, int> managed;
+        managed.Bind([shared](int x) { return *shared + x; });
+        TEST_EQUAL(shared.use_count(), 2L, "Managed callable captured");
+        {
+            Delegate<int, int> copy = managed;
+            TEST_EQUAL(shared.use_count(), 3L, "Managed copy constructs");
+            Delegate<int, int> moved = std::move(copy);
+            TEST_ASSERT(!copy && moved, "Moved-from delegate is empty");
+            TEST_EQUAL(moved(1) + trivial(1), 10, "Invoke after move");
+        }
+        TEST_EQUAL(shared.use_count(), 2L, "Managed copies destroyed");
+        managed.Reset();
+        TEST_EQUAL(shared.use_count(), 1L, "Reset destroys callable");
+
+        // 多播
+        MulticastDelegate<int> multicast;
+        int total = 0;
+        int calls = 0;
+        MulticastDelegate<int>::HandlerId selfId = 0;
+        multicast.Add([&total](int x) { total += x; });
+        selfId = multicast.Add([&multicast, &selfId, &calls](int) {
+            ++calls;
+            // 调用过程中删除自身并添加新的绑定
+            multicast.Remove(selfId);
+            multicast.Add([&calls](int) { calls += 10; });
+        });
+        multicast(2);
+        TEST_EQUAL(total, 2, "First handler called");
+        TEST_EQUAL(calls, 1, "Handler added during invoke waits for next call");
+        TEST_EQUAL(multicast.GetCount(), size_t(2), "Self removal applied after invoke");
+        multicast(3);
+        TEST_EQUAL(total, 5, "First handler called again");
+        TEST_EQUAL(calls, 11, "Removed handler not called, added handler called");
+        multicast.Clear();
+        TEST_ASSERT(!multicast, "Cleared");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_LatencyTracker
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 测试时钟，单位纳秒
+    uint64_t g_fakeNow = 0;
+    uint64_t fakeClock() { return g_fakeNow; }
+    constexpr uint64_t MS = 1000000;
+
+    // 测试输入延迟统计
+    int Test_LatencyTracker(int argc, char* argv[])
+    {
+        print_section("Test_LatencyTracker");
+
+        LatencyTracker tracker(4);
+        tracker.SetClock(&fakeClock);
+
+        // 事件在1ms产生，2ms开始处理，3ms处理完，5ms帧开始，9ms呈现
+        g_fakeNow = 2 * MS;
+        tracker.OnInputBegin(1 * MS);
+        g_fakeNow = 3 * MS;
+        tracker.OnInputEnd();
+        g_fakeNow = 5 * MS;
+        tracker.OnFrameBegin();
+        g_fakeNow = 9 * MS;
+        tracker.OnFramePresented();
+        TEST_EQUAL(tracker.GetSamples().size(), size_t(1), "One sample recorded");
+        const auto& sample = tracker.GetSamples()[0];
+        TEST_EQUAL(sample.m_queueMs, 1.0, "Queue delay");
+        TEST_EQUAL(sample.m_waitMs, 2.0, "Wait for frame");
+        TEST_EQUAL(sample.m_frameMs, 4.0, "Frame time");
+        TEST_EQUAL(sample.m_totalMs, 8.0, "End to end");
+
+        // 没有输入的帧不记录
+        tracker.OnFrameBegin();
+        g_fakeNow = 10 * MS;
+        tracker.OnFramePresented();
+        TEST_EQUAL(tracker.GetStats().m_count, uint64_t(1), "Idle frame ignored");
+
+        // 同一帧反映多个输入，时间戳为0时视为当前时间，超出容量时覆盖最旧的
+        for (uint64_t i = 0; i < 5; ++i)
+        {
+            g_fakeNow = (20 + i) * MS;
+            tracker.OnInputBegin(i == 0 ? 0 : (10 + i) * MS);
+            tracker.OnInputEnd();
+        }
+        g_fakeNow = 30 * MS;
+        tracker.OnFrameBegin();
+        g_fakeNow = 32 * MS;
+        tracker.OnFramePresented();
+        auto stats = tracker.GetStats();
+        TEST_EQUAL(stats.m_count, uint64_t(6), "All inputs counted");
+        TEST_EQUAL(tracker.GetSamples().size(), size_t(4), "Samples capped at capacity");
+        TEST_EQUAL(stats.m_maxMs, 21.0, "Oldest remaining input");
+        TEST_EQUAL(stats.m_frameMedianMs, 2.0, "Frame median");
+
+        // UI管理器处理的输入进入跟踪
+        auto manager = std::make_shared<UIManager>(nullptr);
+        manager->SetLayout(new layout::AnchorLayout());
+        manager->GetLatencyTracker().SetClock(&fakeClock);
+        SDL_Event event{};
+        event.type = SDL_EVENT_MOUSE_MOTION;
+        event.common.timestamp = 31 * MS;
+        manager->HandleEvent(&event);
+        event.type = SDL_EVENT_KEY_DOWN;
+        manager->HandleEvent(&event);
+        manager->GetLatencyTracker().OnFrameBegin();
+        manager->GetLatencyTracker().OnFramePresented();
+        TEST_EQUAL(manager->GetLatencyTracker().GetStats().m_count, uint64_t(1), "Only handled events tracked");
+        TEST_EQUAL(manager->GetLatencyTracker().GetStats().m_medianMs, 1.0, "Event timestamp used");
+
+        tracker.Reset();
+        TEST_EQUAL(tracker.GetStats().m_count, uint64_t(0), "Reset");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_RangeAllocator
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试区间分配器
+    int Test_RangeAllocator(int argc, char* argv[])
+    {
+        print_section("Test_RangeAllocator");
+
+        RangeAllocator allocator(100);
+        size_t a = allocator.Allocate(10);
+        size_t b = allocator.Allocate(20);
+        size_t c = allocator.Allocate(30);
+        TEST_EQUAL(a, size_t(0), "First range at start");
+        TEST_EQUAL(b, size_t(10), "Ranges are contiguous");
+        TEST_EQUAL(c, size_t(30), "Ranges are contiguous");
+        TEST_EQUAL(allocator.Allocate(50), RangeAllocator::INVALID_OFFSET, "Out of space");
+        TEST_EQUAL(allocator.Allocate(0), RangeAllocator::INVALID_OFFSET, "Empty range");
+
+        // 释放中间区间后产生碎片，最佳适配取能放下的最小空闲区间
+        allocator.Free(a, 10);
+        allocator.Free(c, 30);
+        auto stats = allocator.GetStats();
+        TEST_EQUAL(stats.m_used, size_t(20), "Used after free");
+        TEST_EQUAL(stats.m_freeBlocks, size_t(2), "Head and merged tail are free");
+        TEST_EQUAL(stats.m_largestFree, size_t(70), "Tail merged with trailing space");
+        TEST_ASSERT(stats.GetFragmentation() > 0.0, "Fragmented");
+        TEST_EQUAL(allocator.Allocate(8), size_t(0), "Best fit picks smallest block");
+        allocator.Free(0, 8);
+
+        // 前后都合并后空闲空间连续
+        allocator.Free(b, 20);
+        stats = allocator.GetStats();
+        TEST_EQUAL(stats.m_freeBlocks, size_t(1), "Neighbours coalesced");
+        TEST_EQUAL(stats.m_largestFree, size_t(100), "Whole space free");
+        TEST_EQUAL(stats.GetFragmentation(), 0.0, "No fragmentation");
+        TEST_EQUAL(stats.m_liveCount, size_t(0), "No live ranges");
+
+        // 扩容与末尾空闲区间合并，已有区间不移动
+        size_t d = allocator.Allocate(100);
+        TEST_EQUAL(d, size_t(0), "Fill all");
+        allocator.Grow(150);
+        TEST_EQUAL(allocator.Allocate(50), size_t(100), "Grown space appended");
+        allocator.Free(100, 50);
+        allocator.Grow(200);
+        stats = allocator.GetStats();
+        TEST_EQUAL(stats.m_freeBlocks, size_t(1), "Grow merges free tail");
+        TEST_EQUAL(stats.m_largestFree, size_t(100), "Free tail size");
+        TEST_EQUAL(stats.m_growCount, uint64_t(2), "Grow count");
+        TEST_EQUAL(stats.GetUtilization(), 0.5, "Utilization");
+
+        // 合并多个分配器的统计
+        RangeAllocatorStats total;
+        total.Merge(stats);
+        total.Merge(RangeAllocator(10).GetStats());
+        TEST_EQUAL(total.m_capacity, size_t(210), "Merged capacity");
+        TEST_EQUAL(total.m_largestFree, size_t(100), "Merged largest free");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_ShelfPacker
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试货架装箱
+    int Test_ShelfPacker(int argc, char* argv[])
+    {
+        print_section("Test_ShelfPacker");
+
+        ShelfPacker packer(100, 100, 1);
+        int32_t x = -1;
+        int32_t y = -1;
+        TEST_ASSERT(packer.Allocate(10, 10, x, y) && x == 0 && y == 0, "First rect at origin");
+        TEST_ASSERT(packer.Allocate(10, 10, x, y) && x == 11 && y == 0, "Same shelf with padding");
+        TEST_ASSERT(packer.Allocate(20, 20, x, y) && x == 0 && y == 11, "Taller rect opens new shelf");
+        TEST_ASSERT(packer.Allocate(5, 5, x, y) && x == 22 && y == 0, "Best fit shelf");
+        TEST_ASSERT(packer.Allocate(4, 4, x, y) && x == 0 && y == 32, "Too much waste opens new shelf");
+        TEST_ASSERT(!packer.Allocate(100, 10, x, y), "Wider than page with padding");
+
+        // 填满剩余高度后只能放进已有货架
+        TEST_ASSERT(packer.Allocate(99, 60, x, y) && x == 0 && y == 37, "Fill remaining height");
+        TEST_ASSERT(packer.Allocate(50, 5, x, y) && x == 28 && y == 0, "Reuse first shelf");
+        TEST_ASSERT(!packer.Allocate(10, 30, x, y), "No shelf and no height left");
+        TEST_EQUAL(packer.GetShelfCount(), size_t(4), "Shelf count");
+        TEST_EQUAL(packer.GetUsedArea(), int64_t(6831), "Used area excludes padding");
+
+        packer.Reset();
+        TEST_EQUAL(packer.GetShelfCount(), size_t(0), "Reset clears shelves");
+        TEST_ASSERT(packer.Allocate(10, 10, x, y) && x == 0 && y == 0, "Allocate after reset");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_PixelConvert
+{
+    using namespace sz_test;
+    using namespace sz_utils;
+
+    // 测试像素转换，长度覆盖SIMD主循环和标量尾部
+    int Test_PixelConvert(int argc, char* argv[])
+    {
+        print_section("Test_PixelConvert");
+
+        bool rgbOk = true;
+        bool grayOk = true;
+        bool grayAlphaOk = true;
+        bool flipOk = true;
+        for (size_t pixels = 0; pixels <= 67; ++pixels)
+        {
+            std::vector<uint8_t> src(pixels * 4);
+            for (size_t i = 0; i < src.size(); ++i)
+            {
+                src[i] = uint8_t(i * 7 + pixels);
+            }
+            std::vector<uint8_t> dst(pixels * 4, 0);
+
+            ConvertToRGBA(src.data(), 3, dst.data(), pixels);
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                rgbOk = rgbOk && dst[i * 4] == src[i * 3] && dst[i * 4 + 1] == src[i * 3 + 1] &&
+                    dst[i * 4 + 2] == src[i * 3 + 2] && dst[i * 4 + 3] == 0xFF;
+            }
+
+            ConvertToRGBA(src.data(), 1, dst.data(), pixels);
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                grayOk = grayOk && dst[i * 4] == src[i] && dst[i * 4 + 1] == src[i] &&
+                    dst[i * 4 + 2] == src[i] && dst[i * 4 + 3] == 0xFF;
+            }
+
+            ConvertToRGBA(src.data(), 2, dst.data(), pixels);
+            for (size_t i = 0; i < pixels; ++i)
+            {
+                grayAlphaOk = grayAlphaOk && dst[i * 4] == src[i * 2] && dst[i * 4 + 1] == src[i * 2] &&
+                    dst[i * 4 + 2] == src[i * 2] && dst[i * 4 + 3] == src[i * 2 + 1];
+            }
+
+            // 按pixels字节一行，共5行
+            std::vector<uint8_t> image(pixels * 5);
+            for (size_t i = 0; i < image.size(); ++i)
+            {
+                image[i] = uint8_t(i * 13);
+            }
+            auto flipped = image;
+            FlipRowsVertically(flipped.data(), pixels, 5);
+            for (size_t row = 0; row < 5; ++row)
+            {
+                flipOk = flipOk && std::equal(flipped.begin() + row * pixels, flipped.begin() + (row + 1) * pixels,
+                    image.begin() + (4 - row) * pixels);
+            }
+        }
+        TEST_ASSERT(rgbOk, "RGB to RGBA");
+        TEST_ASSERT(grayOk, "Gray to RGBA");
+        TEST_ASSERT(grayAlphaOk, "Gray alpha to RGBA");
+        TEST_ASSERT(flipOk, "Flip rows");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_CoverageGrid
+{
+    using namespace sz_test;
+    using namespace sz_ds;
+
+    // 测试遮挡覆盖位图
+    int Test_CoverageGrid(int argc, char* argv[])
+    {
+        print_section("Test_CoverageGrid");
+
+        CoverageGrid grid(8.0f);
+        grid.Reset(100.0f, 60.0f);
+        TEST_EQUAL(grid.GetCols(), 13, "Cols round up");
+        TEST_EQUAL(grid.GetRows(), 8, "Rows round up");
+        TEST_ASSERT(!grid.IsCovered(AABB2D(glm::vec2(0, 0), glm::vec2(8, 8))), "Empty grid covers nothing");
+
+        // 只标记完全被覆盖的格子
+        grid.AddOccluder(AABB2D(glm::vec2(4, 4), glm::vec2(28, 20)));
+        TEST_EQUAL(grid.GetCoveredTileCount(), size_t(2), "Partial tiles not marked");
+        TEST_ASSERT(grid.IsCovered(AABB2D(glm::vec2(9, 9), glm::vec2(23, 15))), "Inside full tiles");
+        TEST_ASSERT(!grid.IsCovered(AABB2D(glm::vec2(5, 5), glm::vec2(20, 15))), "Touches partial tile");
+        TEST_ASSERT(!grid.IsCovered(AABB2D()), "Null box not covered");
+
+        // 贴着区域边缘的遮挡物覆盖边缘格子
+        grid.Reset(100.0f, 60.0f);
+        grid.AddOccluder(AABB2D(glm::vec2(-10, -10), glm::vec2(200, 200)));
+        TEST_EQUAL(grid.GetCoveredTileCount(), size_t(13 * 8), "Window sized occluder covers all");
+        TEST_ASSERT(grid.IsCovered(AABB2D(glm::vec2(90, 50), glm::vec2(100, 60))), "Edge tile covered");
+        TEST_ASSERT(grid.IsCovered(AABB2D(glm::vec2(90, 50), glm::vec2(150, 90))), "Clamped to window");
+        TEST_ASSERT(!grid.IsCovered(AABB2D(glm::vec2(120, 70), glm::vec2(150, 90))), "Outside window");
+
+        // 两个遮挡物拼起来覆盖
+        grid.Reset(100.0f, 60.0f);
+        grid.AddOccluder(AABB2D(glm::vec2(0, 0), glm::vec2(48, 32)));
+        grid.AddOccluder(AABB2D(glm::vec2(48, 0), glm::vec2(96, 32)));
+        TEST_ASSERT(grid.IsCovered(AABB2D(glm::vec2(10, 10), glm::vec2(90, 30))), "Union of occluders");
+        TEST_ASSERT(!grid.IsCovered(AABB2D(glm::vec2(10, 10), glm::vec2(90, 40))), "Below union");
+        grid.AddOccluder(AABB2D(glm::vec2(0, 0), glm::vec2(48, 32)));
+        TEST_EQUAL(grid.GetCoveredTileCount(), size_t(12 * 4), "Overlap counted once");
+
+        // 跨越64位字边界
+        grid.Reset(1024.0f, 16.0f);
+        grid.AddOccluder(AABB2D(glm::vec2(480, 0), glm::vec2(560, 16)));
+        TEST_ASSERT(grid.IsCovered(AABB2D(glm::vec2(480, 0), glm::vec2(560, 16))), "Across word boundary");
+        TEST_ASSERT(!grid.IsCovered(AABB2D(glm::vec2(470, 0), glm::vec2(560, 16))), "Left of word boundary");
+        TEST_EQUAL(grid.GetCoveredTileCount(), size_t(20), "Word boundary tile count");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_ResizeCoalescer
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    SDL_Event makeResize(int width, int height, uint64_t timestamp = 0)
+    {
+        SDL_Event event{};
+        event.type = SDL_EVENT_WINDOW_RESIZED;
+        event.common.timestamp = timestamp;
+        event.window.data1 = width;
+        event.window.data2 = height;
+        return event;
+    }
+
+    // 测试窗口大小改变合并
+    int Test_ResizeCoalescer(int argc, char* argv[])
+    {
+        print_section("Test_ResizeCoalescer");
+
+        ResizeCoalescer coalescer;
+        SDL_Event event{};
+        TEST_ASSERT(!coalescer.IsPending(), "Nothing pending initially");
+        TEST_ASSERT(!coalescer.Take(event), "Take without resize");
+
+        // 一帧内多次改变只保留最后一次
+        coalescer.Push(makeResize(800, 600));
+        coalescer.Push(makeResize(820, 610));
+        coalescer.Push(makeResize(840, 620));
+        TEST_ASSERT(coalescer.IsPending(), "Pending after push");
+        TEST_ASSERT(coalescer.Take(event), "Take pending resize");
+        TEST_EQUAL(event.window.data1, 840, "Last width kept");
+        TEST_EQUAL(event.window.data2, 620, "Last height kept");
+        TEST_EQUAL(coalescer.GetCoalescedCount(), (uint64_t)2, "Earlier resizes dropped");
+        TEST_ASSERT(!coalescer.Take(event), "Taken only once per frame");
+
+        // 下一帧单次改变不算合并
+        coalescer.Push(makeResize(900, 700));
+        TEST_ASSERT(coalescer.Take(event), "Take next frame");
+        TEST_EQUAL(event.window.data1, 900, "Next frame width");
+        TEST_EQUAL(coalescer.GetCoalescedCount(), (uint64_t)2, "Single resize not coalesced");
+
+        // 合并后的事件驱动一次布局，结果和逐个处理一致
+        auto manager = std::make_shared<UIManager>(nullptr);
+        manager->SetLayout(new layout::AnchorLayout());
+        auto frame = MakeWidget<widget::UIFrame>("Root", layout::AnchorPoint::Fill, layout::Margins(10.0f), 0, 0);
+        manager->RegTopUI(frame);
+        manager->LayoutAddWidget(frame);
+        manager->Init(800, 600);
+        manager->RunBeforWork();
+        for (int i = 1; i <= 20; ++i)
+        {
+            coalescer.Push(makeResize(800 + i * 10, 600 + i * 5));
+        }
+        TEST_ASSERT(coalescer.Take(event), "Take after drag");
+        manager->HandleEvent(&event);
+        manager->RunBeforWork();
+        TEST_ASSERT(frame->GetRect() == sz_ds::Rect(10.0f, 10.0f, 980.0f, 680.0f), "Layout uses last size");
+        TEST_EQUAL(coalescer.GetCoalescedCount(), (uint64_t)21, "Drag coalesced to one event");
+
+        // 延迟从本帧第一次改变算起
+        constexpr uint64_t MS = 1000000;
+        static uint64_t now = 0;
+        manager->GetLatencyTracker().SetClock([]() { return now; });
+        manager->GetLatencyTracker().Reset();
+        coalescer.Push(makeResize(900, 700, 10 * MS));
+        coalescer.Push(makeResize(910, 705, 20 * MS));
+        coalescer.Push(makeResize(920, 710, 30 * MS));
+        TEST_ASSERT(coalescer.Take(event), "Take timed drag");
+        TEST_EQUAL(event.common.timestamp, 10 * MS, "Timestamp of first resize");
+        TEST_EQUAL(event.window.data1, 920, "Width of last resize");
+        now = 40 * MS;
+        manager->HandleEvent(&event);
+        manager->GetLatencyTracker().OnFrameBegin();
+        now = 50 * MS;
+        manager->GetLatencyTracker().OnFramePresented();
+        TEST_EQUAL(manager->GetLatencyTracker().GetStats().m_count, (uint64_t)1, "Resize recorded once");
+        TEST_EQUAL(manager->GetLatencyTracker().GetSamples()[0].m_totalMs, 40.0, "Latency from first resize");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_Occlusion
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 记录准备次数，可以在准备时移动自己，模拟列表滚动后重新绑定行
+    class PrepareCounter : public widget::UIButton
+    {
+    public:
+        using widget::UIButton::UIButton;
+
+        void OnPrepareRenderData() override
+        {
+            ++m_prepareCount;
+            if (m_moveOnPrepare)
+            {
+                m_moveOnPrepare = false;
+                SetRect({ 320.0f, 320.0f, 96.0f, 64.0f });
+            }
+        }
+
+        int m_prepareCount = 0;
+        bool m_moveOnPrepare = false;
+    };
+
+    // 测试遮挡剔除，组件没有变化时沿用上次结果，Z值、矩形和可见性变化后重新计算
+    int Test_Occlusion(int argc, char* argv[])
+    {
+        print_section("Test_Occlusion");
+
+        auto render = std::make_shared<NullRender>();
+        render->BuildTrueType("");
+        auto manager = std::make_shared<UIManager>(render);
+        manager->SetLayout(new layout::AnchorLayout());
+        auto below = MakeWidget<widget::UIButton>("Below", layout::AnchorPoint::TopLeft, layout::Margins(16.0f), 96, 64);
+        auto above = MakeWidget<widget::UIButton>("Above", layout::AnchorPoint::TopLeft, layout::Margins(16.0f), 96, 64);
+        above->SetZValue(1.0f);
+        for (auto& button : { below, above })
+        {
+            manager->RegTopUI(button);
+            manager->LayoutAddWidget(button);
+        }
+        manager->Init(800, 600);
+        manager->RunBeforWork();
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(1), "Lower button occluded");
+        TEST_ASSERT(below->HasUIFlag(UIFlag::Occluded), "Lower button flagged");
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(1), "Unchanged frame reuses result");
+        TEST_ASSERT(below->HasUIFlag(UIFlag::Occluded), "Flag kept on unchanged frame");
+
+        // 交换Z值
+        below->SetZValue(2.0f);
+        manager->Render();
+        TEST_ASSERT(above->HasUIFlag(UIFlag::Occluded) && !below->HasUIFlag(UIFlag::Occluded), "Z change re-sorts");
+
+        // 移开后不再遮挡
+        below->SetRect({ 320.0f, 320.0f, 96.0f, 64.0f });
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(0), "Moved button uncovers");
+        TEST_ASSERT(!above->HasUIFlag(UIFlag::Occluded), "Flag cleared after move");
+
+        // 隐藏上层后不再遮挡
+        below->SetRect({ 16.0f, 16.0f, 96.0f, 64.0f });
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(1), "Moved back covers");
+        below->ClearUIFlag(UIFlag::Visibale);
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(0), "Hidden occluder ignored");
+        TEST_ASSERT(!above->HasUIFlag(UIFlag::Occluded), "Flag cleared after hide");
+        below->SetUIFlag(UIFlag::Visibale);
+        manager->Render();
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(1), "Shown occluder covers");
+
+        // 准备时改了矩形，本帧重新计算，每个组件仍然只准备一次
+        auto counter = MakeWidget<PrepareCounter>("Counter", layout::AnchorPoint::TopLeft, layout::Margins(16.0f), 96, 64);
+        counter->SetZValue(3.0f);
+        manager->RegTopUI(counter);
+        counter->SetRect({ 16.0f, 16.0f, 96.0f, 64.0f });
+        manager->Render();
+        TEST_EQUAL(counter->m_prepareCount, 1, "Prepared once on first frame");
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(2), "Counter covers both buttons");
+        manager->Render();
+        TEST_EQUAL(counter->m_prepareCount, 2, "Prepared once on unchanged frame");
+        counter->m_moveOnPrepare = true;
+        manager->Render();
+        TEST_EQUAL(counter->m_prepareCount, 3, "Prepared once when prepare dirties occlusion");
+        TEST_EQUAL(manager->GetFrameStats().m_occludedWidgets, uint32_t(1), "Move during prepare applied this frame");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
+namespace Test_VertexPosition
+{
+    using namespace sz_test;
+    using namespace sz_gui;
+
+    // 测试顶点位置定点数，4K贴图不越界，过长的文字按最大区域排版
+    int Test_VertexPosition(int argc, char* argv[])
+    {
+        print_section("Test_VertexPosition");
+
+        // 文字精度放不下4096像素，贴图精度可以
+        TEST_ASSERT(gl::MaxFixedPosition(gl::TEXT_POSITION_FRACTION_BITS) < 4096.0f, "Text range below 4K");
+        TEST_ASSERT(gl::MaxFixedPosition(gl::TEXTURE_POSITION_FRACTION_BITS) >= 4096.0f, "Texture range covers 4K");
+        const float scale = float(1 << gl::TEXTURE_POSITION_FRACTION_BITS);
+        for (float value : { 0.0f, 2560.0f, 4095.5f, 4096.0f, -4096.0f })
+        {
+            const int16_t fixed = gl::QuantizePosition(value, gl::TEXTURE_POSITION_FRACTION_BITS);
+            TEST_EQUAL(float(fixed) / scale, value, "Texture position round trips");
+        }
+
+        // 每个字符宽8像素，600个字符一行要4800像素
+        TextLayout textLayout;
+        textLayout.SetFontMetrics(10.0f, -2.0f, 0.0f, 1.0f);
+        textLayout.SetAtlas(256, 256, 0);
+        TextGlyph glyph;
+        glyph.m_x1 = 8.0f;
+        glyph.m_y1 = 12.0f;
+        glyph.m_yoff = -10.0f;
+        glyph.m_xadvance = 8.0f;
+        textLayout.AddGlyph('a', glyph);
+        std::vector<int32_t> codepoints(600, 'a');
+        std::vector<float> positions;
+        std::vector<float> uvs;
+        std::vector<uint32_t> indices;
+        std::vector<float> layers;
+        const TextAlignment center = TextAlignment::HCenter | TextAlignment::VCenter;
+        TEST_ASSERT(textLayout.Layout(center, 4096.0f, 4096.0f, codepoints, positions, uvs, indices, layers),
+            "Long run laid out");
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+        for (size_t i = 0; i < positions.size(); i += 3)
+        {
+            maxX = std::max(maxX, positions[i]);
+            maxY = std::max(maxY, positions[i + 1]);
+        }
+        TEST_ASSERT(maxX <= TextLayout::MAX_EXTENT && maxY <= TextLayout::MAX_EXTENT, "Run wrapped inside max extent");
+        TEST_ASSERT(maxX < gl::MaxFixedPosition(gl::TEXT_POSITION_FRACTION_BITS), "Run fits text fixed point");
+
+        print_subsection("All tests complete");
+        return 0;
+    }
+}
+
 int main(int argc, char* argv[])
 {
     // Test_Delegate::Test_Delegate(argc, argv);
     // Test_EventBus::Test_EventBus(argc, argv);
+    // Test_ObjectPool::Test_ObjectPool(argc, argv);
+    // Test_Handle::Test_Handle(argc, argv);
+    // Test_AnchorLayout::Test_AnchorLayout(argc, argv);
+    // Test_StackLayout::Test_StackLayout(argc, argv);
+    // Test_GridLayout::Test_GridLayout(argc, argv);
+    // Test_ConstraintLayout::Test_ConstraintLayout(argc, argv);
+    // Test_ParallelLayout::Test_ParallelLayout(argc, argv);
+    // Test_MPSCQueue::Test_MPSCQueue(argc, argv);
+    // Test_MulticastDelegate::Test_MulticastDelegate(argc, argv);
+    // Test_LatencyTracker::Test_LatencyTracker(argc, argv);
+    // Test_RangeAllocator::Test_RangeAllocator(argc, argv);
+    // Test_ShelfPacker::Test_ShelfPacker(argc, argv);
+    // Test_PixelConvert::Test_PixelConvert(argc, argv);
+    // Test_CoverageGrid::Test_CoverageGrid(argc, argv);
+    // Test_ResizeCoalescer::Test_ResizeCoalescer(argc, argv);
+    // Test_Occlusion::Test_Occlusion(argc, argv);
+    // Test_VertexPosition::Test_VertexPosition(argc, argv);
 
     sz_gui::SDLApp::InitSDL();
 
@@ -240,7 +1644,7 @@ int main(int argc, char* argv[])
     app.BuildTrueType(R"(D:\github\szgui\sln\x64\Debug\SimSun.ttf)");
     app.SetLayout(new sz_gui::layout::AnchorLayout());
 
-    auto frame = std::make_shared<sz_gui::widget::UIFrame>("Center",
+    auto frame = sz_gui::MakeWidget<sz_gui::widget::UIFrame>("Center",
         sz_gui::layout::AnchorPoint::Center,
         sz_gui::layout::Margins::Percentage(5.0f, 5.0f, 5.0f, 5.0f),
         0, 0);
@@ -249,7 +1653,7 @@ int main(int argc, char* argv[])
     frame->SetLayout(new sz_gui::layout::AnchorLayout());
     frame->SetUIFlag(sz_gui::UIFlag::Top);
 
-    auto btn1 = std::make_shared<sz_gui::widget::UIButton>("TopLeft",
+    auto btn1 = sz_gui::MakeWidget<sz_gui::widget::UIButton>("TopLeft",
         sz_gui::layout::AnchorPoint::TopLeft,
         sz_gui::layout::Margins::Percentage(5.0f, 5.0f, 0.0f, 0.0f),
         80, 40);
@@ -261,33 +1665,47 @@ int main(int argc, char* argv[])
         std::cout << "Mouse Left Button Clicked, id:" << mouseEvent.GetData()->m_widgetOnlyId << std::endl;
     });
 
-    auto btn2 = std::make_shared<sz_gui::widget::UIButton>("TopRight",
+    auto btn2 = sz_gui::MakeWidget<sz_gui::widget::UIButton>("TopRight",
         sz_gui::layout::AnchorPoint::TopRight,
         sz_gui::layout::Margins::Percentage(0.0f, 5.0f, 5.0f, 0.0f),
         80, 40);
     btn2->SetParent(frame);
     frame->AddWidget(btn2);
     
-    auto btn3 = std::make_shared<sz_gui::widget::UIButton>("Center",
+    auto btn3 = sz_gui::MakeWidget<sz_gui::widget::UIButton>("Center",
         sz_gui::layout::AnchorPoint::Center, sz_gui::layout::Margins(0.0f),
         80, 40);
     btn3->SetParent(frame);
     frame->AddWidget(btn3);
 
-    auto btn4 = std::make_shared<sz_gui::widget::UIButton>("BottomLeft",
+    auto btn4 = sz_gui::MakeWidget<sz_gui::widget::UIButton>("BottomLeft",
         sz_gui::layout::AnchorPoint::BottomLeft,
         sz_gui::layout::Margins::Percentage(5.0f, 0.0f, 0.0f, 5.0f),
         80, 40);
     btn4->SetParent(frame);
     frame->AddWidget(btn4);
 
-    auto btn5 = std::make_shared<sz_gui::widget::UIButton>("BottomRight",
+    auto btn5 = sz_gui::MakeWidget<sz_gui::widget::UIButton>("BottomRight",
         sz_gui::layout::AnchorPoint::BottomRight,
         sz_gui::layout::Margins::Percentage(0.0f, 0.0f, 5.0f, 5.0f),
         80, 40);
     btn5->SetParent(frame);
     frame->AddWidget(btn5);
 
+    auto list = sz_gui::MakeWidget<sz_gui::widget::UIListView>("List",
+        sz_gui::layout::AnchorPoint::CenterLeft,
+        sz_gui::layout::Margins::Percentage(5.0f, 0.0f, 0.0f, 0.0f),
+        160, 240, 24.0f);
+    list->SetParent(frame);
+    frame->AddWidget(list);
+
+    sz_gui::widget::UIListView::RowBinder binder;
+    binder.Bind([](size_t row, sz_gui::widget::UIListRow& rowWidget) {
+        rowWidget.SetText("Row " + std::to_string(row));
+    });
+    list->SetRowBinder(binder);
+    list->SetRowCount(100000);
+
     app.Run();
 
     return 0;
@@ -0,0 +1,402 @@
+// comment: 微基准测试，注册后统一运行，先预热和校准迭代次数，再重复采样统计中位数、MAD和最小值
+
+#pragma once
+
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace sz_test
+{
+    // 阻止编译器优化掉结果
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        static volatile const void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    // 阻止编译器跨越该点重排内存访问
+    inline void ClobberMemory()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    // 单次采样状态，基准函数先做准备，然后在KeepRunning循环中执行被测代码，只统计循环部分
+    class BenchmarkState
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        // 本次采样迭代次数
+        uint64_t m_iterations = 0;
+        // 剩余迭代次数
+        uint64_t m_remaining = 0;
+        // 计时开始
+        Clock::time_point m_begin;
+        // 计时结束
+        Clock::time_point m_end;
+        // 是否已经开始
+        bool m_started = false;
+        // 每次迭代处理的元素个数，用于输出吞吐
+        uint64_t m_itemsPerIteration = 0;
+        // 自定义计数，名字和每次迭代的平均值
+        std::vector<std::pair<std::string, double>> m_counters;
+
+    public:
+        explicit BenchmarkState(uint64_t iterations)
+            : m_iterations(iterations), m_remaining(iterations)
+        {
+        }
+
+    public:
+        // 第一次调用开始计时，迭代完成时停止计时并返回false
+        bool KeepRunning()
+        {
+            if (!m_started)
+            {
+                m_started = true;
+                m_begin = Clock::now();
+            }
+            if (m_remaining > 0)
+            {
+                --m_remaining;
+                return true;
+            }
+            m_end = Clock::now();
+            return false;
+        }
+        // 本次采样迭代次数
+        uint64_t GetIterations() const { return m_iterations; }
+        // 设置每次迭代处理的元素个数
+        void SetItemsPerIteration(uint64_t items) { m_itemsPerIteration = items; }
+        uint64_t GetItemsPerIteration() const { return m_itemsPerIteration; }
+        // 设置自定义计数，value为每次迭代的平均值，循环结束后调用
+        void SetCounter(const std::string& name, double value) { m_counters.emplace_back(name, value); }
+        const std::vector<std::pair<std::string, double>>& GetCounters() const { return m_counters; }
+        // 本次采样耗时，单位纳秒
+        double GetElapsedNs() const
+        {
+            if (!m_started)
+            {
+                return 0.0;
+            }
+            return std::chrono::duration<double, std::nano>(m_end - m_begin).count();
+        }
+    };
+
+    // 基准函数
+    using BenchmarkFunc = void(*)(BenchmarkState& state);
+
+    // 已注册的基准
+    struct BenchmarkEntry
+    {
+        std::string m_name;
+        BenchmarkFunc m_func = nullptr;
+    };
+
+    // 基准统计结果，时间单位为每次迭代纳秒
+    struct BenchmarkResult
+    {
+        std::string m_name;
+        // 每次采样迭代次数
+        uint64_t m_iterations = 0;
+        // 采样次数
+        uint32_t m_samples = 0;
+        double m_median = 0.0;
+        // 中位数绝对偏差
+        double m_mad = 0.0;
+        double m_min = 0.0;
+        double m_mean = 0.0;
+        // 每秒处理的元素个数，未设置时为0
+        double m_itemsPerSecond = 0.0;
+        // 自定义计数，取最后一次采样
+        std::vector<std::pair<std::string, double>> m_counters;
+    };
+
+    // 运行参数
+    struct BenchmarkOptions
+    {
+        // 只运行名字包含该字符串的基准
+        std::string m_filter;
+        // 预热采样次数
+        uint32_t m_warmup = 2;
+        // 统计采样次数
+        uint32_t m_repetitions = 15;
+        // 每次采样的最短时间，单位毫秒
+        double m_minSampleMs = 10.0;
+        // JSON输出文件，"-"输出到标准输出，为空不输出
+        std::string m_jsonPath;
+    };
+
+    // 基准注册表
+    inline std::vector<BenchmarkEntry>& GetBenchmarks()
+    {
+        static std::vector<BenchmarkEntry> benchmarks;
+        return benchmarks;
+    }
+
+    // 注册基准，静态初始化时调用
+    inline bool RegisterBenchmark(const char* name, BenchmarkFunc func)
+    {
+        GetBenchmarks().push_back(BenchmarkEntry{ name, func });
+        return true;
+    }
+
+    // 中位数，values会被排序
+    inline double Median(std::vector<double>& values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        const size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) * 0.5;
+    }
+
+    // 运行一个基准，迭代次数倍增直到单次采样超过最短时间
+    inline BenchmarkResult RunBenchmark(const BenchmarkEntry& entry, const BenchmarkOptions& options)
+    {
+        BenchmarkResult result;
+        result.m_name = entry.m_name;
+
+        const double minSampleNs = options.m_minSampleMs * 1e6;
+        uint64_t iterations = 1;
+        uint64_t itemsPerIteration = 0;
+        while (true)
+        {
+            BenchmarkState state(iterations);
+            entry.m_func(state);
+            const double elapsed = state.GetElapsedNs();
+            if (elapsed >= minSampleNs || iterations >= (uint64_t(1) << 40))
+            {
+                break;
+            }
+            // 按已测耗时估算，最多放大10倍
+            const double factor = elapsed > 0.0 ? std::min(10.0, minSampleNs * 1.2 / elapsed) : 10.0;
+            iterations = std::max(iterations + 1, uint64_t(double(iterations) * factor));
+        }
+        result.m_iterations = iterations;
+
+        for (uint32_t i = 0; i < options.m_warmup; ++i)
+        {
+            BenchmarkState state(iterations);
+            entry.m_func(state);
+        }
+
+        std::vector<double> samples;
+        samples.reserve(options.m_repetitions);
+        for (uint32_t i = 0; i < std::max(1u, options.m_repetitions); ++i)
+        {
+            BenchmarkState state(iterations);
+            entry.m_func(state);
+            samples.push_back(state.GetElapsedNs() / double(iterations));
+            itemsPerIteration = state.GetItemsPerIteration();
+            result.m_counters = state.GetCounters();
+        }
+
+        result.m_samples = uint32_t(samples.size());
+        result.m_min = *std::min_element(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double sample : samples)
+        {
+            sum += sample;
+        }
+        result.m_mean = sum / double(samples.size());
+        result.m_median = Median(samples);
+        std::vector<double> deviations;
+        deviations.reserve(samples.size());
+        for (double sample : samples)
+        {
+            deviations.push_back(std::fabs(sample - result.m_median));
+        }
+        result.m_mad = Median(deviations);
+        if (itemsPerIteration > 0 && result.m_median > 0.0)
+        {
+            result.m_itemsPerSecond = double(itemsPerIteration) * 1e9 / result.m_median;
+        }
+        return result;
+    }
+
+    // JSON字符串转义
+    inline std::string JsonEscape(const std::string& text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                }
+                else
+                {
+                    escaped += c;
+                }
+                break;
+            }
+        }
+        return escaped;
+    }
+
+    // 输出JSON
+    inline void WriteBenchmarkJson(std::ostream& os, const std::vector<BenchmarkResult>& results,
+        const BenchmarkOptions& options)
+    {
+        os << "{\n  \"unit\": \"ns/iter\",\n";
+        os << "  \"repetitions\": " << options.m_repetitions << ",\n";
+        os << "  \"warmup\": " << options.m_warmup << ",\n";
+        os << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            os << "    {\"name\": \"" << JsonEscape(r.m_name) << "\", \"iterations\": " << r.m_iterations
+                << ", \"samples\": " << r.m_samples << ", \"median\": " << r.m_median
+                << ", \"mad\": " << r.m_mad << ", \"min\": " << r.m_min << ", \"mean\": " << r.m_mean
+                << ", \"items_per_second\": " << r.m_itemsPerSecond;
+            if (!r.m_counters.empty())
+            {
+                os << ", \"counters\": {";
+                for (size_t c = 0; c < r.m_counters.size(); ++c)
+                {
+                    os << (c ? ", " : "") << "\"" << JsonEscape(r.m_counters[c].first) << "\": " << r.m_counters[c].second;
+                }
+                os << "}";
+            }
+            os << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+    }
+
+    // 解析命令行，--filter=xx --repetitions=n --warmup=n --min-time-ms=x --json=path
+    inline BenchmarkOptions ParseBenchmarkOptions(int argc, char* argv[])
+    {
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&arg](const char* key) -> const char* {
+                const size_t length = strlen(key);
+                return arg.compare(0, length, key) == 0 ? arg.c_str() + length : nullptr;
+            };
+            if (auto v = value("--filter="))
+            {
+                options.m_filter = v;
+            }
+            else if (auto v = value("--repetitions="))
+            {
+                options.m_repetitions = uint32_t(std::max(1, atoi(v)));
+            }
+            else if (auto v = value("--warmup="))
+            {
+                options.m_warmup = uint32_t(std::max(0, atoi(v)));
+            }
+            else if (auto v = value("--min-time-ms="))
+            {
+                options.m_minSampleMs = std::max(0.01, atof(v));
+            }
+            else if (auto v = value("--json="))
+            {
+                options.m_jsonPath = v;
+            }
+            else if (arg == "--json")
+            {
+                options.m_jsonPath = "-";
+            }
+        }
+        return options;
+    }
+
+    // 运行所有注册的基准，返回进程退出码
+    inline int RunBenchmarks(int argc, char* argv[])
+    {
+        const BenchmarkOptions options = ParseBenchmarkOptions(argc, argv);
+        const bool jsonToStdout = options.m_jsonPath == "-";
+
+        std::vector<BenchmarkResult> results;
+        for (const auto& entry : GetBenchmarks())
+        {
+            if (!options.m_filter.empty() && entry.m_name.find(options.m_filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            results.push_back(RunBenchmark(entry, options));
+            if (!jsonToStdout)
+            {
+                const auto& r = results.back();
+                std::ostringstream oss;
+                oss << r.m_name << ": median " << r.m_median << " ns, mad " << r.m_mad
+                    << " ns, min " << r.m_min << " ns (" << r.m_samples << " x " << r.m_iterations << ")";
+                if (r.m_itemsPerSecond > 0.0)
+                {
+                    oss << ", " << r.m_itemsPerSecond / 1e6 << " M items/s";
+                }
+                for (const auto& [name, value] : r.m_counters)
+                {
+                    oss << ", " << name << " " << value;
+                }
+                log(LogLevel::INFO, oss.str());
+            }
+        }
+
+        if (jsonToStdout)
+        {
+            WriteBenchmarkJson(std::cout, results, options);
+        }
+        else if (!options.m_jsonPath.empty())
+        {
+            std::ofstream file(options.m_jsonPath);
+            if (!file)
+            {
+                log(LogLevel::FAIL, "open json file failed: " + options.m_jsonPath);
+                return 1;
+            }
+            WriteBenchmarkJson(file, results, options);
+        }
+        return 0;
+    }
+}
+
+// 注册基准
+#define SZ_BENCHMARK(name) \
+    static void name(sz_test::BenchmarkState& state); \
+    static const bool name##_registered = sz_test::RegisterBenchmark(#name, &name); \
+    static void name(sz_test::BenchmarkState& state)
@@ -0,0 +1,190 @@
+// comment: 像素格式转换和上下翻转，x86用SSE2/SSSE3，ARM用NEON，其他平台和尾部像素走标量
+// SSSE3需要编译器开启(MSVC /arch:AVX，GCC -mssse3)，否则RGB转换走标量
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SZ_PIXEL_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SZ_PIXEL_SSE2 1
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define SZ_PIXEL_SSSE3 1
+#endif
+#endif
+
+namespace sz_utils
+{
+    // RGB转RGBA，alpha为255
+    inline void ConvertRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(SZ_PIXEL_NEON)
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+            uint8x16x4_t rgba;
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(0xFF);
+            vst4q_u8(dst + i * 4, rgba);
+        }
+#elif defined(SZ_PIXEL_SSSE3)
+        // 每次读16字节取前4个像素，最后一组读取会越界，留给标量处理
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(int32_t(0xFF000000));
+        for (; i + 6 <= pixels; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            dst[i * 4 + 0] = src[i * 3 + 0];
+            dst[i * 4 + 1] = src[i * 3 + 1];
+            dst[i * 4 + 2] = src[i * 3 + 2];
+            dst[i * 4 + 3] = 0xFF;
+        }
+    }
+
+    // 灰度转RGBA，alpha为255
+    inline void ConvertGrayToRGBA(const uint8_t* src, uint8_t* dst, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(SZ_PIXEL_NEON)
+        for (; i + 16 <= pixels; i += 16)
+        {
+            const uint8x16_t g = vld1q_u8(src + i);
+            uint8x16x4_t rgba;
+            rgba.val[0] = g;
+            rgba.val[1] = g;
+            rgba.val[2] = g;
+            rgba.val[3] = vdupq_n_u8(0xFF);
+            vst4q_u8(dst + i * 4, rgba);
+        }
+#elif defined(SZ_PIXEL_SSE2)
+        const __m128i alpha = _mm_set1_epi32(int32_t(0xFF000000));
+        for (; i + 16 <= pixels; i += 16)
+        {
+            const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i gg0 = _mm_unpacklo_epi8(g, g);
+            const __m128i gg1 = _mm_unpackhi_epi8(g, g);
+            auto* out = reinterpret_cast<__m128i*>(dst + i * 4);
+            _mm_storeu_si128(out + 0, _mm_or_si128(_mm_unpacklo_epi16(gg0, gg0), alpha));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_unpackhi_epi16(gg0, gg0), alpha));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_unpacklo_epi16(gg1, gg1), alpha));
+            _mm_storeu_si128(out + 3, _mm_or_si128(_mm_unpackhi_epi16(gg1, gg1), alpha));
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            dst[i * 4 + 0] = src[i];
+            dst[i * 4 + 1] = src[i];
+            dst[i * 4 + 2] = src[i];
+            dst[i * 4 + 3] = 0xFF;
+        }
+    }
+
+    // 灰度加透明度转RGBA
+    inline void ConvertGrayAlphaToRGBA(const uint8_t* src, uint8_t* dst, size_t pixels)
+    {
+        size_t i = 0;
+#if defined(SZ_PIXEL_NEON)
+        for (; i + 16 <= pixels; i += 16)
+        {
+            const uint8x16x2_t ga = vld2q_u8(src + i * 2);
+            uint8x16x4_t rgba;
+            rgba.val[0] = ga.val[0];
+            rgba.val[1] = ga.val[0];
+            rgba.val[2] = ga.val[0];
+            rgba.val[3] = ga.val[1];
+            vst4q_u8(dst + i * 4, rgba);
+        }
+#elif defined(SZ_PIXEL_SSE2)
+        // 每个像素的ga复制成gaga，再把第二个字节换成g
+        const __m128i keep = _mm_set1_epi32(int32_t(0xFFFF00FF));
+        const __m128i low = _mm_set1_epi32(0xFF);
+        for (; i + 8 <= pixels; i += 8)
+        {
+            const __m128i ga = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            const __m128i p0 = _mm_unpacklo_epi16(ga, ga);
+            const __m128i p1 = _mm_unpackhi_epi16(ga, ga);
+            auto* out = reinterpret_cast<__m128i*>(dst + i * 4);
+            _mm_storeu_si128(out + 0, _mm_or_si128(_mm_and_si128(p0, keep),
+                _mm_slli_epi32(_mm_and_si128(p0, low), 8)));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_and_si128(p1, keep),
+                _mm_slli_epi32(_mm_and_si128(p1, low), 8)));
+        }
+#endif
+        for (; i < pixels; ++i)
+        {
+            dst[i * 4 + 0] = src[i * 2];
+            dst[i * 4 + 1] = src[i * 2];
+            dst[i * 4 + 2] = src[i * 2];
+            dst[i * 4 + 3] = src[i * 2 + 1];
+        }
+    }
+
+    // 任意通道数转RGBA，channels为1~4
+    inline void ConvertToRGBA(const uint8_t* src, int channels, uint8_t* dst, size_t pixels)
+    {
+        switch (channels)
+        {
+        case 1:
+            ConvertGrayToRGBA(src, dst, pixels);
+            break;
+        case 2:
+            ConvertGrayAlphaToRGBA(src, dst, pixels);
+            break;
+        case 3:
+            ConvertRGBToRGBA(src, dst, pixels);
+            break;
+        default:
+            std::memcpy(dst, src, pixels * 4);
+            break;
+        }
+    }
+
+    // 原地上下翻转，rowBytes为每行字节数
+    inline void FlipRowsVertically(uint8_t* pixels, size_t rowBytes, size_t rows)
+    {
+        for (size_t top = 0, bottom = rows ? rows - 1 : 0; top < bottom; ++top, --bottom)
+        {
+            uint8_t* a = pixels + top * rowBytes;
+            uint8_t* b = pixels + bottom * rowBytes;
+            size_t i = 0;
+#if defined(SZ_PIXEL_NEON)
+            for (; i + 16 <= rowBytes; i += 16)
+            {
+                const uint8x16_t va = vld1q_u8(a + i);
+                const uint8x16_t vb = vld1q_u8(b + i);
+                vst1q_u8(a + i, vb);
+                vst1q_u8(b + i, va);
+            }
+#elif defined(SZ_PIXEL_SSE2)
+            for (; i + 16 <= rowBytes; i += 16)
+            {
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), vb);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), va);
+            }
+#endif
+            for (; i < rowBytes; ++i)
+            {
+                const uint8_t t = a[i];
+                a[i] = b[i];
+                b[i] = t;
+            }
+        }
+    }
+}